@@ -0,0 +1,216 @@
+/**
+ *  Benchmark of AES engines from mycrypto-aes library
+ *  Encrypts and decrypts a random buffer of given size with every engine
+ *  supported by this CPU and reports throughput (MB/s) and cost in cycles per
+ *  byte (cycles of the time stamp counter, where available).
+ *
+ *  Build (from this folder, after running librarize.bash in parent folder):
+ *      g++ -std=c++11 -O2 -pthread aesBench.cpp -L.. -lmycrypto -lcrypto -o aesBench
+ *  Run:
+ *      LD_LIBRARY_PATH=.. ./aesBench [size in MB, default 64]
+ *
+ *  Created: 17. Oct 2026.
+ *  Author: Vedran Mikov
+ */
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include "../mycrypto-aes.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_TSC
+#endif
+
+using namespace std;
+
+
+/**
+ *  Fill string with pseudo-random bytes (xorshift, rand() is too slow here)
+ *  @param length Desired length of returned string
+ *  @return String of pseudo-random bytes
+ */
+string RandomBytes(size_t length)
+{
+    string retVal(length, 0);
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+
+    for (size_t i = 0; i < length; i++)
+    {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        retVal[i] = (char)(state >> 56);
+    }
+
+    return retVal;
+}
+
+/**
+ *  Start of a measurement, wall time and time stamp counter
+ */
+struct Mark
+{
+    chrono::steady_clock::time_point    time;
+    uint64_t                            tsc;
+};
+
+Mark Now()
+{
+    Mark m;
+    m.time = chrono::steady_clock::now();
+#ifdef BENCH_TSC
+    m.tsc = __rdtsc();
+#else
+    m.tsc = 0;
+#endif
+    return m;
+}
+
+/**
+ *  Print throughput and cycles per byte of a single measurement
+ *  @param name Name of measured function
+ *  @param bytes Number of input bytes processed
+ *  @param start Mark at which the measurement started
+ */
+void Report(string const &name, size_t bytes, Mark const &start)
+{
+    Mark end = Now();
+    double sec = chrono::duration<double>(end.time - start.time).count();
+
+    cout << setw(40) << left << name << fixed << setprecision(1)
+         << setw(10) << right << (bytes / 1048576.0) / sec << " MB/s";
+#ifdef BENCH_TSC
+    cout << setprecision(2) << setw(10) << (double)(end.tsc - start.tsc) / bytes
+         << " cycles/B";
+#endif
+    cout << endl;
+}
+
+
+int main(int argc, char *argv[])
+{
+    size_t sizeMB = (argc > 1) ? strtoul(argv[1], NULL, 10) : 64;
+    string text = RandomBytes(sizeMB * 1048576), key = text.substr(0, 16);
+    //  Preallocated output, to measure engines without allocation costs
+    string buffer(text.length() + AES_ECB_BLOCK_SIZE, 0), check(buffer);
+    size_t blocks = text.length() / AES_ECB_BLOCK_SIZE;
+    uint8_t const *iv = (uint8_t const*)text.data() + 16;
+    //  Hybrid engine is the automatic choice without AES-NI, its single-block
+    //  and CBC encryption rows should match those of OpenSSL
+    uint8_t engines[] = { AES_ENGINE_OPENSSL, AES_ENGINE_AESNI, AES_ENGINE_TTABLE,
+                          AES_ENGINE_BITSLICE, AES_ENGINE_HYBRID };
+    const char *engineName[] = { "auto", "OpenSSL", "AES-NI", "T-table", "bitsliced",
+                                 "hybrid (bitsliced 8+ blocks, OpenSSL otherwise)" };
+    //  Many short independent records, for batch CBC encryption
+    size_t recordLen = 1024, recordOut = recordLen + AES_ECB_BLOCK_SIZE;
+    size_t records = text.length() / recordOut;
+    vector<AESCBCJob> jobs(records);
+    Mark start;
+
+    cout << "Input size: " << sizeMB << " MB" << endl;
+
+    for (uint8_t e : engines)
+    {
+        if (!AESEngineSupported(e))
+            continue;
+        AES128Context ctx(key, e);
+        cout << "Engine: " << engineName[e] << endl;
+
+        start = Now();
+        ctx.encryptBlocks((uint8_t const*)text.data(), (uint8_t*)&buffer[0], blocks);
+        Report("  ECB encrypt", text.length(), start);
+
+        start = Now();
+        ctx.decryptBlocks((uint8_t const*)buffer.data(), (uint8_t*)&check[0], blocks);
+        Report("  ECB decrypt", text.length(), start);
+        if (memcmp(check.data(), text.data(), text.length()) != 0)
+            cout << "\tMISMATCH" << endl;
+
+        //  One call per block, as done by code chaining blocks itself
+        start = Now();
+        for (size_t b = 0; b < blocks; b++)
+            ctx.encryptBlock((uint8_t const*)text.data() + b * AES_ECB_BLOCK_SIZE,
+                             (uint8_t*)&buffer[b * AES_ECB_BLOCK_SIZE]);
+        Report("  encryptBlock (one per call)", text.length(), start);
+
+        start = Now();
+        size_t n = AESCBCEncryptText(ctx, iv, text.data(), text.length(),
+                                     &buffer[0], buffer.length());
+        Report("  CBC encrypt", text.length(), start);
+
+        start = Now();
+        AESCBCDecryptText(ctx, iv, buffer.data(), n, &check[0], check.length(), 1);
+        Report("  CBC decrypt (1 thread)", text.length(), start);
+        if (memcmp(check.data(), text.data(), text.length()) != 0)
+            cout << "\tMISMATCH" << endl;
+
+        start = Now();
+        AESCBCDecryptText(ctx, iv, buffer.data(), n, &check[0], check.length(), 0);
+        Report("  CBC decrypt (all cores)", text.length(), start);
+        if (memcmp(check.data(), text.data(), text.length()) != 0)
+            cout << "\tMISMATCH" << endl;
+
+        //  Piped through a fixed 1 MB buffer, as when streaming a file
+        AES128CBCStream stream(ctx, iv, true);
+        size_t piece = 1048576, at = 0;
+        string pipe(piece + AES_ECB_BLOCK_SIZE, 0);
+        start = Now();
+        for (size_t pos = 0; pos < text.length(); pos += piece)
+        {
+            size_t k = stream.update(text.data() + pos, min(piece, text.length() - pos),
+                                     &pipe[0], pipe.length());
+            memcpy(&check[at], pipe.data(), k);
+            at += k;
+        }
+        at += stream.final(&check[at], check.length() - at);
+        Report("  CBC encrypt, streamed 1 MB at a time", text.length(), start);
+        if ((at != n) || (memcmp(check.data(), buffer.data(), n) != 0))
+            cout << "\tMISMATCH" << endl;
+
+        AES128CTR ctr1(ctx, 0, 1), ctrAll(ctx, 0, 0);
+        start = Now();
+        ctr1.crypt(text.data(), text.length(), &buffer[0]);
+        Report("  CTR (1 thread)", text.length(), start);
+
+        start = Now();
+        ctrAll.crypt(buffer.data(), text.length(), &check[0]);
+        Report("  CTR (all cores)", text.length(), start);
+        if (memcmp(check.data(), text.data(), text.length()) != 0)
+            cout << "\tMISMATCH" << endl;
+
+        //  Random access, 4 kB reads at scattered offsets
+        start = Now();
+        for (size_t r = 0, o = 0; r < text.length() / 4096; r++, o = (o + 40961 * 16) % (text.length() - 4096))
+        {
+            ctr1.seek(o);
+            ctr1.crypt(buffer.data() + o, 4096, &check[o]);
+        }
+        Report("  CTR 4 kB reads at random offsets", text.length(), start);
+
+        start = Now();
+        for (size_t r = 0; r < records; r++)
+            AESCBCEncryptText(ctx, iv, text.data() + r * recordOut, recordLen,
+                              &check[r * recordOut], recordOut);
+        Report("  CBC encrypt 1 KB records", records * recordLen, start);
+
+        for (size_t r = 0; r < records; r++)
+        {
+            AESCBCJob job = { &ctx, iv, text.data() + r * recordOut, recordLen,
+                              &buffer[r * recordOut], recordOut, 0 };
+            jobs[r] = job;
+        }
+        start = Now();
+        AESCBCEncryptBatch(jobs.data(), records);
+        Report("  CBC encrypt 1 KB records, batch", records * recordLen, start);
+        if (memcmp(check.data(), buffer.data(), records * recordOut) != 0)
+            cout << "\tMISMATCH" << endl;
+    }
+
+    return 0;
+}
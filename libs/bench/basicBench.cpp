@@ -0,0 +1,272 @@
+/**
+ *  Benchmark of functions from mycrypto-basic library
+ *  Generates a random buffer of given size and reports throughput (MB/s) of
+ *  data conversions on it.
+ *
+ *  Build (from this folder, after running librarize.bash in parent folder):
+ *      g++ -std=c++11 -O2 -pthread basicBench.cpp -L.. -lmycrypto -o basicBench
+ *  Run:
+ *      LD_LIBRARY_PATH=.. ./basicBench [size in MB, default 256]
+ *
+ *  Created: 17. Oct 2026.
+ *  Author: Vedran Mikov
+ */
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include "../mycrypto-basic.h"
+#include "../mycrypto-simd.h"
+#include "../mycrypto-english.h"
+
+using namespace std;
+
+
+/**
+ *  Fill string with pseudo-random bytes (xorshift, rand() is too slow here)
+ *  @param length Desired length of returned string
+ *  @return String of pseudo-random bytes
+ */
+string RandomBytes(size_t length)
+{
+    string retVal(length, 0);
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+
+    for (size_t i = 0; i < length; i++)
+    {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        retVal[i] = (char)(state >> 56);
+    }
+
+    return retVal;
+}
+
+/**
+ *  Print throughput of a single measurement
+ *  @param name Name of measured function
+ *  @param bytes Number of input bytes processed
+ *  @param start Time at which the measurement started
+ */
+void Report(string const &name, size_t bytes,
+            chrono::steady_clock::time_point const &start)
+{
+    double sec = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    cout << setw(40) << left << name << fixed << setprecision(1)
+         << setw(10) << right << (bytes / 1048576.0) / sec << " MB/s" << endl;
+}
+
+
+int main(int argc, char *argv[])
+{
+    size_t sizeMB = (argc > 1) ? strtoul(argv[1], NULL, 10) : 256;
+    string ascii = RandomBytes(sizeMB * 1048576), b64, hex, ret;
+    //  Preallocated output, to measure kernels without allocation costs
+    string buffer(2 * ascii.length() + 64, 0);
+    chrono::steady_clock::time_point start;
+    const char *levelName[] = { "scalar", "SSSE3", "AVX2", "AVX-512" };
+
+    cout << "Input size: " << sizeMB << " MB" << endl;
+
+    //  Reference encodings
+    b64 = ASCIIToBase64(ascii);
+    hex = ASCIIToHex(ascii);
+
+    //  Decoding chained through HEX, as done before direct conversion existed
+    start = chrono::steady_clock::now();
+    ret = HexToASCII(Base64ToHex(b64));
+    Report("HexToASCII(Base64ToHex())", b64.length(), start);
+    if (ret != ascii)
+        cout << "\tMISMATCH" << endl;
+
+    //  Base64 XOR chained through HEX, as done before the fused one existed
+    start = chrono::steady_clock::now();
+    string b64XOR = HexToBase64(HexRepeatKeyXOR(Base64ToHex(b64), "494345"));
+    Report("Base64 XOR through HEX", b64.length(), start);
+
+    //  Upper bound for kernels that read and write the whole buffer once
+    start = chrono::steady_clock::now();
+    memcpy(&buffer[0], ascii.data(), ascii.length());
+    Report("memcpy", ascii.length(), start);
+
+    //  Repeating-key XOR through a key expanded to the length of the text, as
+    //  done before the kernel existed
+    start = chrono::steady_clock::now();
+    {
+        string key("ICE"), keyNew;
+        for (size_t i = 0; i < ascii.length(); i++)
+            keyNew += key[i % key.length()];
+        ret = ASCIIFixedXOR(ascii, keyNew);
+    }
+    Report("ASCIIFixedXOR(expanded key)", ascii.length(), start);
+
+    //  Key size estimation over a wide range of key sizes, both count over the
+    //  whole text once per key size
+    {
+        size_t len = (ascii.length() < 4194304) ? ascii.length() : 4194304;
+        start = chrono::steady_clock::now();
+        EstimateRepeatingKeySize(ascii.data(), len, 2, 4000);
+        Report("EstimateRepeatingKeySize (2-4000)", len, start);
+
+        start = chrono::steady_clock::now();
+        EstimateRepeatingKeySizeIoC(ascii.data(), len, 2, 4000);
+        Report("EstimateRepeatingKeySizeIoC (2-4000)", len, start);
+    }
+
+    //  Bulk single-byte XOR detection over 60-char HEX lines
+    {
+        string lines;
+        size_t count = 0;
+        for (size_t i = 0; (i + 30) <= ascii.length(); i += 30, count++)
+            lines += ASCIIToHex(ascii.substr(i, 30)) + "\n";
+
+        start = chrono::steady_clock::now();
+        DetectSingleByteXOR(lines.data(), lines.length(), ENC_HEX, 10);
+        double sec = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        cout << setw(40) << left << "DetectSingleByteXOR (HEX lines)" << fixed
+             << setprecision(1) << setw(10) << right << count / sec << " lines/s" << endl;
+    }
+
+    //  Crib dragging 200 cribs over XOR of two 1MB texts made of random words
+    {
+        const char *words[] = { "the", "of", "and", "a", "to", "in", "is", "you",
+                                "that", "it", "he", "was", "for", "on", "are" };
+        string text[2];
+        vector<string> cribs;
+        uint32_t state = 1;
+        for (size_t t = 0; t < 2; t++)
+            while (text[t].length() < 1048576)
+            {
+                state = state * 1103515245 + 12345;
+                text[t] += string(words[(state >> 16) % 15]) + " ";
+            }
+        for (size_t i = 0; i < 200; i++)
+            cribs.push_back(string(" ") + words[i % 15] + " " + words[(i / 15) % 15] + " ");
+        string x = ASCIIFixedXOR(text[0].substr(0, 1048576), text[1].substr(0, 1048576));
+
+        start = chrono::steady_clock::now();
+        CribDrag(x, cribs, 100);
+        double sec = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        cout << setw(40) << left << "CribDrag (200 cribs)" << fixed << setprecision(1)
+             << setw(10) << right << (x.length() * cribs.size() / 1e6) / sec << " M windows/s" << endl;
+    }
+
+    //  Plaintext scoring with n-gram model, directly and through a key
+    start = chrono::steady_clock::now();
+    EnglishScore(ascii);
+    Report("EnglishScore", ascii.length(), start);
+
+    start = chrono::steady_clock::now();
+    EnglishScoreXOR(ascii.data(), ascii.length(), b64.data(), 29);
+    Report("EnglishScoreXOR (key 29)", ascii.length(), start);
+
+    //  All conversions, for every kernel level supported by this CPU
+    for (uint8_t lvl = SIMD_SCALAR; lvl <= SIMDSupportedLevel(); lvl++)
+    {
+        SIMDSetLevel(lvl);
+        cout << "Kernels: " << levelName[lvl] << endl;
+
+        start = chrono::steady_clock::now();
+        ret = ASCIIToBase64(ascii);
+        Report("  ASCIIToBase64", ascii.length(), start);
+
+        start = chrono::steady_clock::now();
+        ret = Base64ToASCII(b64);
+        Report("  Base64ToASCII", b64.length(), start);
+        if (ret != ascii)
+            cout << "\tMISMATCH" << endl;
+
+        start = chrono::steady_clock::now();
+        ret = ASCIIToHex(ascii);
+        Report("  ASCIIToHex", ascii.length(), start);
+
+        start = chrono::steady_clock::now();
+        ret = HexToASCII(hex);
+        Report("  HexToASCII", hex.length(), start);
+        if (ret != ascii)
+            cout << "\tMISMATCH" << endl;
+
+        start = chrono::steady_clock::now();
+        ret = HexToBase64(hex);
+        Report("  HexToBase64", hex.length(), start);
+        if (ret != b64)
+            cout << "\tMISMATCH" << endl;
+
+        start = chrono::steady_clock::now();
+        ret = Base64ToHex(b64);
+        Report("  Base64ToHex", b64.length(), start);
+        if (ret != hex)
+            cout << "\tMISMATCH" << endl;
+
+        start = chrono::steady_clock::now();
+        ret = HexRepeatKeyXOR(hex, "494345");
+        Report("  HexRepeatKeyXOR", hex.length(), start);
+
+        start = chrono::steady_clock::now();
+        ret = RepeatKeyXOR(b64, "SUNF", ENC_BASE64);
+        Report("  RepeatKeyXOR (Base64)", b64.length(), start);
+        if (ret != b64XOR)
+            cout << "\tMISMATCH" << endl;
+
+        //  Raw kernels, writing into preallocated buffer
+        start = chrono::steady_clock::now();
+        SIMDBase64Encode(&buffer[0], (const uint8_t*)ascii.data(), ascii.length());
+        Report("  SIMDBase64Encode (buffer)", ascii.length(), start);
+
+        start = chrono::steady_clock::now();
+        SIMDBase64Decode((uint8_t*)&buffer[0], b64.data(), b64.length());
+        Report("  SIMDBase64Decode (buffer)", b64.length(), start);
+
+        start = chrono::steady_clock::now();
+        SIMDHexEncode(&buffer[0], (const uint8_t*)ascii.data(), ascii.length());
+        Report("  SIMDHexEncode (buffer)", ascii.length(), start);
+
+        start = chrono::steady_clock::now();
+        SIMDHexDecode((uint8_t*)&buffer[0], hex.data(), hex.length());
+        Report("  SIMDHexDecode (buffer)", hex.length(), start);
+
+        start = chrono::steady_clock::now();
+        SIMDHamming((const uint8_t*)ascii.data(), (const uint8_t*)buffer.data(), ascii.length());
+        Report("  SIMDHamming", ascii.length(), start);
+
+        //  Many short blocks, as compared by keysize estimation
+        start = chrono::steady_clock::now();
+        for (size_t i = 0; (i + 80) <= ascii.length(); i += 80)
+            SIMDHamming((const uint8_t*)ascii.data() + i, (const uint8_t*)ascii.data() + i + 40, 40);
+        Report("  SIMDHamming (40 byte blocks)", ascii.length(), start);
+
+        start = chrono::steady_clock::now();
+        ASCIIClassCount(ascii.data(), ascii.length(), CHAR_TEXT);
+        Report("  ASCIIClassCount", ascii.length(), start);
+
+        //  Split into key columns and back, for a typical key size
+        start = chrono::steady_clock::now();
+        SIMDTranspose((uint8_t*)&buffer[0], (const uint8_t*)ascii.data(), ascii.length(), 29);
+        Report("  SIMDTranspose (29 columns)", ascii.length(), start);
+
+        start = chrono::steady_clock::now();
+        SIMDUntranspose((uint8_t*)&buffer[ascii.length() + 32], (const uint8_t*)buffer.data(), ascii.length(), 29);
+        Report("  SIMDUntranspose (29 columns)", ascii.length(), start);
+        if (memcmp(&buffer[ascii.length() + 32], ascii.data(), ascii.length()) != 0)
+            cout << "\tMISMATCH" << endl;
+
+        //  Repeating-key XOR, for short key dividing the vector width, short
+        //  key that doesn't and key longer than internal pattern buffer
+        for (size_t keyLen = 4; keyLen <= 1024; keyLen *= 16)
+        {
+            size_t len = keyLen + (keyLen > 4);
+            start = chrono::steady_clock::now();
+            SIMDRepeatXOR((uint8_t*)&buffer[0], (const uint8_t*)ascii.data(),
+                          ascii.length(), (const uint8_t*)b64.data(), len);
+            Report("  SIMDRepeatXOR (key " + to_string(len) + ")", ascii.length(), start);
+        }
+    }
+
+    return 0;
+}
@@ -3,15 +3,27 @@
 # Compile sources into object files
 
 ## Process basic library (data encodings, XOR implementation...)
-g++ -std=c++11 -Wall -fPIC -O -g mycrypto-basic.cpp -c -o mycrypto-basic.o
+g++ -std=c++11 -Wall -fPIC -pthread -O -g mycrypto-basic.cpp -c -o mycrypto-basic.o
+
+## Process vectorized kernels (runtime-dispatched SSSE3/AVX2/AVX-512 code)
+g++ -std=c++11 -Wall -fPIC -pthread -O -g mycrypto-simd.cpp -c -o mycrypto-simd.o
+
+## Process English language model (n-gram tables, plaintext scoring)
+g++ -std=c++11 -Wall -fPIC -pthread -O -g mycrypto-english.cpp -c -o mycrypto-english.o
+
+## Process native AES engines (AES-NI, T-table and bitsliced block kernels)
+g++ -std=c++11 -Wall -fPIC -pthread -O -g mycrypto-aescore.cpp -c -o mycrypto-aescore.o
 
 ## Process AES library (EBC/CBD AES encryption/decryption)
-g++ -std=c++11 -Wall -fPIC -O -g mycrypto-aes.cpp -c -o mycrypto-aes.o
+g++ -std=c++11 -Wall -fPIC -pthread -O -g mycrypto-aes.cpp -c -o mycrypto-aes.o
 
 ## Merge
-g++ -shared mycrypto-basic.o mycrypto-aes.o -lcrypto -o libmycrypto.so 
+g++ -shared -pthread mycrypto-basic.o mycrypto-simd.o mycrypto-english.o mycrypto-aescore.o mycrypto-aes.o -lcrypto -o libmycrypto.so 
 
 
 # Housekeeping
 rm mycrypto-basic.o
+rm mycrypto-simd.o
+rm mycrypto-english.o
+rm mycrypto-aescore.o
 rm mycrypto-aes.o
@@ -5,128 +5,654 @@
  *    Created: 21. Oct 2017.
  *    Author: Vedran Mikov
  */
-#include <vector>
-#include <memory>
-#include <limits>
+#include <cstring>
+#include <algorithm>
 #include <stdexcept>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <functional>
 
 #include <openssl/evp.h>
 #include <openssl/rand.h>
 
 #include "mycrypto-basic.h"
 #include "mycrypto-aes.h"
+#include "mycrypto-aescore.h"
+
+
+//  Largest chunk passed to a single EVP call, lengths there are int
+#define EVP_CHUNK   (1 << 30)
+//  Bytes of CBC ciphertext decrypted by one ECB call, small enough to stay in
+//  L1 cache until it's XORed
+#define CBC_CHUNK   4096
+//  Bytes of CTR keystream generated by one ECB call
+#define CTR_CHUNK   4096
+//  Bytes of input processed by one thread at a time (CBC decryption, CTR),
+//  inputs of a single chunk aren't worth starting threads for
+#define THREAD_CHUNK    (1 << 20)
+//  Blocks of a call the hybrid engine gives to bitsliced engine at once,
+//  fewer would be padded to a full group and cost as much
+#define HYBRID_GROUP    8
+//  Messages encrypted in lockstep by batch CBC encryption
+#define CBC_LANES   8
+//  How far ahead of every lane memory is prefetched, once per cache line
+#define CBC_PREFETCH        512
+#define CBC_PREFETCH_LINE   64
+
+
+/**
+ *  Initialize AES engine and seed rand number generator
+ */
+void InitAES128EBC()
+{
+    // Load the necessary cipher
+    EVP_add_cipher(EVP_aes_128_ecb());
+
+    //  Initialize random number generator
+    srand(time(NULL));
+}
 
+/**
+ *  Generate a random string of specified length
+ *  @param keySize Desired length of returned string
+ *  @return Random string with characters in ASCII range between [32,126]
+ */
+string AESGenerateRandString(const uint8_t keySize, bool spec)
+{
+    string retVal(keySize, 0x00);
+
+    uint8_t i = 0;
+    while (i < keySize)
+    {
+        int8_t rndChar = rand() % 128;
+
+        //  Prevent special chars in key
+        if (((rndChar < 32) || (rndChar == 127)) && !spec)
+            continue;
+
+        retVal[i++] = rndChar;
+    }
+
+    return retVal;
+}
 
 //------------------------------------------------------------------------------
-//      Custom OpenSSL data-types                                      [PRIVATE]
+//      Engine selection                                                [PUBLIC]
 //------------------------------------------------------------------------------
-template <typename T>
-struct zallocator
-{
-public:
-    typedef T value_type;
-    typedef value_type* pointer;
-    typedef const value_type* const_pointer;
-    typedef value_type& reference;
-    typedef const value_type& const_reference;
-    typedef std::size_t size_type;
-    typedef std::ptrdiff_t difference_type;
-
-    pointer address (reference v) const {return &v;}
-    const_pointer address (const_reference v) const {return &v;}
-
-    pointer allocate (size_type n, const void* hint = 0) {
-        if (n > std::numeric_limits<size_type>::max() / sizeof(T))
-            throw std::bad_alloc();
-        return static_cast<pointer> (::operator new (n * sizeof (value_type)));
+/**
+ *  Fastest engine supported by this CPU. Without AES-NI, bitsliced engine is
+ *  the fastest only for calls of at least 8 independent blocks, while serial
+ *  chains (CBC encryption, streams) go one block at a time, so the hybrid
+ *  engine picks by number of blocks in a call.
+ */
+static uint8_t FastestEngine()
+{
+    return AESCoreHasAESNI() ? AES_ENGINE_AESNI : AES_ENGINE_HYBRID;
+}
+
+/**
+ *  Check whether an engine needs OpenSSL contexts
+ */
+static inline bool UsesEVP(uint8_t engine)
+{
+    return (engine == AES_ENGINE_OPENSSL) || (engine == AES_ENGINE_HYBRID);
+}
+
+/**
+ *  Check whether an engine needs the native expanded key
+ */
+static inline bool UsesNative(uint8_t engine)
+{
+    return engine != AES_ENGINE_OPENSSL;
+}
+
+/**
+ *  Engine used by contexts not given one, initialized on first use to the
+ *  fastest supported one
+ */
+static std::atomic<uint8_t> &ActiveEngine()
+{
+    static std::atomic<uint8_t> engine(FastestEngine());
+    return engine;
+}
+
+/**
+ *  Check whether an engine can be used on this CPU
+ *  @param engine One of AES_ENGINE_* macros
+ *  @return True if engine is available
+ */
+bool AESEngineSupported(uint8_t engine)
+{
+    switch (engine)
+    {
+    case AES_ENGINE_AUTO:
+    case AES_ENGINE_OPENSSL:
+    case AES_ENGINE_TTABLE:
+    case AES_ENGINE_BITSLICE:
+    case AES_ENGINE_HYBRID:
+        return true;
+    case AES_ENGINE_AESNI:
+        return AESCoreHasAESNI();
+    default:
+        return false;
     }
+}
+
+/**
+ *  Engine used by contexts not given one, initialized to the fastest engine
+ *  supported by the CPU
+ *  @return One of AES_ENGINE_* macros, other than AES_ENGINE_AUTO
+ */
+uint8_t AESEngine()
+{
+    return ActiveEngine().load();
+}
+
+/**
+ *  Set engine used by contexts not given one, mostly for testing and
+ *  benchmarking. Meant to be called before contexts are created.
+ *  @param engine One of AES_ENGINE_* macros, AES_ENGINE_AUTO for the fastest
+ *  supported one
+ *  @return Engine that has actually been selected, unsupported engines are
+ *  replaced by the fastest supported one
+ */
+uint8_t AESSetEngine(uint8_t engine)
+{
+    if ((engine == AES_ENGINE_AUTO) || !AESEngineSupported(engine))
+        engine = FastestEngine();
 
-    void deallocate(pointer p, size_type n) {
-        OPENSSL_cleanse(p, n*sizeof(T));
-        ::operator delete(p);
+    ActiveEngine().store(engine);
+    return engine;
+}
+
+//------------------------------------------------------------------------------
+//      AES-128 cipher context                                          [PUBLIC]
+//------------------------------------------------------------------------------
+AES128Context::AES128Context(uint8_t engine)
+    : _engine(engine ? engine : AESEngine()), _enc(NULL), _dec(NULL)
+{
+    if (!AESEngineSupported(_engine))
+        throw std::runtime_error("AES engine not supported on this CPU");
+
+    memset(&_rk, 0, sizeof(_rk));
+    if (!UsesEVP(_engine))
+        return;
+
+    _enc = EVP_CIPHER_CTX_new();
+    _dec = EVP_CIPHER_CTX_new();
+    if ((_enc == NULL) || (_dec == NULL))
+    {
+        EVP_CIPHER_CTX_free(_enc);
+        EVP_CIPHER_CTX_free(_dec);
+        throw std::bad_alloc();
     }
+}
+
+/**
+ *  Create context and expand the key
+ *  @param key Key, its first AES_ECB_BLOCK_SIZE bytes are used
+ *  @param engine One of AES_ENGINE_* macros; runtime_error if it isn't
+ *  supported by the CPU
+ */
+AES128Context::AES128Context(string const &key, uint8_t engine)
+    : AES128Context(engine)
+{
+    //  Contexts are freed by the destructor if this throws, object is already
+    //  constructed by the delegated constructor
+    setKey(key);
+}
 
-    size_type max_size() const {
-        return std::numeric_limits<size_type>::max() / sizeof (T);
+/**
+ *  Create context with the same engine and key as another one, e.g. for
+ *  use by another thread
+ *  @param other Context to copy, only read from
+ */
+AES128Context::AES128Context(AES128Context const &other)
+    : _engine(other._engine), _rk(other._rk), _enc(NULL), _dec(NULL)
+{
+    if (!UsesEVP(_engine))
+        return;
+
+    //  OpenSSL refuses to copy contexts without a key, they are left empty
+    bool keyed = (EVP_CIPHER_CTX_cipher(other._enc) != NULL);
+
+    _enc = EVP_CIPHER_CTX_new();
+    _dec = EVP_CIPHER_CTX_new();
+    if ((_enc == NULL) || (_dec == NULL) ||
+        (keyed && (EVP_CIPHER_CTX_copy(_enc, other._enc) != 1)) ||
+        (keyed && (EVP_CIPHER_CTX_copy(_dec, other._dec) != 1)))
+    {
+        EVP_CIPHER_CTX_free(_enc);
+        EVP_CIPHER_CTX_free(_dec);
+        throw std::runtime_error("Failed to copy AES context");
     }
+}
+
+AES128Context::~AES128Context()
+{
+    //  Freeing a context also wipes the key schedule in it
+    EVP_CIPHER_CTX_free(_enc);
+    EVP_CIPHER_CTX_free(_dec);
+    OPENSSL_cleanse(&_rk, sizeof(_rk));
+}
+
+/**
+ *  @return Engine used by this context (never AES_ENGINE_AUTO)
+ */
+uint8_t AES128Context::engine() const
+{
+    return _engine;
+}
 
-    template<typename U>
-    struct rebind
+/**
+ *  Expand new key, replacing the old one
+ *  @param key AES_ECB_BLOCK_SIZE bytes of key
+ */
+void AES128Context::setKey(uint8_t const *key)
+{
+    if (UsesNative(_engine))
+        AESCoreExpandKey(&_rk, key);
+    if (!UsesEVP(_engine))
+        return;
+
+    if (EVP_EncryptInit_ex(_enc, EVP_aes_128_ecb(), NULL, key, NULL) != 1)
+        throw std::runtime_error("EVP_EncryptInit_ex failed");
+    if (EVP_DecryptInit_ex(_dec, EVP_aes_128_ecb(), NULL, key, NULL) != 1)
+        throw std::runtime_error("EVP_DecryptInit_ex failed");
+
+    //  Only whole blocks are ever passed in, padding is done by the caller
+    EVP_CIPHER_CTX_set_padding(_enc, 0);
+    EVP_CIPHER_CTX_set_padding(_dec, 0);
+}
+
+/**
+ *  Expand new key, replacing the old one
+ *  @param key Key, its first AES_ECB_BLOCK_SIZE bytes are used; shorter
+ *  keys are rejected with runtime_error
+ */
+void AES128Context::setKey(string const &key)
+{
+    if (key.length() < AES_ECB_BLOCK_SIZE)
+        throw std::runtime_error("AES-128 key shorter than 16 bytes");
+
+    setKey((uint8_t const*)key.data());
+}
+
+/**
+ *  Encrypt one block
+ *  @param in Block of plaintext
+ *  @param out Block of ciphertext, may be the same as in
+ */
+void AES128Context::encryptBlock(uint8_t const *in, uint8_t *out)
+{
+    encryptBlocks(in, out, 1);
+}
+
+/**
+ *  Decrypt one block
+ *  @param in Block of ciphertext
+ *  @param out Block of plaintext, may be the same as in
+ */
+void AES128Context::decryptBlock(uint8_t const *in, uint8_t *out)
+{
+    decryptBlocks(in, out, 1);
+}
+
+/**
+ *  Encrypt consecutive blocks independently of each other (ECB)
+ *  @param in Plaintext
+ *  @param out Ciphertext, may be the same as in
+ *  @param blocks Number of blocks
+ */
+void AES128Context::encryptBlocks(uint8_t const *in, uint8_t *out, size_t blocks)
+{
+    switch (_engine)
     {
-        typedef zallocator<U> other;
-    };
+    case AES_ENGINE_AESNI:
+        AESNIEncryptBlocks(&_rk, in, out, blocks);
+        return;
+    case AES_ENGINE_TTABLE:
+        AESTableEncryptBlocks(&_rk, in, out, blocks);
+        return;
+    case AES_ENGINE_BITSLICE:
+        AESBitsliceEncryptBlocks(&_rk, in, out, blocks);
+        return;
+    case AES_ENGINE_HYBRID:
+        {
+            //  Whole groups bitsliced, the rest (all of a short call) by OpenSSL
+            size_t bulk = blocks - blocks % HYBRID_GROUP;
 
-    void construct (pointer ptr, const T& val) {
-        new (static_cast<T*>(ptr) ) T (val);
+            if (bulk > 0)
+            {
+                AESBitsliceEncryptBlocks(&_rk, in, out, bulk);
+                in += bulk * AES_ECB_BLOCK_SIZE;
+                out += bulk * AES_ECB_BLOCK_SIZE;
+                blocks -= bulk;
+            }
+        }
+        break;
     }
 
-    void destroy(pointer ptr) {
-        static_cast<T*>(ptr)->~T();
+    size_t len = blocks * AES_ECB_BLOCK_SIZE;
+
+    for (size_t i = 0; i < len; i += EVP_CHUNK)
+    {
+        int outLen, chunk = (int)min(len - i, (size_t)EVP_CHUNK);
+
+        if (EVP_EncryptUpdate(_enc, out + i, &outLen, in + i, chunk) != 1)
+            throw std::runtime_error("EVP_EncryptUpdate failed");
     }
+}
+
+/**
+ *  Decrypt consecutive blocks independently of each other (ECB)
+ *  @param in Ciphertext
+ *  @param out Plaintext, may be the same as in
+ *  @param blocks Number of blocks
+ */
+void AES128Context::decryptBlocks(uint8_t const *in, uint8_t *out, size_t blocks)
+{
+    switch (_engine)
+    {
+    case AES_ENGINE_AESNI:
+        AESNIDecryptBlocks(&_rk, in, out, blocks);
+        return;
+    case AES_ENGINE_TTABLE:
+        AESTableDecryptBlocks(&_rk, in, out, blocks);
+        return;
+    case AES_ENGINE_BITSLICE:
+        AESBitsliceDecryptBlocks(&_rk, in, out, blocks);
+        return;
+    case AES_ENGINE_HYBRID:
+        {
+            //  Whole groups bitsliced, the rest (all of a short call) by OpenSSL
+            size_t bulk = blocks - blocks % HYBRID_GROUP;
 
-#if __cpluplus >= 201103L
-    template<typename U, typename... Args>
-    void construct (U* ptr, Args&&  ... args) {
-        ::new (static_cast<void*> (ptr) ) U (std::forward<Args> (args)...);
+            if (bulk > 0)
+            {
+                AESBitsliceDecryptBlocks(&_rk, in, out, bulk);
+                in += bulk * AES_ECB_BLOCK_SIZE;
+                out += bulk * AES_ECB_BLOCK_SIZE;
+                blocks -= bulk;
+            }
+        }
+        break;
     }
 
-    template<typename U>
-    void destroy(U* ptr) {
-        ptr->~U();
+    size_t len = blocks * AES_ECB_BLOCK_SIZE;
+
+    for (size_t i = 0; i < len; i += EVP_CHUNK)
+    {
+        int outLen, chunk = (int)min(len - i, (size_t)EVP_CHUNK);
+
+        if (EVP_DecryptUpdate(_dec, out + i, &outLen, in + i, chunk) != 1)
+            throw std::runtime_error("EVP_DecryptUpdate failed");
     }
-#endif
-};
+}
 
-typedef unsigned char byte;
-typedef std::basic_string<char, std::char_traits<char>, zallocator<char> > secure_string;
-using EVP_CIPHER_CTX_free_ptr = std::unique_ptr<EVP_CIPHER_CTX, decltype(&::EVP_CIPHER_CTX_free)>;
+//------------------------------------------------------------------------------
+//      ECB with PKCS#7 padding                                        [PRIVATE]
+//------------------------------------------------------------------------------
+/**
+ *  Length of data without its PKCS#7 padding
+ *  @param data Decrypted data, multiple of block size long
+ *  @param len Length of data
+ *  @return Length of data before padding; BUF_ERROR if padding isn't valid
+ */
+static size_t UnpaddedLength(uint8_t const *data, size_t len)
+{
+    if (len == 0)
+        return BUF_ERROR;
 
+    uint8_t pad = data[len-1];
+    if ((pad == 0) || (pad > AES_ECB_BLOCK_SIZE))
+        return BUF_ERROR;
 
-//  Function prototypes for low-level OpenSSL calls
-void aes_encrypt(const byte key[AES_ECB_BLOCK_SIZE],
-                 const byte iv[AES_ECB_BLOCK_SIZE],
-                 const secure_string& ptext,
-                 secure_string& ctext);
-void aes_decrypt(const byte key[AES_ECB_BLOCK_SIZE],
-                 const byte iv[AES_ECB_BLOCK_SIZE],
-                 const secure_string& ctext,
-                 secure_string& rtext);
+    uint8_t diff = 0;
+    for (uint8_t i = 1; i <= pad; i++)
+        diff |= data[len-i] ^ pad;
 
+    return diff ? BUF_ERROR : (len - pad);
+}
 
 /**
- *  Initialize AES engine and seed rand number generator
+ *  Pad text (PKCS#7) and encrypt it block by block
+ *  @param ctx Context with expanded key
+ *  @param text Plaintext of any length
+ *  @return Ciphertext, always at least one byte longer than text
  */
-void InitAES128EBC()
+static string ECBEncryptPadded(AES128Context &ctx, string const &text)
 {
-    // Load the necessary cipher
-    EVP_add_cipher(EVP_aes_128_ecb());
+    size_t len = (text.length() / AES_ECB_BLOCK_SIZE + 1) * AES_ECB_BLOCK_SIZE;
+    uint8_t pad = len - text.length();
+    string retVal(len, (char)pad);
 
-    //  Initialize random number generator
-    srand(time(NULL));
+    memcpy(&retVal[0], text.data(), text.length());
+    ctx.encryptBlocks((uint8_t const*)retVal.data(), (uint8_t*)&retVal[0],
+                      len / AES_ECB_BLOCK_SIZE);
+
+    return retVal;
 }
 
 /**
- *  Generate a random string of specified length
- *  @param keySize Desired length of returned string
- *  @return Random string with characters in ASCII range between [32,126]
+ *  Decrypt ciphertext block by block and remove its PKCS#7 padding
+ *  @param ctx Context with expanded key
+ *  @param ciphertext Ciphertext, multiple of block size long
+ *  @return Plaintext; with padding left in place if it isn't valid
  */
-string AESGenerateRandString(const uint8_t keySize, bool spec)
+static string ECBDecryptPadded(AES128Context &ctx, string const &ciphertext)
 {
-    string retVal(keySize, 0x00);
+    if ((ciphertext.length() % AES_ECB_BLOCK_SIZE) != 0)
+        throw std::runtime_error("Ciphertext isn't a multiple of block size");
 
-    uint8_t i = 0;
-    while (i < keySize)
+    string retVal(ciphertext.length(), 0);
+    ctx.decryptBlocks((uint8_t const*)ciphertext.data(), (uint8_t*)&retVal[0],
+                      ciphertext.length() / AES_ECB_BLOCK_SIZE);
+
+    size_t len = UnpaddedLength((uint8_t const*)retVal.data(), retVal.length());
+    if (len != BUF_ERROR)
+        retVal.resize(len);
+
+    return retVal;
+}
+
+//------------------------------------------------------------------------------
+//      Work split between threads                                     [PRIVATE]
+//------------------------------------------------------------------------------
+/**
+ *  Work on bytes [start, start + len) of a longer input, with a context owned
+ *  by the calling thread
+ */
+typedef std::function<void(AES128Context &ctx, size_t start, size_t len)> ChunkWork;
+
+/**
+ *  Worker of RunChunks, takes chunks until there are none left. Works with
+ *  its own copy of the context, the shared one is only read.
+ *  @param next Next chunk to process, shared between workers
+ *  @param failed Set if the context couldn't be copied or used
+ */
+static void ChunkWorker(AES128Context const *shared, size_t len,
+                        ChunkWork const *work, atomic<size_t> *next,
+                        atomic<bool> *failed)
+{
+    size_t chunk, chunks = (len + THREAD_CHUNK - 1) / THREAD_CHUNK;
+
+    try
     {
-        int8_t rndChar = rand() % 128;
+        AES128Context ctx(*shared);
 
-        //  Prevent special chars in key
-        if (((rndChar < 32) || (rndChar == 127)) && !spec)
-            continue;
+        while ((chunk = next->fetch_add(1)) < chunks)
+        {
+            size_t start = chunk * THREAD_CHUNK;
+            (*work)(ctx, start, min(len - start, (size_t)THREAD_CHUNK));
+        }
+    }
+    catch (std::exception const &)
+    {
+        failed->store(true);
+    }
+}
 
-        retVal[i++] = rndChar;
+/**
+ *  Split input into chunks of THREAD_CHUNK bytes and work on them on several
+ *  threads. Threads take chunks from a shared counter so that those finishing
+ *  early take over remaining work. Input of a single chunk (or a single
+ *  thread) is worked on by the calling thread in one go, with ctx itself.
+ *  @param ctx Context with expanded key
+ *  @param len Length of input, chunks are multiples of block size
+ *  @param threads Number of threads to use, 0 for one per CPU core
+ *  @param work Work on a chunk, can be called from any thread
+ */
+static void RunChunks(AES128Context &ctx, size_t len, uint32_t threads,
+                      ChunkWork const &work)
+{
+    size_t chunks = (len + THREAD_CHUNK - 1) / THREAD_CHUNK;
+
+    if (threads == 0)
+        threads = thread::hardware_concurrency();
+    if (threads > chunks)
+        threads = chunks;
+    if (threads <= 1)
+    {
+        work(ctx, 0, len);
+        return;
     }
 
-    return retVal;
+    vector<thread> workers;
+    atomic<size_t> next(0);
+    atomic<bool> failed(false);
+
+    for (uint32_t t = 1; t < threads; t++)
+        workers.push_back(thread(ChunkWorker, &ctx, len, &work, &next, &failed));
+    ChunkWorker(&ctx, len, &work, &next, &failed);
+    for (size_t t = 0; t < workers.size(); t++)
+        workers[t].join();
+
+    if (failed.load())
+        throw std::runtime_error("AES worker thread failed");
+}
+
+//------------------------------------------------------------------------------
+//      CBC of whole blocks                                            [PRIVATE]
+//------------------------------------------------------------------------------
+/**
+ *  XOR block b into block a, two 64-bit words at a time
+ */
+static inline void XORBlock(uint8_t *a, uint8_t const *b)
+{
+    uint64_t a0, a1, b0, b1;
+
+    memcpy(&a0, a, 8);
+    memcpy(&a1, a + 8, 8);
+    memcpy(&b0, b, 8);
+    memcpy(&b1, b + 8, 8);
+    a0 ^= b0;
+    a1 ^= b1;
+    memcpy(a, &a0, 8);
+    memcpy(a + 8, &a1, 8);
+}
+
+/**
+ *  Encrypt whole blocks of CBC plain text
+ *  Chain is carried in registers, every block is read before its ciphertext
+ *  is written so in and out can be the same buffer.
+ *  @param ctx Context with expanded key
+ *  @param chain Ciphertext of the block before (initialization vector for the
+ *  first block), replaced by ciphertext of the last block
+ *  @param in Plain text
+ *  @param len Length of plain text, multiple of block size
+ *  @param out Ciphertext, may be the same as in
+ */
+static void CBCEncryptBlocks(AES128Context &ctx, uint8_t *chain,
+                             uint8_t const *in, size_t len, uint8_t *out)
+{
+    uint64_t c0, c1, p0, p1;
+
+    memcpy(&c0, chain, 8);
+    memcpy(&c1, chain + 8, 8);
+    for (size_t i = 0; i < len; i += AES_ECB_BLOCK_SIZE)
+    {
+        memcpy(&p0, in + i, 8);
+        memcpy(&p1, in + i + 8, 8);
+        c0 ^= p0;
+        c1 ^= p1;
+        memcpy(out + i, &c0, 8);
+        memcpy(out + i + 8, &c1, 8);
+        ctx.encryptBlock(out + i, out + i);
+        memcpy(&c0, out + i, 8);
+        memcpy(&c1, out + i + 8, 8);
+    }
+    memcpy(chain, &c0, 8);
+    memcpy(chain + 8, &c1, 8);
+}
+
+/**
+ *  Decrypt whole blocks of CBC ciphertext, padding is left in place
+ *  Unlike encryption, decryption of CBC blocks doesn't depend on each other:
+ *  a chunk of blocks is decrypted with a single ECB call and then XORed with
+ *  the same chunk of ciphertext, shifted by one block. When decrypting in
+ *  place, ciphertext of the chunk is saved first.
+ *  @param ctx Context with expanded key
+ *  @param iv Initialization vector, AES_ECB_BLOCK_SIZE bytes
+ *  @param in Ciphertext
+ *  @param len Length of ciphertext, multiple of block size
+ *  @param out Plain text, may be the same as in
+ */
+static void CBCDecryptBlocks(AES128Context &ctx, uint8_t const *iv,
+                             uint8_t const *in, size_t len, uint8_t *out)
+{
+    uint8_t saved[CBC_CHUNK], prev[AES_ECB_BLOCK_SIZE];
+
+    memcpy(prev, iv, AES_ECB_BLOCK_SIZE);
+    for (size_t i = 0; i < len; i += CBC_CHUNK)
+    {
+        size_t n = min(len - i, (size_t)CBC_CHUNK);
+        uint8_t const *c = in + i;
+
+        if (in == out)
+        {
+            memcpy(saved, c, n);
+            c = saved;
+        }
+
+        ctx.decryptBlocks(c, out + i, n / AES_ECB_BLOCK_SIZE);
+        XORBlock(out + i, prev);
+        for (size_t b = AES_ECB_BLOCK_SIZE; b < n; b += AES_ECB_BLOCK_SIZE)
+            XORBlock(out + i + b, c + b - AES_ECB_BLOCK_SIZE);
+        memcpy(prev, c + n - AES_ECB_BLOCK_SIZE, AES_ECB_BLOCK_SIZE);
+    }
+}
+
+/**
+ *  Decrypt whole blocks of CBC ciphertext on several threads, padding is left
+ *  in place
+ *  Ciphertext is split into chunks (see RunChunks), every chunk is decrypted
+ *  as a CBC ciphertext of its own with the last ciphertext block of the
+ *  preceding chunk as initialization vector. These blocks are saved before
+ *  any chunk is decrypted, in case it's decrypted in place.
+ *  @param ctx Context with expanded key
+ *  @param iv Initialization vector, AES_ECB_BLOCK_SIZE bytes
+ *  @param in Ciphertext
+ *  @param len Length of ciphertext, multiple of block size
+ *  @param out Plain text, may be the same as in
+ *  @param threads Number of threads to use, 0 for one per CPU core
+ */
+static void CBCDecryptParallel(AES128Context &ctx, uint8_t const *iv,
+                               uint8_t const *in, size_t len, uint8_t *out,
+                               uint32_t threads)
+{
+    size_t chunks = (len + THREAD_CHUNK - 1) / THREAD_CHUNK;
+    vector<uint8_t> chain((chunks > 1) ? (chunks * AES_ECB_BLOCK_SIZE) : 0);
+
+    for (size_t i = 1; i < chunks; i++)
+        memcpy(&chain[i * AES_ECB_BLOCK_SIZE],
+               in + i * THREAD_CHUNK - AES_ECB_BLOCK_SIZE, AES_ECB_BLOCK_SIZE);
+
+    RunChunks(ctx, len, threads, [&](AES128Context &c, size_t start, size_t n) {
+        uint8_t const *prev = start ? &chain[start / THREAD_CHUNK * AES_ECB_BLOCK_SIZE] : iv;
+        CBCDecryptBlocks(c, prev, in + start, n, out + start);
+    });
 }
 
 //------------------------------------------------------------------------------
@@ -143,12 +669,9 @@ string AESGenerateRandString(const uint8_t keySize, bool spec)
  */
 std::string AESCBCEncryptBlock(const std::string key, const std::string iv, std::string const &textblock)
 {
-    secure_string   ptext(textblock.c_str(), textblock.length());
-    secure_string   ctext;
+    AES128Context ctx(key);
 
-    aes_encrypt((const byte*)key.c_str(), (const byte*)iv.c_str(), ptext, ctext);
-
-    return std::string(ctext.c_str(), ctext.length());
+    return ECBEncryptPadded(ctx, textblock);
 }
 
 /**
@@ -161,14 +684,9 @@ std::string AESCBCEncryptBlock(const std::string key, const std::string iv, std:
  */
 std::string AESCBCDecryptBlock(const std::string key, const std::string iv, std::string const &cipherblock)
 {
-    std::string retVal;
-    secure_string   ctext(cipherblock.c_str(), cipherblock.length());
-    secure_string   rtext;
-
-    aes_decrypt((const byte*)key.c_str(), (const byte*)iv.c_str(), ctext, rtext);
+    AES128Context ctx(key);
 
-    retVal = std::string(rtext.c_str(), rtext.length());
-    return retVal;
+    return ECBDecryptPadded(ctx, cipherblock);
 }
 
 //------------------------------------------------------------------------------
@@ -183,200 +701,698 @@ std::string AESCBCDecryptBlock(const std::string key, const std::string iv, std:
  */
 string AESCBCEncryptText(const string key, const string iv, string const &text)
 {
-    string cipherText;
+    if (iv.length() < AES_ECB_BLOCK_SIZE)
+        throw std::runtime_error("Initialization vector shorter than 16 bytes");
 
-    //  Split text into AES_ECB_BLOCK_SIZE long blocks
-    vector<string>block;
-    string tmp("");
-    for (uint32_t i = 1; i <= text.length(); i++)
-    {
-        tmp += text[i-1];
-        if ((i % AES_ECB_BLOCK_SIZE) == 0)
-            block.push_back(tmp), tmp = string("");
-    }
-    //  If the last block isn't long enough pad it to a given block size
-    //  according to PKCS#7
-    if (tmp != "")
-        block.push_back(PadString(tmp, AES_ECB_BLOCK_SIZE, ENC_ASCII));
-
-    //  Initialize variable that holds last value of cipher that will be XORed
-    //  with block in the next loop iteration
-    //  CBC encryption takes XOR between cipher from last iteration, and block of
-    //  plain text from this iteration. Result is then encrypted using simple ECB
-    //  encryption and truncated to the length of a block
-    string lastBlock(iv.c_str(), iv.length());
-    for (uint32_t i = 0; i < block.size(); i++)
-    {
-        //  XOR of block from this iteration, and cipher of a block from last
-        //  iteration (or initialization vector if this is first iteration)
-        string tmp = ASCIIFixedXOR(block[i], lastBlock);
-        //  Encrypt this block with given key, zeroVect simply says we apply no
-        //  initialization vector in encryption (because it got applied in line
-        //  above manually)
-        tmp = AESCBCEncryptBlock(key, zeroVect, tmp);
-        //  Truncate result of encryption to block size
-        lastBlock = string(tmp.c_str(), AES_ECB_BLOCK_SIZE);
-        //  Add result to ciphertext
-        cipherText += lastBlock;
-    }
+    AES128Context ctx(key);
+    string cipherText((text.length() / AES_ECB_BLOCK_SIZE + 1) * AES_ECB_BLOCK_SIZE, 0);
+
+    AESCBCEncryptText(ctx, (uint8_t const*)iv.data(), text.data(), text.length(),
+                      &cipherText[0], cipherText.length());
 
-    //  Return ciphertext
     return cipherText;
 }
 
 /**
- *  AES-128 CBC decryption of a ciphertext
- *  @param key Key for decryption
- *  @param iv Initialization vector used to encrypt original text
- *  @param cyphertext
- *  @return Plain text retrieved from cipher
+ *  AES-128 CBC encryption of plain text into caller-supplied buffer, text is
+ *  padded according to PKCS#7 (a whole block of padding if its length is
+ *  already a multiple of block size)
+ *  CBC encryption takes XOR between ciphertext of the last block (or
+ *  initialization vector for the first one) and plain text of this block, and
+ *  encrypts the result as a single ECB block. Chain is carried in registers,
+ *  every block is read before its ciphertext is written so text and out can
+ *  be the same buffer.
+ *  @param ctx Context with expanded key
+ *  @param iv Initialization vector, AES_ECB_BLOCK_SIZE bytes
+ *  @param text Plain text
+ *  @param len Length of plain text
+ *  @param out Output buffer, may be the same as text
+ *  @param outSize Size of output buffer, at least (len/16 + 1)*16
+ *  @return Length of ciphertext; BUF_ERROR if output buffer is too small
  */
-string AESCBCDecryptText(const string key, const string iv, string const &ciphertext)
+size_t AESCBCEncryptText(AES128Context &ctx, uint8_t const *iv, char const *text,
+                         size_t len, char *out, size_t outSize)
 {
-    //  Split ciphertext in blocks of size AES_ECB_BLOCK_SIZE
-    vector<string>encryptedBlock;
-    string tmp("");
-    for (uint32_t i = 1; i <= ciphertext.length(); i++)
+    size_t whole = len / AES_ECB_BLOCK_SIZE * AES_ECB_BLOCK_SIZE;
+    size_t outLen = whole + AES_ECB_BLOCK_SIZE;
+    uint8_t chain[AES_ECB_BLOCK_SIZE], last[AES_ECB_BLOCK_SIZE];
+
+    if (outSize < outLen)
+        return BUF_ERROR;
+
+    //  Last block, leftover text followed by PKCS#7 padding
+    memset(last, (int)(outLen - len), AES_ECB_BLOCK_SIZE);
+    memcpy(last, text + whole, len - whole);
+
+    memcpy(chain, iv, AES_ECB_BLOCK_SIZE);
+    CBCEncryptBlocks(ctx, chain, (uint8_t const*)text, whole, (uint8_t*)out);
+    CBCEncryptBlocks(ctx, chain, last, AES_ECB_BLOCK_SIZE, (uint8_t*)out + whole);
+
+    return outLen;
+}
+
+/**
+ *  XOR block of plain text at given position into CBC chain, past the end of
+ *  whole blocks leftover text is followed by PKCS#7 padding
+ *  @param chain Ciphertext of the previous block (or initialization vector)
+ *  @param text Plain text
+ *  @param len Length of plain text
+ *  @param pos Position of the block, multiple of block size and at most len
+ */
+static inline void XORTextBlock(uint8_t *chain, char const *text, size_t len,
+                                size_t pos)
+{
+    if (pos + AES_ECB_BLOCK_SIZE <= len)
     {
-        tmp += ciphertext[i-1];
-        if ((i % AES_ECB_BLOCK_SIZE) == 0)
+        XORBlock(chain, (uint8_t const*)text + pos);
+        return;
+    }
+
+    uint8_t last[AES_ECB_BLOCK_SIZE];
+
+    memset(last, (int)(pos + AES_ECB_BLOCK_SIZE - len), AES_ECB_BLOCK_SIZE);
+    memcpy(last, text + pos, len - pos);
+    XORBlock(chain, last);
+}
+
+/**
+ *  AES-128 CBC encryption of many independent messages, each padded according
+ *  to PKCS#7 as by AESCBCEncryptText
+ *  Blocks of one message have to be encrypted one after another, but blocks
+ *  of different messages don't: messages are assigned to lanes advanced in
+ *  lockstep, one block of every lane encrypted per step, and a lane whose
+ *  message is done takes the next one. Jobs whose context doesn't use the
+ *  AES-NI engine are encrypted one by one.
+ *  Chain of every lane is kept in its block of state, which is overwritten by
+ *  the ciphertext block after every step.
+ *  @param jobs Messages to encrypt, their outLen is set
+ *  @param count Number of jobs
+ */
+void AESCBCEncryptBatch(AESCBCJob *jobs, size_t count)
+{
+    uint8_t state[CBC_LANES * AES_ECB_BLOCK_SIZE];
+    AESRoundKeys const *rk[CBC_LANES];
+    AESCBCJob *lane[CBC_LANES];
+    size_t pos[CBC_LANES], active = 0, next = 0;
+
+    //  Next job for the lanes, others are done right away
+    auto take = [&]() -> AESCBCJob* {
+        for (; next < count; next++)
         {
-            encryptedBlock.push_back(tmp);
-            tmp = string("");
+            AESCBCJob &job = jobs[next];
+
+            job.outLen = (job.len / AES_ECB_BLOCK_SIZE + 1) * AES_ECB_BLOCK_SIZE;
+            if (job.outSize < job.outLen)
+                job.outLen = BUF_ERROR;
+            else if (job.ctx->engine() != AES_ENGINE_AESNI)
+                AESCBCEncryptText(*job.ctx, job.iv, job.text, job.len, job.out,
+                                  job.outSize);
+            else
+                return &jobs[next++];
         }
-    }
+        return NULL;
+    };
+    auto start = [&](size_t l, AESCBCJob *job) {
+        lane[l] = job;
+        rk[l] = &job->ctx->_rk;
+        pos[l] = 0;
+        memcpy(state + l * AES_ECB_BLOCK_SIZE, job->iv, AES_ECB_BLOCK_SIZE);
+    };
 
-    //  Initialize variable that holds last value of cipher that will be XORed
-    //  with block in the next loop iteration
-    //  CBC decryption first decrypts a block of ciphertext, then XORs it with
-    //  block of ciphertext(unencrypted) from previous iteration (or initialization
-    //  vector if this is first iteration) to get original text.
-    string lastBlock(iv.c_str(), iv.length());
-    string plainText;
-    for (uint32_t i = 0; i < encryptedBlock.size(); i++)
+    for (AESCBCJob *job; (active < CBC_LANES) && (job = take()); active++)
+        start(active, job);
+
+    while (active > 0)
     {
-        string tmp = encryptedBlock[i];
-        //  We're decrypting a block of AES_ECB_BLOCK_SIZE of ciphertext, which
-        //  has to be twice the block size in order to be a valid AES ciphertext.
-        //  (remember AES pads strings before encryption to have size that's
-        //  multiple of block length but if the text to encrypt is already a
-        //  multiple of block length, it will be padded to its current length +
-        //  another block length). Since we're expecting exactly AES_ECB_BLOCK_SIZE
-        //  of decrypted data, our encrypted block needs to be 2*AES_ECB_BLOCK_SIZE,
-        //  so we pad it. Padding gets discarded anyway and it doesn't affect
-        //  encryption because we're encrypting in ECB mode :)
-        tmp = PadString(tmp, 2* AES_ECB_BLOCK_SIZE, ENC_ASCII);
-
-        //  Decrypting the ciphertext block after padding
-        tmp = AESCBCDecryptBlock(key, zeroVect, tmp);
-        //  Truncate result to the length of one block
-        tmp = string(tmp.c_str(), AES_ECB_BLOCK_SIZE);
-
-        //  XORing it against ciphertext block from last iteration (or
-        //  initialization vector in case this is first iteration)
-        tmp = ASCIIFixedXOR(lastBlock, tmp);
-
-        //  Save block of ciphertext for XORing in next iteration
-        lastBlock = encryptedBlock[i];
-        plainText += tmp;
+        for (size_t l = 0; l < active; l++)
+        {
+            //  Messages are too short for hardware prefetchers to pick up
+            //  every lane as a stream of its own
+            if ((pos[l] % CBC_PREFETCH_LINE) == 0)
+            {
+                __builtin_prefetch(lane[l]->text + pos[l] + CBC_PREFETCH);
+                __builtin_prefetch(lane[l]->out + pos[l] + CBC_PREFETCH, 1);
+            }
+            XORTextBlock(state + l * AES_ECB_BLOCK_SIZE, lane[l]->text,
+                         lane[l]->len, pos[l]);
+        }
+
+        AESNIEncryptLanes(rk, state, active);
+
+        //  Backwards, so that a lane moved into place of a finished one has
+        //  already been written out
+        for (size_t l = active; l-- > 0; )
+        {
+            uint8_t *block = state + l * AES_ECB_BLOCK_SIZE;
+            AESCBCJob *job;
+
+            memcpy(lane[l]->out + pos[l], block, AES_ECB_BLOCK_SIZE);
+            pos[l] += AES_ECB_BLOCK_SIZE;
+            if (pos[l] < lane[l]->outLen)
+                continue;
+
+            if ((job = take()) != NULL)
+                start(l, job);
+            else if (l != --active)
+            {
+                lane[l] = lane[active];
+                rk[l] = rk[active];
+                pos[l] = pos[active];
+                memcpy(block, state + active * AES_ECB_BLOCK_SIZE, AES_ECB_BLOCK_SIZE);
+            }
+        }
     }
+}
+
+/**
+ *  AES-128 CBC decryption of a ciphertext
+ *  @param key Key for decryption
+ *  @param iv Initialization vector used to encrypt original text
+ *  @param cyphertext Ciphertext, multiple of block size long (runtime_error
+ *  otherwise)
+ *  @param threads Number of threads to use, 0 for one per CPU core (inputs
+ *  shorter than a megabyte are always decrypted by the calling thread)
+ *  @return Plain text retrieved from cipher; with padding left in place if it
+ *  isn't valid
+ */
+string AESCBCDecryptText(const string key, const string iv, string const &ciphertext,
+                         uint32_t threads)
+{
+    if (iv.length() < AES_ECB_BLOCK_SIZE)
+        throw std::runtime_error("Initialization vector shorter than 16 bytes");
+    if ((ciphertext.length() % AES_ECB_BLOCK_SIZE) != 0)
+        throw std::runtime_error("Ciphertext isn't a multiple of block size");
+
+    AES128Context ctx(key);
+    string plainText(ciphertext.length(), 0);
+
+    CBCDecryptParallel(ctx, (uint8_t const*)iv.data(),
+                       (uint8_t const*)ciphertext.data(), ciphertext.length(),
+                       (uint8_t*)&plainText[0], threads);
+
+    size_t len = UnpaddedLength((uint8_t const*)plainText.data(), plainText.length());
+    if (len != BUF_ERROR)
+        plainText.resize(len);
 
-    //  Remove padding from the end
-    plainText.resize(plainText.length() - plainText[plainText.length()-1]);
     return plainText;
 }
+
+/**
+ *  AES-128 CBC decryption of a ciphertext into caller-supplied buffer, PKCS#7
+ *  padding is checked and stripped
+ *  @param ctx Context with expanded key
+ *  @param iv Initialization vector, AES_ECB_BLOCK_SIZE bytes
+ *  @param ciphertext Ciphertext
+ *  @param len Length of ciphertext, multiple of block size
+ *  @param out Output buffer, may be the same as ciphertext
+ *  @param outSize Size of output buffer, at least len
+ *  @param threads Number of threads to use, 0 for one per CPU core (inputs
+ *  shorter than a megabyte are always decrypted by the calling thread)
+ *  @return Length of plain text; BUF_ERROR if ciphertext length isn't a
+ *  multiple of block size, output buffer is too small or padding is invalid
+ */
+size_t AESCBCDecryptText(AES128Context &ctx, uint8_t const *iv,
+                         char const *ciphertext, size_t len, char *out,
+                         size_t outSize, uint32_t threads)
+{
+    if ((len % AES_ECB_BLOCK_SIZE) != 0 || (outSize < len))
+        return BUF_ERROR;
+
+    CBCDecryptParallel(ctx, iv, (uint8_t const*)ciphertext, len, (uint8_t*)out,
+                       threads);
+
+    return UnpaddedLength((uint8_t const*)out, len);
+}
+
 /**
  *  AES-128 EBC encryption of plaintext
  *  @param key Key for encryption
- *  @param iv Initialization vector
+ *  @param iv Initialization vector, unused by ECB
  *  @param text One block of ciphertext
+ *  @param engine One of AES_ENGINE_* macros
  *  @return Result of AES encryption of given block (note that length might not
  *  be the same as length of a block since AES might pad it to 2*block_length)
  */
-std::string AESEBCEncryptText(const std::string key, const std::string iv, std::string const &text)
+std::string AESEBCEncryptText(const std::string key, const std::string, std::string const &text,
+                              uint8_t engine)
 {
-    secure_string   ptext(text.c_str(), text.length());
-    secure_string   ctext;
-
-    aes_encrypt((const byte*)key.c_str(), (const byte*)iv.c_str(), ptext, ctext);
+    AES128Context ctx(key, engine);
 
-    return std::string(ctext.c_str(), ctext.length());
+    return ECBEncryptPadded(ctx, text);
 }
 
 /**
  *  AES-128 EBC decryption of ciphertext
  *  @param key Key for decryption
- *  @param iv Initialization vector used to encrypt original text
+ *  @param iv Initialization vector, unused by ECB
  *  @param ciphertext
+ *  @param engine One of AES_ENGINE_* macros
  *  @return Result of AES decryption of given ciphertext
  */
-std::string AESEBCDecryptText(const std::string key, const std::string iv, std::string const &ciphertext)
+std::string AESEBCDecryptText(const std::string key, const std::string, std::string const &ciphertext,
+                              uint8_t engine)
+{
+    AES128Context ctx(key, engine);
+
+    return ECBDecryptPadded(ctx, ciphertext);
+}
+
+
+//------------------------------------------------------------------------------
+//      CTR mode                                                        [PUBLIC]
+//------------------------------------------------------------------------------
+/**
+ *  Store 64-bit number as little-endian, regardless of host byte order
+ */
+static inline void StoreLE64(uint8_t *p, uint64_t x)
+{
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+    x = __builtin_bswap64(x);
+#endif
+    memcpy(p, &x, 8);
+}
+
+/**
+ *  XOR bytes of b into bytes of a, 64-bit words at a time
+ */
+static inline void XORBytes(uint8_t *out, uint8_t const *a, uint8_t const *b,
+                            size_t len)
+{
+    size_t i = 0;
+
+    for (; i + 8 <= len; i += 8)
+    {
+        uint64_t x, y;
+
+        memcpy(&x, a + i, 8);
+        memcpy(&y, b + i, 8);
+        x ^= y;
+        memcpy(out + i, &x, 8);
+    }
+    for (; i < len; i++)
+        out[i] = a[i] ^ b[i];
+}
+
+/**
+ *  XOR keystream into bytes at any offset of CTR ciphertext/plain text
+ *  Counter blocks of a chunk are laid out in a buffer and encrypted with a
+ *  single ECB call, so native engines keep several blocks in flight.
+ *  @param ctx Context with expanded key
+ *  @param nonce Nonce, first half of every counter block
+ *  @param offset Offset of the first byte in keystream
+ *  @param in Input bytes
+ *  @param len Number of bytes
+ *  @param out Output bytes, may be the same as in
+ */
+static void CTRCryptBytes(AES128Context &ctx, uint64_t nonce, uint64_t offset,
+                          uint8_t const *in, size_t len, uint8_t *out)
+{
+    uint8_t stream[CTR_CHUNK];
+    uint64_t counter = offset / AES_ECB_BLOCK_SIZE;
+    size_t skip = offset % AES_ECB_BLOCK_SIZE;
+
+    while (len > 0)
+    {
+        size_t blocks = min((skip + len + AES_ECB_BLOCK_SIZE - 1) / AES_ECB_BLOCK_SIZE,
+                            (size_t)(CTR_CHUNK / AES_ECB_BLOCK_SIZE));
+        size_t n = min(len, blocks * AES_ECB_BLOCK_SIZE - skip);
+
+        for (size_t b = 0; b < blocks; b++)
+        {
+            StoreLE64(stream + b * AES_ECB_BLOCK_SIZE, nonce);
+            StoreLE64(stream + b * AES_ECB_BLOCK_SIZE + 8, counter + b);
+        }
+        ctx.encryptBlocks(stream, stream, blocks);
+
+        XORBytes(out, in, stream + skip, n);
+
+        in += n;
+        out += n;
+        len -= n;
+        counter += blocks;
+        skip = 0;
+    }
+}
+
+/**
+ *  XOR keystream into bytes at any offset, on several threads for long inputs
+ *  (see RunChunks)
+ *  @param threads Number of threads to use, 0 for one per CPU core
+ */
+static void CTRCryptParallel(AES128Context &ctx, uint64_t nonce, uint64_t offset,
+                             uint8_t const *in, size_t len, uint8_t *out,
+                             uint32_t threads)
+{
+    RunChunks(ctx, len, threads, [&](AES128Context &c, size_t start, size_t n) {
+        CTRCryptBytes(c, nonce, offset + start, in + start, n, out + start);
+    });
+}
+
+/**
+ *  Create cipher at the start of the keystream
+ *  @param ctx Context with expanded key, has to outlive this object
+ *  @param nonce Nonce, first half of every counter block
+ *  @param threads Number of threads to use for long inputs, 0 for one per
+ *  CPU core (inputs shorter than a megabyte are always processed by the
+ *  calling thread)
+ */
+AES128CTR::AES128CTR(AES128Context &ctx, uint64_t nonce, uint32_t threads)
+    : _ctx(ctx), _nonce(nonce), _pos(0), _threads(threads)
+{
+}
+
+/**
+ *  Move to a byte of keystream, without generating any keystream before it
+ *  @param offset Offset of the next byte to encrypt/decrypt
+ */
+void AES128CTR::seek(uint64_t offset)
+{
+    _pos = offset;
+}
+
+/**
+ *  @return Offset of the next byte to encrypt/decrypt
+ */
+uint64_t AES128CTR::tell() const
 {
-    std::string retVal;
-    secure_string   ctext(ciphertext.c_str(), ciphertext.length());
-    secure_string   rtext;
+    return _pos;
+}
 
-    aes_decrypt((const byte*)key.c_str(), (const byte*)iv.c_str(), ctext, rtext);
+/**
+ *  Encrypt or decrypt bytes at the current offset, and move past them
+ *  @param in Plain text or ciphertext
+ *  @param len Length of input
+ *  @param out Output buffer of len bytes, may be the same as in
+ */
+void AES128CTR::crypt(char const *in, size_t len, char *out)
+{
+    CTRCryptParallel(_ctx, _nonce, _pos, (uint8_t const*)in, len, (uint8_t*)out,
+                     _threads);
+    _pos += len;
+}
+
+/**
+ *  Rewrite part of a ciphertext with encryption of new text, other bytes
+ *  of ciphertext and the current offset are left as they are
+ *  @param ciphertext Ciphertext, encrypted from offset 0 with this key and
+ *  nonce
+ *  @param len Length of ciphertext
+ *  @param offset Offset of the first byte to rewrite
+ *  @param newText Plain text replacing bytes from offset on
+ *  @param newLen Length of new text
+ *  @return Number of bytes rewritten (newLen); BUF_ERROR if new text
+ *  doesn't fit in ciphertext
+ */
+size_t AES128CTR::edit(char *ciphertext, size_t len, uint64_t offset,
+                       char const *newText, size_t newLen)
+{
+    if ((offset > len) || (newLen > len - offset))
+        return BUF_ERROR;
+
+    CTRCryptParallel(_ctx, _nonce, offset, (uint8_t const*)newText, newLen,
+                     (uint8_t*)ciphertext + offset, _threads);
+    return newLen;
+}
+
+/**
+ *  AES-128 CTR encryption or decryption of text, from the start of keystream
+ *  @param key Key
+ *  @param nonce Nonce, first half of every counter block
+ *  @param text Plain text or ciphertext
+ *  @return Ciphertext or plain text, as long as text
+ */
+string AESCTRCryptText(const string key, uint64_t nonce, string const &text)
+{
+    AES128Context ctx(key);
+    AES128CTR ctr(ctx, nonce);
+    string retVal(text.length(), 0);
+
+    ctr.crypt(text.data(), text.length(), &retVal[0]);
+
+    return retVal;
+}
+
+/**
+ *  Rewrite part of an AES-128 CTR ciphertext with encryption of new text
+ *  @param key Key
+ *  @param nonce Nonce, first half of every counter block
+ *  @param ciphertext Ciphertext
+ *  @param offset Offset of the first byte to rewrite, at most length of
+ *  ciphertext (runtime_error otherwise)
+ *  @param newText Plain text replacing bytes from offset on
+ *  @return Edited ciphertext, longer than the original if new text goes past
+ *  its end
+ */
+string AESCTREditText(const string key, uint64_t nonce, string const &ciphertext,
+                      size_t offset, string const &newText)
+{
+    if (offset > ciphertext.length())
+        throw std::runtime_error("Edit offset past the end of ciphertext");
+
+    AES128Context ctx(key);
+    AES128CTR ctr(ctx, nonce);
+    string retVal(ciphertext);
+
+    if (retVal.length() < offset + newText.length())
+        retVal.resize(offset + newText.length());
+    ctr.edit(&retVal[0], retVal.length(), offset, newText.data(), newText.length());
 
-    retVal = std::string(rtext.c_str(), rtext.length());
     return retVal;
 }
 
 //------------------------------------------------------------------------------
-//      Encryption/Decryption functions from low-level OpenSSL library  [PUBLIC]
+//      Streaming ciphers                                               [PUBLIC]
 //------------------------------------------------------------------------------
-void aes_encrypt(const byte key[AES_ECB_BLOCK_SIZE],
-                 const byte iv[AES_ECB_BLOCK_SIZE],
-                 const secure_string& ptext,
-                 secure_string& ctext
-){
-    EVP_CIPHER_CTX_free_ptr ctx(EVP_CIPHER_CTX_new(), ::EVP_CIPHER_CTX_free);
-    int rc = EVP_EncryptInit_ex(ctx.get(), EVP_aes_128_ecb(), NULL, key, iv);
-    if (rc != 1)
-      throw std::runtime_error("EVP_EncryptInit_ex failed");
-
-    // Recovered text expands upto BLOCK_SIZE
-    ctext.resize(ptext.size()+AES_ECB_BLOCK_SIZE);
-    int out_len1 = (int)ctext.size();
-
-    rc = EVP_EncryptUpdate(ctx.get(), (byte*)&ctext[0], &out_len1,
-                           (const byte*)&ptext[0], (int)ptext.size());
-    if (rc != 1)
-      throw std::runtime_error("EVP_EncryptUpdate failed");
-
-    int out_len2 = (int)ctext.size() - out_len1;
-    rc = EVP_EncryptFinal_ex(ctx.get(), (byte*)&ctext[0]+out_len1, &out_len2);
-    if (rc != 1)
-      throw std::runtime_error("EVP_EncryptFinal_ex failed");
-
-    // Set cipher text size now that we know it
-    ctext.resize(out_len1 + out_len2);
-}
-
-void aes_decrypt(const byte key[AES_ECB_BLOCK_SIZE],
-                 const byte iv[AES_ECB_BLOCK_SIZE],
-                 const secure_string& ctext,
-                 secure_string& rtext)
-{
-    EVP_CIPHER_CTX_free_ptr ctx(EVP_CIPHER_CTX_new(), ::EVP_CIPHER_CTX_free);
-    int rc = EVP_DecryptInit_ex(ctx.get(), EVP_aes_128_ecb(), NULL, key, iv);
-    if (rc != 1)
-      throw std::runtime_error("EVP_DecryptInit_ex failed");
-
-    // Recovered text contracts upto BLOCK_SIZE
-    rtext.resize(ctext.size());
-    int out_len1 = (int)rtext.size();
-
-    rc = EVP_DecryptUpdate(ctx.get(), (byte*)&rtext[0], &out_len1, (const byte*)&ctext[0], (int)ctext.size());
-    if (rc != 1)
-      throw std::runtime_error("EVP_DecryptUpdate failed");
-
-    int out_len2 = (int)rtext.size() - out_len1;
-    rc = EVP_DecryptFinal_ex(ctx.get(), (byte*)&rtext[0]+out_len1, &out_len2);
-
-//    if (rc != 1)
-//      throw std::runtime_error("EVP_DecryptFinal_ex failed");
-
-    // Set recovered text size now that we know it
-    rtext.resize(out_len1 + out_len2);
+/**
+ *  @param ctx Context with expanded key, has to outlive this object
+ *  @param encrypt True to encrypt, false to decrypt
+ *  @param padding True to use PKCS#7 padding, false for messages that are
+ *  a whole number of blocks already
+ */
+AES128BlockStream::AES128BlockStream(AES128Context &ctx, bool encrypt, bool padding)
+    : _ctx(ctx), _encrypt(encrypt), _padding(padding), _bufLen(0)
+{
+}
+
+/**
+ *  Encrypt or decrypt next piece of message
+ *  Bytes left from the last call are completed into a block first, then whole
+ *  blocks go from input to output directly and the rest is kept for the next
+ *  call.
+ *  @param in Next piece of input
+ *  @param len Length of input
+ *  @param out Output buffer
+ *  @param outSize Size of output buffer, len + AES_ECB_BLOCK_SIZE is
+ *  always enough
+ *  @return Number of bytes written to out; BUF_ERROR if output buffer is
+ *  too small (nothing is consumed then)
+ */
+size_t AES128BlockStream::update(char const *in, size_t len, char *out,
+                                 size_t outSize)
+{
+    size_t total = _bufLen + len;
+    size_t emit = total / AES_ECB_BLOCK_SIZE * AES_ECB_BLOCK_SIZE, left;
+    uint8_t const *i = (uint8_t const*)in;
+    uint8_t *o = (uint8_t*)out;
+
+    //  Last whole block might be padding, it's only decrypted in final()
+    if (!_encrypt && _padding && (emit == total) && (emit > 0))
+        emit -= AES_ECB_BLOCK_SIZE;
+    if (outSize < emit)
+        return BUF_ERROR;
+
+    left = emit;
+    if ((_bufLen > 0) && (left > 0))
+    {
+        size_t take = AES_ECB_BLOCK_SIZE - _bufLen;
+
+        memcpy(_buf + _bufLen, i, take);
+        blocks(_buf, o, 1);
+        i += take;
+        len -= take;
+        o += AES_ECB_BLOCK_SIZE;
+        left -= AES_ECB_BLOCK_SIZE;
+        _bufLen = 0;
+    }
+    if (left > 0)
+    {
+        blocks(i, o, left / AES_ECB_BLOCK_SIZE);
+        i += left;
+        len -= left;
+    }
+
+    memcpy(_buf + _bufLen, i, len);
+    _bufLen += len;
+
+    return emit;
+}
+
+/**
+ *  Finish message, output whatever is left and start a new one
+ *  @param out Output buffer
+ *  @param outSize Size of output buffer, AES_ECB_BLOCK_SIZE is always
+ *  enough
+ *  @return Number of bytes written to out; BUF_ERROR if output buffer is
+ *  too small, message isn't a whole number of blocks where it has to be or
+ *  padding is invalid
+ */
+size_t AES128BlockStream::final(char *out, size_t outSize)
+{
+    size_t retVal = 0;
+
+    //  Nothing is consumed if the output doesn't fit
+    if (_padding && (outSize < (_encrypt ? AES_ECB_BLOCK_SIZE : AES_ECB_BLOCK_SIZE - 1)))
+        return BUF_ERROR;
+
+    if (!_padding)
+        retVal = (_bufLen == 0) ? 0 : BUF_ERROR;
+    else if (_encrypt)
+    {
+        uint8_t pad = AES_ECB_BLOCK_SIZE - _bufLen;
+
+        memset(_buf + _bufLen, pad, pad);
+        blocks(_buf, (uint8_t*)out, 1);
+        retVal = AES_ECB_BLOCK_SIZE;
+    }
+    else if (_bufLen != AES_ECB_BLOCK_SIZE)
+        retVal = BUF_ERROR;
+    else
+    {
+        uint8_t last[AES_ECB_BLOCK_SIZE];
+
+        blocks(_buf, last, 1);
+        retVal = UnpaddedLength(last, AES_ECB_BLOCK_SIZE);
+        if (retVal != BUF_ERROR)
+            memcpy(out, last, retVal);
+    }
+
+    _bufLen = 0;
+    restart();
+    return retVal;
+}
+
+/**
+ *  @param ctx Context with expanded key, has to outlive this object
+ *  @param encrypt True to encrypt, false to decrypt
+ *  @param padding True to use PKCS#7 padding
+ */
+AES128ECBStream::AES128ECBStream(AES128Context &ctx, bool encrypt, bool padding)
+    : AES128BlockStream(ctx, encrypt, padding)
+{
+}
+
+void AES128ECBStream::blocks(uint8_t const *in, uint8_t *out, size_t blocks)
+{
+    if (_encrypt)
+        _ctx.encryptBlocks(in, out, blocks);
+    else
+        _ctx.decryptBlocks(in, out, blocks);
+}
+
+void AES128ECBStream::restart()
+{
+}
+
+/**
+ *  @param ctx Context with expanded key, has to outlive this object
+ *  @param iv Initialization vector, AES_ECB_BLOCK_SIZE bytes
+ *  @param encrypt True to encrypt, false to decrypt
+ *  @param padding True to use PKCS#7 padding
+ */
+AES128CBCStream::AES128CBCStream(AES128Context &ctx, uint8_t const *iv,
+                                 bool encrypt, bool padding)
+    : AES128BlockStream(ctx, encrypt, padding)
+{
+    init(iv);
+}
+
+/**
+ *  Start a new message with a new initialization vector, dropping
+ *  anything left from the current one
+ *  @param iv Initialization vector, AES_ECB_BLOCK_SIZE bytes
+ */
+void AES128CBCStream::init(uint8_t const *iv)
+{
+    memcpy(_iv, iv, AES_ECB_BLOCK_SIZE);
+    memcpy(_chain, iv, AES_ECB_BLOCK_SIZE);
+    _bufLen = 0;
+}
+
+void AES128CBCStream::blocks(uint8_t const *in, uint8_t *out, size_t blocks)
+{
+    size_t len = blocks * AES_ECB_BLOCK_SIZE;
+
+    if (_encrypt)
+    {
+        CBCEncryptBlocks(_ctx, _chain, in, len, out);
+        return;
+    }
+
+    //  Last ciphertext block chains into the next call, saved in case it's
+    //  decrypted in place
+    uint8_t next[AES_ECB_BLOCK_SIZE];
+
+    memcpy(next, in + len - AES_ECB_BLOCK_SIZE, AES_ECB_BLOCK_SIZE);
+    CBCDecryptBlocks(_ctx, _chain, in, len, out);
+    memcpy(_chain, next, AES_ECB_BLOCK_SIZE);
+}
+
+/**
+ *  Next message starts from the same initialization vector, unless init()
+ *  gives a new one
+ */
+void AES128CBCStream::restart()
+{
+    memcpy(_chain, _iv, AES_ECB_BLOCK_SIZE);
+}
+
+/**
+ *  @param ctx Context with expanded key, has to outlive this object
+ *  @param nonce Nonce, first half of every counter block
+ *  @param threads Number of threads to use for long pieces, 0 for one per
+ *  CPU core
+ */
+AES128CTRStream::AES128CTRStream(AES128Context &ctx, uint64_t nonce,
+                                 uint32_t threads)
+    : _ctx(ctx), _nonce(nonce), _pos(0), _threads(threads)
+{
+}
+
+/**
+ *  Start a new message with a new nonce
+ *  @param nonce Nonce, first half of every counter block
+ */
+void AES128CTRStream::init(uint64_t nonce)
+{
+    _nonce = nonce;
+    _pos = 0;
+}
+
+/**
+ *  Encrypt or decrypt next piece of message, in may be the same as out
+ *  @return Number of bytes written to out (len); BUF_ERROR if output buffer
+ *  is too small
+ */
+size_t AES128CTRStream::update(char const *in, size_t len, char *out,
+                               size_t outSize)
+{
+    if (outSize < len)
+        return BUF_ERROR;
+
+    CTRCryptParallel(_ctx, _nonce, _pos, (uint8_t const*)in, len, (uint8_t*)out,
+                     _threads);
+    _pos += len;
+
+    return len;
+}
+
+/**
+ *  Finish message, next one starts from the beginning of keystream
+ *  @return Always 0, nothing is held back
+ */
+size_t AES128CTRStream::final(char *, size_t)
+{
+    //  CTR keeps no partial block, there is nothing to flush
+    _pos = 0;
+    return 0;
 }
@@ -5,10 +5,28 @@
  *    Created: 21. Oct 2017.
  *    Author: Vedran Mikov
  */
+#ifndef MYCRYPTO_AES_H_
+#define MYCRYPTO_AES_H_
+
 #include <string>
+#include <cstdint>
+#include <cstddef>
+#include "mycrypto-basic.h"
+#include "mycrypto-aescore.h"
 
 #define AES_ECB_BLOCK_SIZE   16
 
+//  Engines blocks can be encrypted/decrypted with
+#define AES_ENGINE_AUTO      0   //  Engine set by AESSetEngine
+#define AES_ENGINE_OPENSSL   1   //  OpenSSL EVP interface
+#define AES_ENGINE_AESNI     2   //  Native, AES-NI instructions
+#define AES_ENGINE_TTABLE    3   //  Native software, T-tables
+#define AES_ENGINE_BITSLICE  4   //  Native software, bitsliced 8 blocks at a
+                                 //  time, constant-time
+#define AES_ENGINE_HYBRID    5   //  Bitsliced for groups of 8 blocks, OpenSSL
+                                 //  for the rest of a call (fastest without
+                                 //  AES-NI)
+
 using namespace std;
 
 
@@ -27,6 +45,119 @@ void InitAES128EBC();
  *  @return Random ASCII string of specified length
  */
 string AESGenerateRandString(const uint8_t keySize, bool spec = false);
+
+/**
+ *  Check whether an engine can be used on this CPU
+ *  @param engine One of AES_ENGINE_* macros
+ *  @return True if engine is available
+ */
+bool AESEngineSupported(uint8_t engine);
+/**
+ *  Engine used by contexts not given one, initialized to the fastest engine
+ *  supported by the CPU
+ *  @return One of AES_ENGINE_* macros, other than AES_ENGINE_AUTO
+ */
+uint8_t AESEngine();
+/**
+ *  Set engine used by contexts not given one, mostly for testing and
+ *  benchmarking. Meant to be called before contexts are created.
+ *  @param engine One of AES_ENGINE_* macros, AES_ENGINE_AUTO for the fastest
+ *  supported one
+ *  @return Engine that has actually been selected, unsupported engines are
+ *  replaced by the fastest supported one
+ */
+uint8_t AESSetEngine(uint8_t engine);
+
+//  Cipher context of OpenSSL, kept opaque here
+typedef struct evp_cipher_ctx_st EVP_CIPHER_CTX;
+struct AESCBCJob;
+
+/**
+ *  AES-128 cipher with expanded key
+ *  Key is expanded once, when set, and the round keys (or initialized OpenSSL
+ *  cipher contexts) are kept for all blocks encrypted or decrypted with it
+ *  afterwards. Blocks are raw ECB blocks, padding and chaining are left to the
+ *  caller. Not to be shared between threads, every thread needs its own context
+ *  (a copy of one already keyed will do).
+ */
+class AES128Context
+{
+public:
+    /**
+     *  Create context without a key
+     *  @param engine One of AES_ENGINE_* macros; runtime_error if it isn't
+     *  supported by the CPU
+     */
+    explicit AES128Context(uint8_t engine = AES_ENGINE_AUTO);
+    /**
+     *  Create context and expand the key
+     *  @param key Key, its first AES_ECB_BLOCK_SIZE bytes are used
+     *  @param engine One of AES_ENGINE_* macros; runtime_error if it isn't
+     *  supported by the CPU
+     */
+    explicit AES128Context(string const &key, uint8_t engine = AES_ENGINE_AUTO);
+    /**
+     *  Create context with the same engine and key as another one, e.g. for
+     *  use by another thread
+     *  @param other Context to copy, only read from
+     */
+    AES128Context(AES128Context const &other);
+    ~AES128Context();
+
+    /**
+     *  @return Engine used by this context (never AES_ENGINE_AUTO)
+     */
+    uint8_t engine() const;
+
+    /**
+     *  Expand new key, replacing the old one
+     *  @param key AES_ECB_BLOCK_SIZE bytes of key
+     */
+    void setKey(uint8_t const *key);
+    /**
+     *  Expand new key, replacing the old one
+     *  @param key Key, its first AES_ECB_BLOCK_SIZE bytes are used; shorter
+     *  keys are rejected with runtime_error
+     */
+    void setKey(string const &key);
+
+    /**
+     *  Encrypt one block
+     *  @param in Block of plaintext
+     *  @param out Block of ciphertext, may be the same as in
+     */
+    void encryptBlock(uint8_t const *in, uint8_t *out);
+    /**
+     *  Decrypt one block
+     *  @param in Block of ciphertext
+     *  @param out Block of plaintext, may be the same as in
+     */
+    void decryptBlock(uint8_t const *in, uint8_t *out);
+    /**
+     *  Encrypt consecutive blocks independently of each other (ECB)
+     *  @param in Plaintext
+     *  @param out Ciphertext, may be the same as in
+     *  @param blocks Number of blocks
+     */
+    void encryptBlocks(uint8_t const *in, uint8_t *out, size_t blocks);
+    /**
+     *  Decrypt consecutive blocks independently of each other (ECB)
+     *  @param in Ciphertext
+     *  @param out Plaintext, may be the same as in
+     *  @param blocks Number of blocks
+     */
+    void decryptBlocks(uint8_t const *in, uint8_t *out, size_t blocks);
+
+private:
+    AES128Context &operator=(AES128Context const&);
+    //  Runs blocks of many contexts through native engines at once
+    friend void AESCBCEncryptBatch(AESCBCJob *jobs, size_t count);
+
+    uint8_t         _engine;
+    AESRoundKeys    _rk;    //  Expanded key of native engines
+    EVP_CIPHER_CTX  *_enc;  //  OpenSSL expands keys for encryption and
+    EVP_CIPHER_CTX  *_dec;  //  decryption in separate contexts
+};
 /**
  *  AES-128 CBC encryption of a single block
  *  @param key Key for encryption
@@ -54,28 +185,332 @@ std::string AESCBCDecryptBlock(const std::string key, const std::string iv, std:
  *  @return Ciphertext, result of AES encryption of plain text input
  */
 string AESCBCEncryptText(const string key, const string iv, string const &text);
+/**
+ *  AES-128 CBC encryption of plain text into caller-supplied buffer, text is
+ *  padded according to PKCS#7 (a whole block of padding if its length is
+ *  already a multiple of block size)
+ *  @param ctx Context with expanded key
+ *  @param iv Initialization vector, AES_ECB_BLOCK_SIZE bytes
+ *  @param text Plain text
+ *  @param len Length of plain text
+ *  @param out Output buffer, may be the same as text
+ *  @param outSize Size of output buffer, at least (len/16 + 1)*16
+ *  @return Length of ciphertext; BUF_ERROR if output buffer is too small
+ */
+size_t AESCBCEncryptText(AES128Context &ctx, uint8_t const *iv, char const *text,
+                         size_t len, char *out, size_t outSize);
+
+/**
+ *  One message of batch CBC encryption (see AESCBCEncryptBatch)
+ */
+struct AESCBCJob
+{
+    AES128Context   *ctx;       //  Context with expanded key, can be shared
+                                //  between jobs
+    uint8_t const   *iv;        //  Initialization vector, AES_ECB_BLOCK_SIZE bytes
+    char const      *text;      //  Plain text
+    size_t          len;        //  Length of plain text
+    char            *out;       //  Output buffer, may be the same as text
+    size_t          outSize;    //  Size of output buffer, at least (len/16 + 1)*16
+    size_t          outLen;     //  [out] Length of ciphertext; BUF_ERROR if
+                                //  output buffer is too small
+};
+/**
+ *  AES-128 CBC encryption of many independent messages, each padded according
+ *  to PKCS#7 as by AESCBCEncryptText
+ *  Blocks of one message have to be encrypted one after another, but blocks
+ *  of different messages don't: messages are assigned to lanes advanced in
+ *  lockstep, one block of every lane encrypted per step, and a lane whose
+ *  message is done takes the next one. Jobs whose context doesn't use the
+ *  AES-NI engine are encrypted one by one.
+ *  @param jobs Messages to encrypt, their outLen is set
+ *  @param count Number of jobs
+ */
+void AESCBCEncryptBatch(AESCBCJob *jobs, size_t count);
 /**
  *  AES-128 CBC decryption of a ciphertext
  *  @param key Key for decryption
  *  @param iv Initialization vector used to encrypt original text
- *  @param cyphertext
- *  @return Plain text retrieved from cipher
+ *  @param cyphertext Ciphertext, multiple of block size long (runtime_error
+ *  otherwise)
+ *  @param threads Number of threads to use, 0 for one per CPU core (inputs
+ *  shorter than a megabyte are always decrypted by the calling thread)
+ *  @return Plain text retrieved from cipher; with padding left in place if it
+ *  isn't valid
+ */
+string AESCBCDecryptText(const string key, const string iv, string const &ciphertext,
+                         uint32_t threads = 0);
+/**
+ *  AES-128 CBC decryption of a ciphertext into caller-supplied buffer, PKCS#7
+ *  padding is checked and stripped
+ *  @param ctx Context with expanded key
+ *  @param iv Initialization vector, AES_ECB_BLOCK_SIZE bytes
+ *  @param ciphertext Ciphertext
+ *  @param len Length of ciphertext, multiple of block size
+ *  @param out Output buffer, may be the same as ciphertext
+ *  @param outSize Size of output buffer, at least len
+ *  @param threads Number of threads to use, 0 for one per CPU core (inputs
+ *  shorter than a megabyte are always decrypted by the calling thread)
+ *  @return Length of plain text; BUF_ERROR if ciphertext length isn't a
+ *  multiple of block size, output buffer is too small or padding is invalid
  */
-string AESCBCDecryptText(const string key, const string iv, string const &ciphertext);
+size_t AESCBCDecryptText(AES128Context &ctx, uint8_t const *iv,
+                         char const *ciphertext, size_t len, char *out,
+                         size_t outSize, uint32_t threads = 0);
 /**
  *  AES-128 EBC encryption of plain text
  *  @param key Key for encryption
  *  @param iv Initialization vector used to encrypt first block of text
  *  @param text
+ *  @param engine One of AES_ENGINE_* macros
  *  @return Ciphertext, result of AES encryption of plain text input
  */
-string AESEBCEncryptText(const string key, const string iv, string const &text);
+string AESEBCEncryptText(const string key, const string iv, string const &text,
+                         uint8_t engine = AES_ENGINE_AUTO);
 /**
  *  AES-128 EBC decryption of a ciphertext
  *  @param key Key for decryption
  *  @param iv Initialization vector used to encrypt original text
  *  @param cyphertext
+ *  @param engine One of AES_ENGINE_* macros
  *  @return Plain text retrieved from cipher
  */
-string AESEBCDecryptText(const string key, const string iv, string const &ciphertext);
+string AESEBCDecryptText(const string key, const string iv, string const &ciphertext,
+                         uint8_t engine = AES_ENGINE_AUTO);
+
+
+/**
+ *  AES-128 in counter (CTR) mode
+ *  Keystream block i is encryption of a block made of nonce and i, both as
+ *  64-bit little-endian numbers (layout used by challenges from set 3 on).
+ *  Keystream blocks don't depend on each other, so any byte of keystream can
+ *  be reached directly and long inputs are split between threads. Encryption
+ *  and decryption are the same operation.
+ */
+class AES128CTR
+{
+public:
+    /**
+     *  Create cipher at the start of the keystream
+     *  @param ctx Context with expanded key, has to outlive this object
+     *  @param nonce Nonce, first half of every counter block
+     *  @param threads Number of threads to use for long inputs, 0 for one per
+     *  CPU core (inputs shorter than a megabyte are always processed by the
+     *  calling thread)
+     */
+    AES128CTR(AES128Context &ctx, uint64_t nonce, uint32_t threads = 0);
+
+    /**
+     *  Move to a byte of keystream, without generating any keystream before it
+     *  @param offset Offset of the next byte to encrypt/decrypt
+     */
+    void seek(uint64_t offset);
+    /**
+     *  @return Offset of the next byte to encrypt/decrypt
+     */
+    uint64_t tell() const;
+
+    /**
+     *  Encrypt or decrypt bytes at the current offset, and move past them
+     *  @param in Plain text or ciphertext
+     *  @param len Length of input
+     *  @param out Output buffer of len bytes, may be the same as in
+     */
+    void crypt(char const *in, size_t len, char *out);
+    /**
+     *  Rewrite part of a ciphertext with encryption of new text, other bytes
+     *  of ciphertext and the current offset are left as they are
+     *  @param ciphertext Ciphertext, encrypted from offset 0 with this key and
+     *  nonce
+     *  @param len Length of ciphertext
+     *  @param offset Offset of the first byte to rewrite
+     *  @param newText Plain text replacing bytes from offset on
+     *  @param newLen Length of new text
+     *  @return Number of bytes rewritten (newLen); BUF_ERROR if new text
+     *  doesn't fit in ciphertext
+     */
+    size_t edit(char *ciphertext, size_t len, uint64_t offset,
+                char const *newText, size_t newLen);
+
+private:
+    AES128Context   &_ctx;
+    uint64_t        _nonce;
+    uint64_t        _pos;       //  Offset of the next byte of keystream
+    uint32_t        _threads;
+};
+/**
+ *  AES-128 CTR encryption or decryption of text, from the start of keystream
+ *  @param key Key
+ *  @param nonce Nonce, first half of every counter block
+ *  @param text Plain text or ciphertext
+ *  @return Ciphertext or plain text, as long as text
+ */
+string AESCTRCryptText(const string key, uint64_t nonce, string const &text);
+/**
+ *  Rewrite part of an AES-128 CTR ciphertext with encryption of new text
+ *  @param key Key
+ *  @param nonce Nonce, first half of every counter block
+ *  @param ciphertext Ciphertext
+ *  @param offset Offset of the first byte to rewrite, at most length of
+ *  ciphertext (runtime_error otherwise)
+ *  @param newText Plain text replacing bytes from offset on
+ *  @return Edited ciphertext, longer than the original if new text goes past
+ *  its end
+ */
+string AESCTREditText(const string key, uint64_t nonce, string const &ciphertext,
+                      size_t offset, string const &newText);
+
+/**
+ *  Streaming AES-128 cipher: message is passed in pieces of any length through
+ *  update() and finished with final(), chaining state and partial blocks are
+ *  carried between calls. Input and output of a call mustn't overlap, except
+ *  in CTR mode where they may be the same buffer.
+ */
+class AES128Stream
+{
+public:
+    virtual ~AES128Stream() {}
+
+    /**
+     *  Encrypt or decrypt next piece of message
+     *  @param in Next piece of input
+     *  @param len Length of input
+     *  @param out Output buffer
+     *  @param outSize Size of output buffer, len + AES_ECB_BLOCK_SIZE is
+     *  always enough
+     *  @return Number of bytes written to out; BUF_ERROR if output buffer is
+     *  too small (nothing is consumed then)
+     */
+    virtual size_t update(char const *in, size_t len, char *out, size_t outSize) = 0;
+    /**
+     *  Finish message, output whatever is left and start a new one
+     *  @param out Output buffer
+     *  @param outSize Size of output buffer, AES_ECB_BLOCK_SIZE is always
+     *  enough
+     *  @return Number of bytes written to out; BUF_ERROR if output buffer is
+     *  too small, message isn't a whole number of blocks where it has to be or
+     *  padding is invalid
+     */
+    virtual size_t final(char *out, size_t outSize) = 0;
+};
+
+/**
+ *  Streaming cipher working on whole blocks (ECB and CBC), with optional
+ *  PKCS#7 padding added or checked and stripped in final(). When decrypting
+ *  with padding the last whole block is held back until final(), since it
+ *  might be the padding one.
+ */
+class AES128BlockStream : public AES128Stream
+{
+public:
+    size_t update(char const *in, size_t len, char *out, size_t outSize);
+    size_t final(char *out, size_t outSize);
+
+protected:
+    /**
+     *  @param ctx Context with expanded key, has to outlive this object
+     *  @param encrypt True to encrypt, false to decrypt
+     *  @param padding True to use PKCS#7 padding, false for messages that are
+     *  a whole number of blocks already
+     */
+    AES128BlockStream(AES128Context &ctx, bool encrypt, bool padding);
+
+    /**
+     *  Encrypt/decrypt whole blocks, advancing chaining state of the mode
+     *  @param in Input blocks
+     *  @param out Output blocks, may be the same as in
+     *  @param blocks Number of blocks
+     */
+    virtual void blocks(uint8_t const *in, uint8_t *out, size_t blocks) = 0;
+    /**
+     *  Restart chaining state of the mode at the end of a message
+     */
+    virtual void restart() = 0;
+
+    AES128Context   &_ctx;
+    bool            _encrypt, _padding;
+    uint8_t         _buf[AES_ECB_BLOCK_SIZE];   //  Input not processed yet
+    size_t          _bufLen;
+};
+
+/**
+ *  Streaming AES-128 ECB encryption/decryption
+ */
+class AES128ECBStream : public AES128BlockStream
+{
+public:
+    /**
+     *  @param ctx Context with expanded key, has to outlive this object
+     *  @param encrypt True to encrypt, false to decrypt
+     *  @param padding True to use PKCS#7 padding
+     */
+    AES128ECBStream(AES128Context &ctx, bool encrypt, bool padding = true);
+
+protected:
+    void blocks(uint8_t const *in, uint8_t *out, size_t blocks);
+    void restart();
+};
+
+/**
+ *  Streaming AES-128 CBC encryption/decryption
+ */
+class AES128CBCStream : public AES128BlockStream
+{
+public:
+    /**
+     *  @param ctx Context with expanded key, has to outlive this object
+     *  @param iv Initialization vector, AES_ECB_BLOCK_SIZE bytes
+     *  @param encrypt True to encrypt, false to decrypt
+     *  @param padding True to use PKCS#7 padding
+     */
+    AES128CBCStream(AES128Context &ctx, uint8_t const *iv, bool encrypt,
+                    bool padding = true);
+
+    /**
+     *  Start a new message with a new initialization vector, dropping
+     *  anything left from the current one
+     *  @param iv Initialization vector, AES_ECB_BLOCK_SIZE bytes
+     */
+    void init(uint8_t const *iv);
+
+protected:
+    void blocks(uint8_t const *in, uint8_t *out, size_t blocks);
+    void restart();
+
+private:
+    uint8_t _iv[AES_ECB_BLOCK_SIZE];
+    uint8_t _chain[AES_ECB_BLOCK_SIZE];     //  Last ciphertext block
+};
+
+/**
+ *  Streaming AES-128 CTR encryption/decryption (see AES128CTR), output is
+ *  never held back so final() writes nothing
+ */
+class AES128CTRStream : public AES128Stream
+{
+public:
+    /**
+     *  @param ctx Context with expanded key, has to outlive this object
+     *  @param nonce Nonce, first half of every counter block
+     *  @param threads Number of threads to use for long pieces, 0 for one per
+     *  CPU core
+     */
+    AES128CTRStream(AES128Context &ctx, uint64_t nonce, uint32_t threads = 0);
+
+    /**
+     *  Start a new message with a new nonce
+     *  @param nonce Nonce, first half of every counter block
+     */
+    void init(uint64_t nonce);
+
+    size_t update(char const *in, size_t len, char *out, size_t outSize);
+    size_t final(char *out, size_t outSize);
+
+private:
+    AES128Context   &_ctx;
+    uint64_t        _nonce;
+    uint64_t        _pos;       //  Offset of the next byte of keystream
+    uint32_t        _threads;
+};
 
+#endif  /* MYCRYPTO_AES_H_ */
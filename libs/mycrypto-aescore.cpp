@@ -0,0 +1,1080 @@
+/**
+ *    Implementation of native AES-128 engines from mycrypto-aescore header
+ *    Description
+ *      Key is expanded once, in portable code, into round keys of the cipher
+ *      and of the equivalent inverse cipher (and their bitsliced form), so that
+ *      every engine can use the same schedule. AES-NI kernels are compiled through target attributes,
+ *      the library itself can be built without any -m flags. Latency of
+ *      aesenc/aesdec is several cycles while a new one can be issued every
+ *      cycle, so kernels keep 8 independent blocks in flight and go through
+ *      rounds for all of them at once.
+ *      Software engines are a T-table one, for single blocks, and a bitsliced
+ *      one after BearSSL's aes_ct64, which keeps 8 blocks in 128-bit vectors
+ *      (GCC vector extensions, so no instruction set is assumed) and runs
+ *      SubBytes as a Boolean circuit instead of table lookups. Key expansion
+ *      uses the same circuit, and bitsliced engine pads fewer than 8 blocks to
+ *      a full group, so neither key nor data ever index memory there: it is the
+ *      constant-time engine, whereas T-table one leaks through cache timing.
+ *
+ *    Created: 17. Oct 2026.
+ *    Author: Vedran Mikov
+ */
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define AES_X86
+#endif
+
+#include "mycrypto-aescore.h"
+
+//  Blocks encrypted/decrypted together by AES-NI and bitsliced kernels
+#define AESNI_LANES     8
+#define SLICE_BLOCKS    8
+
+//------------------------------------------------------------------------------
+//      Key expansion                                                  [PRIVATE]
+//------------------------------------------------------------------------------
+//  AES S-box, for T-table engine (key expansion runs the bitsliced circuit)
+static const uint8_t sbox[256] =
+{
+    0x63, 0x7c, 0x77, 0x7b, 0xf2, 0x6b, 0x6f, 0xc5, 0x30, 0x01, 0x67, 0x2b, 0xfe, 0xd7, 0xab, 0x76,
+    0xca, 0x82, 0xc9, 0x7d, 0xfa, 0x59, 0x47, 0xf0, 0xad, 0xd4, 0xa2, 0xaf, 0x9c, 0xa4, 0x72, 0xc0,
+    0xb7, 0xfd, 0x93, 0x26, 0x36, 0x3f, 0xf7, 0xcc, 0x34, 0xa5, 0xe5, 0xf1, 0x71, 0xd8, 0x31, 0x15,
+    0x04, 0xc7, 0x23, 0xc3, 0x18, 0x96, 0x05, 0x9a, 0x07, 0x12, 0x80, 0xe2, 0xeb, 0x27, 0xb2, 0x75,
+    0x09, 0x83, 0x2c, 0x1a, 0x1b, 0x6e, 0x5a, 0xa0, 0x52, 0x3b, 0xd6, 0xb3, 0x29, 0xe3, 0x2f, 0x84,
+    0x53, 0xd1, 0x00, 0xed, 0x20, 0xfc, 0xb1, 0x5b, 0x6a, 0xcb, 0xbe, 0x39, 0x4a, 0x4c, 0x58, 0xcf,
+    0xd0, 0xef, 0xaa, 0xfb, 0x43, 0x4d, 0x33, 0x85, 0x45, 0xf9, 0x02, 0x7f, 0x50, 0x3c, 0x9f, 0xa8,
+    0x51, 0xa3, 0x40, 0x8f, 0x92, 0x9d, 0x38, 0xf5, 0xbc, 0xb6, 0xda, 0x21, 0x10, 0xff, 0xf3, 0xd2,
+    0xcd, 0x0c, 0x13, 0xec, 0x5f, 0x97, 0x44, 0x17, 0xc4, 0xa7, 0x7e, 0x3d, 0x64, 0x5d, 0x19, 0x73,
+    0x60, 0x81, 0x4f, 0xdc, 0x22, 0x2a, 0x90, 0x88, 0x46, 0xee, 0xb8, 0x14, 0xde, 0x5e, 0x0b, 0xdb,
+    0xe0, 0x32, 0x3a, 0x0a, 0x49, 0x06, 0x24, 0x5c, 0xc2, 0xd3, 0xac, 0x62, 0x91, 0x95, 0xe4, 0x79,
+    0xe7, 0xc8, 0x37, 0x6d, 0x8d, 0xd5, 0x4e, 0xa9, 0x6c, 0x56, 0xf4, 0xea, 0x65, 0x7a, 0xae, 0x08,
+    0xba, 0x78, 0x25, 0x2e, 0x1c, 0xa6, 0xb4, 0xc6, 0xe8, 0xdd, 0x74, 0x1f, 0x4b, 0xbd, 0x8b, 0x8a,
+    0x70, 0x3e, 0xb5, 0x66, 0x48, 0x03, 0xf6, 0x0e, 0x61, 0x35, 0x57, 0xb9, 0x86, 0xc1, 0x1d, 0x9e,
+    0xe1, 0xf8, 0x98, 0x11, 0x69, 0xd9, 0x8e, 0x94, 0x9b, 0x1e, 0x87, 0xe9, 0xce, 0x55, 0x28, 0xdf,
+    0x8c, 0xa1, 0x89, 0x0d, 0xbf, 0xe6, 0x42, 0x68, 0x41, 0x99, 0x2d, 0x0f, 0xb0, 0x54, 0xbb, 0x16,
+};
+
+/**
+ *  Multiply by x (i.e. by 2) in GF(2^8) modulo AES polynomial
+ */
+static inline uint8_t XTime(uint8_t a)
+{
+    return (uint8_t)((a << 1) ^ (-(a >> 7) & 0x1B));
+}
+
+/**
+ *  Multiply two elements of GF(2^8) modulo AES polynomial, without branches
+ *  on either of them
+ */
+static uint8_t GFMul(uint8_t a, uint8_t b)
+{
+    uint8_t r = 0;
+
+    for (uint8_t i = 0; i < 8; i++, b >>= 1, a = XTime(a))
+        r ^= a & -(b & 1);
+
+    return r;
+}
+
+/**
+ *  Apply InvMixColumns to a round key, turning it into a round key of the
+ *  equivalent inverse cipher
+ *  @param out Transformed round key
+ *  @param in Round key of the cipher
+ */
+static void InvMixRoundKey(uint8_t *out, uint8_t const *in)
+{
+    for (uint8_t c = 0; c < 16; c += 4)
+    {
+        uint8_t const *a = in + c;
+
+        out[c]   = GFMul(a[0], 14) ^ GFMul(a[1], 11) ^ GFMul(a[2], 13) ^ GFMul(a[3], 9);
+        out[c+1] = GFMul(a[0], 9) ^ GFMul(a[1], 14) ^ GFMul(a[2], 11) ^ GFMul(a[3], 13);
+        out[c+2] = GFMul(a[0], 13) ^ GFMul(a[1], 9) ^ GFMul(a[2], 14) ^ GFMul(a[3], 11);
+        out[c+3] = GFMul(a[0], 11) ^ GFMul(a[1], 13) ^ GFMul(a[2], 9) ^ GFMul(a[3], 14);
+    }
+}
+
+//------------------------------------------------------------------------------
+//      T-table kernels                                                [PRIVATE]
+//------------------------------------------------------------------------------
+/**
+ *  Lookup tables of T-table engine, columns are packed into words with row 0
+ *  in the lowest byte
+ */
+struct AESTables
+{
+    //  SubBytes and MixColumns of a byte in row r: te[r][x]
+    uint32_t te[4][256];
+    //  InvSubBytes and InvMixColumns of a byte in row r: td[r][x]
+    uint32_t td[4][256];
+    uint8_t  invSbox[256];
+};
+
+static inline uint32_t Rotl32(uint32_t x, uint8_t n)
+{
+    return (x << n) | (x >> (32 - n));
+}
+
+/**
+ *  Build lookup tables from S-box, once
+ */
+static AESTables const &Tables()
+{
+    static AESTables const *tables = []() {
+        AESTables *t = new AESTables;
+
+        for (uint32_t x = 0; x < 256; x++)
+            t->invSbox[sbox[x]] = (uint8_t)x;
+
+        for (uint32_t x = 0; x < 256; x++)
+        {
+            uint8_t s = sbox[x], i = t->invSbox[x];
+
+            t->te[0][x] = (uint32_t)XTime(s) | ((uint32_t)s << 8) |
+                          ((uint32_t)s << 16) | ((uint32_t)(XTime(s) ^ s) << 24);
+            t->td[0][x] = (uint32_t)GFMul(i, 14) | ((uint32_t)GFMul(i, 9) << 8) |
+                          ((uint32_t)GFMul(i, 13) << 16) | ((uint32_t)GFMul(i, 11) << 24);
+            for (uint8_t r = 1; r < 4; r++)
+            {
+                t->te[r][x] = Rotl32(t->te[0][x], 8 * r);
+                t->td[r][x] = Rotl32(t->td[0][x], 8 * r);
+            }
+        }
+
+        return t;
+    }();
+
+    return *tables;
+}
+
+/**
+ *  Load 4 bytes as a word, first byte lowest
+ */
+static inline uint32_t Load32(uint8_t const *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) |
+           ((uint32_t)p[3] << 24);
+}
+
+static inline void Store32(uint8_t *p, uint32_t x)
+{
+    p[0] = (uint8_t)x;
+    p[1] = (uint8_t)(x >> 8);
+    p[2] = (uint8_t)(x >> 16);
+    p[3] = (uint8_t)(x >> 24);
+}
+
+//  Output column of T-table round from bytes of rows 0-3 of columns a-d
+#define TABLE_COLUMN(t, k, a, b, c, d)                                          \
+    (t[0][(a) & 0xFF] ^ t[1][((b) >> 8) & 0xFF] ^ t[2][((c) >> 16) & 0xFF] ^    \
+     t[3][(d) >> 24] ^ Load32(k))
+
+//  Output column of the last round (S-box only) from bytes of columns a-d
+#define TABLE_LAST(x, k, a, b, c, d)                                            \
+    (((uint32_t)x[(a) & 0xFF] | ((uint32_t)x[((b) >> 8) & 0xFF] << 8) |         \
+      ((uint32_t)x[((c) >> 16) & 0xFF] << 16) | ((uint32_t)x[(d) >> 24] << 24)) \
+     ^ Load32(k))
+
+//  Row r of output column c comes from column c + r (ShiftRows)
+#define TABLE_ENC(C, k, n0, n1, n2, n3, s0, s1, s2, s3)                         \
+    n0 = C(k, s0, s1, s2, s3);                                                  \
+    n1 = C(k + 4, s1, s2, s3, s0);                                              \
+    n2 = C(k + 8, s2, s3, s0, s1);                                              \
+    n3 = C(k + 12, s3, s0, s1, s2)
+
+//  Row r of output column c comes from column c - r (InvShiftRows)
+#define TABLE_DEC(C, k, n0, n1, n2, n3, s0, s1, s2, s3)                         \
+    n0 = C(k, s0, s3, s2, s1);                                                  \
+    n1 = C(k + 4, s1, s0, s3, s2);                                              \
+    n2 = C(k + 8, s2, s1, s0, s3);                                              \
+    n3 = C(k + 12, s3, s2, s1, s0)
+
+#define TE_COLUMN(k, a, b, c, d)    TABLE_COLUMN(t.te, k, a, b, c, d)
+#define TD_COLUMN(k, a, b, c, d)    TABLE_COLUMN(t.td, k, a, b, c, d)
+#define TE_LAST(k, a, b, c, d)      TABLE_LAST(sbox, k, a, b, c, d)
+#define TD_LAST(k, a, b, c, d)      TABLE_LAST(t.invSbox, k, a, b, c, d)
+
+/**
+ *  Encrypt a single block with T-tables
+ *  @param t Lookup tables
+ *  @param keys Round keys of the cipher
+ *  @param in Plaintext block
+ *  @param out Ciphertext block, may be the same as in
+ */
+static inline void TableEncryptBlock(AESTables const &t, uint8_t const (*keys)[16],
+                                     uint8_t const *in, uint8_t *out)
+{
+    uint32_t s0 = Load32(in) ^ Load32(keys[0]),
+             s1 = Load32(in + 4) ^ Load32(keys[0] + 4),
+             s2 = Load32(in + 8) ^ Load32(keys[0] + 8),
+             s3 = Load32(in + 12) ^ Load32(keys[0] + 12);
+    uint32_t n0, n1, n2, n3;
+
+    //  Two rounds per iteration, so that state doesn't have to be copied
+    for (uint8_t r = 1; r < AES_ROUNDS - 1; r += 2)
+    {
+        TABLE_ENC(TE_COLUMN, keys[r], n0, n1, n2, n3, s0, s1, s2, s3);
+        TABLE_ENC(TE_COLUMN, keys[r+1], s0, s1, s2, s3, n0, n1, n2, n3);
+    }
+    TABLE_ENC(TE_COLUMN, keys[AES_ROUNDS - 1], n0, n1, n2, n3, s0, s1, s2, s3);
+    TABLE_ENC(TE_LAST, keys[AES_ROUNDS], s0, s1, s2, s3, n0, n1, n2, n3);
+
+    Store32(out, s0);
+    Store32(out + 4, s1);
+    Store32(out + 8, s2);
+    Store32(out + 12, s3);
+}
+
+/**
+ *  Decrypt a single block with T-tables (equivalent inverse cipher)
+ *  @param t Lookup tables
+ *  @param keys Round keys of the equivalent inverse cipher
+ *  @param in Ciphertext block
+ *  @param out Plaintext block, may be the same as in
+ */
+static inline void TableDecryptBlock(AESTables const &t, uint8_t const (*keys)[16],
+                                     uint8_t const *in, uint8_t *out)
+{
+    uint32_t s0 = Load32(in) ^ Load32(keys[0]),
+             s1 = Load32(in + 4) ^ Load32(keys[0] + 4),
+             s2 = Load32(in + 8) ^ Load32(keys[0] + 8),
+             s3 = Load32(in + 12) ^ Load32(keys[0] + 12);
+    uint32_t n0, n1, n2, n3;
+
+    for (uint8_t r = 1; r < AES_ROUNDS - 1; r += 2)
+    {
+        TABLE_DEC(TD_COLUMN, keys[r], n0, n1, n2, n3, s0, s1, s2, s3);
+        TABLE_DEC(TD_COLUMN, keys[r+1], s0, s1, s2, s3, n0, n1, n2, n3);
+    }
+    TABLE_DEC(TD_COLUMN, keys[AES_ROUNDS - 1], n0, n1, n2, n3, s0, s1, s2, s3);
+    TABLE_DEC(TD_LAST, keys[AES_ROUNDS], s0, s1, s2, s3, n0, n1, n2, n3);
+
+    Store32(out, s0);
+    Store32(out + 4, s1);
+    Store32(out + 8, s2);
+    Store32(out + 12, s3);
+}
+
+//------------------------------------------------------------------------------
+//      Bitsliced kernels                                              [PRIVATE]
+//------------------------------------------------------------------------------
+/**
+ *  Bitsliced state of 8 blocks, two groups of 4 blocks in 64-bit lanes of
+ *  128-bit vectors. Word i holds bit i of every byte of its 4 blocks, so one
+ *  logic instruction works on 512 bits of state. Layout of bytes within a word
+ *  follows BearSSL's aes_ct64: 16 bits per row, so rotating a word by 16 bits
+ *  moves every column to the next row.
+ */
+typedef uint64_t Slice __attribute__((vector_size(16)));
+
+#define SWAPN(cl, ch, s, x, y)                                                  \
+    do {                                                                        \
+        Slice a = (x), b = (y);                                                 \
+        (x) = (a & (uint64_t)(cl)) | ((b & (uint64_t)(cl)) << (s));             \
+        (y) = ((a & (uint64_t)(ch)) >> (s)) | (b & (uint64_t)(ch));             \
+    } while (0)
+
+/**
+ *  Transpose bits between words of state, its own inverse
+ */
+static inline void Ortho(Slice *q)
+{
+    SWAPN(0x5555555555555555ULL, 0xAAAAAAAAAAAAAAAAULL, 1, q[0], q[1]);
+    SWAPN(0x5555555555555555ULL, 0xAAAAAAAAAAAAAAAAULL, 1, q[2], q[3]);
+    SWAPN(0x5555555555555555ULL, 0xAAAAAAAAAAAAAAAAULL, 1, q[4], q[5]);
+    SWAPN(0x5555555555555555ULL, 0xAAAAAAAAAAAAAAAAULL, 1, q[6], q[7]);
+
+    SWAPN(0x3333333333333333ULL, 0xCCCCCCCCCCCCCCCCULL, 2, q[0], q[2]);
+    SWAPN(0x3333333333333333ULL, 0xCCCCCCCCCCCCCCCCULL, 2, q[1], q[3]);
+    SWAPN(0x3333333333333333ULL, 0xCCCCCCCCCCCCCCCCULL, 2, q[4], q[6]);
+    SWAPN(0x3333333333333333ULL, 0xCCCCCCCCCCCCCCCCULL, 2, q[5], q[7]);
+
+    SWAPN(0x0F0F0F0F0F0F0F0FULL, 0xF0F0F0F0F0F0F0F0ULL, 4, q[0], q[4]);
+    SWAPN(0x0F0F0F0F0F0F0F0FULL, 0xF0F0F0F0F0F0F0F0ULL, 4, q[1], q[5]);
+    SWAPN(0x0F0F0F0F0F0F0F0FULL, 0xF0F0F0F0F0F0F0F0ULL, 4, q[2], q[6]);
+    SWAPN(0x0F0F0F0F0F0F0F0FULL, 0xF0F0F0F0F0F0F0F0ULL, 4, q[3], q[7]);
+}
+
+/**
+ *  Spread bytes of a block over two words, ready for Ortho
+ */
+static inline void InterleaveIn(uint64_t *q0, uint64_t *q1, uint8_t const *block)
+{
+    uint64_t x0 = Load32(block), x1 = Load32(block + 4),
+             x2 = Load32(block + 8), x3 = Load32(block + 12);
+
+    x0 |= (x0 << 16);
+    x1 |= (x1 << 16);
+    x2 |= (x2 << 16);
+    x3 |= (x3 << 16);
+    x0 &= 0x0000FFFF0000FFFFULL;
+    x1 &= 0x0000FFFF0000FFFFULL;
+    x2 &= 0x0000FFFF0000FFFFULL;
+    x3 &= 0x0000FFFF0000FFFFULL;
+    x0 |= (x0 << 8);
+    x1 |= (x1 << 8);
+    x2 |= (x2 << 8);
+    x3 |= (x3 << 8);
+    x0 &= 0x00FF00FF00FF00FFULL;
+    x1 &= 0x00FF00FF00FF00FFULL;
+    x2 &= 0x00FF00FF00FF00FFULL;
+    x3 &= 0x00FF00FF00FF00FFULL;
+    *q0 = x0 | (x2 << 8);
+    *q1 = x1 | (x3 << 8);
+}
+
+/**
+ *  Gather bytes of a block back from two words, inverse of InterleaveIn
+ */
+static inline void InterleaveOut(uint8_t *block, uint64_t q0, uint64_t q1)
+{
+    uint64_t x0 = q0 & 0x00FF00FF00FF00FFULL, x1 = q1 & 0x00FF00FF00FF00FFULL,
+             x2 = (q0 >> 8) & 0x00FF00FF00FF00FFULL,
+             x3 = (q1 >> 8) & 0x00FF00FF00FF00FFULL;
+
+    x0 |= (x0 >> 8);
+    x1 |= (x1 >> 8);
+    x2 |= (x2 >> 8);
+    x3 |= (x3 >> 8);
+    x0 &= 0x0000FFFF0000FFFFULL;
+    x1 &= 0x0000FFFF0000FFFFULL;
+    x2 &= 0x0000FFFF0000FFFFULL;
+    x3 &= 0x0000FFFF0000FFFFULL;
+    Store32(block, (uint32_t)x0 | (uint32_t)(x0 >> 16));
+    Store32(block + 4, (uint32_t)x1 | (uint32_t)(x1 >> 16));
+    Store32(block + 8, (uint32_t)x2 | (uint32_t)(x2 >> 16));
+    Store32(block + 12, (uint32_t)x3 | (uint32_t)(x3 >> 16));
+}
+
+/**
+ *  Bitslice 8 blocks, blocks 0-3 go to the first lane and 4-7 to the second
+ */
+static inline void SliceIn(Slice *q, uint8_t const *in)
+{
+    uint64_t w[2][8];
+
+    for (uint8_t l = 0; l < 2; l++)
+        for (uint8_t i = 0; i < 4; i++)
+            InterleaveIn(&w[l][i], &w[l][i + 4], in + 16 * (4*l + i));
+
+    for (uint8_t i = 0; i < 8; i++)
+    {
+        Slice v = { w[0][i], w[1][i] };
+        q[i] = v;
+    }
+    Ortho(q);
+}
+
+static inline void SliceOut(uint8_t *out, Slice *q)
+{
+    Ortho(q);
+    for (uint8_t l = 0; l < 2; l++)
+        for (uint8_t i = 0; i < 4; i++)
+            InterleaveOut(out + 16 * (4*l + i), q[i][l], q[i + 4][l]);
+}
+
+/**
+ *  SubBytes on bitsliced state, circuit of Boyar and Peralta (113 gates)
+ */
+static inline void SubBytes(Slice *q)
+{
+    Slice x0 = q[7], x1 = q[6], x2 = q[5], x3 = q[4],
+          x4 = q[3], x5 = q[2], x6 = q[1], x7 = q[0];
+    Slice y1, y2, y3, y4, y5, y6, y7, y8, y9, y10, y11, y12, y13, y14, y15,
+          y16, y17, y18, y19, y20, y21;
+    Slice z0, z1, z2, z3, z4, z5, z6, z7, z8, z9, z10, z11, z12, z13, z14,
+          z15, z16, z17;
+    Slice t0, t1, t2, t3, t4, t5, t6, t7, t8, t9, t10, t11, t12, t13, t14,
+          t15, t16, t17, t18, t19, t20, t21, t22, t23, t24, t25, t26, t27, t28,
+          t29, t30, t31, t32, t33, t34, t35, t36, t37, t38, t39, t40, t41, t42,
+          t43, t44, t45, t46, t47, t48, t49, t50, t51, t52, t53, t54, t55, t56,
+          t57, t58, t59, t60, t61, t62, t63, t64, t65, t66, t67;
+
+    //  Top linear transformation
+    y14 = x3 ^ x5;
+    y13 = x0 ^ x6;
+    y9 = x0 ^ x3;
+    y8 = x0 ^ x5;
+    t0 = x1 ^ x2;
+    y1 = t0 ^ x7;
+    y4 = y1 ^ x3;
+    y12 = y13 ^ y14;
+    y2 = y1 ^ x0;
+    y5 = y1 ^ x6;
+    y3 = y5 ^ y8;
+    t1 = x4 ^ y12;
+    y15 = t1 ^ x5;
+    y20 = t1 ^ x1;
+    y6 = y15 ^ x7;
+    y10 = y15 ^ t0;
+    y11 = y20 ^ y9;
+    y7 = x7 ^ y11;
+    y17 = y10 ^ y11;
+    y19 = y10 ^ y8;
+    y16 = t0 ^ y11;
+    y21 = y13 ^ y16;
+    y18 = x0 ^ y16;
+
+    //  Non-linear section
+    t2 = y12 & y15;
+    t3 = y3 & y6;
+    t4 = t3 ^ t2;
+    t5 = y4 & x7;
+    t6 = t5 ^ t2;
+    t7 = y13 & y16;
+    t8 = y5 & y1;
+    t9 = t8 ^ t7;
+    t10 = y2 & y7;
+    t11 = t10 ^ t7;
+    t12 = y9 & y11;
+    t13 = y14 & y17;
+    t14 = t13 ^ t12;
+    t15 = y8 & y10;
+    t16 = t15 ^ t12;
+    t17 = t4 ^ t14;
+    t18 = t6 ^ t16;
+    t19 = t9 ^ t14;
+    t20 = t11 ^ t16;
+    t21 = t17 ^ y20;
+    t22 = t18 ^ y19;
+    t23 = t19 ^ y21;
+    t24 = t20 ^ y18;
+
+    t25 = t21 ^ t22;
+    t26 = t21 & t23;
+    t27 = t24 ^ t26;
+    t28 = t25 & t27;
+    t29 = t28 ^ t22;
+    t30 = t23 ^ t24;
+    t31 = t22 ^ t26;
+    t32 = t31 & t30;
+    t33 = t32 ^ t24;
+    t34 = t23 ^ t33;
+    t35 = t27 ^ t33;
+    t36 = t24 & t35;
+    t37 = t36 ^ t34;
+    t38 = t27 ^ t36;
+    t39 = t29 & t38;
+    t40 = t25 ^ t39;
+
+    t41 = t40 ^ t37;
+    t42 = t29 ^ t33;
+    t43 = t29 ^ t40;
+    t44 = t33 ^ t37;
+    t45 = t42 ^ t41;
+    z0 = t44 & y15;
+    z1 = t37 & y6;
+    z2 = t33 & x7;
+    z3 = t43 & y16;
+    z4 = t40 & y1;
+    z5 = t29 & y7;
+    z6 = t42 & y11;
+    z7 = t45 & y17;
+    z8 = t41 & y10;
+    z9 = t44 & y12;
+    z10 = t37 & y3;
+    z11 = t33 & y4;
+    z12 = t43 & y13;
+    z13 = t40 & y5;
+    z14 = t29 & y2;
+    z15 = t42 & y9;
+    z16 = t45 & y14;
+    z17 = t41 & y8;
+
+    //  Bottom linear transformation
+    t46 = z15 ^ z16;
+    t47 = z10 ^ z11;
+    t48 = z5 ^ z13;
+    t49 = z9 ^ z10;
+    t50 = z2 ^ z12;
+    t51 = z2 ^ z5;
+    t52 = z7 ^ z8;
+    t53 = z0 ^ z3;
+    t54 = z6 ^ z7;
+    t55 = z16 ^ z17;
+    t56 = z12 ^ t48;
+    t57 = t50 ^ t53;
+    t58 = z4 ^ t46;
+    t59 = z3 ^ t54;
+    t60 = t46 ^ t57;
+    t61 = z14 ^ t57;
+    t62 = t52 ^ t58;
+    t63 = t49 ^ t58;
+    t64 = z4 ^ t59;
+    t65 = t61 ^ t62;
+    t66 = z1 ^ t63;
+    q[7] = t59 ^ t63;
+    q[1] = t56 ^ ~t62;
+    q[0] = t48 ^ ~t60;
+    t67 = t64 ^ t65;
+    q[4] = t53 ^ t66;
+    q[3] = t51 ^ t66;
+    q[2] = t47 ^ t65;
+    q[6] = t64 ^ ~q[4];
+    q[5] = t55 ^ ~t67;
+}
+
+/**
+ *  Inverse affine transformation of S-box (with its constant), applied on both
+ *  sides of SubBytes it gives InvSubBytes
+ */
+static inline void InvAffine(Slice *q)
+{
+    Slice q0 = ~q[0], q1 = ~q[1], q2 = q[2], q3 = q[3],
+          q4 = q[4], q5 = ~q[5], q6 = ~q[6], q7 = q[7];
+
+    q[7] = q1 ^ q4 ^ q6;
+    q[6] = q0 ^ q3 ^ q5;
+    q[5] = q7 ^ q2 ^ q4;
+    q[4] = q6 ^ q1 ^ q3;
+    q[3] = q5 ^ q0 ^ q2;
+    q[2] = q4 ^ q7 ^ q1;
+    q[1] = q3 ^ q6 ^ q0;
+    q[0] = q2 ^ q5 ^ q7;
+}
+
+static inline void InvSubBytes(Slice *q)
+{
+    InvAffine(q);
+    SubBytes(q);
+    InvAffine(q);
+}
+
+static inline void ShiftRows(Slice *q)
+{
+    for (uint8_t i = 0; i < 8; i++)
+    {
+        Slice x = q[i];
+        q[i] = (x & 0x000000000000FFFFULL)
+             | ((x & 0x00000000FFF00000ULL) >> 4)
+             | ((x & 0x00000000000F0000ULL) << 12)
+             | ((x & 0x0000FF0000000000ULL) >> 8)
+             | ((x & 0x000000FF00000000ULL) << 8)
+             | ((x & 0xF000000000000000ULL) >> 12)
+             | ((x & 0x0FFF000000000000ULL) << 4);
+    }
+}
+
+static inline void InvShiftRows(Slice *q)
+{
+    for (uint8_t i = 0; i < 8; i++)
+    {
+        Slice x = q[i];
+        q[i] = (x & 0x000000000000FFFFULL)
+             | ((x & 0x000000000FFF0000ULL) << 4)
+             | ((x & 0x00000000F0000000ULL) >> 12)
+             | ((x & 0x000000FF00000000ULL) << 8)
+             | ((x & 0x0000FF0000000000ULL) >> 8)
+             | ((x & 0x000F000000000000ULL) << 12)
+             | ((x & 0xFFF0000000000000ULL) >> 4);
+    }
+}
+
+/**
+ *  Rotate word by one and two rows
+ */
+static inline Slice Rot16(Slice x)
+{
+    return (x >> 16) | (x << 48);
+}
+
+static inline Slice Rot32(Slice x)
+{
+    return (x >> 32) | (x << 32);
+}
+
+/**
+ *  Row j of a column becomes 2*(a_j + a_j+1) + a_j+1 + (a_j+2 + a_j+3), where
+ *  multiplying by 2 shifts bit planes and folds bit 7 back by AES polynomial
+ */
+static inline void MixColumns(Slice *q)
+{
+    Slice q0 = q[0], q1 = q[1], q2 = q[2], q3 = q[3],
+          q4 = q[4], q5 = q[5], q6 = q[6], q7 = q[7];
+    Slice r0 = Rot16(q0), r1 = Rot16(q1), r2 = Rot16(q2), r3 = Rot16(q3),
+          r4 = Rot16(q4), r5 = Rot16(q5), r6 = Rot16(q6), r7 = Rot16(q7);
+
+    q[0] = q7 ^ r7 ^ r0 ^ Rot32(q0 ^ r0);
+    q[1] = q0 ^ r0 ^ q7 ^ r7 ^ r1 ^ Rot32(q1 ^ r1);
+    q[2] = q1 ^ r1 ^ r2 ^ Rot32(q2 ^ r2);
+    q[3] = q2 ^ r2 ^ q7 ^ r7 ^ r3 ^ Rot32(q3 ^ r3);
+    q[4] = q3 ^ r3 ^ q7 ^ r7 ^ r4 ^ Rot32(q4 ^ r4);
+    q[5] = q4 ^ r4 ^ r5 ^ Rot32(q5 ^ r5);
+    q[6] = q5 ^ r5 ^ r6 ^ Rot32(q6 ^ r6);
+    q[7] = q6 ^ r6 ^ r7 ^ Rot32(q7 ^ r7);
+}
+
+/**
+ *  Multiply every byte by 2 in GF(2^8), on bit planes
+ */
+static inline void Mul2(Slice *q)
+{
+    Slice hi = q[7];
+
+    q[7] = q[6];
+    q[6] = q[5];
+    q[5] = q[4];
+    q[4] = q[3] ^ hi;
+    q[3] = q[2] ^ hi;
+    q[2] = q[1];
+    q[1] = q[0] ^ hi;
+    q[0] = hi;
+}
+
+/**
+ *  InvMixColumns polynomial is MixColumns one times 4x^2 + 5, so columns are
+ *  first mapped to 5*a_j + 4*a_j+2 and then mixed as in encryption
+ */
+static inline void InvMixColumns(Slice *q)
+{
+    Slice p[8];
+
+    for (uint8_t i = 0; i < 8; i++)
+        p[i] = q[i] ^ Rot32(q[i]);
+    Mul2(p);
+    Mul2(p);
+    for (uint8_t i = 0; i < 8; i++)
+        q[i] ^= p[i];
+
+    MixColumns(q);
+}
+
+static inline void AddRoundKey(Slice *q, uint64_t const *k)
+{
+    for (uint8_t i = 0; i < 8; i++)
+        q[i] ^= k[i];
+}
+
+/**
+ *  Encrypt 8 blocks, bitsliced
+ *  @param keys Bitsliced round keys of the cipher
+ *  @param in 8 blocks of plaintext
+ *  @param out 8 blocks of ciphertext, may be the same as in
+ */
+static void BitsliceEncrypt8(uint64_t const (*keys)[8], uint8_t const *in,
+                             uint8_t *out)
+{
+    Slice q[8];
+
+    SliceIn(q, in);
+    AddRoundKey(q, keys[0]);
+    for (uint8_t r = 1; r < AES_ROUNDS; r++)
+    {
+        SubBytes(q);
+        ShiftRows(q);
+        MixColumns(q);
+        AddRoundKey(q, keys[r]);
+    }
+    SubBytes(q);
+    ShiftRows(q);
+    AddRoundKey(q, keys[AES_ROUNDS]);
+    SliceOut(out, q);
+}
+
+/**
+ *  Decrypt 8 blocks, bitsliced (straightforward inverse cipher)
+ *  @param keys Bitsliced round keys of the cipher
+ *  @param in 8 blocks of ciphertext
+ *  @param out 8 blocks of plaintext, may be the same as in
+ */
+static void BitsliceDecrypt8(uint64_t const (*keys)[8], uint8_t const *in,
+                             uint8_t *out)
+{
+    Slice q[8];
+
+    SliceIn(q, in);
+    AddRoundKey(q, keys[AES_ROUNDS]);
+    for (uint8_t r = AES_ROUNDS - 1; r > 0; r--)
+    {
+        InvShiftRows(q);
+        InvSubBytes(q);
+        AddRoundKey(q, keys[r]);
+        InvMixColumns(q);
+    }
+    InvShiftRows(q);
+    InvSubBytes(q);
+    AddRoundKey(q, keys[0]);
+    SliceOut(out, q);
+}
+
+/**
+ *  Bitslice round keys of the cipher, each key is repeated for all 4 blocks
+ *  of a lane
+ *  @param sliced [out] Bitsliced round keys
+ *  @param keys Round keys of the cipher
+ */
+static void SliceKeys(uint64_t (*sliced)[8], uint8_t const (*keys)[16])
+{
+    for (uint8_t r = 0; r <= AES_ROUNDS; r++)
+    {
+        uint8_t copies[8 * 16];
+        Slice q[8];
+
+        for (uint8_t b = 0; b < 8; b++)
+            memcpy(copies + 16 * b, keys[r], 16);
+        SliceIn(q, copies);
+        for (uint8_t i = 0; i < 8; i++)
+            sliced[r][i] = q[i][0];
+    }
+}
+
+/**
+ *  Substitute bytes of a word of key expansion through the S-box circuit,
+ *  so that key bytes never index a table
+ *  @param w 4 bytes, substituted in place
+ */
+static void SliceSubWord(uint8_t *w)
+{
+    uint8_t blocks[SLICE_BLOCKS * 16] = { 0 };
+    Slice q[8];
+
+    memcpy(blocks, w, 4);
+    SliceIn(q, blocks);
+    SubBytes(q);
+    SliceOut(blocks, q);
+    memcpy(w, blocks, 4);
+}
+
+//------------------------------------------------------------------------------
+//      AES-NI kernels                                                 [PRIVATE]
+//------------------------------------------------------------------------------
+#ifdef AES_X86
+//  Apply one round (aesenc, aesdec...) with round key k to all 8 blocks
+#define AESNI_ROUND8(op, k)                                                     \
+    b0 = op(b0, k); b1 = op(b1, k); b2 = op(b2, k); b3 = op(b3, k);             \
+    b4 = op(b4, k); b5 = op(b5, k); b6 = op(b6, k); b7 = op(b7, k)
+
+/**
+ *  Run blocks through the cipher (or the equivalent inverse cipher) with AES-NI
+ *  @param keys Round keys in order of use
+ *  @param in Input blocks
+ *  @param out Output blocks, may be the same as in
+ *  @param blocks Number of blocks
+ *  @param decrypt Use aesdec instead of aesenc
+ */
+__attribute__((target("aes,sse2")))
+static inline void AESNIBlocks(uint8_t const (*keys)[16], uint8_t const *in,
+                               uint8_t *out, size_t blocks, bool decrypt)
+{
+    __m128i k[AES_ROUNDS + 1];
+    size_t i = 0;
+
+    for (uint8_t r = 0; r <= AES_ROUNDS; r++)
+        k[r] = _mm_loadu_si128((__m128i const*)keys[r]);
+
+    for (; i + AESNI_LANES <= blocks; i += AESNI_LANES)
+    {
+        __m128i const *src = (__m128i const*)(in + i * 16);
+        __m128i *dst = (__m128i*)(out + i * 16);
+        __m128i b0 = _mm_xor_si128(_mm_loadu_si128(src + 0), k[0]);
+        __m128i b1 = _mm_xor_si128(_mm_loadu_si128(src + 1), k[0]);
+        __m128i b2 = _mm_xor_si128(_mm_loadu_si128(src + 2), k[0]);
+        __m128i b3 = _mm_xor_si128(_mm_loadu_si128(src + 3), k[0]);
+        __m128i b4 = _mm_xor_si128(_mm_loadu_si128(src + 4), k[0]);
+        __m128i b5 = _mm_xor_si128(_mm_loadu_si128(src + 5), k[0]);
+        __m128i b6 = _mm_xor_si128(_mm_loadu_si128(src + 6), k[0]);
+        __m128i b7 = _mm_xor_si128(_mm_loadu_si128(src + 7), k[0]);
+
+        if (decrypt)
+        {
+            for (uint8_t r = 1; r < AES_ROUNDS; r++)
+            {
+                AESNI_ROUND8(_mm_aesdec_si128, k[r]);
+            }
+            AESNI_ROUND8(_mm_aesdeclast_si128, k[AES_ROUNDS]);
+        }
+        else
+        {
+            for (uint8_t r = 1; r < AES_ROUNDS; r++)
+            {
+                AESNI_ROUND8(_mm_aesenc_si128, k[r]);
+            }
+            AESNI_ROUND8(_mm_aesenclast_si128, k[AES_ROUNDS]);
+        }
+
+        _mm_storeu_si128(dst + 0, b0);
+        _mm_storeu_si128(dst + 1, b1);
+        _mm_storeu_si128(dst + 2, b2);
+        _mm_storeu_si128(dst + 3, b3);
+        _mm_storeu_si128(dst + 4, b4);
+        _mm_storeu_si128(dst + 5, b5);
+        _mm_storeu_si128(dst + 6, b6);
+        _mm_storeu_si128(dst + 7, b7);
+    }
+
+    //  Leftover blocks one at a time
+    for (; i < blocks; i++)
+    {
+        __m128i b = _mm_xor_si128(_mm_loadu_si128((__m128i const*)(in + i * 16)), k[0]);
+
+        for (uint8_t r = 1; r < AES_ROUNDS; r++)
+            b = decrypt ? _mm_aesdec_si128(b, k[r]) : _mm_aesenc_si128(b, k[r]);
+        b = decrypt ? _mm_aesdeclast_si128(b, k[AES_ROUNDS])
+                    : _mm_aesenclast_si128(b, k[AES_ROUNDS]);
+
+        _mm_storeu_si128((__m128i*)(out + i * 16), b);
+    }
+}
+
+//  Round key r of lane l
+#define LANE_KEY(l, r)  _mm_loadu_si128((__m128i const*)rk[l]->enc[r])
+//  Apply round r to all 8 blocks, every block with a round key of its own lane
+#define AESNI_LANE_ROUND8(op, r)                                                \
+    b0 = op(b0, LANE_KEY(0, r)); b1 = op(b1, LANE_KEY(1, r));                  \
+    b2 = op(b2, LANE_KEY(2, r)); b3 = op(b3, LANE_KEY(3, r));                  \
+    b4 = op(b4, LANE_KEY(4, r)); b5 = op(b5, LANE_KEY(5, r));                  \
+    b6 = op(b6, LANE_KEY(6, r)); b7 = op(b7, LANE_KEY(7, r))
+
+/**
+ *  Encrypt 8 blocks in place, each with the key of its own lane
+ *  @param rk Expanded key of every lane
+ *  @param blocks 8 consecutive blocks
+ */
+__attribute__((target("aes,sse2")))
+static inline void AESNILanes8(AESRoundKeys const *const *rk, uint8_t *blocks)
+{
+    __m128i *b = (__m128i*)blocks;
+    __m128i b0 = _mm_loadu_si128(b + 0), b1 = _mm_loadu_si128(b + 1),
+            b2 = _mm_loadu_si128(b + 2), b3 = _mm_loadu_si128(b + 3),
+            b4 = _mm_loadu_si128(b + 4), b5 = _mm_loadu_si128(b + 5),
+            b6 = _mm_loadu_si128(b + 6), b7 = _mm_loadu_si128(b + 7);
+
+    AESNI_LANE_ROUND8(_mm_xor_si128, 0);
+    for (uint8_t r = 1; r < AES_ROUNDS; r++)
+    {
+        AESNI_LANE_ROUND8(_mm_aesenc_si128, r);
+    }
+    AESNI_LANE_ROUND8(_mm_aesenclast_si128, AES_ROUNDS);
+
+    _mm_storeu_si128(b + 0, b0);
+    _mm_storeu_si128(b + 1, b1);
+    _mm_storeu_si128(b + 2, b2);
+    _mm_storeu_si128(b + 3, b3);
+    _mm_storeu_si128(b + 4, b4);
+    _mm_storeu_si128(b + 5, b5);
+    _mm_storeu_si128(b + 6, b6);
+    _mm_storeu_si128(b + 7, b7);
+}
+#endif
+
+//------------------------------------------------------------------------------
+//      Engine support and key expansion                                [PUBLIC]
+//------------------------------------------------------------------------------
+/**
+ *  Check whether CPU supports AES-NI instructions (from CPUID)
+ *  @return True if AES-NI engine can be used
+ */
+bool AESCoreHasAESNI()
+{
+#ifdef AES_X86
+    static const bool has = (__builtin_cpu_init(), __builtin_cpu_supports("aes"));
+    return has;
+#else
+    return false;
+#endif
+}
+
+/**
+ *  Expand AES-128 key into round keys for encryption and decryption, in
+ *  constant time (S-box is the bitsliced circuit, GF(2^8) products have no
+ *  branches)
+ *  @param rk [out] Expanded key
+ *  @param key 16 bytes of key
+ */
+void AESCoreExpandKey(AESRoundKeys *rk, uint8_t const *key)
+{
+    uint8_t rcon = 0x01;
+
+    memcpy(rk->enc[0], key, 16);
+    for (uint8_t r = 1; r <= AES_ROUNDS; r++)
+    {
+        uint8_t const *prev = rk->enc[r-1];
+        uint8_t *next = rk->enc[r];
+
+        //  First word: rotated, substituted last word of previous round key
+        uint8_t word[4] = { prev[13], prev[14], prev[15], prev[12] };
+        SliceSubWord(word);
+        next[0] = prev[0] ^ word[0] ^ rcon;
+        for (uint8_t i = 1; i < 4; i++)
+            next[i] = prev[i] ^ word[i];
+        for (uint8_t i = 4; i < 16; i++)
+            next[i] = prev[i] ^ next[i-4];
+
+        rcon = XTime(rcon);
+    }
+
+    memcpy(rk->dec[0], rk->enc[AES_ROUNDS], 16);
+    for (uint8_t r = 1; r < AES_ROUNDS; r++)
+        InvMixRoundKey(rk->dec[r], rk->enc[AES_ROUNDS - r]);
+    memcpy(rk->dec[AES_ROUNDS], rk->enc[0], 16);
+
+    SliceKeys(rk->sliced, rk->enc);
+}
+
+//------------------------------------------------------------------------------
+//      AES-NI engine                                                   [PUBLIC]
+//------------------------------------------------------------------------------
+/**
+ *  Encrypt consecutive blocks independently of each other (ECB) with AES-NI,
+ *  8 blocks at a time in flight. Only to be called if AESCoreHasAESNI().
+ *  @param rk Expanded key
+ *  @param in Plaintext
+ *  @param out Ciphertext, may be the same as in
+ *  @param blocks Number of blocks
+ */
+void AESNIEncryptBlocks(AESRoundKeys const *rk, uint8_t const *in, uint8_t *out,
+                        size_t blocks)
+{
+#ifdef AES_X86
+    AESNIBlocks(rk->enc, in, out, blocks, false);
+#endif
+}
+
+/**
+ *  Decrypt consecutive blocks independently of each other (ECB) with AES-NI,
+ *  8 blocks at a time in flight. Only to be called if AESCoreHasAESNI().
+ *  @param rk Expanded key
+ *  @param in Ciphertext
+ *  @param out Plaintext, may be the same as in
+ *  @param blocks Number of blocks
+ */
+void AESNIDecryptBlocks(AESRoundKeys const *rk, uint8_t const *in, uint8_t *out,
+                        size_t blocks)
+{
+#ifdef AES_X86
+    AESNIBlocks(rk->dec, in, out, blocks, true);
+#endif
+}
+
+/**
+ *  Encrypt one block of each of several independent streams (lanes), every
+ *  lane with its own key, 8 lanes at a time in flight. Only to be called if
+ *  AESCoreHasAESNI().
+ *  Groups of fewer than 8 lanes still go through the 8-lane kernel, padded
+ *  with copies of the first lane: rounds of few blocks are bound by latency of
+ *  aesenc, so extra lanes come for free.
+ *  @param rk Expanded key of every lane
+ *  @param blocks One block of every lane, consecutive, encrypted in place
+ *  @param lanes Number of lanes
+ */
+void AESNIEncryptLanes(AESRoundKeys const *const *rk, uint8_t *blocks,
+                       size_t lanes)
+{
+#ifdef AES_X86
+    size_t i = 0;
+
+    for (; i + AESNI_LANES <= lanes; i += AESNI_LANES)
+        AESNILanes8(rk + i, blocks + i * 16);
+
+    if (i < lanes)
+    {
+        AESRoundKeys const *padKeys[AESNI_LANES];
+        uint8_t padBlocks[AESNI_LANES * 16];
+        size_t n = lanes - i;
+
+        for (size_t l = 0; l < AESNI_LANES; l++)
+            padKeys[l] = rk[i + ((l < n) ? l : 0)];
+        memcpy(padBlocks, blocks + i * 16, n * 16);
+        memset(padBlocks + n * 16, 0, (AESNI_LANES - n) * 16);
+
+        AESNILanes8(padKeys, padBlocks);
+        memcpy(blocks + i * 16, padBlocks, n * 16);
+    }
+#endif
+}
+
+//------------------------------------------------------------------------------
+//      Software engines                                                [PUBLIC]
+//------------------------------------------------------------------------------
+/**
+ *  Encrypt consecutive blocks independently of each other (ECB) with T-tables,
+ *  one block at a time
+ *  @param rk Expanded key
+ *  @param in Plaintext
+ *  @param out Ciphertext, may be the same as in
+ *  @param blocks Number of blocks
+ */
+void AESTableEncryptBlocks(AESRoundKeys const *rk, uint8_t const *in, uint8_t *out,
+                           size_t blocks)
+{
+    AESTables const &t = Tables();
+
+    for (size_t i = 0; i < blocks; i++)
+        TableEncryptBlock(t, rk->enc, in + 16 * i, out + 16 * i);
+}
+
+/**
+ *  Decrypt consecutive blocks independently of each other (ECB) with T-tables,
+ *  one block at a time
+ *  @param rk Expanded key
+ *  @param in Ciphertext
+ *  @param out Plaintext, may be the same as in
+ *  @param blocks Number of blocks
+ */
+void AESTableDecryptBlocks(AESRoundKeys const *rk, uint8_t const *in, uint8_t *out,
+                           size_t blocks)
+{
+    AESTables const &t = Tables();
+
+    for (size_t i = 0; i < blocks; i++)
+        TableDecryptBlock(t, rk->dec, in + 16 * i, out + 16 * i);
+}
+
+/**
+ *  Encrypt consecutive blocks independently of each other (ECB), bitsliced 8
+ *  blocks at a time. Leftover blocks are padded to a full group of 8, so no
+ *  block ever goes through a table lookup.
+ *  @param rk Expanded key
+ *  @param in Plaintext
+ *  @param out Ciphertext, may be the same as in
+ *  @param blocks Number of blocks
+ */
+void AESBitsliceEncryptBlocks(AESRoundKeys const *rk, uint8_t const *in,
+                              uint8_t *out, size_t blocks)
+{
+    size_t i = 0;
+
+    for (; i + SLICE_BLOCKS <= blocks; i += SLICE_BLOCKS)
+        BitsliceEncrypt8(rk->sliced, in + 16 * i, out + 16 * i);
+
+    if (i < blocks)
+    {
+        uint8_t pad[SLICE_BLOCKS * 16] = { 0 };
+        size_t n = (blocks - i) * 16;
+
+        memcpy(pad, in + 16 * i, n);
+        BitsliceEncrypt8(rk->sliced, pad, pad);
+        memcpy(out + 16 * i, pad, n);
+    }
+}
+
+/**
+ *  Decrypt consecutive blocks independently of each other (ECB), bitsliced 8
+ *  blocks at a time. Leftover blocks are padded to a full group of 8, so no
+ *  block ever goes through a table lookup.
+ *  @param rk Expanded key
+ *  @param in Ciphertext
+ *  @param out Plaintext, may be the same as in
+ *  @param blocks Number of blocks
+ */
+void AESBitsliceDecryptBlocks(AESRoundKeys const *rk, uint8_t const *in,
+                              uint8_t *out, size_t blocks)
+{
+    size_t i = 0;
+
+    for (; i + SLICE_BLOCKS <= blocks; i += SLICE_BLOCKS)
+        BitsliceDecrypt8(rk->sliced, in + 16 * i, out + 16 * i);
+
+    if (i < blocks)
+    {
+        uint8_t pad[SLICE_BLOCKS * 16] = { 0 };
+        size_t n = (blocks - i) * 16;
+
+        memcpy(pad, in + 16 * i, n);
+        BitsliceDecrypt8(rk->sliced, pad, pad);
+        memcpy(out + 16 * i, pad, n);
+    }
+}
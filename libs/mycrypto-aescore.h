@@ -0,0 +1,125 @@
+/**
+ *    Native AES-128 block engines used by mycrypto-aes
+ *    Engines work on raw blocks with an expanded key, modes of operation and
+ *    padding are left to mycrypto-aes. Hardware engine uses AES-NI
+ *    instructions and is only usable if CPUID reports them, software engines
+ *    (T-table and bitsliced) run anywhere.
+ *
+ *    Created: 17. Oct 2026.
+ *    Author: Vedran Mikov
+ */
+#ifndef MYCRYPTO_AESCORE_H_
+#define MYCRYPTO_AESCORE_H_
+
+#include <cstdint>
+#include <cstddef>
+
+//  Number of rounds of AES-128
+#define AES_ROUNDS      10
+
+/**
+ *  Expanded AES-128 key
+ */
+struct AESRoundKeys
+{
+    //  Round keys of the cipher, in order of use
+    uint8_t enc[AES_ROUNDS + 1][16];
+    //  Round keys of the equivalent inverse cipher, in order of use (last
+    //  round key first, with InvMixColumns applied to all but first and last)
+    uint8_t dec[AES_ROUNDS + 1][16];
+    //  Round keys of the cipher in bitsliced form, for bitsliced engine
+    uint64_t sliced[AES_ROUNDS + 1][8];
+};
+
+
+/**
+ *  Check whether CPU supports AES-NI instructions (from CPUID)
+ *  @return True if AES-NI engine can be used
+ */
+bool AESCoreHasAESNI();
+
+/**
+ *  Expand AES-128 key into round keys for encryption and decryption, in
+ *  constant time (S-box is the bitsliced circuit, GF(2^8) products have no
+ *  branches)
+ *  @param rk [out] Expanded key
+ *  @param key 16 bytes of key
+ */
+void AESCoreExpandKey(AESRoundKeys *rk, uint8_t const *key);
+
+/**
+ *  Encrypt consecutive blocks independently of each other (ECB) with AES-NI,
+ *  8 blocks at a time in flight. Only to be called if AESCoreHasAESNI().
+ *  @param rk Expanded key
+ *  @param in Plaintext
+ *  @param out Ciphertext, may be the same as in
+ *  @param blocks Number of blocks
+ */
+void AESNIEncryptBlocks(AESRoundKeys const *rk, uint8_t const *in, uint8_t *out,
+                        size_t blocks);
+/**
+ *  Decrypt consecutive blocks independently of each other (ECB) with AES-NI,
+ *  8 blocks at a time in flight. Only to be called if AESCoreHasAESNI().
+ *  @param rk Expanded key
+ *  @param in Ciphertext
+ *  @param out Plaintext, may be the same as in
+ *  @param blocks Number of blocks
+ */
+void AESNIDecryptBlocks(AESRoundKeys const *rk, uint8_t const *in, uint8_t *out,
+                        size_t blocks);
+/**
+ *  Encrypt one block of each of several independent streams (lanes), every
+ *  lane with its own key, 8 lanes at a time in flight. Only to be called if
+ *  AESCoreHasAESNI().
+ *  @param rk Expanded key of every lane
+ *  @param blocks One block of every lane, consecutive, encrypted in place
+ *  @param lanes Number of lanes
+ */
+void AESNIEncryptLanes(AESRoundKeys const *const *rk, uint8_t *blocks,
+                       size_t lanes);
+
+/**
+ *  Encrypt consecutive blocks independently of each other (ECB) with T-tables,
+ *  one block at a time
+ *  @param rk Expanded key
+ *  @param in Plaintext
+ *  @param out Ciphertext, may be the same as in
+ *  @param blocks Number of blocks
+ */
+void AESTableEncryptBlocks(AESRoundKeys const *rk, uint8_t const *in, uint8_t *out,
+                           size_t blocks);
+/**
+ *  Decrypt consecutive blocks independently of each other (ECB) with T-tables,
+ *  one block at a time
+ *  @param rk Expanded key
+ *  @param in Ciphertext
+ *  @param out Plaintext, may be the same as in
+ *  @param blocks Number of blocks
+ */
+void AESTableDecryptBlocks(AESRoundKeys const *rk, uint8_t const *in, uint8_t *out,
+                           size_t blocks);
+
+/**
+ *  Encrypt consecutive blocks independently of each other (ECB), bitsliced 8
+ *  blocks at a time. Leftover blocks are padded to a full group of 8, so no
+ *  block ever goes through a table lookup.
+ *  @param rk Expanded key
+ *  @param in Plaintext
+ *  @param out Ciphertext, may be the same as in
+ *  @param blocks Number of blocks
+ */
+void AESBitsliceEncryptBlocks(AESRoundKeys const *rk, uint8_t const *in,
+                              uint8_t *out, size_t blocks);
+/**
+ *  Decrypt consecutive blocks independently of each other (ECB), bitsliced 8
+ *  blocks at a time. Leftover blocks are padded to a full group of 8, so no
+ *  block ever goes through a table lookup.
+ *  @param rk Expanded key
+ *  @param in Ciphertext
+ *  @param out Plaintext, may be the same as in
+ *  @param blocks Number of blocks
+ */
+void AESBitsliceDecryptBlocks(AESRoundKeys const *rk, uint8_t const *in,
+                              uint8_t *out, size_t blocks);
+
+#endif  /* MYCRYPTO_AESCORE_H_ */
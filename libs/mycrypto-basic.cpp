@@ -2,21 +2,33 @@
  *    Implementation of basic functions required in set 1 of crypto challenge
  *    Description
  *
- *      TODO: Implement decoding from base64 to ASCII
- *
  *    Created: 20. Oct 2017.
  *    Author: Vedran Mikov
  */
 #include <cstdlib>
 #include <cstdio>
+#include <cstring>
 #include <string>
 #include <iostream>
 #include <cstdint>
-#include <climits>
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include <complex>
+#include <cmath>
+#include <atomic>
+#include <functional>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include "mycrypto-basic.h"
+#include "mycrypto-simd.h"
+#include "mycrypto-english.h"
 
-//  Base64 character set
-const string charSet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+//  Size of intermediate buffer (in bytes) used when converting between HEX
+//  and Base64, multiple of 3 so that only the last chunk gets padded
+#define CONV_CHUNK  3072
 
 //------------------------------------------------------------------------------
 //      Mapping between characters and their integer values            [PRIVATE]
@@ -51,30 +63,307 @@ int8_t IntToHexChar (uint8_t const &arg)
 }
 
 /**
- *  Mapping of Base64 character set to integer numbers they represent (0-63)
- *  @param arg Input digit/char of Base64 string
- *  @return Integer value in range 0-63 corresponding to input digit
+ *  Number of bytes encoded in a Base64 string. Up to two '=' padding chars at
+ *  the end of input are accepted but not required.
+ *  @param in Input Base64 string
+ *  @param inLen Length of input
+ *  @return Number of decoded bytes; BUF_ERROR if length is invalid
+ */
+static size_t Base64DataLength(char const *in, size_t inLen)
+{
+    if ((inLen > 0) && (in[inLen-1] == '='))
+        inLen--;
+    if ((inLen > 0) && (in[inLen-1] == '='))
+        inLen--;
+
+    //  Single leftover digit doesn't hold a whole byte
+    if ((inLen % 4) == 1)
+        return BUF_ERROR;
+
+    return (inLen / 4) * 3 + ((inLen % 4) ? (inLen % 4 - 1) : 0);
+}
+
+/**
+ *  Decode a window of Base64 string, starting at arbitrary byte offset of
+ *  decoded data. Only the quanta covering the window are decoded.
+ *  @param in Input Base64 string
+ *  @param inLen Length of input
+ *  @param offset Offset (in decoded bytes) at which window starts
+ *  @param out Output buffer
+ *  @param count Length of the window, capped to CONV_CHUNK bytes
+ *  @return Number of bytes written, less than count at the end of data;
+ *  BUF_ERROR on invalid input
+ */
+static size_t Base64Window(char const *in, size_t inLen, size_t offset,
+                           uint8_t *out, size_t count)
+{
+    uint8_t scratch[CONV_CHUNK + 6];
+    size_t skip = offset % 3, start = (offset / 3) * 4, chars, n;
+
+    if (count > CONV_CHUNK)
+        count = CONV_CHUNK;
+    if (start >= inLen)
+        return 0;
+
+    //  Whole quanta, except possibly the last one of the input
+    chars = ((skip + count + 2) / 3) * 4;
+    if (chars > (inLen - start))
+        chars = inLen - start;
+
+    n = SIMDBase64Decode(scratch, in + start, chars);
+    if (n == BUF_ERROR)
+        return BUF_ERROR;
+    if (n <= skip)
+        return 0;
+
+    n = ((n - skip) > count) ? count : (n - skip);
+    memcpy(out, scratch + skip, n);
+
+    return n;
+}
+
+/**
+ *  XOR two Base64-encoded strings in a single pass. Text is decoded, XORed and
+ *  encoded again one cache-sized chunk at the time, with no intermediate
+ *  strings.
+ *  @param text Base64 text to encrypt
+ *  @param textLen Length of text
+ *  @param key Base64 key, repeated over the whole text
+ *  @param keyLen Length of key
+ *  @param fixed True if key is required to be as long as text
+ *  @param out Output buffer
+ *  @param outSize Size of output buffer
+ *  @return Number of chars written; BUF_ERROR on invalid input or output
+ *  buffer too small
+ */
+static size_t Base64XOR(char const *text, size_t textLen, char const *key,
+                        size_t keyLen, bool fixed, char *out, size_t outSize)
+{
+    uint8_t txtChunk[CONV_CHUNK], keyChunk[CONV_CHUNK];
+    size_t textBytes = Base64DataLength(text, textLen);
+    size_t keyBytes = Base64DataLength(key, keyLen);
+    size_t b64Chunk = CONV_CHUNK/3*4, keyPos = 0, o = 0;
+    bool shortKey = (keyBytes <= CONV_CHUNK);
+
+    if ((textBytes == BUF_ERROR) || (keyBytes == BUF_ERROR) || (keyBytes == 0))
+        return BUF_ERROR;
+    if (fixed && (keyBytes != textBytes))
+        return BUF_ERROR;
+    if (outSize < ((textBytes + 2) / 3) * 4)
+        return BUF_ERROR;
+
+    //  Key that fits the chunk buffer is decoded only once
+    if (shortKey && (SIMDBase64Decode(keyChunk, key, keyLen) == BUF_ERROR))
+        return BUF_ERROR;
+
+    //  Chunk is a multiple of 3 bytes, so only the last one gets padded
+    for (size_t i = 0; i < textLen; i += b64Chunk)
+    {
+        size_t inLen = ((textLen - i) > b64Chunk) ? b64Chunk : (textLen - i);
+        size_t t = SIMDBase64Decode(txtChunk, text + i, inLen);
+
+        if (t == BUF_ERROR)
+            return BUF_ERROR;
+
+        if (shortKey)
+            keyPos = SIMDRepeatXOR(txtChunk, txtChunk, t, keyChunk, keyBytes, keyPos);
+        else
+        {
+            //  Longer key is decoded window by window, in step with the text
+            for (size_t k = 0, n; k < t; k += n)
+            {
+                n = Base64Window(key, keyLen, keyPos, keyChunk + k, t - k);
+                if ((n == BUF_ERROR) || (n == 0))
+                    return BUF_ERROR;
+                keyPos = (keyPos + n) % keyBytes;
+            }
+            SIMDRepeatXOR(txtChunk, txtChunk, t, keyChunk, t);
+        }
+
+        o += SIMDBase64Encode(out + o, txtChunk, t);
+    }
+
+    return o;
+}
+
+//------------------------------------------------------------------------------
+//      Character classes                                              [PRIVATE]
+//------------------------------------------------------------------------------
+//  Class of a character, classes are checked in this order, so that the first
+//  one matching takes it
+static constexpr uint8_t CharClass(uint8_t c)
+{
+    return ((c > 64) && (c < 91))  ? CHAR_UPPER :
+           ((c > 96) && (c < 123)) ? CHAR_LOWER :
+           ((c > 47) && (c < 58))  ? CHAR_NUM :
+           ((c == 32) || (c == 33) || (c == 34) || (c == 39) || (c == 44) ||
+            (c == 46) || (c == 58) || (c == 59) || (c == 63)) ? CHAR_SENT :
+           (((c > 34) && (c < 44)) || (c == 45) || (c == 47) || (c == 10) ||
+            (c == 13)) ? CHAR_COMM :
+           ((c < 32) || (c > 126)) ? CHAR_CONT : CHAR_SPEC;
+}
+
+//  Row of a set of characters for SIMDCountByteSet: bit h of row l is set if
+//  character (h << 4) | l belongs to one of the classes in mask
+static constexpr uint8_t ClassRow(uint8_t l, uint8_t mask)
+{
+    return (((CharClass(l)       & mask) ? 0x01 : 0) | ((CharClass(16 + l)  & mask) ? 0x02 : 0) |
+            ((CharClass(32 + l)  & mask) ? 0x04 : 0) | ((CharClass(48 + l)  & mask) ? 0x08 : 0) |
+            ((CharClass(64 + l)  & mask) ? 0x10 : 0) | ((CharClass(80 + l)  & mask) ? 0x20 : 0) |
+            ((CharClass(96 + l)  & mask) ? 0x40 : 0) | ((CharClass(112 + l) & mask) ? 0x80 : 0));
+}
+
+#define CLASS_4(c)  CharClass(c), CharClass(c + 1), CharClass(c + 2), CharClass(c + 3)
+#define CLASS_16(c) CLASS_4(c), CLASS_4(c + 4), CLASS_4(c + 8), CLASS_4(c + 12)
+#define CLASS_64(c) CLASS_16(c), CLASS_16(c + 16), CLASS_16(c + 32), CLASS_16(c + 48)
+
+//  Class of every character, computed at compile time
+static const uint8_t charClass[256] =
+{
+    CLASS_64(0), CLASS_64(64), CLASS_64(128), CLASS_64(192)
+};
+
+#define ROW_4(l, m) ClassRow(l, m), ClassRow(l + 1, m), ClassRow(l + 2, m), ClassRow(l + 3, m)
+#define ROWS(m)     { ROW_4(0, m), ROW_4(4, m), ROW_4(8, m), ROW_4(12, m) }
+#define ROWS_8(m)   ROWS(m), ROWS(m + 1), ROWS(m + 2), ROWS(m + 3), \
+                    ROWS(m + 4), ROWS(m + 5), ROWS(m + 6), ROWS(m + 7)
+
+//  Rows of every combination of classes, computed at compile time
+static const uint8_t classRows[128][16] =
+{
+    ROWS_8(0),  ROWS_8(8),  ROWS_8(16), ROWS_8(24), ROWS_8(32), ROWS_8(40),
+    ROWS_8(48), ROWS_8(56), ROWS_8(64), ROWS_8(72), ROWS_8(80), ROWS_8(88),
+    ROWS_8(96), ROWS_8(104), ROWS_8(112), ROWS_8(120)
+};
+
+//------------------------------------------------------------------------------
+//      English language model                                         [PRIVATE]
+//------------------------------------------------------------------------------
+/**
+ *  Byte log-probabilities of a model, as doubles with index XORed by low nibble
+ *  of a ciphertext byte, so that plaintext probabilities of 16 consecutive
+ *  keys are contiguous (as expected by SIMDXORKeyScores)
+ */
+struct XORScoreRows
+{
+    EnglishModel const *source;
+    double permuted[16][256];
+};
+
+/**
+ *  Rows of the active model, converted once per thread and model
+ */
+static double const *XORRows()
+{
+    static thread_local XORScoreRows rows = { NULL, { { 0 } } };
+    EnglishModel const *model = &EnglishActiveModel();
+
+    if (rows.source != model)
+    {
+        for (size_t l = 0; l < 16; l++)
+            for (size_t i = 0; i < 256; i++)
+                rows.permuted[l][i] = model->unigram[i ^ l] / (double)ENG_SCALE;
+        rows.source = model;
+    }
+
+    return &rows.permuted[0][0];
+}
+
+//------------------------------------------------------------------------------
+//      Work split between threads                                     [PRIVATE]
+//------------------------------------------------------------------------------
+/**
+ *  Work on one item, given index of the worker doing it (below number of
+ *  threads) so that every worker can keep its own state
+ */
+typedef std::function<void(size_t item, uint32_t worker)> ItemWork;
+
+/**
+ *  Number of threads to use for a number of items
+ *  @param threads Requested number of threads, 0 for one per CPU core
+ *  @return Number of threads, at least one and at most one per item
+ */
+static uint32_t WorkerCount(uint32_t threads, size_t items)
+{
+    if (threads == 0)
+        threads = thread::hardware_concurrency();
+    if (threads > items)
+        threads = items;
+    if (threads == 0)
+        threads = 1;
+
+    return threads;
+}
+
+/**
+ *  Worker of RunItems, takes items until there are none left
+ *  @param next Next item to process, shared between workers
+ */
+static void ItemWorker(size_t items, uint32_t worker, ItemWork const *work,
+                       atomic<size_t> *next)
+{
+    size_t item;
+
+    while ((item = next->fetch_add(1)) < items)
+        (*work)(item, worker);
+}
+
+/**
+ *  Work on items 0 to items-1 on several threads, the calling one included.
+ *  Threads take items from a shared counter so that those finishing early
+ *  take over remaining work.
+ *  @param threads Number of threads to use, as returned by WorkerCount
+ *  @param work Work on an item, can be called from any thread
+ */
+static void RunItems(size_t items, uint32_t threads, ItemWork const &work)
+{
+    vector<thread> workers;
+    atomic<size_t> next(0);
+
+    for (uint32_t t = 1; t < threads; t++)
+        workers.push_back(thread(ItemWorker, items, t, &work, &next));
+    ItemWorker(items, 0, &work, &next);
+    for (size_t t = 0; t < workers.size(); t++)
+        workers[t].join();
+}
+
+/**
+ *  Offer a candidate to a heap of at most topK best ones, the worst one on top
+ *  @param better Ordering of candidates, the best one first
+ */
+template <typename T, typename Better>
+static void KeepBest(vector<T> &heap, T const &cand, size_t topK, Better better)
+{
+    if (heap.size() < topK)
+    {
+        heap.push_back(cand);
+        push_heap(heap.begin(), heap.end(), better);
+    }
+    else if ((topK > 0) && better(cand, heap.front()))
+    {
+        pop_heap(heap.begin(), heap.end(), better);
+        heap.back() = cand;
+        push_heap(heap.begin(), heap.end(), better);
+    }
+}
+
+/**
+ *  Merge heaps kept by KeepBest on every worker
+ *  @return topK best candidates, from the best one
  */
-uint8_t B64CharToInt(uint8_t arg)
+template <typename T, typename Better>
+static vector<T> MergeBest(vector< vector<T> > const &heaps, size_t topK,
+                           Better better)
 {
-    //  Upper case letters map to 0-25
-    if ((arg > 64) && (arg < 91))
-        return (arg - 65);
-    //  Lower case letters map to 26-51
-    if ((arg > 96) && (arg < 123))
-        return (arg - 97 + 26);
-    //  Numbers map to 52-61
-    if ((arg > 47) && (arg < 58))
-        return (arg - 48 + 52);
-    //  '+' is 62
-    if (arg == '+')
-        return 62;
-    //  '/' is 63
-    if (arg == '/')
-        return 63;
+    vector<T> retVal;
 
-    //  For invalid digit return 127
-    return 127;
+    for (size_t t = 0; t < heaps.size(); t++)
+        retVal.insert(retVal.end(), heaps[t].begin(), heaps[t].end());
+    sort(retVal.begin(), retVal.end(), better);
+    if (retVal.size() > topK)
+        retVal.resize(topK);
+
+    return retVal;
 }
 
 //------------------------------------------------------------------------------
@@ -96,13 +385,50 @@ string RepeatKeyXOR(string const &text, string const &key, uint8_t encod)
     case ENC_ASCII:
         return ASCIIRepeatKeyXOR(text, key);
     case ENC_BASE64:
-        return HexToBase64(HexRepeatKeyXOR(Base64ToHex(text), Base64ToHex(key)));
+    {
+        string retVal(((text.length() + 3) / 4) * 4, 0);
+        size_t n = RepeatKeyXOR(text.data(), text.length(), key.data(),
+                                key.length(), encod, &retVal[0], retVal.length());
+        if (n == BUF_ERROR)
+            return "ERROR";
+        retVal.resize(n);
+        return retVal;
+    }
     case ENC_HEX:
         return HexRepeatKeyXOR(text, key);
     default:
         return "ERROR";
     }
 }
+
+/**
+ *  General repeat-key XOR function, writing into caller-supplied buffer
+ *  @param text Text to encrypt with repeating key
+ *  @param textLen Length of text
+ *  @param key Arbitrary-length key to use for encryption of text variable
+ *  @param keyLen Length of key
+ *  @param encod Encoding of text, key & result (one of ENC_* macros)
+ *  @param out Output buffer, may be the same as text
+ *  @param outSize Size of output buffer
+ *  @return Number of chars written; BUF_ERROR on invalid input or output
+ *  buffer too small
+ */
+size_t RepeatKeyXOR(char const *text, size_t textLen, char const *key,
+                    size_t keyLen, uint8_t encod, char *out, size_t outSize)
+{
+    switch(encod)
+    {
+    case ENC_ASCII:
+        return ASCIIRepeatKeyXOR(text, textLen, key, keyLen, out, outSize);
+    case ENC_BASE64:
+        return Base64XOR(text, textLen, key, keyLen, false, out, outSize);
+    case ENC_HEX:
+        return HexRepeatKeyXOR(text, textLen, key, keyLen, out, outSize);
+    default:
+        return BUF_ERROR;
+    }
+}
+
 /**
  *  General fixed-key XOR function
  *  Performs XOR between text and key for key size of the same length as text.
@@ -119,13 +445,50 @@ string FixedKeyXOR(string const &text, string const &key, uint8_t encod)
     case ENC_ASCII:
         return ASCIIFixedXOR(text, key);
     case ENC_BASE64:
-        return HexToBase64(HexFixedXOR(Base64ToHex(text), Base64ToHex(key)));
+    {
+        string retVal(((text.length() + 3) / 4) * 4, 0);
+        size_t n = FixedKeyXOR(text.data(), text.length(), key.data(),
+                               key.length(), encod, &retVal[0], retVal.length());
+        if (n == BUF_ERROR)
+            return "ERROR";
+        retVal.resize(n);
+        return retVal;
+    }
     case ENC_HEX:
         return HexFixedXOR(text, key);
     default:
         return "ERROR";
     }
 }
+
+/**
+ *  General fixed-key XOR function, writing into caller-supplied buffer
+ *  @param text Text to encrypt
+ *  @param textLen Length of text
+ *  @param key Key to use for encryption of text variable
+ *  @param keyLen Length of key, has to match the length of text
+ *  @param encod Encoding of text, key & result (one of ENC_* macros)
+ *  @param out Output buffer, may be the same as text
+ *  @param outSize Size of output buffer
+ *  @return Number of chars written; BUF_ERROR on invalid input or output
+ *  buffer too small
+ */
+size_t FixedKeyXOR(char const *text, size_t textLen, char const *key,
+                   size_t keyLen, uint8_t encod, char *out, size_t outSize)
+{
+    switch(encod)
+    {
+    case ENC_ASCII:
+        return ASCIIFixedXOR(text, textLen, key, keyLen, out, outSize);
+    case ENC_BASE64:
+        return Base64XOR(text, textLen, key, keyLen, true, out, outSize);
+    case ENC_HEX:
+        return HexFixedXOR(text, textLen, key, keyLen, out, outSize);
+    default:
+        return BUF_ERROR;
+    }
+}
+
 /**
  *  Pad text string by appending  padding character until string reaches desired
  *  length.
@@ -137,28 +500,65 @@ string FixedKeyXOR(string const &text, string const &key, uint8_t encod)
  */
 string PadString(string const &text, uint32_t length, uint8_t encod, int8_t paddingChar)
 {
-    string retVal(text);
-    string paddingASCII;
+    string retVal((length > text.length()) ? length : text.length(), 0);
+    size_t n = PadString(text.data(), text.length(), length, encod,
+                         &retVal[0], retVal.length());
+
+    if (n == BUF_ERROR)
+        return "ERROR";
 
+    retVal.resize(n);
+    return retVal;
+}
+
+/**
+ *  Pad text by appending padding characters (PKCS#7 scheme) until it reaches
+ *  desired length, writing into caller-supplied buffer
+ *  @param text Text to pad
+ *  @param textLen Length of text
+ *  @param length Required length of padded text
+ *  @param encod Encoding of text (one of ENC_* macros), Base64 is not allowed
+ *  @param out Output buffer, may be the same as text
+ *  @param outSize Size of output buffer
+ *  @return Number of chars written; BUF_ERROR if text is longer than length,
+ *  on Base64 encoding or if output buffer is too small
+ */
+size_t PadString(char const *text, size_t textLen, uint32_t length,
+                 uint8_t encod, char *out, size_t outSize)
+{
     //  Calculate padding character based on difference in length (PCSK#7 scheme)
-    paddingChar = length - text.length();
+    int8_t paddingChar = length - textLen;
+    size_t retLen = textLen;
+
+    if (length < textLen)
+        return BUF_ERROR;
 
     switch(encod)
     {
     case ENC_ASCII:
-        paddingASCII.resize(length-text.length(), paddingChar);
-        retVal += paddingASCII;
+        retLen = length;
         break;
     case ENC_BASE64:
-        return "ERROR"; //  Illegal action
+        return BUF_ERROR; //  Illegal action
     case ENC_HEX:
-        paddingASCII.resize((length-text.length())/2, paddingChar);
-        string paddingHex = ASCIIToHex(paddingASCII);
-        retVal += paddingHex;
+        retLen = textLen + 2*((length - textLen)/2);
         break;
     }
 
-    return retVal;
+    if (outSize < retLen)
+        return BUF_ERROR;
+
+    memmove(out, text, textLen);
+    if (encod == ENC_ASCII)
+        memset(out + textLen, paddingChar, retLen - textLen);
+    else if (encod == ENC_HEX)
+        for (size_t i = textLen; i < retLen; i += 2)
+        {
+            out[i] = IntToHexChar((uint8_t)paddingChar >> 4);
+            out[i+1] = IntToHexChar(paddingChar & 0x0F);
+        }
+
+    return retLen;
 }
 
 //------------------------------------------------------------------------------
@@ -172,42 +572,29 @@ string PadString(string const &text, uint32_t length, uint8_t encod, int8_t padd
 string ASCIIToBase64(string const &arg)
 {
     string retVal;
-    uint32_t b64Len = 0, b64Pad = 0;
-
-    //  Calculate length of output b64 string and 0 padding. If input string has
-    //  length dividable by 3 then no padding is needed, if not, padding is
-    //  equal to difference between first multiple of 3 larger than string's len
-    //  and string's len
-    if ((arg.length() % 3) != 0) {
-        b64Pad = 3 - (arg.length() % 3);
-        b64Len = (1+arg.length()/3)*4 - b64Pad;
-    } else {
-        b64Pad = 0;
-        b64Len = (arg.length()/3)*4 - b64Pad;
-    }
-
-    //  Allocate memory for output string
-    retVal.resize(b64Len, 0);
-
-    //  Process input string by taking 3 chars at the time, combine them into a
-    //  single decimal number
-    for (uint32_t i = 0; i < arg.length(); i += 3)
-    {
-        uint32_t chunk24bit = 0;
 
-        //  Accumulate 3 (or max avail. less than 3) bytes in a row
-        for (uint32_t j = 0; (j < 3) && ((i+j) < arg.length()); j++)
-            chunk24bit |= ((uint32_t)arg[j+i]<<((2-j)*8));
+    //  Every 3 input bytes produce 4 Base64 digits, a trailing partial chunk
+    //  still takes up whole 4 digits where missing ones are padded with '='
+    retVal.resize(((arg.length() + 2) / 3) * 4);
+    ASCIIToBase64(arg.data(), arg.length(), &retVal[0], retVal.length());
 
-        //  Split accumulated 24-bit chunk in 6-bit, base64 signs
-        for (uint32_t j = 3; (j >= 0) && ((i/3)*4 + (3-j)) < b64Len; j--)
-            retVal[(i/3)*4 + (3-j)] = charSet[(chunk24bit >> (6*j)) & 0x3F];
-    }
+    return retVal;
+}
 
-    for (uint8_t j = 0; j < b64Pad; j++)
-        retVal += "=";
+/**
+ *  Convert input ASCII string into a Base64 string in caller-supplied buffer
+ *  @param arg Input ASCII string
+ *  @param len Length of input
+ *  @param out Output buffer
+ *  @param outSize Size of output buffer, at least ((len+2)/3)*4
+ *  @return Number of chars written; BUF_ERROR if output buffer is too small
+ */
+size_t ASCIIToBase64(char const *arg, size_t len, char *out, size_t outSize)
+{
+    if (outSize < ((len + 2) / 3) * 4)
+        return BUF_ERROR;
 
-    return retVal;
+    return SIMDBase64Encode(out, (const uint8_t*)arg, len);
 }
 
 /**
@@ -222,20 +609,37 @@ string ASCIIToHex(string const &arg, uint32_t length)
 {
     string retVal;
 
-    if (length == 0)
-        length = arg.length()*2;
-
-    retVal.resize(length, 0);
+    retVal.resize(arg.length()*2, 0);
+    ASCIIToHex(arg.data(), arg.length(), &retVal[0], retVal.length());
 
-    for (uint32_t i = 0; i <length; i+=2)
+    //  Repeat HEX of the input until it reaches required length
+    if ((length != 0) && (retVal.length() > 0))
     {
-        retVal[i] = IntToHexChar((arg[((i/2)%arg.length())]>>4) & 0x0F);
-        retVal[i+1] = IntToHexChar(arg[((i/2)%arg.length())] & 0x0F);
+        size_t hexLen = retVal.length();
+        retVal.resize(length);
+        for (uint32_t i = hexLen; i < length; i++)
+            retVal[i] = retVal[i % hexLen];
     }
 
     return retVal;
 }
 
+/**
+ *  Convert input ASCII string to HEX string in caller-supplied buffer
+ *  @param arg ASCII string to convert to HEX
+ *  @param len Length of input
+ *  @param out Output buffer
+ *  @param outSize Size of output buffer, at least 2*len
+ *  @return Number of chars written; BUF_ERROR if output buffer is too small
+ */
+size_t ASCIIToHex(char const *arg, size_t len, char *out, size_t outSize)
+{
+    if (outSize < 2*len)
+        return BUF_ERROR;
+
+    return SIMDHexEncode(out, (const uint8_t*)arg, len);
+}
+
 /**
  *  Perform XOR on two ASCII strings
  *  @param arg1 First ASCII string
@@ -247,15 +651,36 @@ string ASCIIFixedXOR(string const &arg1,string const &arg2)
     string retVal;
     retVal.resize(arg1.length(), 0);
 
-    if (arg1.length() != arg2.length())
+    if (ASCIIFixedXOR(arg1.data(), arg1.length(), arg2.data(), arg2.length(),
+                      &retVal[0], retVal.length()) == BUF_ERROR)
         return "ERROR";
 
-    for (uint32_t i = 0; i < arg1.length(); i++)
-        retVal[i] = arg1[i] ^ arg2[i];
-
     return retVal;
 }
 
+/**
+ *  Perform XOR on two equal-length ASCII strings into caller-supplied buffer
+ *  @param arg1 First ASCII string
+ *  @param len1 Length of first string
+ *  @param arg2 Second ASCII string
+ *  @param len2 Length of second string
+ *  @param out Output buffer, may be the same as one of inputs
+ *  @param outSize Size of output buffer, at least len1
+ *  @return Number of bytes written; BUF_ERROR if lengths don't match or
+ *  output buffer is too small
+ */
+size_t ASCIIFixedXOR(char const *arg1, size_t len1, char const *arg2,
+                     size_t len2, char *out, size_t outSize)
+{
+    if ((len1 != len2) || (outSize < len1))
+        return BUF_ERROR;
+
+    //  Key as long as the text is never repeated
+    SIMDRepeatXOR((uint8_t*)out, (const uint8_t*)arg1, len1, (const uint8_t*)arg2, len1);
+
+    return len1;
+}
+
 /**
  *  Perform repeating-key XORing of given text and key. In this process, key is
  *  extended by repeating original key to match the length of text string.
@@ -266,19 +691,38 @@ string ASCIIFixedXOR(string const &arg1,string const &arg2)
  */
 string ASCIIRepeatKeyXOR(string const &text, string const &key)
 {
-//    Using native implementation, without HEX
-//    //  Convert text to hex
-//    string txtHex = ASCIIToHex(text);
-//    //  Convert key to hex and repeat it as many times as need to have the same
-//    //  length as text
-//    string keyHex = ASCIIToHex(key, txtHex.length());
+    string retVal;
+    retVal.resize(text.length(), 0);
+
+    if (ASCIIRepeatKeyXOR(text.data(), text.length(), key.data(), key.length(),
+                          &retVal[0], retVal.length()) == BUF_ERROR)
+        return "ERROR";
+
+    return retVal;
+}
+
+/**
+ *  Perform repeating-key XORing of given text and key into caller-supplied
+ *  buffer. Key is applied in place, without building its expanded copy, by
+ *  vector kernel selected for this CPU.
+ *  @param text ASCII text to encrypt with repeating key
+ *  @param textLen Length of text
+ *  @param key Arbitrary-length key to use for encryption of text variable
+ *  @param keyLen Length of key, non-zero
+ *  @param out Output buffer, may be the same as text
+ *  @param outSize Size of output buffer, at least textLen
+ *  @return Number of bytes written; BUF_ERROR on empty key or output buffer
+ *  too small
+ */
+size_t ASCIIRepeatKeyXOR(char const *text, size_t textLen, char const *key,
+                         size_t keyLen, char *out, size_t outSize)
+{
+    if ((keyLen == 0) || (outSize < textLen))
+        return BUF_ERROR;
 
-    //  Ensure key and text have matching lengths
-    string newKey;
-    for (uint32_t i = 0; i < text.length(); i++)
-        newKey += key[i % key.length()];
+    SIMDRepeatXOR((uint8_t*)out, (const uint8_t*)text, textLen, (const uint8_t*)key, keyLen);
 
-    return ASCIIFixedXOR(text, newKey);
+    return textLen;
 }
 
 /**
@@ -288,225 +732,511 @@ string ASCIIRepeatKeyXOR(string const &text, string const &key)
  *  1s in XORed variable
  *  @param arg1 First ASCII string
  *  @param arg2 Second ASCII string
- *  @return Humming distance between 2 input strings; ULLONG_MAX if length of
+ *  @return Humming distance between 2 input strings; BUF_ERROR if length of
  *  strings is not the same
  */
-uint32_t ASCIIDistHamming(string const &arg1, string const &arg2)
+size_t ASCIIDistHamming(string const &arg1, string const &arg2)
 {
-    uint32_t retVal = 0;
+    return ASCIIDistHamming(arg1.data(), arg1.length(), arg2.data(), arg2.length());
+}
 
-    if (arg1.length() != arg2.length())
-        return (ULLONG_MAX & 0xFFFFFFF);
+/**
+ *  Calculate Hamming distance between two equal-length ASCII buffers
+ *  @param arg1 First ASCII string
+ *  @param len1 Length of first string
+ *  @param arg2 Second ASCII string
+ *  @param len2 Length of second string
+ *  @return Humming distance between 2 inputs; BUF_ERROR if lengths are not
+ *  the same
+ */
+size_t ASCIIDistHamming(char const *arg1, size_t len1, char const *arg2,
+                        size_t len2)
+{
+    if (len1 != len2)
+        return BUF_ERROR;
 
-    for (uint32_t i = 0; i < arg1.length(); i++)
-    {
-        //  XOR two chars, this will set 1 in all bits that don't match, then we
-        //  just need to count number of bits that are 1
-        uint8_t xorRes = arg1[i] ^ arg2[i];
+    //  XOR of two chars sets 1 in all bits that don't match, kernel counts
+    //  them a whole vector at the time
+    return SIMDHamming((const uint8_t*)arg1, (const uint8_t*)arg2, len1);
+}
 
-        //  Count number of bits that are 1
-        for (uint8_t j = 0; j < 8; j++)
-            if ((xorRes>>j) & 0x01)
-                retVal++;
-    }
+/**
+ *  Calculate Hamming distances of one ASCII block against a number of blocks
+ *  of the same length, e.g. consecutive blocks of a ciphertext
+ *  @param ref Block all others are compared to
+ *  @param blocks First of the blocks to compare
+ *  @param blockLen Length of every block
+ *  @param stride Distance between starts of two consecutive blocks
+ *  @param count Number of blocks
+ *  @param dist [out] Array of count distances, one per block
+ *  @return Number of distances written
+ */
+size_t ASCIIDistHammingBatch(char const *ref, char const *blocks, size_t blockLen,
+                             size_t stride, size_t count, size_t *dist)
+{
+    for (size_t i = 0; i < count; i++)
+        dist[i] = SIMDHamming((const uint8_t*)ref,
+                              (const uint8_t*)blocks + i*stride, blockLen);
 
-    return retVal;
+    return count;
 }
 
 /**
- *  Checks if input string consists of valid characters. Use bool selectors to
- *  choose valid groups of characters
- *  @param lc Allows for lower-case letters in string
- *  @param uc Allows for upper-case letters in string
- *  @param num Allows for numbers in string
- *  @param sent Allows for sentence chars in string (!',.:;)
- *  @param comm Allows for characters used in common slang #$&+-
- *  @param spec Allows for special chars in string (not in all the other rules)
- *  @param cont Allows for control chars in string (ASCII < 32)
- *  @return True if string passed all requirements, false if it didn't
+ *  Calculate Hamming distances between all pairs of equal-length ASCII blocks
+ *  Each pair is only compared once, results are mirrored over the diagonal
+ *  @param blocks First of the blocks to compare
+ *  @param blockLen Length of every block
+ *  @param stride Distance between starts of two consecutive blocks
+ *  @param count Number of blocks
+ *  @param dist [out] Row-major count x count matrix of distances, with zeros
+ *  on the diagonal
+ *  @return Number of distances written (count*count)
  */
-bool validASCIIString(string const &arg, bool lc, bool uc, bool num, bool sent,
-                      bool comm, bool spec, bool cont)
+size_t ASCIIDistHammingMatrix(char const *blocks, size_t blockLen, size_t stride,
+                              size_t count, size_t *dist)
 {
-    bool valid = true;
-
-    for (uint32_t i = 0; (i < arg.length()) && valid; i++)
-    {
-        //  Check if it's upper case and we want upper case
-        if ((arg[i] > 64) && (arg[i] < 91))
-            valid &= uc;
-        //  Check if it's lower case and we want lower case
-        else if ((arg[i] > 96) && (arg[i] < 123))
-            valid &= lc;
-        //  Check if it's number and we want number
-        else if ((arg[i] > 47) && (arg[i] < 58))
-            valid &= num;
-        //  Check if it's sentence punctuation !'",.:;()/
-        else if ((arg[i] == 32) || (arg[i] == 33) || (arg[i] == 34) ||
-                 (arg[i] == 39) || (arg[i] == 44) || (arg[i] == 46) ||
-                 (arg[i] == 58) || (arg[i] == 59) || (arg[i] == 63))
-            valid &= sent;
-        else if (((arg[i] > 34) && (arg[i] < 44)) || (arg[i] == 42)
-                 || (arg[i] == 43) || (arg[i] == 45) || (arg[i] == 47) || (arg[i] == 10) || (arg[i] == 13))
-            valid &=comm;
-        else if ((arg[i] < 32) || (arg[i] == 127))
-            valid &= cont;
-        else
-            valid &= spec;
+    for (size_t i = 0; i < count; i++)
+    {
+        dist[i*count + i] = 0;
+        for (size_t j = i + 1; j < count; j++)
+            dist[i*count + j] = dist[j*count + i] =
+                SIMDHamming((const uint8_t*)blocks + i*stride,
+                            (const uint8_t*)blocks + j*stride, blockLen);
     }
 
-    return valid;
+    return count*count;
 }
 
-//------------------------------------------------------------------------------
-//      Operations on Base64-encoded data                               [PUBLIC]
-//------------------------------------------------------------------------------
 /**
- *  Convert input Base64 string into a HEX string
- *  @param arg Input Base64 string
- *  @return Corresponding HEX string
+ *  Split ASCII string into k columns, see ASCIITranspose for layout
+ *  @param arg Input string
+ *  @param k Number of columns
+ *  @return Columns concatenated into one string of k*ceil(len/k) bytes;
+ *  "ERROR" if k is 0
  */
-string Base64ToHex(string const &arg)
+string ASCIITranspose(string const &arg, size_t k)
 {
-    string retVal;
-    uint32_t b64Len = 0, b64Pad = 0;
-
-    //  Find length and padding of b64 input
-    b64Len = arg.length();
-    for (uint32_t i = (b64Len-1); 1==1 ; i--)
-        if (arg[i] == '=')
-            b64Pad++;
-        else
-            break;
-
-    //  Set the length on data part of Base64
-    b64Len -= b64Pad;
-
-    //  Length of HEX is simply length data part of Base64*6 (since B64 takes
-    //  6 bits to encode one sign) reduced by the number of padded zeros to
-    //  B64 string(2*number of '=') divided by 4 (since HEX encodes char with 4
-    //                                            bits)
-    //  Allocate memory for output string
-    retVal.resize((b64Len*6-b64Pad*2)/4, 0);
-
-    //  Process input string by taking 4 chars at the time, combine them into a
-    //  single decimal number of 24bit that can be split in 4bit HEX chunks
-    for (uint32_t i = 0; i < b64Len; i += 4)
-    {
-        uint32_t chunk24bit = 0;
-
-        //  Accumulate 4 (or max avail. less than 4) b64 digits(3 bytes) in a row
-        for (uint32_t j = 0; (j < 4) && ((i+j) < b64Len); j++)
-            chunk24bit |= ((uint32_t)B64CharToInt(arg[j+i]))<<((3-j)*6);
+    if (k == 0)
+        return "ERROR";
 
-        //  Split accumulated 24-bit chunk in six 4-bit chunks, HEX digits
-        for (uint32_t j = 5; (j >= 0) && ((i/4)*6 + (5-j)) < retVal.length(); j--)
-            retVal[(i/4)*6 + (5-j)] = IntToHexChar((chunk24bit >> (4*j)) & 0x0F);
-    }
+    string retVal(k * ((arg.length() + k - 1) / k), 0);
+    ASCIITranspose(arg.data(), arg.length(), k, &retVal[0], retVal.length());
 
     return retVal;
 }
 
 /**
- *  Calculate Hamming distance between two equal-length Base64-encoded strings
- *  To do so, chars at the same index are XORed which produces 1 at the position
- *  where bits in two characters mismatch. The result is just counting number of
- *  1s in XORed variable
- *  @param arg1 First Base64-encoded string
- *  @param arg2 Second Base64-encoded string
- *  @return Humming distance between 2 input strings; ULLONG_MAX if length of
- *  strings is not the same
+ *  Split ASCII buffer into k columns (bytes sharing the same key byte under a
+ *  k-byte repeating key), column j holding bytes j, j+k, j+2k... at
+ *  out + j*stride, where stride = ceil(len/k). Shorter columns are padded
+ *  with 0 up to the stride.
+ *  @param arg Input buffer
+ *  @param len Length of input buffer
+ *  @param k Number of columns
+ *  @param out [out] Output buffer
+ *  @param outSize Size of output buffer
+ *  @return Number of bytes written (k*stride); BUF_ERROR if k is 0 or output
+ *  buffer is too small
  */
-uint32_t Base64DistHamming(string const &arg1, string const &arg2)
+size_t ASCIITranspose(char const *arg, size_t len, size_t k, char *out,
+                      size_t outSize)
 {
-    uint32_t retVal = 0;
+    if (k == 0)
+        return BUF_ERROR;
 
-    if (arg1.length() != arg2.length())
-        return (ULLONG_MAX & 0xFFFFFFF);
+    size_t n = k * ((len + k - 1) / k);
+    if (outSize < n)
+        return BUF_ERROR;
 
-    for (uint32_t i = 0; i < arg1.length(); i++)
-    {
-        //  XOR two chars, this will set 1 in all bits that don't match, then we
-        //  just need to count number of bits that are 1
-        uint8_t xorRes =  B64CharToInt(arg1[i]) ^ B64CharToInt(arg2[i]);
-
-        //  Count number of bits that are 1
-        for (uint8_t j = 0; j < 8; j++)
-            if ((xorRes>>j) & 0x01)
-                retVal++;
-    }
+    //  Tiles of rows are transposed in vector registers, so that every column
+    //  is written in whole cache lines instead of a byte at the time
+    SIMDTranspose((uint8_t*)out, (const uint8_t*)arg, len, k);
 
-    return retVal;
+    return n;
 }
 
-//------------------------------------------------------------------------------
-//      Operations on HEX-encoded data                                  [PUBLIC]
-//------------------------------------------------------------------------------
 /**
- *  Convert HEX-encoded string into its ASCII representation
- *  @param arg HEX-encoded string to decode
- *  @return ASCII representation of input string
+ *  Reassemble ASCII string of given length from k columns
+ *  @param arg Columns, see ASCIITranspose
+ *  @param len Length of reassembled string
+ *  @param k Number of columns
+ *  @return Reassembled string; "ERROR" on invalid input
  */
-string HexToASCII(string const &arg)
+string ASCIIUntranspose(string const &arg, size_t len, size_t k)
 {
-    string retVal;
-    retVal.resize(arg.length()/2, 0);
+    string retVal(len, 0);
 
-    for (uint32_t i = 0; i < arg.length(); i+=2)
-    {
-        retVal[i/2] = ((HexCharToInt(arg[i])<<4) | HexCharToInt(arg[i+1]));
-    }
+    if (ASCIIUntranspose(arg.data(), arg.length(), len, k, &retVal[0],
+                         retVal.length()) == BUF_ERROR)
+        return "ERROR";
 
     return retVal;
 }
 
 /**
- *  Convert input HEX string into a Base64 string
- *  @param arg Input HEX string
- *  @return Corresponding Base64 string
+ *  Reassemble ASCII buffer from k columns produced by ASCIITranspose, e.g.
+ *  plaintext decrypted column by column
+ *  @param arg Columns, k*stride bytes where stride = ceil(len/k)
+ *  @param argLen Length of columns buffer
+ *  @param len Length of reassembled buffer
+ *  @param k Number of columns
+ *  @param out [out] Output buffer
+ *  @param outSize Size of output buffer
+ *  @return Number of bytes written (len); BUF_ERROR if k is 0, columns buffer
+ *  is too short or output buffer is too small
  */
-string HexToBase64(string const &arg)
+size_t ASCIIUntranspose(char const *arg, size_t argLen, size_t len, size_t k,
+                        char *out, size_t outSize)
+{
+    if ((k == 0) || (argLen < k * ((len + k - 1) / k)) || (outSize < len))
+        return BUF_ERROR;
+
+    SIMDUntranspose((uint8_t*)out, (const uint8_t*)arg, len, k);
+
+    return len;
+}
+
+/**
+ *  Checks if input string consists of valid characters. Use bool selectors to
+ *  choose valid groups of characters
+ *  @param lc Allows for lower-case letters in string
+ *  @param uc Allows for upper-case letters in string
+ *  @param num Allows for numbers in string
+ *  @param sent Allows for sentence chars in string (!',.:;)
+ *  @param comm Allows for characters used in common slang #$&+-
+ *  @param spec Allows for special chars in string (not in all the other rules)
+ *  @param cont Allows for control chars in string (ASCII < 32)
+ *  @return True if string passed all requirements, false if it didn't
+ */
+bool validASCIIString(string const &arg, bool lc, bool uc, bool num, bool sent,
+                      bool comm, bool spec, bool cont)
+{
+    return validASCIIString(arg.data(), arg.length(), lc, uc, num, sent, comm,
+                            spec, cont);
+}
+
+/**
+ *  Checks if input buffer consists of valid characters. Use bool selectors to
+ *  choose valid groups of characters
+ *  @param arg Input buffer
+ *  @param len Length of input buffer
+ *  @return True if buffer passed all requirements, false if it didn't
+ */
+bool validASCIIString(char const *arg, size_t len, bool lc, bool uc, bool num,
+                      bool sent, bool comm, bool spec, bool cont)
+{
+    uint8_t mask = (lc ? CHAR_LOWER : 0) | (uc ? CHAR_UPPER : 0) |
+                   (num ? CHAR_NUM : 0) | (sent ? CHAR_SENT : 0) |
+                   (comm ? CHAR_COMM : 0) | (spec ? CHAR_SPEC : 0) |
+                   (cont ? CHAR_CONT : 0);
+
+    return ASCIIClassCount(arg, len, mask) == len;
+}
+
+/**
+ *  Class of a character (one of CHAR_* classes)
+ *  @param c Character
+ *  @return Class of character
+ */
+uint8_t ASCIICharClass(char c)
+{
+    return charClass[(uint8_t)c];
+}
+
+/**
+ *  Count characters in buffer belonging to any of the given classes
+ *  @param arg Input buffer
+ *  @param len Length of input buffer
+ *  @param mask Bitwise OR of accepted CHAR_* classes
+ *  @return Number of characters belonging to accepted classes
+ */
+size_t ASCIIClassCount(char const *arg, size_t len, uint8_t mask)
+{
+    mask &= 0x7F;
+    return SIMDCountByteSet((const uint8_t*)arg, len, classRows[mask],
+                            (mask & CHAR_CONT) != 0);
+}
+
+/**
+ *  Count characters in string belonging to any of the given classes
+ *  @param arg Input string
+ *  @param mask Bitwise OR of accepted CHAR_* classes
+ *  @return Number of characters belonging to accepted classes
+ */
+size_t ASCIIClassCount(string const &arg, uint8_t mask)
+{
+    return ASCIIClassCount(arg.data(), arg.length(), mask);
+}
+
+/**
+ *  Share of characters in buffer belonging to any of the given classes, to
+ *  allow for some unexpected characters in otherwise valid text
+ *  @param arg Input buffer
+ *  @param len Length of input buffer
+ *  @param mask Bitwise OR of accepted CHAR_* classes
+ *  @return Share of accepted characters in range [0, 1], 1 for empty buffer
+ */
+double ASCIIClassRatio(char const *arg, size_t len, uint8_t mask)
+{
+    if (len == 0)
+        return 1.0;
+
+    return (double)ASCIIClassCount(arg, len, mask) / len;
+}
+
+/**
+ *  Share of characters in string belonging to any of the given classes
+ *  @param arg Input string
+ *  @param mask Bitwise OR of accepted CHAR_* classes
+ *  @return Share of accepted characters in range [0, 1], 1 for empty string
+ */
+double ASCIIClassRatio(string const &arg, uint8_t mask)
+{
+    return ASCIIClassRatio(arg.data(), arg.length(), mask);
+}
+
+//------------------------------------------------------------------------------
+//      Operations on Base64-encoded data                               [PUBLIC]
+//------------------------------------------------------------------------------
+/**
+ *  Convert input Base64 string into a HEX string
+ *  @param arg Input Base64 string
+ *  @return Corresponding HEX string
+ */
+string Base64ToHex(string const &arg)
 {
     string retVal;
-    uint32_t b64Len = 0, b64Pad = 0;
+    size_t dataLen = Base64DataLength(arg.data(), arg.length());
 
-    //  HEX input has to have even size
-    if ((arg.length() % 2) != 0)
+    if (dataLen == BUF_ERROR)
+        return "ERROR";
+
+    retVal.resize(2*dataLen);
+    if (Base64ToHex(arg.data(), arg.length(), &retVal[0], retVal.length()) == BUF_ERROR)
         return "ERROR";
 
-    //  Calculate length of output b64 string and 0 padding
-    if ((arg.length() % 3) != 0) {
-        b64Pad = 3 - (arg.length()/2 % 3);
-        b64Len = (1+arg.length()/6)*4 - b64Pad;
-    } else {
-        b64Pad = 0;
-        b64Len = (arg.length()/6)*4 - b64Pad;
+    return retVal;
+}
+
+/**
+ *  Convert input Base64 string into a HEX string in caller-supplied buffer
+ *  @param arg Input Base64 string
+ *  @param len Length of input
+ *  @param out Output buffer
+ *  @param outSize Size of output buffer, at least twice the decoded length
+ *  @return Number of chars written; BUF_ERROR on invalid input or output
+ *  buffer too small
+ */
+size_t Base64ToHex(char const *arg, size_t len, char *out, size_t outSize)
+{
+    uint8_t chunk[CONV_CHUNK];
+    size_t i = 0, o = 0, b64Chunk = CONV_CHUNK/3*4;
+    size_t dataLen = Base64DataLength(arg, len);
+
+    if ((dataLen == BUF_ERROR) || (outSize < 2*dataLen))
+        return BUF_ERROR;
+
+    //  Decode Base64 in chunks small enough to stay in cache and convert each
+    //  of them to HEX. Last chunk holds the padding, if any
+    while (i < len)
+    {
+        size_t inLen = ((len - i) > b64Chunk) ? b64Chunk : (len - i);
+        size_t outLen = SIMDBase64Decode(chunk, arg + i, inLen);
+
+        if (outLen == BUF_ERROR)
+            return BUF_ERROR;
+
+        o += SIMDHexEncode(out + o, chunk, outLen);
+        i += inLen;
     }
 
-    //  Allocate memory for output string
-    retVal.resize(b64Len + b64Pad, 0);
+    return o;
+}
+
+/**
+ *  Convert input Base64 string directly into an ASCII string
+ *  Decoding is done in a single pass (vectorized where CPU allows it) into an
+ *  output string that is allocated only once, with no HEX intermediate
+ *  @param arg Input Base64 string
+ *  @return Corresponding ASCII string; "ERROR" if input contains characters
+ *  outside of Base64 set or has invalid length
+ */
+string Base64ToASCII(string const &arg)
+{
+    string retVal;
+    size_t dataLen = Base64DataLength(arg.data(), arg.length());
+
+    if (dataLen == BUF_ERROR)
+        return "ERROR";
+
+    retVal.resize(dataLen);
+    if (Base64ToASCII(arg.data(), arg.length(), &retVal[0], retVal.length()) == BUF_ERROR)
+        return "ERROR";
+
+    return retVal;
+}
+
+/**
+ *  Convert input Base64 string into bytes in caller-supplied buffer
+ *  @param arg Input Base64 string
+ *  @param len Length of input
+ *  @param out Output buffer
+ *  @param outSize Size of output buffer, at least the decoded length
+ *  @return Number of bytes written; BUF_ERROR on invalid input or output
+ *  buffer too small
+ */
+size_t Base64ToASCII(char const *arg, size_t len, char *out, size_t outSize)
+{
+    size_t dataLen = Base64DataLength(arg, len);
+
+    if ((dataLen == BUF_ERROR) || (outSize < dataLen))
+        return BUF_ERROR;
+
+    return SIMDBase64Decode((uint8_t*)out, arg, len);
+}
+
+/**
+ *  Calculate Hamming distance between two equal-length Base64-encoded strings
+ *  To do so, chars at the same index are XORed which produces 1 at the position
+ *  where bits in two characters mismatch. The result is just counting number of
+ *  1s in XORed variable
+ *  @param arg1 First Base64-encoded string
+ *  @param arg2 Second Base64-encoded string
+ *  @return Humming distance between 2 input strings; BUF_ERROR if length of
+ *  strings is not the same
+ */
+size_t Base64DistHamming(string const &arg1, string const &arg2)
+{
+    return Base64DistHamming(arg1.data(), arg1.length(), arg2.data(), arg2.length());
+}
+
+/**
+ *  Calculate Hamming distance between two equal-length Base64-encoded buffers
+ *  Both are decoded in chunks and compared as bytes, so bits dropped by
+ *  padding don't count
+ *  @param arg1 First Base64-encoded string
+ *  @param len1 Length of first string
+ *  @param arg2 Second Base64-encoded string
+ *  @param len2 Length of second string
+ *  @return Humming distance between 2 inputs; BUF_ERROR if lengths are not
+ *  the same or on invalid input
+ */
+size_t Base64DistHamming(char const *arg1, size_t len1, char const *arg2,
+                         size_t len2)
+{
+    uint8_t chunk1[CONV_CHUNK], chunk2[CONV_CHUNK];
+    size_t retVal = 0, b64Chunk = CONV_CHUNK/3*4;
+
+    if (len1 != len2)
+        return BUF_ERROR;
 
-    //  Process input string by taking 3 chars at the time, combine them into a
-    //  single decimal number
-    for (uint32_t i = 0; i < arg.length(); i += 6)
+    //  Chunks are aligned in both inputs, only the last ones hold the padding
+    for (size_t i = 0; i < len1; i += b64Chunk)
     {
-        uint32_t chunk24bit = 0;
+        size_t inLen = ((len1 - i) > b64Chunk) ? b64Chunk : (len1 - i);
+        size_t n1 = SIMDBase64Decode(chunk1, arg1 + i, inLen);
+        size_t n2 = SIMDBase64Decode(chunk2, arg2 + i, inLen);
 
-        //  Accumulate 6 (or max avail. less than 6) hex digits(3 bytes) in a row
-        for (uint32_t j = 0; (j < 6) && ((i+j) < arg.length()); j++)
-            chunk24bit |= ((uint32_t)HexCharToInt(arg[j+i])<<((5-j)*4));
+        if ((n1 == BUF_ERROR) || (n1 != n2))
+            return BUF_ERROR;
 
-        //  Split accumulated 24-bit chunk in 6-bit, base64 signs
-        for (uint32_t j = 3; (j >= 0) && ((i/6)*4 + (3-j)) < b64Len; j--)
-            retVal[(i/6)*4 + (3-j)] = charSet[(chunk24bit >> (6*j)) & 0x3F];
+        retVal += SIMDHamming(chunk1, chunk2, n1);
     }
 
-    for (uint32_t j = b64Len; j < (b64Len+b64Pad); j++)
-        retVal[j] = '=';
+    return retVal;
+}
+
+//------------------------------------------------------------------------------
+//      Operations on HEX-encoded data                                  [PUBLIC]
+//------------------------------------------------------------------------------
+/**
+ *  Convert HEX-encoded string into its ASCII representation
+ *  @param arg HEX-encoded string to decode
+ *  @return ASCII representation of input string
+ */
+string HexToASCII(string const &arg)
+{
+    string retVal;
+    retVal.resize(arg.length()/2, 0);
+
+    if (HexToASCII(arg.data(), arg.length(), &retVal[0], retVal.length()) == BUF_ERROR)
+        return "ERROR";
+
+    return retVal;
+}
+
+/**
+ *  Convert HEX-encoded string into bytes in caller-supplied buffer
+ *  @param arg HEX-encoded string to decode
+ *  @param len Length of input, has to be even
+ *  @param out Output buffer, may be the same as arg
+ *  @param outSize Size of output buffer, at least len/2
+ *  @return Number of bytes written; BUF_ERROR on invalid input or output
+ *  buffer too small
+ */
+size_t HexToASCII(char const *arg, size_t len, char *out, size_t outSize)
+{
+    if (outSize < len/2)
+        return BUF_ERROR;
+
+    return SIMDHexDecode((uint8_t*)out, arg, len);
+}
+
+/**
+ *  Convert input HEX string into a Base64 string
+ *  @param arg Input HEX string
+ *  @return Corresponding Base64 string
+ */
+string HexToBase64(string const &arg)
+{
+    string retVal;
+
+    //  HEX input has to have even size
+    if ((arg.length() % 2) != 0)
+        return "ERROR";
+
+    //  Allocate memory for output string
+    retVal.resize(((arg.length()/2 + 2) / 3) * 4);
+    if (HexToBase64(arg.data(), arg.length(), &retVal[0], retVal.length()) == BUF_ERROR)
+        return "ERROR";
 
     return retVal;
 }
 
+/**
+ *  Convert input HEX string into a Base64 string in caller-supplied buffer
+ *  @param arg Input HEX string
+ *  @param len Length of input, has to be even
+ *  @param out Output buffer
+ *  @param outSize Size of output buffer, at least ((len/2+2)/3)*4
+ *  @return Number of chars written; BUF_ERROR on invalid input or output
+ *  buffer too small
+ */
+size_t HexToBase64(char const *arg, size_t len, char *out, size_t outSize)
+{
+    uint8_t chunk[CONV_CHUNK];
+    size_t o = 0;
+
+    if (((len % 2) != 0) || (outSize < ((len/2 + 2) / 3) * 4))
+        return BUF_ERROR;
+
+    //  Decode HEX in chunks small enough to stay in cache and encode each of
+    //  them to Base64. Only the last chunk can be shorter than CONV_CHUNK and
+    //  get padded
+    for (size_t i = 0; i < len; i += 2*CONV_CHUNK)
+    {
+        size_t inLen = ((len - i) > 2*CONV_CHUNK) ? 2*CONV_CHUNK : (len - i);
+        size_t outLen = SIMDHexDecode(chunk, arg + i, inLen);
+
+        if (outLen == BUF_ERROR)
+            return BUF_ERROR;
+
+        o += SIMDBase64Encode(out + o, chunk, outLen);
+    }
+
+    return o;
+}
+
 /**
  *  Perform XOR on two HEX encoded strings
  *  @param arg1 First HEX-encoded string
@@ -517,18 +1247,39 @@ string HexFixedXOR(string const &arg1,string const &arg2)
 {
     string retVal;
     retVal.resize(arg1.length(), 0);
-    if (arg1.length() != arg2.length())
-        return "ERROR";
 
-    for (uint32_t i = 0; i < arg1.length(); i++)
-    {
-        uint8_t res = HexCharToInt(arg1[i]) ^ HexCharToInt(arg2[i]);
-        retVal[i] = IntToHexChar(res);
-    }
+    if (HexFixedXOR(arg1.data(), arg1.length(), arg2.data(), arg2.length(),
+                    &retVal[0], retVal.length()) == BUF_ERROR)
+        return "ERROR";
 
     return retVal;
 }
 
+/**
+ *  Perform XOR on two equal-length HEX encoded strings into caller-supplied
+ *  buffer. XOR is done digit by digit, without decoding digits into bytes.
+ *  @param arg1 First HEX-encoded string
+ *  @param len1 Length of first string
+ *  @param arg2 Second HEX-encoded string
+ *  @param len2 Length of second string
+ *  @param out Output buffer, may be the same as one of inputs
+ *  @param outSize Size of output buffer, at least len1
+ *  @return Number of chars written; BUF_ERROR if lengths don't match, on
+ *  invalid digit or if output buffer is too small
+ */
+size_t HexFixedXOR(char const *arg1, size_t len1, char const *arg2,
+                   size_t len2, char *out, size_t outSize)
+{
+    if ((len1 != len2) || (outSize < len1))
+        return BUF_ERROR;
+
+    //  Key as long as the text is never repeated
+    if (SIMDHexRepeatXOR(out, arg1, len1, arg2, len1) == BUF_ERROR)
+        return BUF_ERROR;
+
+    return len1;
+}
+
 /**
  *  Perform repeating-key XORing of given text and key. In this process, key is
  *  extended by repeating original key to match the length of text string.
@@ -539,13 +1290,38 @@ string HexFixedXOR(string const &arg1,string const &arg2)
  */
 string HexRepeatKeyXOR(string const &text, string const &key)
 {
-    string keyNew;
+    string retVal;
+    retVal.resize(text.length(), 0);
+
+    if (HexRepeatKeyXOR(text.data(), text.length(), key.data(), key.length(),
+                        &retVal[0], retVal.length()) == BUF_ERROR)
+        return "ERROR";
+
+    return retVal;
+}
+
+/**
+ *  Perform repeating-key XORing of given HEX text and key into caller-supplied
+ *  buffer. Key digits are repeated in place, without building expanded key.
+ *  @param text HEX text to encrypt with repeating key
+ *  @param textLen Length of text
+ *  @param key Arbitrary-length HEX key to use for encryption of text variable
+ *  @param keyLen Length of key, non-zero
+ *  @param out Output buffer, may be the same as text
+ *  @param outSize Size of output buffer, at least textLen
+ *  @return Number of chars written; BUF_ERROR on empty key, invalid digit or
+ *  output buffer too small
+ */
+size_t HexRepeatKeyXOR(char const *text, size_t textLen, char const *key,
+                       size_t keyLen, char *out, size_t outSize)
+{
+    if ((keyLen == 0) || (outSize < textLen))
+        return BUF_ERROR;
 
-    //  Ensure that text and key have matching sizes
-    for (uint32_t i = 0; i < text.length(); i++)
-        keyNew += key[i % key.length()];
+    if (SIMDHexRepeatXOR(out, text, textLen, key, keyLen) == BUF_ERROR)
+        return BUF_ERROR;
 
-    return HexFixedXOR(text, keyNew);
+    return textLen;
 }
 
 /**
@@ -555,27 +1331,1625 @@ string HexRepeatKeyXOR(string const &text, string const &key)
  *  1s in XORed variable
  *  @param arg1 First HEX-encoded string
  *  @param arg2 Second HEX-encoded string
- *  @return Humming distance between 2 input strings; ULLONG_MAX if length of
+ *  @return Humming distance between 2 input strings; BUF_ERROR if length of
  *  strings is not the same
  */
-uint32_t HexDistHamming(string const &arg1, string const &arg2)
+size_t HexDistHamming(string const &arg1, string const &arg2)
+{
+    return HexDistHamming(arg1.data(), arg1.length(), arg2.data(), arg2.length());
+}
+
+/**
+ *  Calculate Hamming distance between two equal-length HEX-encoded buffers
+ *  @param arg1 First HEX-encoded string
+ *  @param len1 Length of first string
+ *  @param arg2 Second HEX-encoded string
+ *  @param len2 Length of second string
+ *  @return Humming distance between 2 inputs; BUF_ERROR if lengths are not
+ *  the same or on invalid digit
+ */
+size_t HexDistHamming(char const *arg1, size_t len1, char const *arg2,
+                      size_t len2)
+{
+    uint8_t chunk1[CONV_CHUNK], chunk2[CONV_CHUNK];
+    size_t retVal = 0, even = len1 & ~(size_t)1;
+
+    if (len1 != len2)
+        return BUF_ERROR;
+
+    //  Pairs of digits decode into whole bytes without changing the distance
+    for (size_t i = 0; i < even; i += 2*CONV_CHUNK)
+    {
+        size_t inLen = ((even - i) > 2*CONV_CHUNK) ? 2*CONV_CHUNK : (even - i);
+
+        if ((SIMDHexDecode(chunk1, arg1 + i, inLen) == BUF_ERROR) ||
+            (SIMDHexDecode(chunk2, arg2 + i, inLen) == BUF_ERROR))
+            return BUF_ERROR;
+
+        retVal += SIMDHamming(chunk1, chunk2, inLen/2);
+    }
+
+    //  Last digit of odd-length input decoded as a byte on its own
+    if (even < len1)
+    {
+        char pair1[2] = { '0', arg1[even] }, pair2[2] = { '0', arg2[even] };
+
+        if ((SIMDHexDecode(chunk1, pair1, 2) == BUF_ERROR) ||
+            (SIMDHexDecode(chunk2, pair2, 2) == BUF_ERROR))
+            return BUF_ERROR;
+
+        retVal += SIMDHamming(chunk1, chunk2, 1);
+    }
+
+    return retVal;
+}
+
+//------------------------------------------------------------------------------
+//      Single-byte XOR analysis                                        [PUBLIC]
+//------------------------------------------------------------------------------
+//  Number of best keys by histogram ranked again by the n-gram model
+#define SINGLE_RESCORE  16
+
+/**
+ *  Count occurrences of every byte value in buffer
+ *  @param data Input buffer
+ *  @param len Length of input buffer
+ *  @param hist Histogram to add counts to, 256 elements
+ */
+void ByteHistogram(char const *data, size_t len, uint64_t *hist)
+{
+    //  Consecutive equal bytes would increment the same counter back to back,
+    //  so four tables are used in turn and added together at the end. Not
+    //  worth clearing and adding them for short buffers.
+    uint64_t part[4][256];
+    size_t i = 0;
+
+    if (len < 1024)
+    {
+        for (; i < len; i++)
+            hist[(uint8_t)data[i]]++;
+        return;
+    }
+
+    memset(part, 0, sizeof(part));
+    for (; (i + 4) <= len; i += 4)
+    {
+        part[0][(uint8_t)data[i]]++;
+        part[1][(uint8_t)data[i+1]]++;
+        part[2][(uint8_t)data[i+2]]++;
+        part[3][(uint8_t)data[i+3]]++;
+    }
+    for (; i < len; i++)
+        part[0][(uint8_t)data[i]]++;
+
+    for (size_t b = 0; b < 256; b++)
+        hist[b] += part[0][b] + part[1][b] + part[2][b] + part[3][b];
+}
+
+/**
+ *  Find most likely keys of single-byte XOR ciphertext from its histogram
+ *  Every key is scored by log-likelihood of its plaintext under the English
+ *  character model, which only depends on the histogram, not on the text.
+ *  @param hist Histogram of ciphertext bytes, 256 elements
+ *  @param best Output, most likely keys, from the most likely one
+ *  @param topK Number of keys to return (up to 256)
+ *  @return Number of keys written into best
+ */
+size_t CrackSingleByteXOR(uint64_t const *hist, SingleByteKey *best, size_t topK)
 {
-    uint32_t retVal = 0;
+    SingleByteKey all[256];
+    double score[256] = { 0 };
+    uint64_t total = 0;
 
-    if (arg1.length() != arg2.length())
-        return (ULLONG_MAX & 0xFFFFFFF);
+    for (size_t c = 0; c < 256; c++)
+        total += hist[c];
+    SIMDXORKeyScores(score, hist, XORRows());
 
-    for (uint32_t i = 0; i < arg1.length(); i++)
+    double norm = (total > 0) ? (1.0 / total) : 0;
+    for (size_t k = 0; k < 256; k++)
     {
-        //  XOR two chars, this will set 1 in all bits that don't match, then we
-        //  just need to count number of bits that are 1
-        uint8_t xorRes = HexCharToInt(arg1[i]) ^ HexCharToInt(arg2[i]);
+        all[k].key = k;
+        all[k].score = score[k] * norm;
+    }
+
+    if (topK > 256)
+        topK = 256;
+    partial_sort_copy(all, all + 256, best, best + topK,
+        [](SingleByteKey const &k1, SingleByteKey const &k2) {
+            return (k1.score > k2.score) ||
+                   ((k1.score == k2.score) && (k1.key < k2.key));
+        }
+    );
+
+    return topK;
+}
+
+/**
+ *  Find most likely keys of single-byte XOR ciphertext
+ *  Keys are ranked from the histogram first, and the best of them ranked again
+ *  by scoring their plaintext with the full (n-gram) English model.
+ *  @param data Ciphertext
+ *  @param len Length of ciphertext
+ *  @param topK Number of keys to return (up to 256)
+ *  @return Most likely keys, from the most likely one
+ */
+vector<SingleByteKey> CrackSingleByteXOR(char const *data, size_t len, size_t topK)
+{
+    uint64_t hist[256] = { 0 };
+    vector<SingleByteKey> retVal((topK > SINGLE_RESCORE) ? topK : SINGLE_RESCORE);
 
-        //  Count number of bits that are 1
-        for (uint8_t j = 0; j < 8; j++)
-            if ((xorRes>>j) & 0x01)
-                retVal++;
+    if (retVal.size() > 256)
+        retVal.resize(256);
+    ByteHistogram(data, len, hist);
+    CrackSingleByteXOR(hist, retVal.data(), retVal.size());
+
+    for (size_t i = 0; i < retVal.size(); i++)
+    {
+        char key = retVal[i].key;
+        retVal[i].score = EnglishScoreXOR(data, len, &key, 1);
     }
+    stable_sort(retVal.begin(), retVal.end(),
+        [](SingleByteKey const &k1, SingleByteKey const &k2) {
+            return k1.score > k2.score;
+        }
+    );
+    retVal.resize((topK > 256) ? 256 : topK);
 
     return retVal;
 }
+
+/**
+ *  Find most likely keys of single-byte XOR ciphertext
+ *  @param data ASCII ciphertext
+ *  @param topK Number of keys to return (up to 256)
+ *  @return Most likely keys, from the most likely one
+ */
+vector<SingleByteKey> CrackSingleByteXOR(string const &data, size_t topK)
+{
+    return CrackSingleByteXOR(data.data(), data.length(), topK);
+}
+
+//  Number of chunks per thread lines are split into for bulk detection, so
+//  that threads finishing early can take over remaining work
+#define DETECT_CHUNKS   16
+
+/**
+ *  Candidate line found by a thread of bulk single-byte XOR detection
+ */
+struct LineCandidate
+{
+    size_t chunk, line;     //  Chunk, and line number within it
+    size_t start, len;      //  Encoded line within data
+    SingleByteKey key;
+};
+
+//  Ordering of candidates, the best one first
+static bool BetterCandidate(LineCandidate const &c1, LineCandidate const &c2)
+{
+    return (c1.key.score > c2.key.score) ||
+           ((c1.key.score == c2.key.score) &&
+            ((c1.chunk < c2.chunk) || ((c1.chunk == c2.chunk) && (c1.line < c2.line))));
+}
+
+/**
+ *  Decode line into buffer, growing it when needed
+ *  @return Number of decoded bytes; BUF_ERROR if line failed to decode
+ */
+static size_t DecodeLine(char const *line, size_t len, uint8_t encod,
+                         vector<char> &buf)
+{
+    if (encod == ENC_ASCII)
+    {
+        if (buf.size() < len)
+            buf.resize(len);
+        memcpy(buf.data(), line, len);
+        return len;
+    }
+
+    size_t need = (encod == ENC_HEX) ? (len/2) : ((len/4 + 1) * 3);
+    if (buf.size() < need)
+        buf.resize(need);
+
+    if (encod == ENC_HEX)
+        return HexToASCII(line, len, buf.data(), buf.size());
+    else if (encod == ENC_BASE64)
+        return Base64ToASCII(line, len, buf.data(), buf.size());
+
+    return BUF_ERROR;
+}
+
+/**
+ *  Detect single-byte XOR in one chunk of lines of bulk detection
+ *  @param start Start of chunk in data
+ *  @param end End of chunk in data
+ *  @param lineCount Output, number of lines of the chunk
+ *  @param buf Buffer for decoded lines
+ *  @param best Heap of best lines found by the worker, the worst one on top
+ */
+static void DetectChunk(char const *data, uint8_t encod, size_t topK, size_t chunk,
+                        size_t start, size_t end, size_t *lineCount,
+                        vector<char> &buf, vector<LineCandidate> &best)
+{
+    size_t pos = start, line = 0;
+
+    for (; pos < end; line++)
+    {
+        char const *nl = (char const*)memchr(data + pos, '\n', end - pos);
+        size_t lineEnd = nl ? (nl - data) : end, lineLen = lineEnd - pos;
+
+        if ((lineLen > 0) && (data[pos + lineLen - 1] == '\r'))
+            lineLen--;
+
+        size_t n = (lineLen > 0) ? DecodeLine(data + pos, lineLen, encod, buf) : 0;
+        if ((n != BUF_ERROR) && (n > 0))
+        {
+            uint64_t hist[256] = { 0 };
+            LineCandidate cand;
+
+            ByteHistogram(buf.data(), n, hist);
+            CrackSingleByteXOR(hist, &cand.key, 1);
+            cand.chunk = chunk;
+            cand.line = line;
+            cand.start = pos;
+            cand.len = lineLen;
+            KeepBest(best, cand, topK, BetterCandidate);
+        }
+
+        pos = lineEnd + 1;
+    }
+    *lineCount = line;
+}
+
+/**
+ *  Find lines most likely encrypted with single-byte XOR among many lines
+ *  Lines are split between threads in chunks, every line is decoded and its
+ *  most likely key found from its histogram. Every thread keeps its own top
+ *  lines, merged after all lines are processed.
+ *  @param data Lines, separated by new line (optionally preceded by carriage
+ *  return)
+ *  @param len Length of data
+ *  @param encod Encoding of lines (ENC_ASCII, ENC_HEX or ENC_BASE64), lines
+ *  failing to decode are skipped
+ *  @param topK Number of lines to return, nothing is processed if 0
+ *  @param threads Number of threads to use, 0 for one per CPU core
+ *  @param lines If not NULL, set to number of lines processed
+ *  @return Most likely lines, from the most likely one
+ */
+vector<LineKeyScore> DetectSingleByteXOR(char const *data, size_t len,
+                                         uint8_t encod, size_t topK,
+                                         uint32_t threads, size_t *lines)
+{
+    vector<LineKeyScore> retVal;
+    vector<size_t> bounds(1, 0), lineCount;
+
+    if (lines)
+        *lines = 0;
+    if (topK == 0)
+        return retVal;
+    if (threads == 0)
+        threads = thread::hardware_concurrency();
+    if (threads == 0)
+        threads = 1;
+
+    //  Chunk boundaries, moved forward to the start of the following line
+    size_t chunks = threads * DETECT_CHUNKS;
+    for (size_t i = 1; i < chunks; i++)
+    {
+        size_t pos = len / chunks * i;
+        if (pos <= bounds.back())
+            continue;
+        char const *nl = (char const*)memchr(data + pos - 1, '\n', len - pos + 1);
+        if (!nl)
+            break;
+        if ((size_t)(nl - data + 1) > bounds.back())
+            bounds.push_back(nl - data + 1);
+    }
+    if (len > bounds.back())
+        bounds.push_back(len);
+    else if (bounds.size() == 1)
+        bounds.push_back(0);
+    chunks = bounds.size() - 1;
+    lineCount.assign(chunks, 0);
+
+    threads = WorkerCount(threads, chunks);
+    vector< vector<LineCandidate> > best(threads);
+    vector< vector<char> > buf(threads);
+    RunItems(chunks, threads, [&](size_t chunk, uint32_t worker) {
+        DetectChunk(data, encod, topK, chunk, bounds[chunk], bounds[chunk + 1],
+                    &lineCount[chunk], buf[worker], best[worker]);
+    });
+
+    //  Merge best lines of all threads, line numbers are known only now that
+    //  lines of every chunk have been counted
+    vector<LineCandidate> all = MergeBest(best, topK, BetterCandidate);
+
+    vector<size_t> firstLine(chunks + 1, 0);
+    for (size_t i = 0; i < chunks; i++)
+        firstLine[i + 1] = firstLine[i] + lineCount[i];
+    if (lines)
+        *lines = firstLine[chunks];
+
+    for (size_t i = 0; i < all.size(); i++)
+    {
+        LineKeyScore res;
+        vector<char> buf;
+        size_t n = DecodeLine(data + all[i].start, all[i].len, encod, buf);
+        char key = all[i].key.key;
+
+        res.line = firstLine[all[i].chunk] + all[i].line;
+        res.key = all[i].key.key;
+        res.score = all[i].key.score;
+        res.plain.resize(n);
+        ASCIIRepeatKeyXOR(buf.data(), n, &key, 1, &res.plain[0], n);
+        retVal.push_back(res);
+    }
+
+    return retVal;
+}
+
+/**
+ *  Find lines of a file most likely encrypted with single-byte XOR (see
+ *  above), file is memory-mapped instead of read
+ *  @param path Path to file
+ *  @param lines If not NULL, set to number of lines processed, BUF_ERROR if
+ *  file can't be opened
+ *  @return Most likely lines, from the most likely one
+ */
+vector<LineKeyScore> DetectSingleByteXOR(string const &path, uint8_t encod,
+                                         size_t topK, uint32_t threads,
+                                         size_t *lines)
+{
+    MappedFile file(path);
+
+    if (!file.isOpen())
+    {
+        if (lines)
+            *lines = BUF_ERROR;
+        return vector<LineKeyScore>();
+    }
+
+    return DetectSingleByteXOR(file.data(), file.size(), encod, topK, threads,
+                               lines);
+}
+
+//------------------------------------------------------------------------------
+//      Repeating-key XOR analysis                                      [PUBLIC]
+//------------------------------------------------------------------------------
+/**
+ *  Score key size k
+ *  Sum of Hamming distances over all adjacent block pairs equals the distance
+ *  between the ciphertext and itself shifted by one key size, so every key size
+ *  takes a single kernel call.
+ */
+static KeySizeScore ScoreKeySize(char const *data, size_t len, uint32_t k)
+{
+    KeySizeScore retVal;
+    size_t span = (len / k - 1) * k;
+    size_t dist = SIMDHamming((const uint8_t*)data, (const uint8_t*)data + k, span);
+
+    retVal.keySize = k;
+    retVal.score = (double)dist / span;
+
+    return retVal;
+}
+
+/**
+ *  Estimate key size of a repeating-key XOR ciphertext
+ *  For every candidate key size, the whole ciphertext is split into blocks of
+ *  that size and Hamming distance is averaged over all pairs of adjacent
+ *  blocks, normalized to bits per byte. Candidate sizes are spread across
+ *  threads.
+ *  @param data Ciphertext
+ *  @param len Length of ciphertext
+ *  @param minSize Smallest key size to consider
+ *  @param maxSize Largest key size to consider (inclusive), sizes leaving
+ *  less than two blocks of ciphertext are skipped
+ *  @param threads Number of threads to use, 0 for one per CPU core
+ *  @return Candidate key sizes, ranked from the most likely one
+ */
+vector<KeySizeScore> EstimateRepeatingKeySize(char const *data, size_t len,
+                                              uint32_t minSize, uint32_t maxSize,
+                                              uint32_t threads)
+{
+    vector<KeySizeScore> retVal;
+
+    if (minSize == 0)
+        minSize = 1;
+    if (maxSize > len/2)
+        maxSize = len/2;
+    if (minSize > maxSize)
+        return retVal;
+
+    retVal.resize(maxSize - minSize + 1);
+    RunItems(retVal.size(), WorkerCount(threads, retVal.size()),
+        [&](size_t i, uint32_t) {
+            retVal[i] = ScoreKeySize(data, len, minSize + i);
+        }
+    );
+
+    sort(retVal.begin(), retVal.end(),
+        [](KeySizeScore const &s1, KeySizeScore const &s2) {
+            return s1.score < s2.score;
+        }
+    );
+
+    return retVal;
+}
+
+/**
+ *  Estimate key size of a repeating-key XOR ciphertext (see above)
+ *  @param data ASCII ciphertext
+ *  @return Candidate key sizes, ranked from the most likely one
+ */
+vector<KeySizeScore> EstimateRepeatingKeySize(string const &data,
+                                              uint32_t minSize, uint32_t maxSize,
+                                              uint32_t threads)
+{
+    return EstimateRepeatingKeySize(data.data(), data.length(), minSize, maxSize,
+                                    threads);
+}
+
+//  Cost of one FFT stage over a ciphertext byte, in direct byte comparisons,
+//  used to pick the cheaper way of counting coincidences
+#define IOC_FFT_COST 48
+//  Standard errors within which key sizes score the same
+#define IOC_TIE_ERRORS 3.0
+
+/**
+ *  Count equal byte pairs k bytes apart
+ */
+static uint64_t CountCoincidences(char const *data, size_t len, uint32_t k)
+{
+    const uint64_t low7 = 0x7F7F7F7F7F7F7F7FULL;
+    const uint64_t even = 0x00FF00FF00FF00FFULL;
+    uint64_t equal = 0;
+    size_t i = 0;
+
+    //  Eight pairs at a time, equal bytes XOR to zero bytes, whose top bit
+    //  is the only one left clear after adding 0x7F to the low seven bits.
+    //  Flags are summed per byte lane, at most 255 words before lanes are
+    //  added together.
+    while ((i + k + 8) <= len)
+    {
+        uint64_t lanes = 0;
+        for (uint16_t w = 0; (w < 255) && ((i + k + 8) <= len); w++, i += 8)
+        {
+            uint64_t a, b;
+            memcpy(&a, data + i, 8);
+            memcpy(&b, data + i + k, 8);
+            uint64_t x = a ^ b;
+            lanes += (~(((x & low7) + low7) | x) & ~low7) >> 7;
+        }
+        lanes = (lanes & even) + ((lanes >> 8) & even);
+        equal += (lanes * 0x0001000100010001ULL) >> 48;
+    }
+    for (; (i + k) < len; i++)
+        equal += (data[i] == data[i + k]);
+
+    return equal;
+}
+
+/**
+ *  In-place radix-2 FFT
+ *  @param a Sequence to transform, length is a power of 2
+ *  @param n Length of sequence
+ *  @param roots Roots of unity, roots[i] = exp(-2*pi*j*i/n) for i < n/2
+ *  @param inverse Compute inverse transform (without scaling by 1/n)
+ */
+static void FFT(complex<double> *a, size_t n, complex<double> const *roots,
+                bool inverse)
+{
+    //  Bit-reversal permutation
+    for (size_t i = 1, j = 0; i < n; i++)
+    {
+        size_t bit = n >> 1;
+        for (; j & bit; bit >>= 1)
+            j ^= bit;
+        j ^= bit;
+        if (i < j)
+            swap(a[i], a[j]);
+    }
+
+    for (size_t len = 2; len <= n; len <<= 1)
+    {
+        size_t step = n / len;
+        for (size_t i = 0; i < n; i += len)
+            for (size_t j = 0; j < len/2; j++)
+            {
+                //  Multiplication spelled out, complex operator* checks for
+                //  infinities and is several times slower
+                double wr = roots[j*step].real();
+                double wi = inverse ? -roots[j*step].imag() : roots[j*step].imag();
+                complex<double> x = a[i+j+len/2], u = a[i+j];
+                complex<double> v(x.real()*wr - x.imag()*wi, x.real()*wi + x.imag()*wr);
+                a[i+j] = u + v;
+                a[i+j+len/2] = u - v;
+            }
+    }
+}
+
+/**
+ *  Transform indicator of a byte value over ciphertext block, zero-padded to
+ *  twice its size
+ *  @param out Transformed block, 2*half elements
+ */
+static void IndicatorBlockFFT(char const *data, size_t len, size_t half,
+                              size_t block, char value,
+                              complex<double> const *roots, complex<double> *out)
+{
+    for (size_t i = 0; i < 2*half; i++)
+    {
+        size_t pos = block*half + i;
+        out[i] = ((i < half) && (pos < len) && (data[pos] == value)) ? 1.0 : 0.0;
+    }
+    FFT(out, 2*half, roots, false);
+}
+
+/**
+ *  Accumulate cross-spectrum of indicator of a byte value
+ *  Every half-long block, zero-padded to 2*half, is correlated with itself
+ *  followed by the next block, which covers all shifts up to half without
+ *  circular wrap. Since moving a sequence by half of the transform length
+ *  multiplies its transform by (-1)^k, only one transform per block is needed.
+ *  @param spectrum Accumulator, 2*half elements
+ */
+static void CrossSpectrum(char const *data, size_t len, size_t half, char value,
+                          complex<double> const *roots, complex<double> *spectrum)
+{
+    vector< complex<double> > cur(2*half), next(2*half);
+    size_t blocks = (len + half - 1) / half;
+
+    IndicatorBlockFFT(data, len, half, 0, value, roots, &cur[0]);
+    for (size_t b = 0; b < blocks; b++)
+    {
+        IndicatorBlockFFT(data, len, half, b + 1, value, roots, &next[0]);
+        for (size_t k = 0; k < 2*half; k++)
+        {
+            complex<double> w = (k & 1) ? (cur[k] - next[k]) : (cur[k] + next[k]);
+            double cr = cur[k].real(), ci = cur[k].imag();
+            spectrum[k] += complex<double>(cr*w.real() + ci*w.imag(),
+                                           cr*w.imag() - ci*w.real());
+        }
+        cur.swap(next);
+    }
+}
+
+/**
+ *  Estimate key size of a repeating-key XOR ciphertext from autocorrelation
+ *  Ciphertext bytes repeat as often as plaintext ones (index of coincidence)
+ *  only when compared at a shift that is a multiple of the key size. Number of
+ *  equal bytes is counted exactly for every shift, either directly or, for
+ *  wide ranges of key sizes, with one FFT autocorrelation per byte value
+ *  present in the ciphertext. Score is the share of equal bytes (higher is
+ *  better). Multiples of the key size score as high as the key size itself,
+ *  so key sizes scoring the same as one of their divisors (within sampling
+ *  error) are ranked right after the smallest such divisor.
+ *  @param data Ciphertext
+ *  @param len Length of ciphertext
+ *  @param minSize Smallest key size to consider
+ *  @param maxSize Largest key size to consider (inclusive), sizes longer than
+ *  half of the ciphertext are skipped
+ *  @param threads Number of threads to use, 0 for one per CPU core
+ *  @return Candidate key sizes, ranked from the most likely one
+ */
+vector<KeySizeScore> EstimateRepeatingKeySizeIoC(char const *data, size_t len,
+                                                 uint32_t minSize, uint32_t maxSize,
+                                                 uint32_t threads)
+{
+    vector<KeySizeScore> retVal;
+
+    if (minSize == 0)
+        minSize = 1;
+    if (maxSize > len/2)
+        maxSize = len/2;
+    if (minSize > maxSize)
+        return retVal;
+
+    size_t sizes = maxSize - minSize + 1;
+    vector<uint64_t> counts(sizes);
+
+    //  Only byte values present at least twice can coincide
+    uint64_t hist[256] = { 0 };
+    string values;
+    ByteHistogram(data, len, hist);
+    for (uint16_t v = 0; v < 256; v++)
+        if (hist[v] > 1)
+            values += (char)v;
+
+    //  Block length, transforms are twice as long
+    size_t half = 32, stages = 6;
+    while (half < maxSize)
+    {
+        half <<= 1;
+        stages++;
+    }
+
+    if (sizes <= values.length() * stages * IOC_FFT_COST)
+    {
+        //  Direct count, one item per shift
+        RunItems(sizes, WorkerCount(threads, sizes),
+            [&](size_t i, uint32_t) {
+                counts[i] = CountCoincidences(data, len, minSize + i);
+            }
+        );
+    }
+    else
+    {
+        //  One item per byte value, every worker accumulates cross-spectra of
+        //  its values, which are then added together
+        vector< complex<double> > roots(half);
+        for (size_t i = 0; i < roots.size(); i++)
+            roots[i] = polar(1.0, -M_PI * i / half);
+
+        threads = WorkerCount(threads, values.length());
+        vector< vector< complex<double> > > spectrum(threads,
+                                                     vector< complex<double> >(2*half));
+        RunItems(values.length(), threads,
+            [&](size_t v, uint32_t worker) {
+                CrossSpectrum(data, len, half, values[v], &roots[0],
+                              &spectrum[worker][0]);
+            }
+        );
+        for (size_t t = 1; t < threads; t++)
+            for (size_t i = 0; i < 2*half; i++)
+                spectrum[0][i] += spectrum[t][i];
+
+        //  Back to autocorrelation, element k holds number of equal byte pairs
+        //  k bytes apart (times transform length), rounding error is far below
+        //  one pair
+        FFT(&spectrum[0][0], 2*half, &roots[0], true);
+        for (uint32_t k = minSize; k <= maxSize; k++)
+            counts[k - minSize] = llround(spectrum[0][k].real() / (2.0 * half));
+    }
+
+    for (uint32_t k = minSize; k <= maxSize; k++)
+    {
+        KeySizeScore score;
+        score.keySize = k;
+        score.score = (double)counts[k - minSize] / (len - k);
+        retVal.push_back(score);
+    }
+
+    //  Smallest divisor scoring the same as each key size
+    vector<uint32_t> period(sizes);
+    for (uint32_t k = minSize; k <= maxSize; k++)
+    {
+        double s = retVal[k - minSize].score;
+        double tolerance = IOC_TIE_ERRORS * sqrt(s * (1.0 - s) / (len - k));
+
+        period[k - minSize] = k;
+        for (uint32_t d = minSize; d <= k/2; d++)
+            if (((k % d) == 0) && (fabs(retVal[d - minSize].score - s) <= tolerance))
+            {
+                period[k - minSize] = d;
+                break;
+            }
+    }
+
+    //  Rank by score of the period, multiples of it right after it
+    sort(retVal.begin(), retVal.end(),
+        [&](KeySizeScore const &s1, KeySizeScore const &s2) {
+            uint32_t p1 = period[s1.keySize - minSize];
+            uint32_t p2 = period[s2.keySize - minSize];
+            double r1 = (double)counts[p1 - minSize] / (len - p1);
+            double r2 = (double)counts[p2 - minSize] / (len - p2);
+
+            if (r1 != r2)
+                return r1 > r2;
+            if (p1 != p2)
+                return p1 < p2;
+            return s1.keySize < s2.keySize;
+        }
+    );
+
+    return retVal;
+}
+
+/**
+ *  Estimate key size of a repeating-key XOR ciphertext from autocorrelation
+ *  (see above)
+ *  @param data ASCII ciphertext
+ *  @return Candidate key sizes, ranked from the most likely one
+ */
+vector<KeySizeScore> EstimateRepeatingKeySizeIoC(string const &data,
+                                                 uint32_t minSize, uint32_t maxSize,
+                                                 uint32_t threads)
+{
+    return EstimateRepeatingKeySizeIoC(data.data(), data.length(), minSize,
+                                       maxSize, threads);
+}
+
+/**
+ *  Column of ciphertext encrypted with the same key byte, and its best keys
+ */
+struct KeyColumn
+{
+    uint32_t keySize, index;
+    size_t offset;                  //  Start of column in transposed data
+    size_t count;                   //  Number of bytes in column
+    vector<SingleByteKey> best;
+};
+
+/**
+ *  Crack a column as single-byte XOR, keeping its best keys
+ */
+static void CrackColumn(char const *columnData, KeyColumn &col, size_t candidates)
+{
+    uint64_t hist[256] = { 0 };
+
+    ByteHistogram(columnData + col.offset, col.count, hist);
+    col.best.resize(candidates);
+    CrackSingleByteXOR(hist, col.best.data(), candidates);
+}
+
+/**
+ *  Shortest period of a key, keys like "ICEICE" decrypt the same as "ICE"
+ */
+static string ShortestPeriod(string const &key)
+{
+    for (size_t p = 1; p < key.length(); p++)
+    {
+        if ((key.length() % p) != 0)
+            continue;
+
+        size_t i = p;
+        while ((i < key.length()) && (key[i] == key[i - p]))
+            i++;
+        if (i == key.length())
+            return key.substr(0, p);
+    }
+
+    return key;
+}
+
+/**
+ *  Break repeating-key XOR cipher
+ *  Most likely key sizes are found by EstimateRepeatingKeySize, and for each
+ *  of them (and their divisors) ciphertext is split into columns encrypted by
+ *  the same key byte. Columns are cracked in parallel as single-byte XOR, and
+ *  best full keys are assembled column by column, keeping only beamWidth best
+ *  partial keys. Keys repeating with a shorter period are reduced to it, and
+ *  full keys are ranked by n-gram score of their plaintext.
+ *  @param data Ciphertext
+ *  @param len Length of ciphertext
+ *  @param topN Number of keys to return
+ *  @param minSize Smallest key size to consider
+ *  @param maxSize Largest key size to consider (inclusive)
+ *  @param sizes Number of most likely key sizes to try
+ *  @param beamWidth Number of best partial keys kept, also number of
+ *  candidates taken from every column (up to 256)
+ *  @param threads Number of threads to use, 0 for one per CPU core
+ *  @return Most likely keys, from the most likely one
+ */
+vector<RepeatingKey> BreakRepeatingKeyXOR(char const *data, size_t len,
+                                          size_t topN, uint32_t minSize,
+                                          uint32_t maxSize, uint32_t sizes,
+                                          uint32_t beamWidth, uint32_t threads)
+{
+    vector<RepeatingKey> retVal, found;
+    vector<KeyColumn> columns;
+
+    vector<KeySizeScore> estimate = EstimateRepeatingKeySize(data, len, minSize,
+                                                             maxSize, threads);
+    vector<uint32_t> ranking;
+
+    //  Estimates often favor multiples of the key size, so their divisors are
+    //  tried as well
+    for (size_t r = 0; (r < estimate.size()) && (r < sizes); r++)
+        for (uint32_t d = (minSize > 0) ? minSize : 1; d <= estimate[r].keySize; d++)
+            if (((estimate[r].keySize % d) == 0) &&
+                (find(ranking.begin(), ranking.end(), d) == ranking.end()))
+                ranking.push_back(d);
+    if (beamWidth == 0)
+        beamWidth = 1;
+    if (beamWidth > 256)
+        beamWidth = 256;
+
+    //  Columns of all key sizes, cracked in parallel. Ciphertext is transposed
+    //  once per key size (into one shared buffer), so that every column is
+    //  a contiguous run of bytes instead of a strided walk over the whole text
+    size_t total = 0;
+    for (size_t r = 0; r < ranking.size(); r++)
+    {
+        size_t stride = (len + ranking[r] - 1) / ranking[r];
+        for (uint32_t i = 0; i < ranking[r]; i++)
+        {
+            KeyColumn col;
+            col.keySize = ranking[r];
+            col.index = i;
+            col.offset = total + i*stride;
+            col.count = (len - i + ranking[r] - 1) / ranking[r];
+            columns.push_back(col);
+        }
+        total += ranking[r] * stride;
+    }
+    string columnData(total, 0);
+    for (size_t r = 0, offset = 0; r < ranking.size(); r++)
+        offset += ASCIITranspose(data, len, ranking[r], &columnData[offset],
+                                 total - offset);
+
+    RunItems(columns.size(), WorkerCount(threads, columns.size()),
+        [&](size_t i, uint32_t) {
+            CrackColumn(columnData.data(), columns[i], beamWidth);
+        }
+    );
+
+    //  Beam search over columns of every key size. Scores of columns add up
+    //  (weighted by their length), so taking beamWidth best keys from each
+    //  column is enough to find beamWidth best full keys.
+    size_t col = 0;
+    for (size_t r = 0; r < ranking.size(); r++)
+    {
+        vector< pair<double, string> > beam(1, make_pair(0.0, string())), grown;
+
+        for (uint32_t i = 0; i < ranking[r]; i++, col++)
+        {
+            KeyColumn const &kc = columns[col];
+
+            grown.clear();
+            for (size_t b = 0; b < beam.size(); b++)
+                for (size_t k = 0; k < kc.best.size(); k++)
+                    grown.push_back(make_pair(beam[b].first + kc.best[k].score * kc.count,
+                                              beam[b].second + (char)kc.best[k].key));
+
+            size_t keep = (grown.size() < beamWidth) ? grown.size() : beamWidth;
+            partial_sort(grown.begin(), grown.begin() + keep, grown.end(),
+                [](pair<double, string> const &p1, pair<double, string> const &p2) {
+                    return p1.first > p2.first;
+                }
+            );
+            grown.resize(keep);
+            beam.swap(grown);
+        }
+
+        //  Columns are scored byte by byte, full keys by n-grams across them
+        for (size_t b = 0; b < beam.size(); b++)
+        {
+            RepeatingKey res;
+            res.key = ShortestPeriod(beam[b].second);
+            res.score = EnglishScoreXOR(data, len, res.key.data(), res.key.length()) -
+                        ranking[r] * log(256.0) / len;
+            found.push_back(res);
+        }
+    }
+
+    //  Best keys first, shorter one of equally good, same key found for
+    //  multiples of its size only once
+    stable_sort(found.begin(), found.end(),
+        [](RepeatingKey const &k1, RepeatingKey const &k2) {
+            return (k1.score > k2.score) ||
+                   ((k1.score == k2.score) && (k1.key.length() < k2.key.length()));
+        }
+    );
+    for (size_t i = 0; (i < found.size()) && (retVal.size() < topN); i++)
+    {
+        bool dup = false;
+        for (size_t j = 0; (j < retVal.size()) && !dup; j++)
+            dup = (retVal[j].key == found[i].key);
+        if (dup)
+            continue;
+
+        found[i].plain.resize(len);
+        ASCIIRepeatKeyXOR(data, len, found[i].key.data(), found[i].key.length(),
+                          &found[i].plain[0], len);
+        retVal.push_back(found[i]);
+    }
+
+    return retVal;
+}
+
+/**
+ *  Break repeating-key XOR cipher (see above)
+ *  @param data ASCII ciphertext
+ *  @return Most likely keys, from the most likely one
+ */
+vector<RepeatingKey> BreakRepeatingKeyXOR(string const &data, size_t topN,
+                                          uint32_t minSize, uint32_t maxSize,
+                                          uint32_t sizes, uint32_t beamWidth,
+                                          uint32_t threads)
+{
+    return BreakRepeatingKeyXOR(data.data(), data.length(), topN, minSize,
+                                maxSize, sizes, beamWidth, threads);
+}
+
+//------------------------------------------------------------------------------
+//      Crib dragging                                                   [PUBLIC]
+//------------------------------------------------------------------------------
+//  Number of offsets in a chunk, and number of cribs in a group, processed by
+//  a thread at the time
+#define CRIB_CHUNK      65536
+#define CRIB_GROUP      16
+
+//  Ordering of windows, the best one first
+static bool BetterMatch(CribMatch const &m1, CribMatch const &m2)
+{
+    return (m1.ratio > m2.ratio) ||
+           ((m1.ratio == m2.ratio) &&
+            ((m1.score > m2.score) ||
+             ((m1.score == m2.score) &&
+              ((m1.crib < m2.crib) || ((m1.crib == m2.crib) && (m1.offset < m2.offset))))));
+}
+
+/**
+ *  Buffers of a crib dragging worker, and its best windows
+ */
+struct CribWorkspace
+{
+    vector<uint64_t> match;
+    vector<size_t> found;
+    vector<double> score;
+    vector<CribMatch> best;     //  Heap of best windows, the worst one on top
+};
+
+/**
+ *  Drag a group of cribs over a chunk of offsets
+ *  @param item Index of (chunk, crib group) pair
+ *  @param ws Workspace of the worker
+ */
+static void CribChunk(char const *x, size_t len, vector<string> const &cribs,
+                      size_t topN, double minRatio, uint8_t mask,
+                      EnglishModel const &model, size_t item, CribWorkspace &ws)
+{
+    size_t groups = (cribs.size() + CRIB_GROUP - 1) / CRIB_GROUP;
+    size_t start = (item / groups) * CRIB_CHUNK, first = (item % groups) * CRIB_GROUP;
+    vector<uint64_t> &match = ws.match;
+    vector<size_t> &found = ws.found;
+    vector<double> &score = ws.score;
+
+    match.resize(CRIB_CHUNK / 64);
+    for (size_t c = first; (c < first + CRIB_GROUP) && (c < cribs.size()); c++)
+    {
+        string const &crib = cribs[c];
+        size_t cribLen = crib.length();
+        if ((cribLen == 0) || (cribLen > len) || (start > (len - cribLen)))
+            continue;
+
+        //  Classifier filters a vector of windows at the time
+        size_t n = len - cribLen + 1 - start;
+        size_t need = (size_t)ceil(minRatio * cribLen - 1e-9);
+        size_t maxMiss = cribLen - need;
+        if (n > CRIB_CHUNK)
+            n = CRIB_CHUNK;
+        SIMDCribMatch(match.data(), (const uint8_t*)x + start, n,
+                      (const uint8_t*)crib.data(), cribLen, classRows[mask],
+                      (mask & CHAR_CONT) != 0, (maxMiss > 254) ? 254 : maxMiss);
+
+        //  Survivors of one crib are scored in one batch, exact share of
+        //  text is only needed if some misses were allowed
+        found.clear();
+        for (size_t w = 0; w < (n + 63) / 64; w++)
+            for (uint64_t bits = match[w]; bits != 0; bits &= bits - 1)
+                found.push_back(start + w*64 + __builtin_ctzll(bits));
+        score.resize(found.size());
+        EnglishScoreWindows(score.data(), x, found.data(), found.size(),
+                            crib.data(), cribLen, &model);
+
+        for (size_t f = 0; f < found.size(); f++)
+        {
+            CribMatch cand;
+            size_t hits = cribLen;
+
+            if (maxMiss > 0)
+            {
+                hits = 0;
+                for (size_t i = 0; i < cribLen; i++)
+                    hits += (charClass[(uint8_t)(x[found[f] + i] ^ crib[i])] & mask) != 0;
+                if (hits < need)
+                    continue;
+            }
+            cand.crib = c;
+            cand.offset = found[f];
+            cand.ratio = (double)hits / cribLen;
+            cand.score = score[f];
+
+            KeepBest(ws.best, cand, topN, BetterMatch);
+        }
+    }
+}
+
+/**
+ *  Crib dragging over XOR of two ciphertexts encrypted with the same keystream
+ *  (which equals XOR of their plaintexts). Every crib is XORed into every
+ *  window of the same length, and where the result is text (all or minRatio
+ *  of its chars fall into classes in mask) the crib likely is part of one
+ *  plaintext and the result part of the other. Windows are filtered by the
+ *  character classifier a vector of offsets at the time, survivors ranked by
+ *  n-gram score. Input is split into chunks of offsets, which threads process
+ *  for groups of cribs.
+ *  @param x XOR of two ciphertexts
+ *  @param len Length of XOR (length of the shorter ciphertext)
+ *  @param cribs Guessed words or phrases of plaintext
+ *  @param topN Number of windows to return
+ *  @param minRatio Lowest share of chars in accepted classes, in range [0, 1]
+ *  (at most 254 chars of a window are allowed outside them)
+ *  @param mask Bitwise OR of accepted CHAR_* classes
+ *  @param threads Number of threads to use, 0 for one per CPU core
+ *  @return Best windows, by ratio and then score, from the best one
+ */
+vector<CribMatch> CribDrag(char const *x, size_t len, vector<string> const &cribs,
+                           size_t topN, double minRatio, uint8_t mask,
+                           uint32_t threads)
+{
+    vector<CribMatch> retVal;
+    size_t items = ((len + CRIB_CHUNK - 1) / CRIB_CHUNK) *
+                   ((cribs.size() + CRIB_GROUP - 1) / CRIB_GROUP);
+
+    if ((topN == 0) || (items == 0))
+        return retVal;
+    if (minRatio < 0)
+        minRatio = 0;
+    if (minRatio > 1)
+        minRatio = 1;
+    mask &= 0x7F;
+
+    threads = WorkerCount(threads, items);
+    EnglishModel const &model = EnglishActiveModel();
+    vector<CribWorkspace> ws(threads);
+    RunItems(items, threads, [&](size_t item, uint32_t worker) {
+        CribChunk(x, len, cribs, topN, minRatio, mask, model, item, ws[worker]);
+    });
+
+    //  Merge best windows of all threads, and reveal text only of the final ones
+    vector< vector<CribMatch> > best(threads);
+    for (uint32_t t = 0; t < threads; t++)
+        best[t].swap(ws[t].best);
+    retVal = MergeBest(best, topN, BetterMatch);
+
+    for (size_t i = 0; i < retVal.size(); i++)
+    {
+        string const &crib = cribs[retVal[i].crib];
+        retVal[i].text = ASCIIFixedXOR(string(x + retVal[i].offset, crib.length()), crib);
+    }
+
+    return retVal;
+}
+
+/**
+ *  Crib dragging over XOR of two ciphertexts (see above)
+ *  @param x XOR of two ciphertexts
+ *  @return Best windows, by ratio and then score, from the best one
+ */
+vector<CribMatch> CribDrag(string const &x, vector<string> const &cribs,
+                           size_t topN, double minRatio, uint8_t mask,
+                           uint32_t threads)
+{
+    return CribDrag(x.data(), x.length(), cribs, topN, minRatio, mask, threads);
+}
+
+//------------------------------------------------------------------------------
+//      Streaming encoders/decoders                                     [PUBLIC]
+//------------------------------------------------------------------------------
+/**
+ *  Find the end of data that precedes the next line break
+ *  @param in Input chunk
+ *  @param inLen Length of input chunk
+ *  @param runLen [out] Length of data before line break (without CR of CRLF)
+ *  @return Number of input chars consumed by data and the line break
+ */
+static size_t NextDataRun(char const *in, size_t inLen, size_t &runLen)
+{
+    const char *eol = (const char*)memchr(in, '\n', inLen);
+
+    runLen = eol ? (size_t)(eol - in) : inLen;
+    size_t consumed = eol ? (runLen + 1) : runLen;
+
+    if ((runLen > 0) && (in[runLen-1] == '\r'))
+        runLen--;
+
+    return consumed;
+}
+
+Base64Decoder::Base64Decoder()
+{
+    reset();
+}
+
+/**
+ *  Drop all carried state and start a new stream
+ */
+void Base64Decoder::reset()
+{
+    _quantumLen = 0;
+    _padded = false;
+    _failed = false;
+}
+
+/**
+ *  Decode a run of input that contains no line breaks
+ */
+size_t Base64Decoder::decodeRun(char const *in, size_t inLen, uint8_t *out)
+{
+    size_t o = 0, n, body;
+
+    if (inLen == 0)
+        return 0;
+    //  Nothing can follow the padding
+    if (_padded)
+        return BUF_ERROR;
+
+    //  First complete the quantum carried over from the last chunk
+    if (_quantumLen > 0)
+    {
+        while ((_quantumLen < 4) && (inLen > 0))
+            _quantum[_quantumLen++] = *in++, inLen--;
+        if (_quantumLen < 4)
+            return 0;
+
+        if ((n = SIMDBase64Decode(out, _quantum, 4)) == BUF_ERROR)
+            return BUF_ERROR;
+        o += n;
+        _padded = (_quantum[3] == '=');
+        _quantumLen = 0;
+    }
+
+    //  Decode all whole quanta directly from the input
+    body = inLen & ~(size_t)3;
+    if (body > 0)
+    {
+        if (_padded)
+            return BUF_ERROR;
+        if ((n = SIMDBase64Decode(out + o, in, body)) == BUF_ERROR)
+            return BUF_ERROR;
+        o += n;
+        _padded = (in[body-1] == '=');
+    }
+
+    //  Keep the leftover digits for the next chunk
+    if (body < inLen)
+    {
+        if (_padded)
+            return BUF_ERROR;
+        memcpy(_quantum, in + body, inLen - body);
+        _quantumLen = inLen - body;
+    }
+
+    return o;
+}
+
+/**
+ *  Decode next chunk of input
+ *  @param in Chunk of Base64 input
+ *  @param inLen Length of the chunk
+ *  @param out Output buffer, has to hold at least (inLen/4 + 1)*3 bytes
+ *  @return Number of bytes written; BUF_ERROR on invalid input
+ */
+size_t Base64Decoder::update(char const *in, size_t inLen, uint8_t *out)
+{
+    size_t o = 0;
+
+    while (!_failed && (inLen > 0))
+    {
+        size_t runLen, consumed = NextDataRun(in, inLen, runLen);
+        size_t n = decodeRun(in, runLen, out + o);
+
+        if (n == BUF_ERROR)
+            _failed = true;
+        else
+            o += n;
+
+        in += consumed;
+        inLen -= consumed;
+    }
+
+    return _failed ? BUF_ERROR : o;
+}
+
+/**
+ *  Decode next chunk of input
+ *  @param chunk Chunk of Base64 input
+ *  @return Decoded bytes; "ERROR" on invalid input
+ */
+string Base64Decoder::update(string const &chunk)
+{
+    string retVal((chunk.length()/4 + 1)*3, 0);
+    size_t n = update(chunk.data(), chunk.length(), (uint8_t*)&retVal[0]);
+
+    if (n == BUF_ERROR)
+        return "ERROR";
+
+    retVal.resize(n);
+    return retVal;
+}
+
+/**
+ *  Flush the last, unpadded quantum (if any) and reset the decoder
+ *  @param out Output buffer, has to hold at least 3 bytes
+ *  @return Number of bytes written; BUF_ERROR if stream ended on invalid
+ *  input or with a single leftover digit
+ */
+size_t Base64Decoder::finish(uint8_t *out)
+{
+    size_t n = 0;
+
+    if (_failed)
+        n = BUF_ERROR;
+    else if (_quantumLen > 0)
+        n = SIMDBase64Decode(out, _quantum, _quantumLen);
+
+    reset();
+    return n;
+}
+
+/**
+ *  Flush the last, unpadded quantum (if any) and reset the decoder
+ *  @return Decoded bytes; "ERROR" on invalid stream
+ */
+string Base64Decoder::finish()
+{
+    uint8_t tail[3];
+    size_t n = finish(tail);
+
+    if (n == BUF_ERROR)
+        return "ERROR";
+
+    return string((const char*)tail, n);
+}
+
+HexDecoder::HexDecoder()
+{
+    reset();
+}
+
+/**
+ *  Drop all carried state and start a new stream
+ */
+void HexDecoder::reset()
+{
+    _hasNibble = false;
+    _failed = false;
+}
+
+/**
+ *  Decode a run of input that contains no line breaks
+ */
+size_t HexDecoder::decodeRun(char const *in, size_t inLen, uint8_t *out)
+{
+    size_t o = 0, body;
+
+    if (inLen == 0)
+        return 0;
+
+    //  Pair up the digit carried over from the last chunk
+    if (_hasNibble)
+    {
+        char pair[2] = { _nibble, *in++ };
+        inLen--;
+        if (SIMDHexDecode(out, pair, 2) == BUF_ERROR)
+            return BUF_ERROR;
+        o++;
+        _hasNibble = false;
+    }
+
+    body = inLen & ~(size_t)1;
+    if ((body > 0) && (SIMDHexDecode(out + o, in, body) == BUF_ERROR))
+        return BUF_ERROR;
+    o += body/2;
+
+    if (body < inLen)
+    {
+        _nibble = in[body];
+        _hasNibble = true;
+    }
+
+    return o;
+}
+
+/**
+ *  Decode next chunk of input
+ *  @param in Chunk of HEX input
+ *  @param inLen Length of the chunk
+ *  @param out Output buffer, has to hold at least inLen/2 + 1 bytes
+ *  @return Number of bytes written; BUF_ERROR on invalid input
+ */
+size_t HexDecoder::update(char const *in, size_t inLen, uint8_t *out)
+{
+    size_t o = 0;
+
+    while (!_failed && (inLen > 0))
+    {
+        size_t runLen, consumed = NextDataRun(in, inLen, runLen);
+        size_t n = decodeRun(in, runLen, out + o);
+
+        if (n == BUF_ERROR)
+            _failed = true;
+        else
+            o += n;
+
+        in += consumed;
+        inLen -= consumed;
+    }
+
+    return _failed ? BUF_ERROR : o;
+}
+
+/**
+ *  Decode next chunk of input
+ *  @param chunk Chunk of HEX input
+ *  @return Decoded bytes; "ERROR" on invalid input
+ */
+string HexDecoder::update(string const &chunk)
+{
+    string retVal(chunk.length()/2 + 1, 0);
+    size_t n = update(chunk.data(), chunk.length(), (uint8_t*)&retVal[0]);
+
+    if (n == BUF_ERROR)
+        return "ERROR";
+
+    retVal.resize(n);
+    return retVal;
+}
+
+/**
+ *  End the stream and reset the decoder
+ *  @return 0; BUF_ERROR if stream ended on invalid input or half a byte
+ */
+size_t HexDecoder::finish()
+{
+    size_t n = (_failed || _hasNibble) ? BUF_ERROR : 0;
+
+    reset();
+    return n;
+}
+
+Base64Encoder::Base64Encoder()
+{
+    reset();
+}
+
+/**
+ *  Drop all carried state and start a new stream
+ */
+void Base64Encoder::reset()
+{
+    _pendingLen = 0;
+}
+
+/**
+ *  Encode next chunk of input
+ *  @param in Chunk of input bytes
+ *  @param inLen Length of the chunk
+ *  @param out Output buffer, has to hold at least (inLen/3 + 1)*4 chars
+ *  @return Number of chars written
+ */
+size_t Base64Encoder::update(uint8_t const *in, size_t inLen, char *out)
+{
+    size_t o = 0, body;
+
+    //  First complete the 3-byte chunk carried over from the last call
+    if (_pendingLen > 0)
+    {
+        while ((_pendingLen < 3) && (inLen > 0))
+            _pending[_pendingLen++] = *in++, inLen--;
+        if (_pendingLen < 3)
+            return 0;
+
+        o += SIMDBase64Encode(out, _pending, 3);
+        _pendingLen = 0;
+    }
+
+    //  Whole 3-byte chunks never get padded
+    body = inLen - (inLen % 3);
+    o += SIMDBase64Encode(out + o, in, body);
+
+    memcpy(_pending, in + body, inLen - body);
+    _pendingLen = inLen - body;
+
+    return o;
+}
+
+/**
+ *  Encode next chunk of input
+ *  @param chunk Chunk of input bytes
+ *  @return Base64 digits complete so far
+ */
+string Base64Encoder::update(string const &chunk)
+{
+    string retVal((chunk.length()/3 + 1)*4, 0);
+
+    retVal.resize(update((const uint8_t*)chunk.data(), chunk.length(), &retVal[0]));
+    return retVal;
+}
+
+/**
+ *  Encode and pad leftover bytes (if any), then reset the encoder
+ *  @param out Output buffer, has to hold at least 4 chars
+ *  @return Number of chars written
+ */
+size_t Base64Encoder::finish(char *out)
+{
+    size_t n = SIMDBase64Encode(out, _pending, _pendingLen);
+
+    reset();
+    return n;
+}
+
+/**
+ *  Encode and pad leftover bytes (if any), then reset the encoder
+ *  @return Last, padded Base64 quantum
+ */
+string Base64Encoder::finish()
+{
+    char tail[4];
+    return string(tail, finish(tail));
+}
+
+//------------------------------------------------------------------------------
+//      Memory-mapped files                                             [PUBLIC]
+//------------------------------------------------------------------------------
+MappedFile::MappedFile() : _data(NULL), _size(0), _pos(0), _mapped(false)
+{
+}
+
+/**
+ *  Map file at the given path, check isOpen() for success
+ *  @param path Path to file
+ */
+MappedFile::MappedFile(string const &path)
+    : _data(NULL), _size(0), _pos(0), _mapped(false)
+{
+    open(path);
+}
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+/**
+ *  Map file, closing the one mapped before (if any)
+ *  @param path Path to file
+ *  @return True if file was mapped (empty files included), false otherwise
+ */
+bool MappedFile::open(string const &path)
+{
+    struct stat st;
+
+    close();
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+    if ((fstat(fd, &st) < 0) || !S_ISREG(st.st_mode))
+    {
+        ::close(fd);
+        return false;
+    }
+
+    //  Empty file can't be mapped, point to an empty string instead
+    if (st.st_size == 0)
+    {
+        ::close(fd);
+        _data = "";
+        return true;
+    }
+
+    void *map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED)
+        return false;
+    madvise(map, st.st_size, MADV_SEQUENTIAL);
+
+    _data = (char const*)map;
+    _size = st.st_size;
+    _mapped = true;
+
+    return true;
+}
+
+/**
+ *  Unmap file, views obtained from it become invalid
+ */
+void MappedFile::close()
+{
+    if (_mapped)
+        munmap((void*)_data, _size);
+
+    _data = NULL;
+    _size = 0;
+    _pos = 0;
+    _mapped = false;
+}
+
+/**
+ *  @return True if a file is mapped
+ */
+bool MappedFile::isOpen() const
+{
+    return _data != NULL;
+}
+
+/**
+ *  @return Contents of the file; never NULL while open, even if empty
+ */
+char const *MappedFile::data() const
+{
+    return _data;
+}
+
+/**
+ *  @return Size of the file in bytes
+ */
+size_t MappedFile::size() const
+{
+    return _size;
+}
+
+/**
+ *  Get next line of the file, without its line break ('\n' or "\r\n").
+ *  Last line doesn't need to end with a line break.
+ *  @param line [out] Start of the line, inside the mapping
+ *  @param len [out] Length of the line
+ *  @return True if a line was found, false at the end of the file
+ */
+bool MappedFile::nextLine(char const *&line, size_t &len)
+{
+    if (_pos >= _size)
+        return false;
+
+    line = _data + _pos;
+    _pos += NextDataRun(line, _size - _pos, len);
+
+    return true;
+}
+
+/**
+ *  Go back to the first line of the file
+ */
+void MappedFile::rewind()
+{
+    _pos = 0;
+}
+
+/**
+ *  Decode Base64-encoded file, line breaks in it are skipped
+ *  File is memory-mapped and decoded into a single buffer sized from the length
+ *  of the file, without reading it line by line first.
+ *  @param path Path to file
+ *  @return Decoded file; "ERROR" if file can't be opened or isn't valid Base64
+ */
+string Base64FileToASCII(string const &path)
+{
+    MappedFile file(path);
+
+    if (!file.isOpen())
+        return "ERROR";
+
+    string retVal((file.size()/4 + 1)*3, 0);
+    Base64Decoder decoder;
+    size_t n = decoder.update(file.data(), file.size(), (uint8_t*)&retVal[0]);
+
+    if (n == BUF_ERROR)
+        return "ERROR";
+    size_t tail = decoder.finish((uint8_t*)&retVal[n]);
+    if (tail == BUF_ERROR)
+        return "ERROR";
+
+    retVal.resize(n + tail);
+    return retVal;
+}
+
+/**
+ *  Decode Base64-encoded file, line breaks in it are skipped (see above)
+ *  @param path Path to file
+ *  @param out Output buffer, has to hold at least (file size/4 + 1)*3 bytes
+ *  @param outSize Size of output buffer
+ *  @return Number of bytes written; BUF_ERROR if file can't be opened, isn't
+ *  valid Base64 or doesn't fit the buffer
+ */
+size_t Base64FileToASCII(string const &path, char *out, size_t outSize)
+{
+    MappedFile file(path);
+
+    if (!file.isOpen() || (outSize < (file.size()/4 + 1)*3))
+        return BUF_ERROR;
+
+    Base64Decoder decoder;
+    size_t n = decoder.update(file.data(), file.size(), (uint8_t*)out);
+
+    if (n == BUF_ERROR)
+        return BUF_ERROR;
+    size_t tail = decoder.finish((uint8_t*)out + n);
+    if (tail == BUF_ERROR)
+        return BUF_ERROR;
+
+    return n + tail;
+}
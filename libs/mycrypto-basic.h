@@ -4,14 +4,33 @@
  *    Created: 14. Oct 2017.
  *    Author: Vedran Mikov
  */
+#ifndef MYCRYPTO_BASIC_H_
+#define MYCRYPTO_BASIC_H_
+
 #include <string>
 #include <cstdint>
+#include <cstddef>
+#include <vector>
 
 //  Definitions of different char encodings
 #define ENC_ASCII      8
 #define ENC_BASE64     6
 #define ENC_HEX        4
 
+//  Returned by buffer-oriented functions in place of length on invalid input
+#define BUF_ERROR      ((size_t)-1)
+
+//  Character classes, as used by validASCIIString
+#define CHAR_LOWER     0x01    //  a-z
+#define CHAR_UPPER     0x02    //  A-Z
+#define CHAR_NUM       0x04    //  0-9
+#define CHAR_SENT      0x08    //  Space and !"',.:;?
+#define CHAR_COMM      0x10    //  #$%&()*+-/, new line and carriage return
+#define CHAR_SPEC      0x20    //  Printable chars not in any other class
+#define CHAR_CONT      0x40    //  Other control chars and bytes from 0x80 up
+//  Classes accepted by validASCIIString by default
+#define CHAR_TEXT      (CHAR_LOWER | CHAR_UPPER | CHAR_NUM | CHAR_SENT | CHAR_COMM)
+
 
 using namespace std;
 
@@ -25,6 +44,20 @@ using namespace std;
  *  @return result of XOR operation in the same encoding as input arguments
  */
 string RepeatKeyXOR(string const &text, string const &key, uint8_t encod);
+/**
+ *  General repeat-key XOR function, writing into caller-supplied buffer
+ *  @param text Text to encrypt with repeating key
+ *  @param textLen Length of text
+ *  @param key Arbitrary-length key to use for encryption of text variable
+ *  @param keyLen Length of key
+ *  @param encod Encoding of text, key & result (one of ENC_* macros)
+ *  @param out Output buffer, may be the same as text
+ *  @param outSize Size of output buffer
+ *  @return Number of chars written; BUF_ERROR on invalid input or output
+ *  buffer too small
+ */
+size_t RepeatKeyXOR(char const *text, size_t textLen, char const *key,
+                    size_t keyLen, uint8_t encod, char *out, size_t outSize);
 /**
  *  General fixed-key XOR function
  *  Performs XOR between txt and key for key size of the same length as txt. If
@@ -35,6 +68,20 @@ string RepeatKeyXOR(string const &text, string const &key, uint8_t encod);
  *  @return result of XOR operation in the same encoding as input arguments
  */
 string FixedKeyXOR(string const &text, string const &key, uint8_t encod);
+/**
+ *  General fixed-key XOR function, writing into caller-supplied buffer
+ *  @param text Text to encrypt
+ *  @param textLen Length of text
+ *  @param key Key to use for encryption of text variable
+ *  @param keyLen Length of key, has to match the length of text
+ *  @param encod Encoding of text, key & result (one of ENC_* macros)
+ *  @param out Output buffer, may be the same as text
+ *  @param outSize Size of output buffer
+ *  @return Number of chars written; BUF_ERROR on invalid input or output
+ *  buffer too small
+ */
+size_t FixedKeyXOR(char const *text, size_t textLen, char const *key,
+                   size_t keyLen, uint8_t encod, char *out, size_t outSize);
 /**
  *  Pad txt string by appending  padding character until stirng reaches desired
  *  length.
@@ -46,6 +93,20 @@ string FixedKeyXOR(string const &text, string const &key, uint8_t encod);
  *  @param encod Encoding of txt (one of ENC_* macros)
  */
 string PadString(string const &text, uint32_t length, uint8_t encod, int8_t paddingChar = -1);
+/**
+ *  Pad text by appending padding characters (PKCS#7 scheme) until it reaches
+ *  desired length, writing into caller-supplied buffer
+ *  @param text Text to pad
+ *  @param textLen Length of text
+ *  @param length Required length of padded text
+ *  @param encod Encoding of text (one of ENC_* macros), Base64 is not allowed
+ *  @param out Output buffer, may be the same as text
+ *  @param outSize Size of output buffer
+ *  @return Number of chars written; BUF_ERROR if text is longer than length,
+ *  on Base64 encoding or if output buffer is too small
+ */
+size_t PadString(char const *text, size_t textLen, uint32_t length,
+                 uint8_t encod, char *out, size_t outSize);
 
 
 
@@ -55,6 +116,15 @@ string PadString(string const &text, uint32_t length, uint8_t encod, int8_t padd
  *  @return Corresponding Base64 string
  */
 string ASCIIToBase64(string const &arg);
+/**
+ *  Convert input ASCII string into a Base64 string in caller-supplied buffer
+ *  @param arg Input ASCII string
+ *  @param len Length of input
+ *  @param out Output buffer
+ *  @param outSize Size of output buffer, at least ((len+2)/3)*4
+ *  @return Number of chars written; BUF_ERROR if output buffer is too small
+ */
+size_t ASCIIToBase64(char const *arg, size_t len, char *out, size_t outSize);
 /**
  *  Convert input ASCII string to hex string. Additionally, if length is supplied
  *  function will repeat input string for as many time needed to reach the length.
@@ -64,6 +134,15 @@ string ASCIIToBase64(string const &arg);
  *  @return HEX value of input ASCII string
  */
 string ASCIIToHex(string const &arg, uint32_t length = 0);
+/**
+ *  Convert input ASCII string to HEX string in caller-supplied buffer
+ *  @param arg ASCII string to convert to HEX
+ *  @param len Length of input
+ *  @param out Output buffer
+ *  @param outSize Size of output buffer, at least 2*len
+ *  @return Number of chars written; BUF_ERROR if output buffer is too small
+ */
+size_t ASCIIToHex(char const *arg, size_t len, char *out, size_t outSize);
 /**
  *  Perform XOR on two ASCII strings
  *  @param arg1 First ASCII string
@@ -71,6 +150,19 @@ string ASCIIToHex(string const &arg, uint32_t length = 0);
  *  @return ASCII-encoded result of XOR operator on two inputs
  */
 string ASCIIFixedXOR(string const &arg1,string const &arg2);
+/**
+ *  Perform XOR on two equal-length ASCII strings into caller-supplied buffer
+ *  @param arg1 First ASCII string
+ *  @param len1 Length of first string
+ *  @param arg2 Second ASCII string
+ *  @param len2 Length of second string
+ *  @param out Output buffer, may be the same as one of inputs
+ *  @param outSize Size of output buffer, at least len1
+ *  @return Number of bytes written; BUF_ERROR if lengths don't match or
+ *  output buffer is too small
+ */
+size_t ASCIIFixedXOR(char const *arg1, size_t len1, char const *arg2,
+                     size_t len2, char *out, size_t outSize);
 /**
  *  Perform repeating-key XORing of given text and key. In this process, key is
  *  extended by repeating original key to match the length of text string.
@@ -80,6 +172,21 @@ string ASCIIFixedXOR(string const &arg1,string const &arg2);
  *  @return ASCII result of repeated-key XORing of text and key
  */
 string ASCIIRepeatKeyXOR(string const &text, string const &key);
+/**
+ *  Perform repeating-key XORing of given text and key into caller-supplied
+ *  buffer. Key is applied in place, without building its expanded copy, by
+ *  vector kernel selected for this CPU.
+ *  @param text ASCII text to encrypt with repeating key
+ *  @param textLen Length of text
+ *  @param key Arbitrary-length key to use for encryption of text variable
+ *  @param keyLen Length of key, non-zero
+ *  @param out Output buffer, may be the same as text
+ *  @param outSize Size of output buffer, at least textLen
+ *  @return Number of bytes written; BUF_ERROR on empty key or output buffer
+ *  too small
+ */
+size_t ASCIIRepeatKeyXOR(char const *text, size_t textLen, char const *key,
+                         size_t keyLen, char *out, size_t outSize);
 /**
  *  Calculate Hamming distance between two equal-length ASCII strings
  *  To do so, chars at the same index are XORed which produces 1 at the position
@@ -87,10 +194,92 @@ string ASCIIRepeatKeyXOR(string const &text, string const &key);
  *  1s in XORed variable
  *  @param arg1 First ASCII string
  *  @param arg2 Second ASCII string
- *  @return Humming distance between 2 input strings; ULLONG_MAX if length of
+ *  @return Humming distance between 2 input strings; BUF_ERROR if length of
  *  strings is not the same
  */
-uint32_t ASCIIDistHamming(string const &arg1, string const &arg2);
+size_t ASCIIDistHamming(string const &arg1, string const &arg2);
+/**
+ *  Calculate Hamming distance between two equal-length ASCII buffers
+ *  @param arg1 First ASCII string
+ *  @param len1 Length of first string
+ *  @param arg2 Second ASCII string
+ *  @param len2 Length of second string
+ *  @return Humming distance between 2 inputs; BUF_ERROR if lengths are not
+ *  the same
+ */
+size_t ASCIIDistHamming(char const *arg1, size_t len1, char const *arg2,
+                        size_t len2);
+/**
+ *  Calculate Hamming distances of one ASCII block against a number of blocks
+ *  of the same length, e.g. consecutive blocks of a ciphertext
+ *  @param ref Block all others are compared to
+ *  @param blocks First of the blocks to compare
+ *  @param blockLen Length of every block
+ *  @param stride Distance between starts of two consecutive blocks
+ *  @param count Number of blocks
+ *  @param dist [out] Array of count distances, one per block
+ *  @return Number of distances written
+ */
+size_t ASCIIDistHammingBatch(char const *ref, char const *blocks, size_t blockLen,
+                             size_t stride, size_t count, size_t *dist);
+/**
+ *  Calculate Hamming distances between all pairs of equal-length ASCII blocks
+ *  Each pair is only compared once, results are mirrored over the diagonal
+ *  @param blocks First of the blocks to compare
+ *  @param blockLen Length of every block
+ *  @param stride Distance between starts of two consecutive blocks
+ *  @param count Number of blocks
+ *  @param dist [out] Row-major count x count matrix of distances, with zeros
+ *  on the diagonal
+ *  @return Number of distances written (count*count)
+ */
+size_t ASCIIDistHammingMatrix(char const *blocks, size_t blockLen, size_t stride,
+                              size_t count, size_t *dist);
+/**
+ *  Split ASCII string into k columns, see ASCIITranspose for layout
+ *  @param arg Input string
+ *  @param k Number of columns
+ *  @return Columns concatenated into one string of k*ceil(len/k) bytes;
+ *  "ERROR" if k is 0
+ */
+string ASCIITranspose(string const &arg, size_t k);
+/**
+ *  Split ASCII buffer into k columns (bytes sharing the same key byte under a
+ *  k-byte repeating key), column j holding bytes j, j+k, j+2k... at
+ *  out + j*stride, where stride = ceil(len/k). Shorter columns are padded
+ *  with 0 up to the stride.
+ *  @param arg Input buffer
+ *  @param len Length of input buffer
+ *  @param k Number of columns
+ *  @param out [out] Output buffer
+ *  @param outSize Size of output buffer
+ *  @return Number of bytes written (k*stride); BUF_ERROR if k is 0 or output
+ *  buffer is too small
+ */
+size_t ASCIITranspose(char const *arg, size_t len, size_t k, char *out,
+                      size_t outSize);
+/**
+ *  Reassemble ASCII string of given length from k columns
+ *  @param arg Columns, see ASCIITranspose
+ *  @param len Length of reassembled string
+ *  @param k Number of columns
+ *  @return Reassembled string; "ERROR" on invalid input
+ */
+string ASCIIUntranspose(string const &arg, size_t len, size_t k);
+/**
+ *  Reassemble ASCII buffer from k columns produced by ASCIITranspose, e.g.
+ *  plaintext decrypted column by column
+ *  @param arg Columns, k*stride bytes where stride = ceil(len/k)
+ *  @param argLen Length of columns buffer
+ *  @param len Length of reassembled buffer
+ *  @param k Number of columns
+ *  @param out [out] Output buffer
+ *  @param outSize Size of output buffer
+ *  @return Number of bytes written (len); BUF_ERROR if k is 0, columns buffer
+ *  is too short or output buffer is too small
+ */
+size_t ASCIIUntranspose(char const *arg, size_t argLen, size_t len, size_t k,
+                        char *out, size_t outSize);
 /**
  *  Checks if input string consists of valid characters. Use bool selectors to
  *  choose valid groups of characters
@@ -106,6 +295,53 @@ uint32_t ASCIIDistHamming(string const &arg1, string const &arg2);
 bool   validASCIIString(string const &arg, bool lc = true, bool uc = true,
                       bool num = true, bool sent = true, bool comm = true,
                       bool spec = false, bool cont = false);
+/**
+ *  Checks if input buffer consists of valid characters. Use bool selectors to
+ *  choose valid groups of characters (same as for string version above)
+ *  @param arg Input buffer
+ *  @param len Length of input buffer
+ *  @return True if buffer passed all requirements, false if it didn't
+ */
+bool   validASCIIString(char const *arg, size_t len, bool lc = true,
+                      bool uc = true, bool num = true, bool sent = true,
+                      bool comm = true, bool spec = false, bool cont = false);
+/**
+ *  Class of a character (one of CHAR_* classes)
+ *  @param c Character
+ *  @return Class of character
+ */
+uint8_t ASCIICharClass(char c);
+/**
+ *  Count characters in buffer belonging to any of the given classes
+ *  @param arg Input buffer
+ *  @param len Length of input buffer
+ *  @param mask Bitwise OR of accepted CHAR_* classes
+ *  @return Number of characters belonging to accepted classes
+ */
+size_t ASCIIClassCount(char const *arg, size_t len, uint8_t mask = CHAR_TEXT);
+/**
+ *  Count characters in string belonging to any of the given classes
+ *  @param arg Input string
+ *  @param mask Bitwise OR of accepted CHAR_* classes
+ *  @return Number of characters belonging to accepted classes
+ */
+size_t ASCIIClassCount(string const &arg, uint8_t mask = CHAR_TEXT);
+/**
+ *  Share of characters in buffer belonging to any of the given classes, to
+ *  allow for some unexpected characters in otherwise valid text
+ *  @param arg Input buffer
+ *  @param len Length of input buffer
+ *  @param mask Bitwise OR of accepted CHAR_* classes
+ *  @return Share of accepted characters in range [0, 1], 1 for empty buffer
+ */
+double ASCIIClassRatio(char const *arg, size_t len, uint8_t mask = CHAR_TEXT);
+/**
+ *  Share of characters in string belonging to any of the given classes
+ *  @param arg Input string
+ *  @param mask Bitwise OR of accepted CHAR_* classes
+ *  @return Share of accepted characters in range [0, 1], 1 for empty string
+ */
+double ASCIIClassRatio(string const &arg, uint8_t mask = CHAR_TEXT);
 
 
 /**
@@ -114,6 +350,33 @@ bool   validASCIIString(string const &arg, bool lc = true, bool uc = true,
  *  @return Corresponding HEX string
  */
 string Base64ToHex(string const &arg);
+/**
+ *  Convert input Base64 string into a HEX string in caller-supplied buffer
+ *  @param arg Input Base64 string
+ *  @param len Length of input
+ *  @param out Output buffer
+ *  @param outSize Size of output buffer, at least twice the decoded length
+ *  @return Number of chars written; BUF_ERROR on invalid input or output
+ *  buffer too small
+ */
+size_t Base64ToHex(char const *arg, size_t len, char *out, size_t outSize);
+/**
+ *  Convert input Base64 string directly into an ASCII string
+ *  @param arg Input Base64 string
+ *  @return Corresponding ASCII string; "ERROR" if input contains characters
+ *  outside of Base64 set or has invalid length
+ */
+string Base64ToASCII(string const &arg);
+/**
+ *  Convert input Base64 string into bytes in caller-supplied buffer
+ *  @param arg Input Base64 string
+ *  @param len Length of input
+ *  @param out Output buffer
+ *  @param outSize Size of output buffer, at least the decoded length
+ *  @return Number of bytes written; BUF_ERROR on invalid input or output
+ *  buffer too small
+ */
+size_t Base64ToASCII(char const *arg, size_t len, char *out, size_t outSize);
 /**
  *  Calculate Hamming distance between two equal-length Base64-encoded strings
  *  To do so, chars at the same index are XORed which produces 1 at the position
@@ -121,10 +384,23 @@ string Base64ToHex(string const &arg);
  *  1s in XORed variable
  *  @param arg1 First Base64-encoded string
  *  @param arg2 Second Base64-encoded string
- *  @return Humming distance between 2 input strings; ULLONG_MAX if length of
+ *  @return Humming distance between 2 input strings; BUF_ERROR if length of
  *  strings is not the same
  */
-uint32_t Base64DistHamming(string const &arg1, string const &arg2);
+size_t Base64DistHamming(string const &arg1, string const &arg2);
+/**
+ *  Calculate Hamming distance between two equal-length Base64-encoded buffers
+ *  Both are decoded in chunks and compared as bytes, so bits dropped by
+ *  padding don't count
+ *  @param arg1 First Base64-encoded string
+ *  @param len1 Length of first string
+ *  @param arg2 Second Base64-encoded string
+ *  @param len2 Length of second string
+ *  @return Humming distance between 2 inputs; BUF_ERROR if lengths are not
+ *  the same or on invalid input
+ */
+size_t Base64DistHamming(char const *arg1, size_t len1, char const *arg2,
+                         size_t len2);
 
 
 /**
@@ -138,12 +414,32 @@ uint8_t HexCharToInt (int8_t const &arg);
  *  @return ASCII representation of input string
  */
 string HexToBase64(string const &arg);
+/**
+ *  Convert input HEX string into a Base64 string in caller-supplied buffer
+ *  @param arg Input HEX string
+ *  @param len Length of input, has to be even
+ *  @param out Output buffer
+ *  @param outSize Size of output buffer, at least ((len/2+2)/3)*4
+ *  @return Number of chars written; BUF_ERROR on invalid input or output
+ *  buffer too small
+ */
+size_t HexToBase64(char const *arg, size_t len, char *out, size_t outSize);
 /**
  *  Convert input HEX string into a Base64 string
  *  @param arg Input HEX string
  *  @return Corresponding Base64 string
  */
 string HexToASCII(string const &arg);
+/**
+ *  Convert HEX-encoded string into bytes in caller-supplied buffer
+ *  @param arg HEX-encoded string to decode
+ *  @param len Length of input, has to be even
+ *  @param out Output buffer, may be the same as arg
+ *  @param outSize Size of output buffer, at least len/2
+ *  @return Number of bytes written; BUF_ERROR on invalid input or output
+ *  buffer too small
+ */
+size_t HexToASCII(char const *arg, size_t len, char *out, size_t outSize);
 /**
  *  Perform XOR on two HEX encoded strings
  *  @param arg1 First HEX-encoded string
@@ -151,6 +447,20 @@ string HexToASCII(string const &arg);
  *  @return HEX-encoded result of XOR operator on two inputs
  */
 string HexFixedXOR(string const &arg1,string const &arg2);
+/**
+ *  Perform XOR on two equal-length HEX encoded strings into caller-supplied
+ *  buffer. XOR is done digit by digit, without decoding digits into bytes.
+ *  @param arg1 First HEX-encoded string
+ *  @param len1 Length of first string
+ *  @param arg2 Second HEX-encoded string
+ *  @param len2 Length of second string
+ *  @param out Output buffer, may be the same as one of inputs
+ *  @param outSize Size of output buffer, at least len1
+ *  @return Number of chars written; BUF_ERROR if lengths don't match, on
+ *  invalid digit or if output buffer is too small
+ */
+size_t HexFixedXOR(char const *arg1, size_t len1, char const *arg2,
+                   size_t len2, char *out, size_t outSize);
 /**
  *  Perform repeating-key XORing of given text and key. In this process, key is
  *  extended by repeating original key to match the length of text string.
@@ -160,6 +470,20 @@ string HexFixedXOR(string const &arg1,string const &arg2);
  *  @return HEX result of repeated-key XORing of text and key
  */
 string HexRepeatKeyXOR(string const &text, string const &key);
+/**
+ *  Perform repeating-key XORing of given HEX text and key into caller-supplied
+ *  buffer. Key digits are repeated in place, without building expanded key.
+ *  @param text HEX text to encrypt with repeating key
+ *  @param textLen Length of text
+ *  @param key Arbitrary-length HEX key to use for encryption of text variable
+ *  @param keyLen Length of key, non-zero
+ *  @param out Output buffer, may be the same as text
+ *  @param outSize Size of output buffer, at least textLen
+ *  @return Number of chars written; BUF_ERROR on empty key, invalid digit or
+ *  output buffer too small
+ */
+size_t HexRepeatKeyXOR(char const *text, size_t textLen, char const *key,
+                       size_t keyLen, char *out, size_t outSize);
 /**
  *  Calculate Hamming distance between two equal-length HEX-encoded strings
  *  To do so, chars at the same index are XORed which produces 1 at the position
@@ -167,7 +491,483 @@ string HexRepeatKeyXOR(string const &text, string const &key);
  *  1s in XORed variable
  *  @param arg1 First HEX-encoded string
  *  @param arg2 Second HEX-encoded string
- *  @return Humming distance between 2 input strings; ULLONG_MAX if length of
+ *  @return Humming distance between 2 input strings; BUF_ERROR if length of
  *  strings is not the same
  */
-uint32_t HexDistHamming(string const &arg1, string const &arg2);
+size_t HexDistHamming(string const &arg1, string const &arg2);
+/**
+ *  Calculate Hamming distance between two equal-length HEX-encoded buffers
+ *  @param arg1 First HEX-encoded string
+ *  @param len1 Length of first string
+ *  @param arg2 Second HEX-encoded string
+ *  @param len2 Length of second string
+ *  @return Humming distance between 2 inputs; BUF_ERROR if lengths are not
+ *  the same or on invalid digit
+ */
+size_t HexDistHamming(char const *arg1, size_t len1, char const *arg2,
+                      size_t len2);
+
+/**
+ *  Score of a candidate key of single-byte XOR cipher
+ */
+struct SingleByteKey
+{
+    uint8_t key;
+    double  score;      //  Average log-likelihood of plaintext chars in English
+};
+
+/**
+ *  Count occurrences of every byte value in buffer
+ *  @param data Input buffer
+ *  @param len Length of input buffer
+ *  @param hist Histogram to add counts to, 256 elements
+ */
+void ByteHistogram(char const *data, size_t len, uint64_t *hist);
+/**
+ *  Find most likely keys of single-byte XOR ciphertext from its histogram
+ *  Every key is scored by log-likelihood of its plaintext under the English
+ *  character model, which only depends on the histogram, not on the text.
+ *  @param hist Histogram of ciphertext bytes, 256 elements
+ *  @param best Output, most likely keys, from the most likely one
+ *  @param topK Number of keys to return (up to 256)
+ *  @return Number of keys written into best
+ */
+size_t CrackSingleByteXOR(uint64_t const *hist, SingleByteKey *best, size_t topK);
+/**
+ *  Find most likely keys of single-byte XOR ciphertext
+ *  @param data Ciphertext
+ *  @param len Length of ciphertext
+ *  @param topK Number of keys to return (up to 256)
+ *  @return Most likely keys, from the most likely one
+ */
+vector<SingleByteKey> CrackSingleByteXOR(char const *data, size_t len,
+                                         size_t topK = 1);
+/**
+ *  Find most likely keys of single-byte XOR ciphertext
+ *  @param data ASCII ciphertext
+ *  @param topK Number of keys to return (up to 256)
+ *  @return Most likely keys, from the most likely one
+ */
+vector<SingleByteKey> CrackSingleByteXOR(string const &data, size_t topK = 1);
+
+/**
+ *  Line of a file found to be encrypted with single-byte XOR
+ */
+struct LineKeyScore
+{
+    size_t  line;       //  Line number, from 0
+    uint8_t key;
+    double  score;      //  Same as in SingleByteKey
+    string  plain;      //  Decrypted line
+};
+
+/**
+ *  Find lines most likely encrypted with single-byte XOR among many lines
+ *  Lines are split between threads in chunks, every line is decoded and its
+ *  most likely key found from its histogram. Every thread keeps its own top
+ *  lines, merged after all lines are processed.
+ *  @param data Lines, separated by new line (optionally preceded by carriage
+ *  return)
+ *  @param len Length of data
+ *  @param encod Encoding of lines (ENC_ASCII, ENC_HEX or ENC_BASE64), lines
+ *  failing to decode are skipped
+ *  @param topK Number of lines to return, nothing is processed if 0
+ *  @param threads Number of threads to use, 0 for one per CPU core
+ *  @param lines If not NULL, set to number of lines processed
+ *  @return Most likely lines, from the most likely one
+ */
+vector<LineKeyScore> DetectSingleByteXOR(char const *data, size_t len,
+                                         uint8_t encod, size_t topK = 1,
+                                         uint32_t threads = 0,
+                                         size_t *lines = NULL);
+/**
+ *  Find lines of a file most likely encrypted with single-byte XOR (see
+ *  above), file is memory-mapped instead of read
+ *  @param path Path to file
+ *  @param lines If not NULL, set to number of lines processed, BUF_ERROR if
+ *  file can't be opened
+ *  @return Most likely lines, from the most likely one
+ */
+vector<LineKeyScore> DetectSingleByteXOR(string const &path, uint8_t encod,
+                                         size_t topK = 1, uint32_t threads = 0,
+                                         size_t *lines = NULL);
+
+/**
+ *  Score of a candidate key size of repeating-key XOR cipher
+ */
+struct KeySizeScore
+{
+    uint32_t keySize;
+    double   score;     //  Estimator-specific, see the estimator used
+};
+
+/**
+ *  Estimate key size of a repeating-key XOR ciphertext
+ *  For every candidate key size, the whole ciphertext is split into blocks of
+ *  that size and Hamming distance is averaged over all pairs of adjacent
+ *  blocks, normalized to bits per byte. Candidate sizes are spread across
+ *  threads.
+ *  @param data Ciphertext
+ *  @param len Length of ciphertext
+ *  @param minSize Smallest key size to consider
+ *  @param maxSize Largest key size to consider (inclusive), sizes leaving
+ *  less than two blocks of ciphertext are skipped
+ *  @param threads Number of threads to use, 0 for one per CPU core
+ *  @return Candidate key sizes, ranked from the most likely one
+ */
+vector<KeySizeScore> EstimateRepeatingKeySize(char const *data, size_t len,
+                                              uint32_t minSize = 2,
+                                              uint32_t maxSize = 40,
+                                              uint32_t threads = 0);
+/**
+ *  Estimate key size of a repeating-key XOR ciphertext (see above)
+ *  @param data ASCII ciphertext
+ *  @return Candidate key sizes, ranked from the most likely one
+ */
+vector<KeySizeScore> EstimateRepeatingKeySize(string const &data,
+                                              uint32_t minSize = 2,
+                                              uint32_t maxSize = 40,
+                                              uint32_t threads = 0);
+/**
+ *  Estimate key size of a repeating-key XOR ciphertext from autocorrelation
+ *  Ciphertext bytes repeat as often as plaintext ones (index of coincidence)
+ *  only when compared at a shift that is a multiple of the key size. Number of
+ *  equal bytes is counted exactly for every shift, either directly or, for
+ *  wide ranges of key sizes, with one FFT autocorrelation per byte value
+ *  present in the ciphertext. Score is the share of equal bytes (higher is
+ *  better). Multiples of the key size score as high as the key size itself,
+ *  so key sizes scoring the same as one of their divisors (within sampling
+ *  error) are ranked right after the smallest such divisor.
+ *  @param data Ciphertext
+ *  @param len Length of ciphertext
+ *  @param minSize Smallest key size to consider
+ *  @param maxSize Largest key size to consider (inclusive), sizes longer than
+ *  half of the ciphertext are skipped
+ *  @param threads Number of threads to use, 0 for one per CPU core
+ *  @return Candidate key sizes, ranked from the most likely one
+ */
+vector<KeySizeScore> EstimateRepeatingKeySizeIoC(char const *data, size_t len,
+                                                 uint32_t minSize = 2,
+                                                 uint32_t maxSize = 40,
+                                                 uint32_t threads = 0);
+/**
+ *  Estimate key size of a repeating-key XOR ciphertext from autocorrelation
+ *  (see above)
+ *  @param data ASCII ciphertext
+ *  @return Candidate key sizes, ranked from the most likely one
+ */
+vector<KeySizeScore> EstimateRepeatingKeySizeIoC(string const &data,
+                                                 uint32_t minSize = 2,
+                                                 uint32_t maxSize = 40,
+                                                 uint32_t threads = 0);
+
+/**
+ *  Candidate key of repeating-key XOR cipher
+ */
+struct RepeatingKey
+{
+    string key;
+    //  Same as in SingleByteKey, over the whole plaintext, less log(256) per key
+    //  byte spread over plaintext. Multiples of the right key size have more
+    //  freedom to fit plaintext, this keeps them from scoring better.
+    double score;
+    string plain;       //  Decrypted ciphertext
+};
+
+/**
+ *  Break repeating-key XOR cipher
+ *  Most likely key sizes are found by EstimateRepeatingKeySize, and for each
+ *  of them (and their divisors) ciphertext is split into columns encrypted by
+ *  the same key byte. Columns are cracked in parallel as single-byte XOR, and
+ *  best full keys are assembled column by column, keeping only beamWidth best
+ *  partial keys. Keys repeating with a shorter period are reduced to it, and
+ *  full keys are ranked by n-gram score of their plaintext.
+ *  @param data Ciphertext
+ *  @param len Length of ciphertext
+ *  @param topN Number of keys to return
+ *  @param minSize Smallest key size to consider
+ *  @param maxSize Largest key size to consider (inclusive)
+ *  @param sizes Number of most likely key sizes to try
+ *  @param beamWidth Number of best partial keys kept, also number of
+ *  candidates taken from every column (up to 256)
+ *  @param threads Number of threads to use, 0 for one per CPU core
+ *  @return Most likely keys, from the most likely one
+ */
+vector<RepeatingKey> BreakRepeatingKeyXOR(char const *data, size_t len,
+                                          size_t topN = 1, uint32_t minSize = 2,
+                                          uint32_t maxSize = 40, uint32_t sizes = 3,
+                                          uint32_t beamWidth = 16,
+                                          uint32_t threads = 0);
+/**
+ *  Break repeating-key XOR cipher (see above)
+ *  @param data ASCII ciphertext
+ *  @return Most likely keys, from the most likely one
+ */
+vector<RepeatingKey> BreakRepeatingKeyXOR(string const &data, size_t topN = 1,
+                                          uint32_t minSize = 2, uint32_t maxSize = 40,
+                                          uint32_t sizes = 3, uint32_t beamWidth = 16,
+                                          uint32_t threads = 0);
+
+/**
+ *  Window of ciphertext XOR where a crib reveals text
+ */
+struct CribMatch
+{
+    size_t  crib;       //  Index of the crib
+    size_t  offset;     //  Offset of the window in XOR of ciphertexts
+    double  ratio;      //  Share of revealed chars in accepted classes
+    double  score;      //  Same as in SingleByteKey, of revealed text
+    string  text;       //  Revealed text, crib XORed into the window
+};
+
+/**
+ *  Crib dragging over XOR of two ciphertexts encrypted with the same keystream
+ *  (which equals XOR of their plaintexts). Every crib is XORed into every
+ *  window of the same length, and where the result is text (all or minRatio
+ *  of its chars fall into classes in mask) the crib likely is part of one
+ *  plaintext and the result part of the other. Windows are filtered by the
+ *  character classifier a vector of offsets at the time, survivors ranked by
+ *  n-gram score. Input is split into chunks of offsets, which threads process
+ *  for groups of cribs.
+ *  @param x XOR of two ciphertexts
+ *  @param len Length of XOR (length of the shorter ciphertext)
+ *  @param cribs Guessed words or phrases of plaintext
+ *  @param topN Number of windows to return
+ *  @param minRatio Lowest share of chars in accepted classes, in range [0, 1]
+ *  (at most 254 chars of a window are allowed outside them)
+ *  @param mask Bitwise OR of accepted CHAR_* classes
+ *  @param threads Number of threads to use, 0 for one per CPU core
+ *  @return Best windows, by ratio and then score, from the best one
+ */
+vector<CribMatch> CribDrag(char const *x, size_t len, vector<string> const &cribs,
+                           size_t topN = 10, double minRatio = 1.0, uint8_t mask = CHAR_TEXT,
+                           uint32_t threads = 0);
+/**
+ *  Crib dragging over XOR of two ciphertexts (see above)
+ *  @param x XOR of two ciphertexts
+ *  @return Best windows, by ratio and then score, from the best one
+ */
+vector<CribMatch> CribDrag(string const &x, vector<string> const &cribs,
+                           size_t topN = 10, double minRatio = 1.0, uint8_t mask = CHAR_TEXT,
+                           uint32_t threads = 0);
+
+/**
+ *  Streaming Base64 decoder
+ *  Decodes Base64 input fed in arbitrary chunks, carrying partial 4-digit
+ *  quanta across chunk boundaries. Line breaks ('\n', '\r') are skipped so
+ *  files can be decoded line by line or in fixed-size blocks in constant
+ *  memory. Padding is only accepted at the end of the stream.
+ */
+class Base64Decoder
+{
+public:
+    Base64Decoder();
+
+    /**
+     *  Decode next chunk of input
+     *  @param in Chunk of Base64 input
+     *  @param inLen Length of the chunk
+     *  @param out Output buffer, has to hold at least (inLen/4 + 1)*3 bytes
+     *  @return Number of bytes written; BUF_ERROR on invalid input
+     */
+    size_t update(char const *in, size_t inLen, uint8_t *out);
+    /**
+     *  Decode next chunk of input
+     *  @param chunk Chunk of Base64 input
+     *  @return Decoded bytes; "ERROR" on invalid input
+     */
+    string update(string const &chunk);
+    /**
+     *  Flush the last, unpadded quantum (if any) and reset the decoder
+     *  @param out Output buffer, has to hold at least 3 bytes
+     *  @return Number of bytes written; BUF_ERROR if stream ended on invalid
+     *  input or with a single leftover digit
+     */
+    size_t finish(uint8_t *out);
+    /**
+     *  Flush the last, unpadded quantum (if any) and reset the decoder
+     *  @return Decoded bytes; "ERROR" on invalid stream
+     */
+    string finish();
+    /**
+     *  Drop all carried state and start a new stream
+     */
+    void reset();
+
+private:
+    size_t  decodeRun(char const *in, size_t inLen, uint8_t *out);
+
+    char    _quantum[4];    //  Digits of a quantum split between chunks
+    uint8_t _quantumLen;
+    bool    _padded;        //  Padding seen, no more data allowed
+    bool    _failed;        //  Invalid input seen, sticky until reset
+};
+
+/**
+ *  Streaming HEX decoder
+ *  Decodes HEX input fed in arbitrary chunks, carrying a half byte across
+ *  chunk boundaries and skipping line breaks ('\n', '\r')
+ */
+class HexDecoder
+{
+public:
+    HexDecoder();
+
+    /**
+     *  Decode next chunk of input
+     *  @param in Chunk of HEX input
+     *  @param inLen Length of the chunk
+     *  @param out Output buffer, has to hold at least inLen/2 + 1 bytes
+     *  @return Number of bytes written; BUF_ERROR on invalid input
+     */
+    size_t update(char const *in, size_t inLen, uint8_t *out);
+    /**
+     *  Decode next chunk of input
+     *  @param chunk Chunk of HEX input
+     *  @return Decoded bytes; "ERROR" on invalid input
+     */
+    string update(string const &chunk);
+    /**
+     *  End the stream and reset the decoder
+     *  @return 0; BUF_ERROR if stream ended on invalid input or half a byte
+     */
+    size_t finish();
+    /**
+     *  Drop all carried state and start a new stream
+     */
+    void reset();
+
+private:
+    size_t  decodeRun(char const *in, size_t inLen, uint8_t *out);
+
+    char    _nibble;        //  First digit of a byte split between chunks
+    bool    _hasNibble;
+    bool    _failed;        //  Invalid input seen, sticky until reset
+};
+
+/**
+ *  Streaming Base64 encoder
+ *  Encodes bytes fed in arbitrary chunks, carrying up to 2 bytes of a partial
+ *  3-byte chunk across calls. Padding is only produced by finish().
+ */
+class Base64Encoder
+{
+public:
+    Base64Encoder();
+
+    /**
+     *  Encode next chunk of input
+     *  @param in Chunk of input bytes
+     *  @param inLen Length of the chunk
+     *  @param out Output buffer, has to hold at least (inLen/3 + 1)*4 chars
+     *  @return Number of chars written
+     */
+    size_t update(uint8_t const *in, size_t inLen, char *out);
+    /**
+     *  Encode next chunk of input
+     *  @param chunk Chunk of input bytes
+     *  @return Base64 digits complete so far
+     */
+    string update(string const &chunk);
+    /**
+     *  Encode and pad leftover bytes (if any), then reset the encoder
+     *  @param out Output buffer, has to hold at least 4 chars
+     *  @return Number of chars written
+     */
+    size_t finish(char *out);
+    /**
+     *  Encode and pad leftover bytes (if any), then reset the encoder
+     *  @return Last, padded Base64 quantum
+     */
+    string finish();
+    /**
+     *  Drop all carried state and start a new stream
+     */
+    void reset();
+
+private:
+    uint8_t _pending[3];    //  Bytes of a 3-byte chunk split between calls
+    uint8_t _pendingLen;
+};
+
+/**
+ *  Read-only memory-mapped file
+ *  Whole file is mapped on open and read straight from the page cache. Lines
+ *  are handed out as views into the mapping, valid until the file is closed.
+ */
+class MappedFile
+{
+public:
+    MappedFile();
+    /**
+     *  Map file at the given path, check isOpen() for success
+     *  @param path Path to file
+     */
+    explicit MappedFile(string const &path);
+    ~MappedFile();
+
+    /**
+     *  Map file, closing the one mapped before (if any)
+     *  @param path Path to file
+     *  @return True if file was mapped (empty files included), false otherwise
+     */
+    bool open(string const &path);
+    /**
+     *  Unmap file, views obtained from it become invalid
+     */
+    void close();
+    /**
+     *  @return True if a file is mapped
+     */
+    bool isOpen() const;
+    /**
+     *  @return Contents of the file; never NULL while open, even if empty
+     */
+    char const *data() const;
+    /**
+     *  @return Size of the file in bytes
+     */
+    size_t size() const;
+
+    /**
+     *  Get next line of the file, without its line break ('\n' or "\r\n").
+     *  Last line doesn't need to end with a line break.
+     *  @param line [out] Start of the line, inside the mapping
+     *  @param len [out] Length of the line
+     *  @return True if a line was found, false at the end of the file
+     */
+    bool nextLine(char const *&line, size_t &len);
+    /**
+     *  Go back to the first line of the file
+     */
+    void rewind();
+
+private:
+    MappedFile(MappedFile const&);
+    MappedFile &operator=(MappedFile const&);
+
+    char const  *_data;
+    size_t      _size;
+    size_t      _pos;       //  Start of the next line
+    bool        _mapped;    //  False for empty files, which can't be mapped
+};
+
+/**
+ *  Decode Base64-encoded file, line breaks in it are skipped
+ *  File is memory-mapped and decoded into a single buffer sized from the length
+ *  of the file, without reading it line by line first.
+ *  @param path Path to file
+ *  @return Decoded file; "ERROR" if file can't be opened or isn't valid Base64
+ */
+string Base64FileToASCII(string const &path);
+/**
+ *  Decode Base64-encoded file, line breaks in it are skipped (see above)
+ *  @param path Path to file
+ *  @param out Output buffer, has to hold at least (file size/4 + 1)*3 bytes
+ *  @param outSize Size of output buffer
+ *  @return Number of bytes written; BUF_ERROR if file can't be opened, isn't
+ *  valid Base64 or doesn't fit the buffer
+ */
+size_t Base64FileToASCII(string const &path, char *out, size_t outSize);
+
+#endif  /* MYCRYPTO_BASIC_H_ */
@@ -0,0 +1,1121 @@
+/**
+ *    Implementation of English language model from mycrypto-english header
+ *    Description
+ *      Probability of a byte is its unigram probability, multiplied by how much
+ *      more (or less) likely its symbol is after the two preceding symbols than
+ *      on its own. Byte probabilities keep case and rare characters apart,
+ *      while n-grams over 32 symbols fit into 64kB of tables, so scoring is
+ *      three table lookups per byte.
+ *      Built-in model is derived on first use from constant tables below.
+ *
+ *    Created: 17. Oct 2026.
+ *    Author: Vedran Mikov
+ */
+#include <cmath>
+#include <cstring>
+#include <vector>
+#include <atomic>
+#include <fstream>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "mycrypto-english.h"
+
+//  Weight of lower-order estimate in probabilities of n-grams, the less often
+//  a context was seen the more its estimate leans on the lower order one
+#define ENG_BACKOFF    4.0
+
+//------------------------------------------------------------------------------
+//      Model data                                                     [PRIVATE]
+//------------------------------------------------------------------------------
+//  Symbol of a byte (see EnglishSymbol), computed at compile time
+static constexpr uint8_t Symbol(uint8_t c)
+{
+    return ((c >= 'a') && (c <= 'z')) ? (c - 'a') :
+           ((c >= 'A') && (c <= 'Z')) ? (c - 'A') :
+           (c == ' ') ? 26 :
+           ((c == '\t') || (c == '\n') || (c == '\r')) ? 27 :
+           ((c >= '0') && (c <= '9')) ? 28 :
+           ((c == '.') || (c == ',') || (c == ';') || (c == ':') ||
+            (c == '!') || (c == '?')) ? 29 :
+           ((c > ' ') && (c < 0x7F)) ? 30 : 31;
+}
+
+#define SYM_4(i)   Symbol(i), Symbol((i)+1), Symbol((i)+2), Symbol((i)+3)
+#define SYM_16(i)  SYM_4(i), SYM_4((i)+4), SYM_4((i)+8), SYM_4((i)+12)
+#define SYM_64(i)  SYM_16(i), SYM_16((i)+16), SYM_16((i)+32), SYM_16((i)+48)
+static const uint8_t engSymbol[256] =
+{
+    SYM_64(0), SYM_64(64), SYM_64(128), SYM_64(192)
+};
+
+//  Occurrences of ASCII characters per 100000 characters of English text
+static const uint16_t englishFreq[128] =
+{
+        0,     0,     0,     0,     0,     0,     0,     0,     0,    20,   500,     0,     0,    20,     0,     0,
+        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+    17000,    50,   200,     1,     1,     1,     1,   250,    20,    20,     1,     1,   600,   150,   650,     1,
+       50,    50,    50,    50,    50,    50,    50,    50,    50,    50,    30,    30,     1,     1,     1,    50,
+        1,   245,    45,    83,   128,   381,    67,    60,   183,   209,     5,    23,   121,    72,   202,   225,
+       58,     3,   180,   190,   272,    83,    29,    71,     5,    59,     2,     1,     1,     1,     1,     1,
+        1,  5880,  1074,  2003,  3062,  9146,  1604,  1451,  4388,  5016,   110,   556,  2898,  1732,  4859,  5405,
+     1389,    68,  4311,  4555,  6520,  1986,   704,  1699,   108,  1421,    53,     1,     1,     1,     1,     0,
+};
+//  Occurrences of every byte from 0x80 up per 100000 characters. UTF-8 is
+//  rare in English text, but more likely than control characters.
+#define ENG_HIGH_FREQ  1
+
+//  Trigrams of symbols seen at least 3 times in Isaac Newton's Opticks (about
+//  560kB, public domain), as (s1*1024 + s2*32 + s3) << 16 | count
+static const uint32_t trigramCounts[] =
+{
+    0x00020004, 0x0022001d, 0x0024000c, 0x00280006, 0x002b0088, 0x002e0142,
+    0x00310004, 0x00320007, 0x00370003, 0x003a0007, 0x003d000d, 0x003e0005,
+    0x00410009, 0x0042007e, 0x004401b7, 0x0047004b, 0x00480043, 0x004a008b,
+    0x004b000c, 0x004e0004, 0x00500003, 0x005303c5, 0x00540021, 0x005a000d,
+    0x005d0009, 0x005e0003, 0x0063001b, 0x00640149, 0x00650003, 0x00670003,
+    0x00680028, 0x00690006, 0x006c0007, 0x006e0065, 0x00730054, 0x0074000f,
+    0x00750008, 0x0078000c, 0x007a0091, 0x007b000c, 0x007d002e, 0x007e0004,
+    0x00a5000c, 0x00ae0007, 0x00b300c5, 0x00ba0004, 0x00be0005, 0x00c0007e,
+    0x00c30003, 0x00c400d2, 0x00c8001d, 0x00cc0006, 0x00cd002d, 0x00ce0004,
+    0x00d10013, 0x00dd0006, 0x00de0009, 0x01030030, 0x01060006, 0x010b000d,
+    0x010d0189, 0x011100fd, 0x01120005, 0x01130005, 0x0124000a, 0x01440123,
+    0x01480078, 0x014d0004, 0x015a000f, 0x0160000b, 0x01620008, 0x0164001b,
+    0x01650064, 0x01680047, 0x016b049a, 0x016c0027, 0x016d0003, 0x016e0037,
+    0x01710005, 0x017200fd, 0x01730081, 0x0176001e, 0x01780008, 0x017a02a0,
+    0x017b0046, 0x017d006d, 0x017e000a, 0x01800005, 0x0181002e, 0x0184025c,
+    0x01880014, 0x018e0016, 0x018f0009, 0x0192002a, 0x019a005f, 0x019b0003,
+    0x019d0008, 0x01a00014, 0x01a201e6, 0x01a310c4, 0x01a40078, 0x01a60256,
+    0x01a80070, 0x01aa0003, 0x01ad0080, 0x01ae0121, 0x01b2013f, 0x01b300ac,
+    0x01b8019f, 0x01ba0337, 0x01bb0040, 0x01be0005, 0x01e00015, 0x01e40123,
+    0x01e70003, 0x01e8000a, 0x01ee0027, 0x01ef0178, 0x01f20016, 0x01f3000f,
+    0x01fa0008, 0x02140012, 0x022000b3, 0x02210003, 0x0222003b, 0x02230106,
+    0x02240369, 0x02260044, 0x022800ea, 0x022a008d, 0x022b006c, 0x022c0015,
+    0x022d0009, 0x022e0009, 0x0231002e, 0x0232003f, 0x0233038f, 0x02380067,
+    0x023a017c, 0x023b0026, 0x023d0030, 0x023e0013, 0x02420014, 0x0244009b,
+    0x02470011, 0x02480042, 0x024a0005, 0x024e0059, 0x025202ca, 0x0253010e,
+    0x02540056, 0x02580040, 0x025a0518, 0x025b0078, 0x025d000c, 0x0260000c,
+    0x02620009, 0x02640427, 0x0267004c, 0x0268026b, 0x026c0010, 0x026e0014,
+    0x02710006, 0x02720004, 0x027300a5, 0x02740056, 0x027a0819, 0x027b009a,
+    0x027d0020, 0x02860008, 0x029200b4, 0x02930011, 0x02a4012b, 0x02a8003a,
+    0x02ae000e, 0x02bd0003, 0x02c00021, 0x02c80004, 0x02cd001b, 0x02d20012,
+    0x02da001b, 0x02e80041, 0x02f10004, 0x02fd000a, 0x03040003, 0x03080009,
+    0x031202d0, 0x031a01af, 0x031b0015, 0x031d003d, 0x031e000a, 0x0340000a,
+    0x03410043, 0x03420070, 0x03430060, 0x03450056, 0x03460072, 0x0347001d,
+    0x034b00a3, 0x034c0050, 0x034d000c, 0x034e001a, 0x034f0080, 0x03500013,
+    0x0351004f, 0x03520080, 0x03530039, 0x03550033, 0x03560037, 0x03580003,
+    0x035e0008, 0x03610008, 0x03620011, 0x0363000d, 0x0365000a, 0x0366000d,
+    0x03670004, 0x036b000d, 0x036c000a, 0x036e0003, 0x036f000d, 0x03700005,
+    0x03710005, 0x0372000e, 0x03730009, 0x03750006, 0x039a0004, 0x03ba001b,
+    0x03c60003, 0x03d20006, 0x03da000b, 0x03dd001c, 0x03de0007, 0x0401000e,
+    0x04020022, 0x040b0004, 0x040d0004, 0x04110006, 0x0412001d, 0x04130004,
+    0x04280004, 0x042b003c, 0x043e0003, 0x04430003, 0x045a001a, 0x045d000c,
+    0x045e0006, 0x0474000e, 0x047a0005, 0x04800075, 0x048200e2, 0x04830034,
+    0x04840039, 0x0485007b, 0x0486003b, 0x0487001b, 0x048800dd, 0x048b0015,
+    0x048d002f, 0x0491007e, 0x04920024, 0x049300f5, 0x04980025, 0x049a0465,
+    0x049b007f, 0x049d0017, 0x049e0003, 0x04fd0008, 0x04fe0008, 0x05020003,
+    0x05040006, 0x0506003b, 0x050b0047, 0x050d0006, 0x05120009, 0x0513003c,
+    0x05240082, 0x0560006a, 0x056401c7, 0x0568009d, 0x056e002d, 0x0574012f,
+    0x05780021, 0x05840003, 0x05c0001a, 0x05c30156, 0x05c80004, 0x05cb0009,
+    0x05ce0048, 0x05d10017, 0x05d30074, 0x05d400e7, 0x05d50063, 0x05d6001f,
+    0x05d80003, 0x0620004e, 0x0624006e, 0x06280058, 0x062e0058, 0x063a0003,
+    0x063d0006, 0x0642000f, 0x064400c9, 0x06480003, 0x064e0007, 0x06530053,
+    0x065a000a, 0x065d0032, 0x06600005, 0x0664000c, 0x0668000c, 0x06740004,
+    0x067d0003, 0x0681003c, 0x068b0018, 0x06910011, 0x06920003, 0x069301b2,
+    0x071a0598, 0x071b007d, 0x071d0005, 0x0740000d, 0x07410008, 0x07480006,
+    0x074e0007, 0x07520004, 0x07530006, 0x07560004, 0x075e0004, 0x07ba0023,
+    0x07bb0004, 0x07c30005, 0x07da0003, 0x07dd0006, 0x080b0088, 0x080c0046,
+    0x080d006f, 0x080f000c, 0x0811003d, 0x08120062, 0x08130041, 0x081400b4,
+    0x08150034, 0x08180007, 0x081a0007, 0x08230003, 0x083a000e, 0x083d0003,
+    0x0844006f, 0x084e005d, 0x08540022, 0x087a000a, 0x087d0007, 0x0880000e,
+    0x088300a6, 0x08840042, 0x08880030, 0x088b0012, 0x088c0004, 0x088d0093,
+    0x088f0045, 0x0891003b, 0x089201aa, 0x089a036a, 0x089b0035, 0x089d00eb,
+    0x089e0005, 0x08bd0003, 0x08e000a5, 0x08e40078, 0x08e8000f, 0x08ec0003,
+    0x08ee0011, 0x08f80006, 0x08fa0554, 0x08fb007a, 0x08fd0062, 0x08fe000e,
+    0x0900001f, 0x09030131, 0x09040071, 0x09050005, 0x090d001b, 0x090e0006,
+    0x090f0032, 0x091100ea, 0x0912000d, 0x09130041, 0x091a0011, 0x091e0009,
+    0x093d0005, 0x09440011, 0x094b0007, 0x094d008e, 0x094e000b, 0x0952002b,
+    0x09560003, 0x095a00b6, 0x095b000c, 0x095d0030, 0x095e002a, 0x09600005,
+    0x0964014a, 0x09680049, 0x096e002b, 0x09740015, 0x09ba0005, 0x09c00020,
+    0x09c20004, 0x09c7000d, 0x09cb0413, 0x09cc0230, 0x09cd03d0, 0x09ce0003,
+    0x09cf0085, 0x09d10086, 0x09d40076, 0x09d50031, 0x09de0008, 0x09fa0005,
+    0x0a140003, 0x0a20000f, 0x0a240062, 0x0a280042, 0x0a2e0037, 0x0a340004,
+    0x0a380051, 0x0a3a0003, 0x0a5a000c, 0x0a5d0004, 0x0a600016, 0x0a6401e5,
+    0x0a680322, 0x0a6b0046, 0x0a6d0006, 0x0a710072, 0x0a72004d, 0x0a740025,
+    0x0a7a00e2, 0x0a7b0012, 0x0a7d004b, 0x0a7e0036, 0x0a81000c, 0x0a880007,
+    0x0a8b00fe, 0x0a8c0038, 0x0a8e0015, 0x0a910053, 0x0a92003b, 0x0a930017,
+    0x0a940010, 0x0b0b0005, 0x0b1a0007, 0x0b1d0004, 0x0b400010, 0x0b410007,
+    0x0b48000d, 0x0b4d0003, 0x0b4f0003, 0x0b500007, 0x0b520003, 0x0b530005,
+    0x0b560003, 0x0b5e0006, 0x0b700003, 0x0bba0056, 0x0bbb0003, 0x0bbe0007,
+    0x0bda0007, 0x0bdd0009, 0x0bff0005, 0x0c110087, 0x0c120003, 0x0c18000a,
+    0x0c640012, 0x0c68000d, 0x0c6b0073, 0x0c7a0008, 0x0c7b0004, 0x0c80000d,
+    0x0c82001f, 0x0c8300ad, 0x0c84002f, 0x0c850024, 0x0c86009b, 0x0c8b000d,
+    0x0c8c0009, 0x0c8d0187, 0x0c8f002a, 0x0c910186, 0x0c920100, 0x0c930019,
+    0x0c96000f, 0x0c9a01b4, 0x0c9b0016, 0x0c9d0041, 0x0c9e0010, 0x0cc40058,
+    0x0cda0004, 0x0ce40003, 0x0cfa0006, 0x0d0000e5, 0x0d02006a, 0x0d03003d,
+    0x0d0400ea, 0x0d0500c1, 0x0d060037, 0x0d0b0061, 0x0d0c0023, 0x0d0d00c9,
+    0x0d0f0005, 0x0d11002a, 0x0d12028d, 0x0d13000e, 0x0d140083, 0x0d150047,
+    0x0d200006, 0x0d5d0003, 0x0d5e0003, 0x0d640082, 0x0d680003, 0x0d78000c,
+    0x0d880006, 0x0da40005, 0x0dc40015, 0x0dcc0011, 0x0dcd0018, 0x0dce0003,
+    0x0dd30014, 0x0dd40014, 0x0dd600c1, 0x0dda007a, 0x0ddb0006, 0x0ddd000e,
+    0x0dde0004, 0x0e200034, 0x0e240016, 0x0e280006, 0x0e2e0028, 0x0e380007,
+    0x0e530003, 0x0e5a00fb, 0x0e5b000c, 0x0e5d003e, 0x0e670058, 0x0e80000f,
+    0x0e820059, 0x0e840019, 0x0e8b000b, 0x0e8d0005, 0x0e8f0009, 0x0e910009,
+    0x0ea00003, 0x0ea40005, 0x0f1a0051, 0x0f1b0005, 0x0f1d002e, 0x0f40033f,
+    0x0f41031f, 0x0f4200fa, 0x0f4300a5, 0x0f440091, 0x0f450138, 0x0f460054,
+    0x0f47007b, 0x0f4802d7, 0x0f490006, 0x0f4a0004, 0x0f4b0101, 0x0f4c00ec,
+    0x0f4d00aa, 0x0f4e01e0, 0x0f4f0113, 0x0f50000e, 0x0f5100ea, 0x0f5201bc,
+    0x0f5306a4, 0x0f54004f, 0x0f550070, 0x0f560198, 0x0f58003f, 0x0f5a000b,
+    0x0f5c0052, 0x0f5e006b, 0x0f600035, 0x0f610030, 0x0f62001c, 0x0f63000e,
+    0x0f640013, 0x0f650021, 0x0f660005, 0x0f67000e, 0x0f68002f, 0x0f6b0019,
+    0x0f6c000a, 0x0f6d000f, 0x0f6e001b, 0x0f6f0024, 0x0f710016, 0x0f720040,
+    0x0f73008b, 0x0f740009, 0x0f750008, 0x0f760023, 0x0f780005, 0x0f7c0009,
+    0x0f7e0006, 0x0fba033e, 0x0fbb005d, 0x0fbe000b, 0x0fc20007, 0x0fcc0015,
+    0x0fd00003, 0x0fda000f, 0x0fdd0005, 0x10010014, 0x10020041, 0x100300c9,
+    0x1005000b, 0x100a0027, 0x100b0050, 0x100c0088, 0x100d005a, 0x100f0004,
+    0x1011022f, 0x101201ec, 0x10130177, 0x10150020, 0x101a0004, 0x101e0005,
+    0x102e0006, 0x10310003, 0x10340007, 0x1038004f, 0x10400089, 0x10440044,
+    0x10470004, 0x10480053, 0x104a000d, 0x104b0007, 0x104e011e, 0x10510017,
+    0x10530363, 0x1054004b, 0x10630005, 0x1064002e, 0x10660052, 0x106800f5,
+    0x106b0009, 0x106d0003, 0x106e000c, 0x1072000d, 0x10740006, 0x107a0911,
+    0x107b00b5, 0x107d0215, 0x107e001f, 0x10830052, 0x1088000a, 0x108a005d,
+    0x108b000a, 0x108c0058, 0x108d021f, 0x108f0048, 0x10920066, 0x10930083,
+    0x10990003, 0x109a00a8, 0x109b0015, 0x109d000c, 0x10a00008, 0x10a40004,
+    0x10a5001d, 0x10a60006, 0x10a80021, 0x10ab01e8, 0x10ae013d, 0x10b103a5,
+    0x10b3000f, 0x10b40004, 0x10ba000a, 0x10bd0004, 0x10c00019, 0x10c4000f,
+    0x10c60003, 0x10c80030, 0x10cc0005, 0x10cd0003, 0x10ce000d, 0x10d1008c,
+    0x10d4002b, 0x10da0003, 0x10dd000f, 0x10e40009, 0x10e80019, 0x11060068,
+    0x110d00ff, 0x11110233, 0x11130059, 0x11150030, 0x11240006, 0x115a0004,
+    0x115d0059, 0x1160001c, 0x11630034, 0x1164004c, 0x11650028, 0x11680013,
+    0x116b0174, 0x116e0027, 0x116f0003, 0x1172001f, 0x11730008, 0x11750021,
+    0x117800cf, 0x117a0060, 0x117b0008, 0x117d0010, 0x117e0004, 0x11800039,
+    0x1181000b, 0x1184008e, 0x11880030, 0x118e0026, 0x118f0016, 0x11920038,
+    0x119a00ea, 0x119b0019, 0x119d006a, 0x119e000c, 0x11a00033, 0x11a201dd,
+    0x11a3019c, 0x11a400d4, 0x11a6006d, 0x11a80028, 0x11ab000a, 0x11ad0003,
+    0x11ae0029, 0x11b00005, 0x11b201c9, 0x11b30409, 0x11b40013, 0x11ba03f0,
+    0x11bb003e, 0x11bd008b, 0x11be001f, 0x11c5001f, 0x11cd0004, 0x11d1001c,
+    0x11d4001e, 0x11e00031, 0x11e40053, 0x11e70005, 0x11e80003, 0x11f10044,
+    0x11f20003, 0x11f3004f, 0x11f40005, 0x11fa0023, 0x11fb0004, 0x12140133,
+    0x1220010a, 0x12210009, 0x12220067, 0x1224053c, 0x1225007e, 0x1226009a,
+    0x12270016, 0x1228016a, 0x12290008, 0x122b0004, 0x122c00a6, 0x122d0037,
+    0x122e001c, 0x122f007d, 0x1231001f, 0x12320153, 0x1233009a, 0x12350130,
+    0x12360043, 0x12380157, 0x123a08a9, 0x123b0096, 0x123d031a, 0x123e0062,
+    0x12400007, 0x12420072, 0x124401a8, 0x12470004, 0x12480055, 0x124e0003,
+    0x124f0036, 0x125202fd, 0x1253016a, 0x1254000a, 0x125a0825, 0x125b00a1,
+    0x125d0306, 0x125e000d, 0x12600060, 0x126400d3, 0x126700ca, 0x1268005f,
+    0x1271000f, 0x12720038, 0x12730047, 0x12740033, 0x127600e6, 0x12780009,
+    0x127a01b8, 0x127b0023, 0x127d006b, 0x127e000d, 0x12830003, 0x12a00006,
+    0x12a4016d, 0x12a8000f, 0x12ae0009, 0x12c0000e, 0x12c4001c, 0x12c8001f,
+    0x12cd0006, 0x12d2000e, 0x12d30003, 0x12da0041, 0x12db0008, 0x12dd0007,
+    0x12de001d, 0x12e00018, 0x12e20061, 0x12e70038, 0x12e800c0, 0x12ef013a,
+    0x12f30059, 0x12fa0021, 0x12fb0004, 0x12fd000b, 0x130400a5, 0x130e0025,
+    0x131a01a6, 0x131b0020, 0x131d000b, 0x134005a4, 0x134103ae, 0x1342047a,
+    0x13430289, 0x13440202, 0x134503c3, 0x13460191, 0x13470139, 0x13480405,
+    0x13490005, 0x134a0051, 0x134b0334, 0x134c030d, 0x134d0110, 0x134e06ce,
+    0x134f04c7, 0x13500029, 0x135105c5, 0x13520734, 0x13530734, 0x13540092,
+    0x135500f2, 0x135602ad, 0x13580049, 0x135a001a, 0x135c00a5, 0x135e0073,
+    0x135f000a, 0x13600083, 0x13610059, 0x13620095, 0x1363005d, 0x13640047,
+    0x13650049, 0x13660027, 0x1367001a, 0x1368005f, 0x136a0009, 0x136b0048,
+    0x136c0054, 0x136d001b, 0x136e0083, 0x136f00a7, 0x13700004, 0x1371009e,
+    0x137200bc, 0x13730093, 0x13740011, 0x13750015, 0x13760041, 0x13780007,
+    0x137a0004, 0x137b0007, 0x137c000a, 0x137e000b, 0x13ba057d, 0x13bb00b4,
+    0x13be000d, 0x13c00003, 0x13c60008, 0x13cc002a, 0x13d10003, 0x13d20006,
+    0x13da0021, 0x13db0008, 0x13dd0013, 0x13de0004, 0x1402009b, 0x14080047,
+    0x140b0087, 0x1411008b, 0x1412000a, 0x14130007, 0x141e0007, 0x1480000b,
+    0x14820055, 0x14840048, 0x14880004, 0x148b0024, 0x149100f8, 0x1492002e,
+    0x14960009, 0x149a000f, 0x149d0010, 0x14a400cc, 0x14a80054, 0x14ab0003,
+    0x14ae0003, 0x14b40003, 0x14ba0015, 0x14bd0006, 0x14da000d, 0x14dd0006,
+    0x1501000c, 0x15020099, 0x1504001e, 0x15050036, 0x150600aa, 0x150b0016,
+    0x150d0090, 0x15110171, 0x15120004, 0x15130050, 0x1515001b, 0x15170027,
+    0x1560002a, 0x156401ff, 0x15680004, 0x156e0021, 0x15740025, 0x15780004,
+    0x159a0005, 0x159e0003, 0x15c2004a, 0x15cb0060, 0x15ce000f, 0x15d10438,
+    0x15d400db, 0x162003b1, 0x1624001d, 0x1628006c, 0x162e0316, 0x165a0004,
+    0x166400e8, 0x16670036, 0x16680004, 0x167a0015, 0x167d0005, 0x168b003e,
+    0x168c000f, 0x16910003, 0x1692002d, 0x17080005, 0x171a000a, 0x1740026a,
+    0x17410045, 0x1742008c, 0x17430019, 0x1744005b, 0x1745002f, 0x17460067,
+    0x17470027, 0x174800fa, 0x174b00a4, 0x174c0038, 0x174d002d, 0x174e0083,
+    0x174f0030, 0x17500004, 0x175100c9, 0x175200a8, 0x17530b56, 0x1754000e,
+    0x1755002c, 0x1756009a, 0x1758001a, 0x175a0003, 0x175c0022, 0x175e0018,
+    0x1760002c, 0x1761000a, 0x17620012, 0x17630006, 0x1764000b, 0x17650003,
+    0x17660005, 0x17680014, 0x176b000c, 0x176c0009, 0x176e000c, 0x176f000b,
+    0x17710022, 0x17720013, 0x177300c0, 0x17750007, 0x1776000e, 0x177b0006,
+    0x177c0003, 0x17ba0052, 0x17bb0009, 0x17c60008, 0x17da0005, 0x17db0004,
+    0x17dd0009, 0x1808004a, 0x180d0017, 0x18110013, 0x1813004a, 0x18800007,
+    0x1883005e, 0x188c0005, 0x188d00ab, 0x1891005b, 0x189200c2, 0x18930078,
+    0x189a014d, 0x189b0019, 0x189d0045, 0x189e000b, 0x18c4001d, 0x18e10003,
+    0x18e4000d, 0x18f304d4, 0x18fa012e, 0x18fb0014, 0x18fd0006, 0x19000003,
+    0x190100cb, 0x190d0087, 0x190e0006, 0x19130015, 0x1915002d, 0x196001db,
+    0x196400d4, 0x19680005, 0x196e0028, 0x19780044, 0x1984000f, 0x199d0004,
+    0x199e0006, 0x19a0000a, 0x19a4002d, 0x19a80020, 0x19b40004, 0x19ba0008,
+    0x19be0003, 0x19c30007, 0x19c4000f, 0x19c80025, 0x19cb001e, 0x19ce001c,
+    0x19d30003, 0x19da0041, 0x19db0003, 0x19dd0020, 0x19de0006, 0x1a20003b,
+    0x1a2402f6, 0x1a28000c, 0x1a2e006e, 0x1a3d0018, 0x1a530003, 0x1a5a00d1,
+    0x1a5b000f, 0x1a5d0030, 0x1a670067, 0x1a840013, 0x1a880025, 0x1a8b0035,
+    0x1a8c0009, 0x1a8d0008, 0x1a8e0016, 0x1a91003d, 0x1b1a0008, 0x1b4000ae,
+    0x1b41003b, 0x1b420027, 0x1b43001b, 0x1b440035, 0x1b450045, 0x1b460012,
+    0x1b470014, 0x1b480087, 0x1b4b0017, 0x1b4c0046, 0x1b4d0016, 0x1b4e0097,
+    0x1b4f0040, 0x1b51004b, 0x1b52005b, 0x1b5301dd, 0x1b54001b, 0x1b550010,
+    0x1b56003c, 0x1b580004, 0x1b5c000a, 0x1b5e0006, 0x1b60000c, 0x1b620007,
+    0x1b630004, 0x1b640006, 0x1b650006, 0x1b660004, 0x1b670003, 0x1b680009,
+    0x1b6b0004, 0x1b6c0005, 0x1b6e0006, 0x1b6f0006, 0x1b710007, 0x1b720011,
+    0x1b730027, 0x1b740004, 0x1b760003, 0x1bba00e8, 0x1bbb000c, 0x1bbe0031,
+    0x1bc6000c, 0x1bd00003, 0x1bda0009, 0x1bdd000e, 0x1c0300ad, 0x1c080035,
+    0x1c0a0006, 0x1c0b00f4, 0x1c0c0024, 0x1c0d0230, 0x1c0f003c, 0x1c11003e,
+    0x1c12002e, 0x1c1305a4, 0x1c1500ea, 0x1c2e0003, 0x1c80005d, 0x1c830028,
+    0x1c84000c, 0x1c880248, 0x1c8b002f, 0x1c8c016f, 0x1c8d024e, 0x1c8e001a,
+    0x1c9107bc, 0x1c9201e6, 0x1c930035, 0x1c96002d, 0x1c9801bf, 0x1c9a2293,
+    0x1c9b03ed, 0x1c9e0003, 0x1d01002e, 0x1d02048a, 0x1d040004, 0x1d06000f,
+    0x1d0a0005, 0x1d0b0047, 0x1d0c0011, 0x1d0d0192, 0x1d0f0003, 0x1d110085,
+    0x1d12025b, 0x1d130168, 0x1d2a0003, 0x1d780005, 0x1d840016, 0x1dc3000f,
+    0x1dcb00c7, 0x1dcc0033, 0x1dcd000a, 0x1dce0007, 0x1dd1003d, 0x1dd201cf,
+    0x1dd30021, 0x1dd400e2, 0x1dd60031, 0x1dda0009, 0x1dde0003, 0x1e240070,
+    0x1e280008, 0x1e2e010e, 0x1e530005, 0x1e5a0011, 0x1e5d0008, 0x1e640022,
+    0x1e670010, 0x1e6d0004, 0x1e72001b, 0x1e7a0380, 0x1e7b0047, 0x1e7d00b8,
+    0x1e860004, 0x1e8c0006, 0x1e8d0015, 0x1e910025, 0x1e92002e, 0x1e930016,
+    0x1f0c0006, 0x1f0f0017, 0x1f120003, 0x1f1a0023, 0x1f1b0003, 0x1f1d0007,
+    0x1f4001f6, 0x1f410079, 0x1f420067, 0x1f430032, 0x1f440044, 0x1f45004f,
+    0x1f460023, 0x1f470025, 0x1f4800f8, 0x1f4b0028, 0x1f4c005d, 0x1f4d001a,
+    0x1f4e010c, 0x1f4f0095, 0x1f500007, 0x1f510037, 0x1f520062, 0x1f53026e,
+    0x1f54000a, 0x1f55001a, 0x1f5600b8, 0x1f580006, 0x1f5c0003, 0x1f5e000d,
+    0x1f600022, 0x1f610006, 0x1f62000c, 0x1f630005, 0x1f64000a, 0x1f650006,
+    0x1f660004, 0x1f670004, 0x1f68001c, 0x1f6b0003, 0x1f6c0005, 0x1f6e0011,
+    0x1f6f000e, 0x1f710003, 0x1f72000c, 0x1f73002c, 0x1f76000f, 0x1fba00f6,
+    0x1fbb001a, 0x1fc3003f, 0x1fcb0003, 0x1fda0011, 0x1fdd000d, 0x1fff0028,
+    0x20020006, 0x200b0023, 0x200c0093, 0x200d0011, 0x20130065, 0x201d0003,
+    0x201e0006, 0x20240037, 0x20280074, 0x202b0100, 0x2031003a, 0x20340008,
+    0x20400084, 0x20440031, 0x204703df, 0x20480061, 0x204a0153, 0x204b007a,
+    0x20510008, 0x20530017, 0x2054009e, 0x205a000b, 0x205b0003, 0x205d0008,
+    0x205f0004, 0x20630074, 0x20640285, 0x2068000c, 0x20720014, 0x207a00cb,
+    0x207b0015, 0x207d0026, 0x2082000f, 0x2083005b, 0x20850004, 0x208b0009,
+    0x208d005a, 0x20910008, 0x209201cc, 0x20930016, 0x20950003, 0x20960042,
+    0x209a000a, 0x20a40047, 0x20a500b2, 0x20a8003f, 0x20ab0006, 0x20ae0027,
+    0x20b30049, 0x20b8000f, 0x20ba0191, 0x20bb001c, 0x20c40005, 0x20c6001d,
+    0x20c70494, 0x20c8001d, 0x20cd0037, 0x20ce0039, 0x20d40053, 0x20dd006d,
+    0x21080012, 0x211a0004, 0x211d002d, 0x214400a8, 0x21480004, 0x215a0004,
+    0x21600033, 0x21640038, 0x21680072, 0x216a0004, 0x216b0284, 0x216e0015,
+    0x21720028, 0x21740021, 0x21750033, 0x21780044, 0x217a0053, 0x217b0008,
+    0x217d0014, 0x217e0005, 0x218000d8, 0x2181000c, 0x2184017a, 0x21880041,
+    0x218c002a, 0x218e0011, 0x218f005d, 0x21920003, 0x219a0008, 0x219d0006,
+    0x21a000a0, 0x21a2030d, 0x21a300ea, 0x21a402a0, 0x21a50031, 0x21a60932,
+    0x21a80071, 0x21aa000f, 0x21ab000c, 0x21ad003d, 0x21ae0029, 0x21b20095,
+    0x21b3035c, 0x21b40068, 0x21b5000d, 0x21b6000c, 0x21ba0862, 0x21bb00a9,
+    0x21bd0061, 0x21be0021, 0x21cb00ef, 0x21cc000a, 0x21cd07d4, 0x21d10029,
+    0x21d40083, 0x21da0003, 0x21de0003, 0x21e00009, 0x21e4000e, 0x21e80007,
+    0x21eb001b, 0x21ef0006, 0x21f1000c, 0x21f20005, 0x21f30009, 0x21fa0004,
+    0x21fe0003, 0x221400a9, 0x222200ea, 0x2223007e, 0x2224006b, 0x22280053,
+    0x222c000e, 0x222e001a, 0x22310017, 0x2232014d, 0x22330020, 0x223a0287,
+    0x223b0039, 0x223d006e, 0x223e0005, 0x2240000b, 0x22420033, 0x22440086,
+    0x2245000b, 0x224700d3, 0x22480046, 0x224a0008, 0x224b000c, 0x224c01a0,
+    0x224f0030, 0x22500004, 0x2252005e, 0x22530250, 0x225a05a0, 0x225b0088,
+    0x225d0083, 0x225e001f, 0x22600024, 0x22620013, 0x226401e0, 0x2267036e,
+    0x2268012b, 0x2271002d, 0x227201cd, 0x227300fb, 0x22740051, 0x2278011c,
+    0x227a033d, 0x227b0039, 0x227d00a0, 0x227e0014, 0x228c008f, 0x2292001a,
+    0x22a00004, 0x22a40171, 0x22a80032, 0x22bd000f, 0x22e4001f, 0x22e8001a,
+    0x22f30070, 0x22fa002e, 0x22fb0007, 0x22fd0006, 0x22fe0047, 0x23200003,
+    0x2324000f, 0x232e000f, 0x233d0006, 0x23400019, 0x2342005a, 0x23430020,
+    0x2345003e, 0x2346000b, 0x23470054, 0x23480008, 0x234a0009, 0x234b000c,
+    0x234c0026, 0x234d0005, 0x234e0016, 0x234f001f, 0x23500005, 0x2351000c,
+    0x23520035, 0x23530024, 0x2354000f, 0x23550009, 0x23560017, 0x235e0004,
+    0x23620005, 0x23630004, 0x23650005, 0x23660003, 0x23670007, 0x236c0008,
+    0x236f0004, 0x23720004, 0x23730003, 0x237b0003, 0x23ba002e, 0x23bb002b,
+    0x23be0007, 0x23c3000c, 0x23da0005, 0x23dd0015, 0x23ff0007, 0x2402000e,
+    0x24820097, 0x255a0003, 0x25c8000d, 0x25d10003, 0x26830004, 0x268f0004,
+    0x26920006, 0x27530003, 0x27ba0009, 0x28120003, 0x28830021, 0x28840014,
+    0x288d0041, 0x288f0004, 0x28910025, 0x2892002d, 0x289a0138, 0x289b001f,
+    0x289d000e, 0x29040003, 0x290b0003, 0x290d00b1, 0x29780007, 0x29a4009f,
+    0x29a8004d, 0x29ae0029, 0x29cd000b, 0x2a110003, 0x2a480009, 0x2a5a0019,
+    0x2a5b0007, 0x2a5d0015, 0x2ac00003, 0x2b1e0003, 0x2b400031, 0x2b41000c,
+    0x2b42002e, 0x2b45000b, 0x2b460005, 0x2b470005, 0x2b48001e, 0x2b4b001d,
+    0x2b4c0007, 0x2b4d000b, 0x2b4e001a, 0x2b4f000c, 0x2b510019, 0x2b520021,
+    0x2b530028, 0x2b540005, 0x2b550004, 0x2b560009, 0x2b5a0003, 0x2b5e0005,
+    0x2b610003, 0x2b620003, 0x2b6b0005, 0x2b6f0003, 0x2b720003, 0x2b730003,
+    0x2b7b0005, 0x2bba00b7, 0x2bbb0018, 0x2bc30004, 0x2bd20025, 0x2bda0006,
+    0x2bdd0009, 0x2bde0003, 0x2c010003, 0x2c020136, 0x2c030004, 0x2c080042,
+    0x2c0c0029, 0x2c0d008c, 0x2c0f0003, 0x2c1100f4, 0x2c120222, 0x2c13010b,
+    0x2c160010, 0x2c180013, 0x2c1a0003, 0x2c1d0003, 0x2c1e000d, 0x2c400006,
+    0x2c480004, 0x2c640007, 0x2c680004, 0x2c6e0004, 0x2c72000a, 0x2c7a014e,
+    0x2c7b0015, 0x2c7d0023, 0x2c8000bf, 0x2c82015f, 0x2c83003c, 0x2c85000f,
+    0x2c860006, 0x2c8b0072, 0x2c8c000b, 0x2c8d0110, 0x2c91002d, 0x2c920283,
+    0x2c930179, 0x2c950005, 0x2c9700be, 0x2c9a0393, 0x2c9b004b, 0x2c9d00ef,
+    0x2c9e0007, 0x2cb20005, 0x2cb30005, 0x2cba0062, 0x2cbb0007, 0x2cbd0019,
+    0x2cc0000e, 0x2d000005, 0x2d02001d, 0x2d03002a, 0x2d04001d, 0x2d050009,
+    0x2d060361, 0x2d0a009e, 0x2d0c0035, 0x2d0d0175, 0x2d0f0009, 0x2d1000a9,
+    0x2d120048, 0x2d13012c, 0x2d140005, 0x2d150014, 0x2d190003, 0x2d5a0003,
+    0x2d5d0004, 0x2d600013, 0x2d6400c1, 0x2d680045, 0x2d6d0004, 0x2d6e0148,
+    0x2d720014, 0x2d74009b, 0x2d7800d8, 0x2d7a04b9, 0x2d7b0061, 0x2d7d0037,
+    0x2d7e0009, 0x2d8e0026, 0x2da4000a, 0x2dc00007, 0x2dc10025, 0x2dc2000d,
+    0x2dc6000c, 0x2dcd007e, 0x2dce003a, 0x2dcf0007, 0x2dd1000d, 0x2dd20050,
+    0x2dd3000c, 0x2dd403fb, 0x2dd601a2, 0x2dda0004, 0x2de70023, 0x2dfa0003,
+    0x2e240005, 0x2e320003, 0x2e440018, 0x2e480004, 0x2e4e0093, 0x2e530020,
+    0x2e5a0063, 0x2e5b0006, 0x2e5d0028, 0x2e640031, 0x2e67000d, 0x2e68000d,
+    0x2e6b000b, 0x2e6e0004, 0x2e710005, 0x2e720009, 0x2e780003, 0x2e7a0041,
+    0x2e7b0004, 0x2e7d0015, 0x2e7e0004, 0x2e82002a, 0x2e83000f, 0x2e84012b,
+    0x2e880027, 0x2e8c00c0, 0x2e92004d, 0x2e93003a, 0x2e950003, 0x2ea00006,
+    0x2ea40074, 0x2ea80006, 0x2ec0001e, 0x2f08000d, 0x2f120007, 0x2f1a0376,
+    0x2f1b0056, 0x2f1d00b9, 0x2f1e0003, 0x2f4000a8, 0x2f410114, 0x2f42005f,
+    0x2f430035, 0x2f44001e, 0x2f450025, 0x2f46001b, 0x2f47001d, 0x2f480065,
+    0x2f4a0006, 0x2f4b0037, 0x2f4c0055, 0x2f4d0022, 0x2f4e009d, 0x2f4f007c,
+    0x2f500006, 0x2f51006e, 0x2f520080, 0x2f5301b6, 0x2f54003e, 0x2f550010,
+    0x2f560032, 0x2f5e0003, 0x2f60000a, 0x2f610010, 0x2f620009, 0x2f630007,
+    0x2f640006, 0x2f650008, 0x2f680008, 0x2f6b0004, 0x2f6c0008, 0x2f6e000b,
+    0x2f6f0018, 0x2f71000b, 0x2f720012, 0x2f730017, 0x2f740006, 0x2f760006,
+    0x2fba00c7, 0x2fbb0018, 0x2fc00006, 0x2fc30006, 0x2fc60004, 0x2fd20007,
+    0x2fdd0017, 0x30010007, 0x3003011e, 0x300600d4, 0x3008002e, 0x300a00fe,
+    0x300b006b, 0x300d00ec, 0x30110015, 0x30120009, 0x30130061, 0x30180125,
+    0x30240075, 0x30280007, 0x302b000c, 0x30310010, 0x30320003, 0x303a0011,
+    0x303d0004, 0x305a0004, 0x305e0003, 0x308000a2, 0x30820004, 0x308300f1,
+    0x30840026, 0x308b0011, 0x308c0003, 0x308d017b, 0x309100b1, 0x309200bd,
+    0x30930160, 0x309a02ad, 0x309b0057, 0x309d003c, 0x30a4001d, 0x30da0003,
+    0x3102000e, 0x3103007b, 0x31060050, 0x310b0011, 0x310d013c, 0x31120040,
+    0x31130096, 0x311700b3, 0x311e0010, 0x31780009, 0x31840027, 0x31880007,
+    0x318e002c, 0x3194000b, 0x31b20003, 0x31ba0016, 0x31bd0007, 0x31be0009,
+    0x31c30015, 0x31c60032, 0x31c8000a, 0x31ca0006, 0x31cc0008, 0x31cd0060,
+    0x31ce0013, 0x31d10187, 0x31d2010e, 0x31d300a9, 0x31d40011, 0x31d5003c,
+    0x31da0004, 0x31dd0007, 0x31e0003d, 0x31e4001f, 0x31e70003, 0x31e8000c,
+    0x31eb001a, 0x31ee00ce, 0x31f1002b, 0x31f30014, 0x31f40010, 0x31fa0004,
+    0x323d0009, 0x32440018, 0x32530010, 0x32550003, 0x325a00a3, 0x325b0007,
+    0x325d003a, 0x325e0003, 0x327d0005, 0x328200b9, 0x328b000a, 0x328d0008,
+    0x32920072, 0x32930015, 0x331a0047, 0x331b0006, 0x3340008a, 0x33410048,
+    0x33420014, 0x33430017, 0x33440012, 0x33450016, 0x33460009, 0x3347001a,
+    0x3348007c, 0x334b0005, 0x334c0028, 0x334d000e, 0x334e00e2, 0x334f0023,
+    0x33510011, 0x33520034, 0x3353024b, 0x33540006, 0x3355000d, 0x3356005c,
+    0x33580004, 0x335c000b, 0x335e0017, 0x33600009, 0x33610006, 0x33640004,
+    0x33680005, 0x336c0004, 0x336e000f, 0x336f0004, 0x33710004, 0x33720006,
+    0x33730021, 0x33760008, 0x33ba0147, 0x33bb0022, 0x33be0007, 0x33c30027,
+    0x33da0016, 0x33dd001e, 0x34010010, 0x34020012, 0x340a0010, 0x340b0050,
+    0x340c000e, 0x340d0009, 0x34110017, 0x341300e7, 0x341a001b, 0x341b0003,
+    0x341d0003, 0x341e0004, 0x3440002e, 0x344403fc, 0x344700f2, 0x34480105,
+    0x344b0059, 0x344e002c, 0x34510043, 0x34530071, 0x34540005, 0x3458000b,
+    0x346400e0, 0x346800e6, 0x346b0013, 0x346e003b, 0x34710016, 0x34720057,
+    0x3474001a, 0x347a1160, 0x347b018e, 0x347d0068, 0x347e000c, 0x348000c5,
+    0x34820014, 0x34830082, 0x34840005, 0x34850003, 0x34860004, 0x34880012,
+    0x348d000d, 0x348e0010, 0x348f0004, 0x34900023, 0x349100c8, 0x34920255,
+    0x34930032, 0x34950019, 0x34960031, 0x3497002f, 0x34980004, 0x349a0311,
+    0x349b004d, 0x349d0060, 0x34a40007, 0x34a80044, 0x34ab0016, 0x34ae0010,
+    0x34b40024, 0x34c4017e, 0x34c800e1, 0x34cb011a, 0x34d1000a, 0x34d2010e,
+    0x34d30067, 0x34d40030, 0x34da067b, 0x34db0093, 0x34dd007d, 0x34de000e,
+    0x35000007, 0x3502001b, 0x3504000f, 0x3505007b, 0x35060003, 0x350c0015,
+    0x350d0096, 0x350e0004, 0x35120057, 0x35130046, 0x35140008, 0x35150039,
+    0x35480003, 0x354d0004, 0x355a000a, 0x35600004, 0x3564001a, 0x35780076,
+    0x35880003, 0x358e0004, 0x35a0000d, 0x35a40087, 0x35a8000d, 0x35ae001a,
+    0x35b40008, 0x35be0004, 0x35c80003, 0x35cc002a, 0x35cd0013, 0x35d10023,
+    0x35d30371, 0x35d40043, 0x35d600a2, 0x35da0053, 0x35db0006, 0x35de0006,
+    0x36140006, 0x36240003, 0x36400018, 0x36420003, 0x364400d4, 0x364800f2,
+    0x364b0013, 0x364c0081, 0x364e001a, 0x364f004d, 0x36530098, 0x36550005,
+    0x36560019, 0x365a0221, 0x365b0021, 0x365d00d1, 0x365e000f, 0x36600049,
+    0x366401c6, 0x3667002a, 0x36680103, 0x366b005c, 0x366e0146, 0x36710081,
+    0x3672009a, 0x3678000c, 0x367a0257, 0x367b003a, 0x367d0091, 0x367e0003,
+    0x36800023, 0x36840020, 0x36880006, 0x368c0064, 0x36920028, 0x3693001f,
+    0x36a40076, 0x36b30003, 0x36c00016, 0x371a0175, 0x371b0030, 0x371d000d,
+    0x374002ad, 0x374100e6, 0x37420064, 0x37430059, 0x37440060, 0x37450045,
+    0x37460034, 0x37470044, 0x37480223, 0x374a0003, 0x374b0055, 0x374c006f,
+    0x374d001a, 0x374e028c, 0x374f00a9, 0x3750000e, 0x3751004c, 0x375200bd,
+    0x37530903, 0x37540020, 0x37550035, 0x375600c9, 0x3758000f, 0x375a0008,
+    0x375c0011, 0x375e0054, 0x37600025, 0x3761000d, 0x3762000a, 0x37630007,
+    0x3764000e, 0x37650006, 0x37660007, 0x37670005, 0x37680027, 0x376b0009,
+    0x376c0003, 0x376e0022, 0x376f0016, 0x3771000a, 0x37720006, 0x37730097,
+    0x37740004, 0x37760011, 0x377e0008, 0x37ba02c6, 0x37bb0063, 0x37be0016,
+    0x37c10008, 0x37c30053, 0x37cc000b, 0x37cf000a, 0x37d2005c, 0x37d30003,
+    0x37d60003, 0x37da000c, 0x37db0003, 0x37dd000d, 0x3802000d, 0x38030047,
+    0x380a0004, 0x380b000d, 0x380f0004, 0x3811001a, 0x3812000e, 0x3813000c,
+    0x3820000e, 0x38240017, 0x3829007f, 0x382b00a4, 0x38320110, 0x38330009,
+    0x3834000e, 0x383d0008, 0x3840000d, 0x3842000d, 0x3844000e, 0x38480024,
+    0x384a000c, 0x3854003b, 0x38630006, 0x386800f6, 0x38740045, 0x38780074,
+    0x387a003f, 0x387d0013, 0x38920025, 0x38950008, 0x389d0005, 0x38a50018,
+    0x38b3001e, 0x38ba12eb, 0x38bb019a, 0x38bd001b, 0x38be0003, 0x38c400a9,
+    0x38d1002b, 0x38d80007, 0x38dd0007, 0x38e4000d, 0x38fd0006, 0x3903000a,
+    0x390b0043, 0x390d00b2, 0x3912000d, 0x39240003, 0x3944001f, 0x3948000e,
+    0x3952000d, 0x395a002d, 0x395b0008, 0x395d002d, 0x395e0005, 0x39600022,
+    0x39630045, 0x39640183, 0x39680072, 0x396b0078, 0x396e03f0, 0x39740022,
+    0x3975002b, 0x397a0012, 0x397d000b, 0x397e000b, 0x39810012, 0x398401eb,
+    0x39880027, 0x398c0038, 0x398e0035, 0x398f0124, 0x39920007, 0x39940006,
+    0x399a02fc, 0x399b0030, 0x399d0012, 0x39a00029, 0x39a20083, 0x39a300f5,
+    0x39a402a0, 0x39a5005c, 0x39a600c7, 0x39a80015, 0x39a90004, 0x39ab0063,
+    0x39ad0003, 0x39ae0006, 0x39b202ef, 0x39b300dd, 0x39b5006d, 0x39b80014,
+    0x39ba06db, 0x39bb0063, 0x39bd0201, 0x39be0024, 0x39c3003b, 0x39c50008,
+    0x39ca008f, 0x39cb0003, 0x39cc0011, 0x39cd002a, 0x39d10005, 0x39d3002a,
+    0x39da0015, 0x39db0003, 0x39e00055, 0x39e4007d, 0x39e70015, 0x39e80045,
+    0x39ee00ec, 0x39ef004a, 0x39f2001c, 0x39f30033, 0x39fa0024, 0x39fd0044,
+    0x3a20005d, 0x3a210015, 0x3a220036, 0x3a2300f0, 0x3a240300, 0x3a260007,
+    0x3a28004a, 0x3a2a000a, 0x3a2b000d, 0x3a2c00b1, 0x3a2d000b, 0x3a2e0004,
+    0x3a2f001a, 0x3a310017, 0x3a320032, 0x3a330150, 0x3a340003, 0x3a360004,
+    0x3a38000c, 0x3a3a051e, 0x3a3b007b, 0x3a3d0031, 0x3a3e0013, 0x3a420006,
+    0x3a44028c, 0x3a4800d1, 0x3a4e0015, 0x3a4f0011, 0x3a520045, 0x3a53011d,
+    0x3a60002d, 0x3a640033, 0x3a67037e, 0x3a6800a2, 0x3a6d0003, 0x3a720016,
+    0x3a730021, 0x3a760005, 0x3a7a022a, 0x3a7b002c, 0x3a7d0020, 0x3a810017,
+    0x3a82001b, 0x3a830014, 0x3a86019c, 0x3a8b011b, 0x3a8d0182, 0x3a9104c3,
+    0x3a920107, 0x3a930242, 0x3a9a0046, 0x3a9b0003, 0x3aa00003, 0x3aa40119,
+    0x3aa80012, 0x3ab80007, 0x3ac00069, 0x3ac30020, 0x3ac40067, 0x3ac80037,
+    0x3acb0012, 0x3acd0065, 0x3ad20040, 0x3ada0173, 0x3adb0025, 0x3add00cf,
+    0x3ade002b, 0x3b0b0003, 0x3b1a0003, 0x3b1d0003, 0x3b3a0003, 0x3b400127,
+    0x3b410166, 0x3b420064, 0x3b430050, 0x3b440049, 0x3b450071, 0x3b460045,
+    0x3b470031, 0x3b4800a3, 0x3b4a0014, 0x3b4b002e, 0x3b4c00b9, 0x3b4d004a,
+    0x3b4e00c6, 0x3b4f0078, 0x3b500006, 0x3b510069, 0x3b52009c, 0x3b53038c,
+    0x3b540010, 0x3b550028, 0x3b560051, 0x3b58000e, 0x3b5a001a, 0x3b5c0061,
+    0x3b5e001a, 0x3b600019, 0x3b61000e, 0x3b62000a, 0x3b630008, 0x3b640005,
+    0x3b650007, 0x3b660008, 0x3b670003, 0x3b680011, 0x3b6b0004, 0x3b6c000b,
+    0x3b6d0003, 0x3b6e000e, 0x3b6f000a, 0x3b71000a, 0x3b720010, 0x3b73003f,
+    0x3b760008, 0x3b7c0006, 0x3b7e0003, 0x3bba0058, 0x3bbb0008, 0x3bc2000a,
+    0x3bc80008, 0x3bcc0006, 0x3bd30003, 0x3bda000b, 0x3bdd000c, 0x3c010005,
+    0x3c02005a, 0x3c060037, 0x3c080025, 0x3c0a0019, 0x3c0b0020, 0x3c0d0014,
+    0x3c0f00f9, 0x3c1103a9, 0x3c1200d6, 0x3c190003, 0x3c800153, 0x3c820129,
+    0x3c830013, 0x3c8b001c, 0x3c8d00e7, 0x3c9103a3, 0x3c92003b, 0x3c930017,
+    0x3c9a0013, 0x3c9d0007, 0x3ce4004c, 0x3ce8001d, 0x3cee0003, 0x3cf10004,
+    0x3cf40023, 0x3cf80011, 0x3cfe0004, 0x3cff0028, 0x3d020017, 0x3d040010,
+    0x3d0b000c, 0x3d0c0007, 0x3d0d001d, 0x3d0e003a, 0x3d0f000e, 0x3d11003d,
+    0x3d13001d, 0x3d6001f5, 0x3d640071, 0x3d680020, 0x3d6e000a, 0x3d740003,
+    0x3d78000a, 0x3dc50003, 0x3dc60003, 0x3dc8007e, 0x3dcb0042, 0x3dcd016d,
+    0x3dd100d6, 0x3dd20176, 0x3dd3004b, 0x3dd400a6, 0x3dd60055, 0x3de00004,
+    0x3de40188, 0x3de80006, 0x3deb000d, 0x3dee0069, 0x3df1000f, 0x3dfe000f,
+    0x3e110003, 0x3e1d0003, 0x3e200003, 0x3e2400f3, 0x3e2801d2, 0x3e2e027b,
+    0x3e440008, 0x3e5a002a, 0x3e5d000b, 0x3e640020, 0x3e670004, 0x3e680057,
+    0x3e6e0005, 0x3e780009, 0x3e7a0049, 0x3e7d0016, 0x3e7e002e, 0x3e810008,
+    0x3e8b000a, 0x3e8f0005, 0x3e91003d, 0x3e920010, 0x3e930049, 0x3ec0000c,
+    0x3f400024, 0x3f410008, 0x3f480015, 0x3f4b0003, 0x3f4c0003, 0x3f4e0017,
+    0x3f510005, 0x3f53001c, 0x3f550005, 0x3f56000d, 0x3f5c0009, 0x3f730005,
+    0x3fba0038, 0x3fbb0003, 0x3fbe0024, 0x3fc30013, 0x3fcf0007, 0x3fda0017,
+    0x3fdd0018, 0x422b0003, 0x4233000f, 0x42800171, 0x428400a0, 0x42880098,
+    0x428e0029, 0x429d001c, 0x43410005, 0x43ba0014, 0x43c20003, 0x43da001d,
+    0x43dd0017, 0x4401001f, 0x44020351, 0x44030021, 0x44060008, 0x44080032,
+    0x4409000a, 0x440b0161, 0x440c000c, 0x440d022c, 0x440f0004, 0x4411007b,
+    0x44120008, 0x44130123, 0x4415001e, 0x44160034, 0x441802f4, 0x441a0008,
+    0x441d0005, 0x441e0005, 0x44200004, 0x44240003, 0x4428000b, 0x442b0003,
+    0x442e000a, 0x44320007, 0x443a0007, 0x44440096, 0x44470009, 0x44480003,
+    0x444b009e, 0x44520010, 0x4454006b, 0x445a0003, 0x44640096, 0x44680059,
+    0x447200b3, 0x447a00a2, 0x447b0009, 0x447d0024, 0x448002a9, 0x44810050,
+    0x448200ab, 0x448302ea, 0x44840220, 0x44850659, 0x4486004a, 0x44870003,
+    0x44880012, 0x44890007, 0x448b000a, 0x448c005f, 0x448d00df, 0x448e002d,
+    0x448f0060, 0x4490001d, 0x44910044, 0x449201fe, 0x44930058, 0x4495000d,
+    0x44960013, 0x4498000c, 0x449a07f5, 0x449b00a1, 0x449d00e7, 0x449e000c,
+    0x44a0008c, 0x44a40046, 0x44a80021, 0x44ae0015, 0x44c00007, 0x44c400a2,
+    0x44c80024, 0x44d4001b, 0x44e00016, 0x45000022, 0x45010042, 0x45020041,
+    0x45030009, 0x4504006f, 0x4505001d, 0x45060087, 0x450a000e, 0x450b0003,
+    0x450c00bc, 0x450d021f, 0x450e0086, 0x450f000a, 0x45120221, 0x45130074,
+    0x45140014, 0x45150020, 0x45190011, 0x45200008, 0x45400005, 0x4544001e,
+    0x45480003, 0x454c0003, 0x454d0006, 0x455a0058, 0x455b000a, 0x455d0004,
+    0x4563000d, 0x45640009, 0x4578006a, 0x4580000f, 0x45840082, 0x45880041,
+    0x458b0009, 0x458e001c, 0x4592000e, 0x459a0048, 0x459b0006, 0x459d000a,
+    0x459e001c, 0x45a0001e, 0x45a40025, 0x45a80028, 0x45b2001d, 0x45ba0027,
+    0x45bb0004, 0x45bd0006, 0x45be000c, 0x45c00055, 0x45c1001d, 0x45c20021,
+    0x45c30047, 0x45c6003e, 0x45c90003, 0x45ca000c, 0x45cc0312, 0x45cd007e,
+    0x45ce002d, 0x45cf01b8, 0x45d10010, 0x45d20045, 0x45d3000b, 0x45d40188,
+    0x45d50027, 0x45d60050, 0x45d80007, 0x45da0005, 0x45e4007e, 0x45e80007,
+    0x45eb002e, 0x45ee0011, 0x45f4000f, 0x46200003, 0x4624002e, 0x46280021,
+    0x462e0025, 0x46340005, 0x46380004, 0x463d0004, 0x463e0004, 0x46400003,
+    0x46440023, 0x46470003, 0x46480005, 0x464c0003, 0x464f0007, 0x4653017c,
+    0x46540003, 0x465a029c, 0x465b002e, 0x465d0118, 0x465e0004, 0x4660003e,
+    0x4664004a, 0x466700c7, 0x46680173, 0x466b000f, 0x466e000d, 0x4672012f,
+    0x46740038, 0x46780013, 0x467a0120, 0x467b000d, 0x467d002e, 0x467e0024,
+    0x4681000c, 0x46820004, 0x46840016, 0x468b002a, 0x468c0078, 0x468d0011,
+    0x468f0009, 0x46920010, 0x4693000f, 0x46940009, 0x46a000cc, 0x46a40058,
+    0x46a8000d, 0x46be000c, 0x46c0002b, 0x46c8001c, 0x47080013, 0x47120051,
+    0x471a01a6, 0x471b0028, 0x471d0026, 0x471e0008, 0x474001ea, 0x4741010f,
+    0x4742011b, 0x4743008a, 0x47440072, 0x474500a4, 0x4746003f, 0x4747003e,
+    0x474801eb, 0x474a0008, 0x474b0054, 0x474c009a, 0x474d002f, 0x474e01aa,
+    0x474f00eb, 0x47500005, 0x4751009e, 0x47520150, 0x47530343, 0x47540032,
+    0x4755003f, 0x47560108, 0x4758000f, 0x475a0004, 0x475c0048, 0x475e0026,
+    0x4760001d, 0x4761000d, 0x47620021, 0x4763000c, 0x4764000b, 0x4765000d,
+    0x47660003, 0x47670006, 0x4768001b, 0x476b000a, 0x476c000a, 0x476d0005,
+    0x476e001a, 0x476f0021, 0x47710018, 0x4772001a, 0x4773003f, 0x47740003,
+    0x47750003, 0x47760018, 0x477c0006, 0x477e0005, 0x47ba0404, 0x47bb006a,
+    0x47be002b, 0x47c10003, 0x47c30095, 0x47d20016, 0x47da001e, 0x47dd001a,
+    0x48000004, 0x48060018, 0x48080020, 0x480b0055, 0x480c0162, 0x480d0012,
+    0x480f0006, 0x48110011, 0x48130031, 0x4816000e, 0x4818000f, 0x48400036,
+    0x4844002e, 0x48470006, 0x48480003, 0x484b0011, 0x484e005d, 0x4851004d,
+    0x48540011, 0x4880000a, 0x488200ce, 0x488300d8, 0x488400cc, 0x488b0062,
+    0x488c001a, 0x488d00ec, 0x488f0031, 0x48900042, 0x4891011c, 0x48920139,
+    0x48930026, 0x48940003, 0x489500c2, 0x489a0469, 0x489b0068, 0x489d0071,
+    0x489e0003, 0x48a00003, 0x48a80006, 0x48e000f9, 0x48e4006d, 0x48e80041,
+    0x48ec0004, 0x48ee0042, 0x48f10005, 0x48f40016, 0x48fa004d, 0x48fb0004,
+    0x48fd000f, 0x48fe003e, 0x49010068, 0x49020007, 0x4903016a, 0x49040003,
+    0x49060018, 0x490b0066, 0x490c0018, 0x490d015d, 0x490e00a8, 0x49110014,
+    0x49120050, 0x4913011c, 0x49150039, 0x4917004e, 0x4919000d, 0x4948000c,
+    0x49580004, 0x495a0008, 0x495d0003, 0x4960001f, 0x4964000b, 0x49680007,
+    0x496e0017, 0x4978003d, 0x49800062, 0x4988007f, 0x498e000e, 0x4992004f,
+    0x49940003, 0x499a00c8, 0x499b000f, 0x499d006e, 0x49ae0004, 0x49c00006,
+    0x49c20006, 0x49c40008, 0x49c50008, 0x49cb0079, 0x49cc010c, 0x49cd005c,
+    0x49ce001e, 0x49cf0015, 0x49d1008a, 0x49d40015, 0x49da025e, 0x49db0028,
+    0x49dd0013, 0x49e00098, 0x49e40136, 0x49e70048, 0x49e80043, 0x49eb000f,
+    0x49ee006e, 0x49f1001b, 0x49f40006, 0x4a11000f, 0x4a14002e, 0x4a40002a,
+    0x4a440115, 0x4a480114, 0x4a4e002b, 0x4a54000c, 0x4a580006, 0x4a5a029c,
+    0x4a5b0038, 0x4a5d00f2, 0x4a5e0017, 0x4a6002a0, 0x4a640044, 0x4a680142,
+    0x4a6b0014, 0x4a6e0055, 0x4a710107, 0x4a720019, 0x4a740020, 0x4a7a0433,
+    0x4a7b0061, 0x4a7d0084, 0x4a7e0003, 0x4a80004d, 0x4a810088, 0x4a82011e,
+    0x4a830004, 0x4a850052, 0x4a8b002c, 0x4a8c0013, 0x4a8d00af, 0x4a8f0074,
+    0x4a9100e6, 0x4a92000c, 0x4aa40005, 0x4aad0003, 0x4ac4001f, 0x4ac8000b,
+    0x4b0c0006, 0x4b1a0039, 0x4b1b0007, 0x4b400427, 0x4b41021e, 0x4b420119,
+    0x4b4300d8, 0x4b4400c5, 0x4b450129, 0x4b460056, 0x4b470063, 0x4b480345,
+    0x4b490003, 0x4b4a000c, 0x4b4b00b7, 0x4b4c01aa, 0x4b4d00c7, 0x4b4e0768,
+    0x4b4f0118, 0x4b50000e, 0x4b5100e2, 0x4b52014b, 0x4b53049a, 0x4b54006a,
+    0x4b550051, 0x4b560283, 0x4b570003, 0x4b58001d, 0x4b5a0006, 0x4b5c0091,
+    0x4b5e0059, 0x4b5f0003, 0x4b600044, 0x4b610033, 0x4b620022, 0x4b630020,
+    0x4b640013, 0x4b650014, 0x4b66000a, 0x4b67000b, 0x4b68002d, 0x4b6b000d,
+    0x4b6c002f, 0x4b6d0012, 0x4b6e0060, 0x4b6f0017, 0x4b710020, 0x4b720020,
+    0x4b730050, 0x4b740006, 0x4b750008, 0x4b760040, 0x4b780003, 0x4b7a0003,
+    0x4b7b0008, 0x4b7c0009, 0x4b7e000c, 0x4bba07ca, 0x4bbb0116, 0x4bbe0055,
+    0x4bc30016, 0x4bda0031, 0x4bdb0003, 0x4bdd002d, 0x4bde0004, 0x4c010024,
+    0x4c020018, 0x4c06000a, 0x4c080054, 0x4c0a005b, 0x4c0b00cd, 0x4c0d022c,
+    0x4c110039, 0x4c12000a, 0x4c130065, 0x4c180004, 0x4c1a0004, 0x4c47001c,
+    0x4c80001d, 0x4c810005, 0x4c830412, 0x4c840027, 0x4c8b0085, 0x4c8c000a,
+    0x4c8d00f0, 0x4c8f0003, 0x4c910554, 0x4c9200ca, 0x4c950008, 0x4c970004,
+    0x4c9a01eb, 0x4c9b0023, 0x4c9d0083, 0x4ce006f3, 0x4ce43429, 0x4ce80482,
+    0x4ceb0003, 0x4cec0011, 0x4cee0267, 0x4cf1017e, 0x4cf2001e, 0x4cf4002e,
+    0x4cf80004, 0x4cfa043c, 0x4cfb0050, 0x4cfd007b, 0x4d000004, 0x4d010003,
+    0x4d020121, 0x4d040083, 0x4d050015, 0x4d060017, 0x4d0b00d5, 0x4d0c00c9,
+    0x4d0d0250, 0x4d0e0674, 0x4d11000f, 0x4d120048, 0x4d13005b, 0x4d15003c,
+    0x4d1f0007, 0x4d6400aa, 0x4d7800cf, 0x4d8e002b, 0x4da4000f, 0x4dae0003,
+    0x4dc60060, 0x4dcb0004, 0x4dcc001e, 0x4dcd001e, 0x4dce003c, 0x4dcf0032,
+    0x4dd1001a, 0x4dd30032, 0x4dd4001c, 0x4dd60069, 0x4dda08c7, 0x4ddb009e,
+    0x4ddd0005, 0x4e1e0004, 0x4e20020b, 0x4e240050, 0x4e28008f, 0x4e2e0070,
+    0x4e3400b4, 0x4e380022, 0x4e480009, 0x4e4e0003, 0x4e5a0382, 0x4e5b0046,
+    0x4e5d00b4, 0x4e5e0003, 0x4e6400bc, 0x4e680028, 0x4e6b00a3, 0x4e6e001b,
+    0x4e710062, 0x4e78001c, 0x4e80002d, 0x4e810006, 0x4e83001e, 0x4e840014,
+    0x4e8c000b, 0x4e8d0006, 0x4e8e0004, 0x4e910172, 0x4e920005, 0x4e930020,
+    0x4ec00010, 0x4ec40104, 0x4ec8000a, 0x4ece0117, 0x4efa0003, 0x4efd0005,
+    0x4f1a00fe, 0x4f1b0010, 0x4f1d0062, 0x4f1e0004, 0x4f40034b, 0x4f4101f9,
+    0x4f4200d8, 0x4f43009c, 0x4f440080, 0x4f45010d, 0x4f460034, 0x4f47007a,
+    0x4f48032f, 0x4f490004, 0x4f4a0012, 0x4f4b00d7, 0x4f4c00f0, 0x4f4d0054,
+    0x4f4e0450, 0x4f4f0125, 0x4f50001a, 0x4f510136, 0x4f52017a, 0x4f5305ba,
+    0x4f540046, 0x4f55002d, 0x4f5601f4, 0x4f570012, 0x4f580037, 0x4f590003,
+    0x4f5a0004, 0x4f5c0040, 0x4f5e0054, 0x4f600048, 0x4f610021, 0x4f620018,
+    0x4f630018, 0x4f640011, 0x4f65000e, 0x4f66000b, 0x4f670008, 0x4f680026,
+    0x4f6b0010, 0x4f6c0011, 0x4f6d0006, 0x4f6e002b, 0x4f6f0015, 0x4f700006,
+    0x4f71002e, 0x4f720028, 0x4f730069, 0x4f740009, 0x4f750007, 0x4f76002b,
+    0x4f780003, 0x4f7c0004, 0x4f7e000a, 0x4fba037f, 0x4fbb0077, 0x4fbe0013,
+    0x4fc40003, 0x4fc60033, 0x4fc80004, 0x4fcc000e, 0x4fcf0003, 0x4fd20015,
+    0x4fd30007, 0x4fda004b, 0x4fdb0005, 0x4fdc000a, 0x4fdd0032, 0x4fde0005,
+    0x50030004, 0x500b0180, 0x500d002a, 0x50110043, 0x50130019, 0x501a000f,
+    0x50210045, 0x5023000e, 0x50240010, 0x50290005, 0x502b0029, 0x5032004f,
+    0x5033001c, 0x50420069, 0x5044003f, 0x50470188, 0x50480031, 0x504a0004,
+    0x50530014, 0x50630005, 0x5064002d, 0x50660003, 0x50680003, 0x506e0003,
+    0x50720011, 0x50830016, 0x508b0023, 0x508d0048, 0x50910003, 0x50920023,
+    0x509a00e8, 0x509b000e, 0x509d0092, 0x509e0011, 0x50a50052, 0x50c40004,
+    0x50c7019d, 0x50cc0007, 0x51020035, 0x51030022, 0x51040004, 0x510d000b,
+    0x5111000f, 0x5112003c, 0x5113003f, 0x51140004, 0x516000c6, 0x51620003,
+    0x51630116, 0x5164002c, 0x5166000e, 0x516a0003, 0x516b003c, 0x516d0003,
+    0x516f0023, 0x51720009, 0x5173003e, 0x5174004c, 0x5178000e, 0x517a0008,
+    0x5181005b, 0x51840037, 0x5185001d, 0x51880071, 0x518d0006, 0x518e0005,
+    0x518f0004, 0x51920046, 0x519a00be, 0x519b0008, 0x519d005f, 0x519e001d,
+    0x51a20017, 0x51a301b8, 0x51a40017, 0x51a50008, 0x51a8004b, 0x51aa0006,
+    0x51ab001b, 0x51ac0006, 0x51ad0005, 0x51b10003, 0x51b20003, 0x51b3003b,
+    0x51b40024, 0x51ba0047, 0x51bb0004, 0x51bd001b, 0x51be005d, 0x51d1002a,
+    0x51d40023, 0x51de000c, 0x51e40025, 0x51e80009, 0x51eb000a, 0x51ee0160,
+    0x51ef005e, 0x51f30005, 0x51f6000c, 0x51fa002e, 0x51fb0004, 0x51fd0003,
+    0x52200039, 0x5221000d, 0x522401b4, 0x5225008c, 0x52260003, 0x52280025,
+    0x522b0004, 0x522d007a, 0x522f003e, 0x52310005, 0x52320286, 0x5233002f,
+    0x52350007, 0x52380018, 0x523a0124, 0x523b0010, 0x523d007a, 0x523e0042,
+    0x52400009, 0x5242001d, 0x524400fc, 0x52470008, 0x5248002d, 0x524b003a,
+    0x524f000a, 0x52520006, 0x525300b1, 0x52540047, 0x525a0115, 0x525b0014,
+    0x525d002e, 0x525e000b, 0x52600015, 0x5264006c, 0x5267001e, 0x52680027,
+    0x526c001b, 0x52710009, 0x52720019, 0x5273001a, 0x5274000e, 0x5276000f,
+    0x527a037b, 0x527b003d, 0x527d002a, 0x528c0019, 0x52a80003, 0x52fe0003,
+    0x53400003, 0x534c0015, 0x534f0005, 0x53520007, 0x53530004, 0x5356000f,
+    0x53be001c, 0x53dd0003, 0x5401000c, 0x5402001e, 0x54030003, 0x54080003,
+    0x540b003d, 0x540d002e, 0x540f0027, 0x54110068, 0x54120003, 0x5413008d,
+    0x54830084, 0x5486000b, 0x54870005, 0x5488000a, 0x548b004f, 0x548c0003,
+    0x548d0088, 0x54910336, 0x549200a0, 0x54970033, 0x54980004, 0x549a01ba,
+    0x549b002c, 0x549d0035, 0x549e001d, 0x55000003, 0x5501002d, 0x55020004,
+    0x55030035, 0x55040044, 0x55060003, 0x5508000c, 0x550d0037, 0x550e00d9,
+    0x5511001a, 0x5512002a, 0x5513004c, 0x55150007, 0x55190006, 0x551d0008,
+    0x55c80009, 0x55cb001e, 0x55d10003, 0x55d4000a, 0x55de0003, 0x568b000d,
+    0x56f80003, 0x571e0005, 0x57ba0010, 0x57bb0010, 0x57c3000a, 0x57da0009,
+    0x57dd000d, 0x580b0023, 0x580d0013, 0x581100d3, 0x581201bc, 0x581300f6,
+    0x58150010, 0x58180092, 0x58640020, 0x5880001a, 0x58830021, 0x588400e8,
+    0x58880015, 0x588b0051, 0x588d001d, 0x5891018e, 0x58920008, 0x5893000b,
+    0x589a0036, 0x589b0007, 0x58e00056, 0x58e40285, 0x58e80565, 0x58ee0088,
+    0x58f8001b, 0x59020003, 0x59030007, 0x5905000a, 0x590b0173, 0x590d008b,
+    0x59120025, 0x591302f7, 0x59640004, 0x59780010, 0x59b20007, 0x59b6000a,
+    0x59ba0060, 0x59bb0006, 0x59bd000e, 0x59ce0007, 0x59d10023, 0x59d400a0,
+    0x59da00f4, 0x59db001a, 0x59dd0009, 0x5a28000d, 0x5a2e0006, 0x5a5a0039,
+    0x5a5b0005, 0x5a5d0021, 0x5a6e0003, 0x5b400039, 0x5b41001f, 0x5b42001c,
+    0x5b430005, 0x5b450020, 0x5b46000a, 0x5b470007, 0x5b480027, 0x5b4b000b,
+    0x5b4c0024, 0x5b4e0022, 0x5b4f0004, 0x5b510008, 0x5b52000a, 0x5b530065,
+    0x5b550007, 0x5b560017, 0x5b5a0007, 0x5b5c0004, 0x5b600005, 0x5b630003,
+    0x5b650003, 0x5b680003, 0x5b6b0003, 0x5b6c0004, 0x5b6e0005, 0x5b730006,
+    0x5b760005, 0x5bba00bb, 0x5bbb001a, 0x5bc30027, 0x5bcc000b, 0x5bd20013,
+    0x5c02000a, 0x5c0c000e, 0x5c440048, 0x5c480019, 0x5c83001f, 0x5ce0000a,
+    0x5ce8002e, 0x5d01000b, 0x5d0d0019, 0x5d0e00bc, 0x5d120038, 0x5de0000f,
+    0x5de400e5, 0x5deb0039, 0x5df1000c, 0x5e3a0003, 0x5e640025, 0x5e670018,
+    0x5e710006, 0x5e740053, 0x5e780004, 0x5e7a0027, 0x5e7b0005, 0x5ea80003,
+    0x5ebd0004, 0x5f1a0007, 0x5f1d0008, 0x5f400006, 0x5f430003, 0x5f450016,
+    0x5f480008, 0x5f4e0012, 0x5f4f0006, 0x5f510003, 0x5f520008, 0x5f560005,
+    0x5fba002d, 0x5fbb000a, 0x5fc30047, 0x5fda0005, 0x5fdd000b, 0x600b0003,
+    0x6080000e, 0x60830004, 0x608b00df, 0x60920014, 0x60930060, 0x609a0040,
+    0x609b0007, 0x609d0044, 0x609e0006, 0x61040009, 0x610d0031, 0x61640003,
+    0x61680005, 0x61880006, 0x618f0006, 0x61cd0025, 0x61d4004a, 0x61e40009,
+    0x61ee000e, 0x6248000a, 0x62530055, 0x625a0223, 0x625b0027, 0x625d0087,
+    0x634001b7, 0x63410154, 0x63420101, 0x63430093, 0x6344005c, 0x63450090,
+    0x63460039, 0x6347004e, 0x634800c8, 0x634a0008, 0x634b0057, 0x634c00b2,
+    0x634d004a, 0x634e0198, 0x634f0079, 0x6351011b, 0x635200ee, 0x635303ae,
+    0x63540035, 0x63550039, 0x6356011c, 0x635c0003, 0x635e0013, 0x6360001c,
+    0x63610010, 0x63620021, 0x63630012, 0x63640010, 0x6365000b, 0x63670007,
+    0x6368001b, 0x636b0009, 0x636c0016, 0x636d0006, 0x636e0019, 0x636f0012,
+    0x63710027, 0x63720017, 0x6373003c, 0x63740004, 0x63750004, 0x63760014,
+    0x63ba01b7, 0x63bb0029, 0x63be0009, 0x63c20003, 0x63c30011, 0x63c50004,
+    0x63cb0005, 0x63da0006, 0x63dd0003, 0x64130003, 0x6492000b, 0x649a0003,
+    0x650d0003, 0x65cd000f, 0x67530003, 0x67ba0003, 0x67be0007, 0x68010160,
+    0x680200f4, 0x68030041, 0x68040003, 0x680500bd, 0x68060073, 0x68070005,
+    0x680800b9, 0x680b02da, 0x680c001a, 0x680d1399, 0x680f0166, 0x681102c8,
+    0x6812039d, 0x681302ed, 0x68140015, 0x68150006, 0x6816001c, 0x68170042,
+    0x68180004, 0x681a04bf, 0x681b008f, 0x681c0004, 0x681d0003, 0x681e0008,
+    0x68200043, 0x68220011, 0x68230003, 0x682408e4, 0x6827000a, 0x6828003d,
+    0x682b0180, 0x682c0003, 0x682d0003, 0x682e0221, 0x68310105, 0x683401cb,
+    0x68370004, 0x68380584, 0x683a000a, 0x683d0009, 0x683e0003, 0x68400170,
+    0x6841000b, 0x6843000f, 0x6844008b, 0x68450006, 0x68460004, 0x6847009d,
+    0x684800d1, 0x68490006, 0x684b0040, 0x684d0007, 0x684e08c7, 0x684f0003,
+    0x68510080, 0x68540020, 0x68580005, 0x685a0009, 0x685d0009, 0x685e0004,
+    0x6860008d, 0x6864021a, 0x68660005, 0x68670007, 0x68680437, 0x686a0003,
+    0x686e00f7, 0x68710062, 0x6874001f, 0x687a0005, 0x687d0008, 0x688000bf,
+    0x68810003, 0x68820007, 0x6883004f, 0x68850026, 0x68860004, 0x68880071,
+    0x688b002e, 0x688c006d, 0x688d00d0, 0x6890009c, 0x68910018, 0x68920011,
+    0x6895007a, 0x689701a1, 0x6898009b, 0x689a0008, 0x689d000b, 0x689e0004,
+    0x68a00158, 0x68a4008f, 0x68a6000c, 0x68a802c8, 0x68ab0069, 0x68ac0005,
+    0x68ae03ce, 0x68b1036e, 0x68b40047, 0x68ba0013, 0x68bd000e, 0x68be0007,
+    0x68c00012, 0x68c40036, 0x68c8002a, 0x68cb019b, 0x68cc0006, 0x68ce0095,
+    0x68d10246, 0x68d40007, 0x68da0007, 0x68dd0011, 0x68de0004, 0x68e0023c,
+    0x68e40105, 0x68e80069, 0x68e90005, 0x68ee010a, 0x68f40018, 0x68f80011,
+    0x68fa0004, 0x68fd000d, 0x69020006, 0x69050189, 0x6908001f, 0x690b003c,
+    0x690c00fc, 0x690d0c4d, 0x6911003a, 0x691203b4, 0x691304b0, 0x6915000e,
+    0x691a0218, 0x691b0035, 0x691d001a, 0x692e000a, 0x69340008, 0x693a0004,
+    0x693d0004, 0x6944001a, 0x69480016, 0x694b0003, 0x694d0073, 0x695a0005,
+    0x69600094, 0x696402b3, 0x69680530, 0x696e0096, 0x69740039, 0x6978000b,
+    0x697a0004, 0x697d0004, 0x697e0005, 0x698003f1, 0x69820008, 0x698401a1,
+    0x69860003, 0x6988019f, 0x698d0017, 0x698e02fa, 0x69910008, 0x69930004,
+    0x6994011e, 0x69980049, 0x699a0006, 0x699d0006, 0x699e0004, 0x69a0006d,
+    0x69a30008, 0x69a400f1, 0x69a8002c, 0x69ae02e7, 0x69b4003e, 0x69ba0005,
+    0x69bd000d, 0x69be0005, 0x69c101c3, 0x69c2000c, 0x69c30007, 0x69c40004,
+    0x69c513b8, 0x69c60004, 0x69c70004, 0x69c80037, 0x69cb0007, 0x69cd03d2,
+    0x69cf007a, 0x69d1041f, 0x69d30190, 0x69d40125, 0x69d50038, 0x69d6000e,
+    0x69d80003, 0x69d90003, 0x69da0006, 0x69dd0004, 0x69e0045f, 0x69e400fb,
+    0x69e70039, 0x69e80038, 0x69eb01b0, 0x69ee0164, 0x69f00006, 0x69f103d1,
+    0x69f20003, 0x69f3003c, 0x69f4006d, 0x69fa000a, 0x69fd000a, 0x69fe0008,
+    0x6a020003, 0x6a140092, 0x6a1a000c, 0x6a1d0008, 0x6a20033f, 0x6a2408ca,
+    0x6a280131, 0x6a2e005f, 0x6a310003, 0x6a320003, 0x6a340046, 0x6a3a0009,
+    0x6a3d0009, 0x6a4001d9, 0x6a42003b, 0x6a440318, 0x6a47016e, 0x6a480220,
+    0x6a4a000e, 0x6a4b0027, 0x6a4c005c, 0x6a4d0005, 0x6a4e03b4, 0x6a4f01ce,
+    0x6a500035, 0x6a530138, 0x6a54037a, 0x6a56000f, 0x6a580004, 0x6a5a000e,
+    0x6a5d0009, 0x6a5e0007, 0x6a600083, 0x6a640082, 0x6a673985, 0x6a6800c9,
+    0x6a6e08dd, 0x6a700005, 0x6a710134, 0x6a740048, 0x6a750004, 0x6a760124,
+    0x6a770006, 0x6a7a000a, 0x6a7d0010, 0x6a7e000a, 0x6a8d00fb, 0x6a8f018a,
+    0x6a910005, 0x6a920066, 0x6a930005, 0x6a970003, 0x6aa000b4, 0x6aa4013e,
+    0x6aa8018f, 0x6aae0019, 0x6ab20003, 0x6ab4000c, 0x6ab70004, 0x6abd000a,
+    0x6ac002fa, 0x6ac401bf, 0x6ac707f3, 0x6ac80449, 0x6ace00b2, 0x6ad10010,
+    0x6ae80006, 0x6af50007, 0x6af8000d, 0x6afa0003, 0x6afd0009, 0x6b040130,
+    0x6b080008, 0x6b0e0043, 0x6b1a000d, 0x6b1d0007, 0x6b3a0007, 0x6b400003,
+    0x6b410008, 0x6b430003, 0x6b450005, 0x6b4c0003, 0x6b4e0009, 0x6b530008,
+    0x6b5a10cd, 0x6b5c011b, 0x6b5e01f7, 0x6b800005, 0x6b830009, 0x6b880005,
+    0x6b8a0003, 0x6b8b0003, 0x6b8c0004, 0x6b8d0003, 0x6b8e0003, 0x6b910004,
+    0x6b930020, 0x6b9a004c, 0x6b9b0004, 0x6b9c0398, 0x6b9d010a, 0x6b9e012f,
+    0x6b9f0013, 0x6bc00049, 0x6bc10020, 0x6bc20045, 0x6bc30014, 0x6bc4000f,
+    0x6bc50048, 0x6bc6004f, 0x6bc7000d, 0x6bc80050, 0x6bc90006, 0x6bca0007,
+    0x6bcb0017, 0x6bcc0029, 0x6bcd000b, 0x6bce000e, 0x6bcf0072, 0x6bd00024,
+    0x6bd10029, 0x6bd20034, 0x6bd30067, 0x6bd40007, 0x6bd5002f, 0x6bd60011,
+    0x6bd70009, 0x6bd80007, 0x6bda0194, 0x6bdb0051, 0x6bdc000d, 0x6bde0016,
+    0x6bdf0005, 0x6bff0025, 0x6c010026, 0x6c02001d, 0x6c030009, 0x6c050015,
+    0x6c060016, 0x6c080013, 0x6c0b003e, 0x6c0c0003, 0x6c0d0176, 0x6c0f002c,
+    0x6c110031, 0x6c120031, 0x6c130033, 0x6c160003, 0x6c17000e, 0x6c1a0025,
+    0x6c200006, 0x6c2400a4, 0x6c28000c, 0x6c2b0022, 0x6c2e0038, 0x6c31001e,
+    0x6c34002f, 0x6c38003d, 0x6c400023, 0x6c44000c, 0x6c470016, 0x6c480020,
+    0x6c4b0004, 0x6c4e011e, 0x6c51000e, 0x6c540007, 0x6c60000a, 0x6c640055,
+    0x6c68009c, 0x6c6e0016, 0x6c710004, 0x6c740004, 0x6c800011, 0x6c810004,
+    0x6c850007, 0x6c88000d, 0x6c8b0009, 0x6c8c0016, 0x6c8d0011, 0x6c900013,
+    0x6c910005, 0x6c920007, 0x6c95000e, 0x6c970050, 0x6c98000a, 0x6ca0001a,
+    0x6ca4000f, 0x6ca80036, 0x6cab0007, 0x6cae0060, 0x6cb1003c, 0x6cb40007,
+    0x6cc00004, 0x6cc80005, 0x6ccb0028, 0x6cce0008, 0x6cd10046, 0x6ce00025,
+    0x6ce4001c, 0x6ce80008, 0x6cee0017, 0x6cf40004, 0x6cf80006, 0x6d05001d,
+    0x6d0b000b, 0x6d0c002a, 0x6d0d0123, 0x6d110007, 0x6d120022, 0x6d130049,
+    0x6d1a001a, 0x6d340003, 0x6d480003, 0x6d4d0008, 0x6d600011, 0x6d640045,
+    0x6d680079, 0x6d6e000b, 0x6d740006, 0x6d800050, 0x6d84003a, 0x6d880029,
+    0x6d8e0041, 0x6d94001b, 0x6d980004, 0x6da0000a, 0x6da40017, 0x6da80005,
+    0x6dae004b, 0x6db4000b, 0x6dbe0003, 0x6dc10040, 0x6dc500ed, 0x6dc80005,
+    0x6dcd0039, 0x6dcf0011, 0x6dd10049, 0x6dd30022, 0x6dd4001a, 0x6dd50004,
+    0x6de00080, 0x6de40033, 0x6de7000b, 0x6de80006, 0x6deb0029, 0x6dee0024,
+    0x6df1009a, 0x6df40012, 0x6e140016, 0x6e20004e, 0x6e24012d, 0x6e28001b,
+    0x6e2e000a, 0x6e40002b, 0x6e42000c, 0x6e44005b, 0x6e47002d, 0x6e48003c,
+    0x6e4c0008, 0x6e4e0051, 0x6e4f0051, 0x6e53001d, 0x6e54005f, 0x6e60000b,
+    0x6e64001c, 0x6e67045b, 0x6e680011, 0x6e6e007e, 0x6e710048, 0x6e74000b,
+    0x6e760016, 0x6e8d0020, 0x6e8f0024, 0x6e920008, 0x6ea00012, 0x6ea4000f,
+    0x6ea80025, 0x6eae0006, 0x6ec00045, 0x6ec40020, 0x6ec700db, 0x6ec8005a,
+    0x6ece0016, 0x6ed10003, 0x6f040019, 0x6f0e0007, 0x6f5a007c, 0x6f600034,
+    0x6f610016, 0x6f630009, 0x6f650015, 0x6f670003, 0x6f680034, 0x6f6b000e,
+    0x6f6c0003, 0x6f6d001b, 0x6f6e0010, 0x6f6f0015, 0x6f72001b, 0x6f730059,
+    0x6f76001d, 0x6f7a0004, 0x6f7b0073, 0x6f7e0130, 0x6f9c002e, 0x6f9d0008,
+    0x6f9e001a, 0x6fc0000b, 0x6fc1000b, 0x6fc20008, 0x6fc30006, 0x6fc40028,
+    0x6fc50005, 0x6fc60008, 0x6fc70003, 0x6fc80051, 0x6fcb0008, 0x6fcc0005,
+    0x6fcd0003, 0x6fce0034, 0x6fcf0029, 0x6fd00021, 0x6fd10007, 0x6fd2000c,
+    0x6fd3002a, 0x6fd60005, 0x6fde001c, 0x701a0005, 0x701d0003, 0x707a0007,
+    0x707d0005, 0x711d0004, 0x715d0003, 0x717d0003, 0x719d0003, 0x71bd0003,
+    0x71fa0008, 0x723a0004, 0x72530004, 0x72670087, 0x727e0009, 0x73400015,
+    0x73430042, 0x73450015, 0x73460006, 0x7348002d, 0x734c0023, 0x734e003b,
+    0x734f0010, 0x73520003, 0x73530084, 0x735a0108, 0x735e0011, 0x735f0005,
+    0x73600007, 0x73630007, 0x73660003, 0x73680008, 0x736c0006, 0x736e0006,
+    0x73720003, 0x73730008, 0x737a0018, 0x737e0010, 0x73830004, 0x73920004,
+    0x73930069, 0x739a01d0, 0x739b004a, 0x739c0272, 0x739d0151, 0x739e00bc,
+    0x739f000f, 0x73ba0215, 0x73bb003c, 0x73bc0008, 0x73be0072, 0x73cf0004,
+    0x73d10004, 0x73d30004, 0x73da0005, 0x73db0004, 0x73dc02de, 0x73dd000b,
+    0x73de0004, 0x73ff0027, 0x77400c44, 0x774102f2, 0x77420065, 0x7743007b,
+    0x77440053, 0x774501b5, 0x77460056, 0x7747004a, 0x77480324, 0x77490003,
+    0x774a0003, 0x774b0070, 0x774c008a, 0x774d006c, 0x774e01ab, 0x774f0067,
+    0x77500003, 0x7751004f, 0x77520178, 0x775305cf, 0x77540042, 0x7755003a,
+    0x775602d2, 0x7757000d, 0x7758005f, 0x775a0035, 0x775c0178, 0x775e0132,
+    0x775f0007, 0x776000c0, 0x77610039, 0x77620010, 0x77630009, 0x7764000d,
+    0x77650016, 0x7766000b, 0x77670005, 0x77680028, 0x776b0004, 0x776c000d,
+    0x776d0009, 0x776e0018, 0x776f000e, 0x77710005, 0x7772001d, 0x7773007c,
+    0x77740008, 0x77750005, 0x77760046, 0x77780009, 0x777b020a, 0x777c001b,
+    0x777e0021, 0x779c0008, 0x77da0138, 0x77db008a, 0x77de0007, 0x78010007,
+    0x78020004, 0x78050005, 0x78060009, 0x780d000b, 0x78100010, 0x78110007,
+    0x78120016, 0x781e0008, 0x78270008, 0x782b0009, 0x782e000e, 0x78340003,
+    0x7838000c, 0x783e0005, 0x7840000a, 0x78480008, 0x784e0014, 0x78510004,
+    0x78540004, 0x785a0003, 0x785d0030, 0x785e0009, 0x78640011, 0x7868000d,
+    0x786a0003, 0x787a0194, 0x787b0019, 0x787d0062, 0x787e0006, 0x78850003,
+    0x788b0003, 0x788d0006, 0x78970024, 0x789e0009, 0x78a00009, 0x78a80032,
+    0x78ac0003, 0x78ae0009, 0x78be000b, 0x78cb0046, 0x78cc0006, 0x78d10063,
+    0x78de0007, 0x78ee0007, 0x78f40005, 0x78fe0003, 0x79050007, 0x79080004,
+    0x790b0040, 0x790d0055, 0x791e0006, 0x79340005, 0x795e0006, 0x7960000a,
+    0x79640003, 0x79680014, 0x796e0004, 0x797e0006, 0x79800058, 0x79840025,
+    0x79880005, 0x798d0009, 0x79940005, 0x799e0009, 0x79a60004, 0x79be0005,
+    0x79c10033, 0x79d10007, 0x79e0001c, 0x79e4000a, 0x79ee0007, 0x79f10025,
+    0x79f30028, 0x79f40006, 0x79fd0009, 0x79fe002b, 0x7a14001f, 0x7a1e002e,
+    0x7a200003, 0x7a240012, 0x7a2e0004, 0x7a310004, 0x7a350006, 0x7a3e0013,
+    0x7a400004, 0x7a420004, 0x7a44000e, 0x7a470018, 0x7a480027, 0x7a4e000e,
+    0x7a530005, 0x7a540012, 0x7a5a0083, 0x7a5b0009, 0x7a5e000d, 0x7a67003c,
+    0x7a680023, 0x7a6e0008, 0x7a700004, 0x7a740004, 0x7a7a0003, 0x7a7d0003,
+    0x7a7e002e, 0x7a8b0005, 0x7aa00010, 0x7aa40003, 0x7aa80015, 0x7abe000a,
+    0x7ac00009, 0x7ac70013, 0x7ace0003, 0x7afd0006, 0x7afe0007, 0x7b040005,
+    0x7b400067, 0x7b410028, 0x7b42000a, 0x7b43000d, 0x7b440007, 0x7b450013,
+    0x7b460009, 0x7b470007, 0x7b48004f, 0x7b4b0006, 0x7b4c0011, 0x7b4d0003,
+    0x7b4e0024, 0x7b4f0007, 0x7b510022, 0x7b520013, 0x7b53003f, 0x7b55000a,
+    0x7b560033, 0x7b5a0124, 0x7b5c010e, 0x7b5e001a, 0x7b60000b, 0x7b650004,
+    0x7b6e0009, 0x7b710003, 0x7b720005, 0x7b730012, 0x7b7a0055, 0x7b7b0092,
+    0x7b7c0006, 0x7b800003, 0x7b8f0009, 0x7b930006, 0x7b9a009e, 0x7b9b0014,
+    0x7b9c00da, 0x7b9d0060, 0x7b9e00fa, 0x7b9f0003, 0x7bba0188, 0x7bbb002c,
+    0x7bc60005, 0x7bcc0006, 0x7bcf0004, 0x7bd10003, 0x7bda000e, 0x7bdb0024,
+    0x7bdc0004, 0x7bdd0006, 0x7bde06dd, 0x7bff0006, 0x7dae0028, 0x7e280007,
+    0x7e67000e, 0x7f420005, 0x7f4e0003, 0x7f5c000e, 0x7f9e0004, 0x7fba0018,
+    0x7fda0004, 0x7fdd0006, 0x7fed0028, 0x7ff10007, 0x7ff3000f, 0x7ffa001d,
+    0x7ffc0005, 0x7ffd0018, 0x7ffe000c, 0x7fff002a
+};
+
+/**
+ *  Fill model tables from byte frequencies and trigram counts
+ *  @param freq Frequency of every byte, per 100000 bytes
+ *  @param tri Counts of all ENG_SYMBOLS^3 trigrams
+ *  @param model [out] Model
+ */
+static void ModelFromCounts(double const *freq, double const *tri,
+                            EnglishModel *model)
+{
+    const size_t S = ENG_SYMBOLS;
+    vector<double> bi(S*S, 0), ctx3(S*S, 0), uni(S, 0), ctx2(S, 0), p1(S), p2(S*S);
+    double total = 0, n = 0;
+
+    memcpy(model->magic, ENG_MAGIC, sizeof(model->magic));
+
+    //  Bytes never seen get a small probability, so that a single one of them
+    //  lowers the score but doesn't rule the text out
+    for (size_t i = 0; i < 256; i++)
+        total += freq[i] + 0.01;
+    for (size_t i = 0; i < 256; i++)
+        model->unigram[i] = lround((log(freq[i] + 0.01) - log(total)) * ENG_SCALE);
+
+    //  Lower-order counts are marginals of trigram counts
+    for (size_t i = 0; i < S*S*S; i++)
+    {
+        bi[i % (S*S)] += tri[i];
+        ctx3[i / S] += tri[i];
+    }
+    for (size_t i = 0; i < S*S; i++)
+    {
+        uni[i % S] += bi[i];
+        ctx2[i / S] += bi[i];
+        n += bi[i];
+    }
+
+    //  Each order backs off to the one below it, with lifts stored relative to
+    //  symbol probability (byte probability already accounts for it)
+    for (size_t s = 0; s < S; s++)
+        p1[s] = (uni[s] + 1) / (n + S);
+    for (size_t i = 0; i < S*S; i++)
+    {
+        p2[i] = (bi[i] + ENG_BACKOFF * p1[i % S]) / (ctx2[i / S] + ENG_BACKOFF);
+        model->bigram[i] = lround(log(p2[i] / p1[i % S]) * ENG_SCALE);
+    }
+    for (size_t i = 0; i < S*S*S; i++)
+    {
+        double p3 = (tri[i] + ENG_BACKOFF * p2[i % (S*S)]) / (ctx3[i / S] + ENG_BACKOFF);
+        model->trigram[i] = lround(log(p3 / p1[i % S]) * ENG_SCALE);
+    }
+}
+
+/**
+ *  Built-in model, from constant tables above
+ */
+struct DefaultModel
+{
+    EnglishModel model;
+
+    DefaultModel()
+    {
+        double freq[256];
+        vector<double> tri(ENG_SYMBOLS * ENG_SYMBOLS * ENG_SYMBOLS, 0);
+
+        for (size_t i = 0; i < 256; i++)
+            freq[i] = (i < 128) ? englishFreq[i] : ENG_HIGH_FREQ;
+        for (size_t i = 0; i < sizeof(trigramCounts) / sizeof(trigramCounts[0]); i++)
+            tri[trigramCounts[i] >> 16] = trigramCounts[i] & 0xFFFF;
+
+        ModelFromCounts(freq, tri.data(), &model);
+    }
+};
+
+static atomic<EnglishModel const*> activeModel(NULL);
+
+//------------------------------------------------------------------------------
+//      Model management                                                [PUBLIC]
+//------------------------------------------------------------------------------
+/**
+ *  Symbol of a byte in the n-gram alphabet: 0-25 for letters (of any case),
+ *  26 for space, 27 for other white space, 28 for digits, 29 for punctuation
+ *  ending a sentence or a clause, 30 for other printable characters and 31 for
+ *  control characters and bytes from 0x80 up
+ *  @param c Byte
+ *  @return Symbol of the byte, in range [0, 31]
+ */
+uint8_t EnglishSymbol(uint8_t c)
+{
+    return engSymbol[c];
+}
+
+/**
+ *  Built-in model, derived from character frequencies and trigram counts of
+ *  about half a megabyte of English prose
+ *  @return Built-in model
+ */
+EnglishModel const &EnglishDefaultModel()
+{
+    static const DefaultModel builtIn;
+    return builtIn.model;
+}
+
+/**
+ *  Model used when scoring functions aren't given one, built-in by default
+ *  @return Active model
+ */
+EnglishModel const &EnglishActiveModel()
+{
+    EnglishModel const *model = activeModel.load();
+    return model ? *model : EnglishDefaultModel();
+}
+
+/**
+ *  Replace the model used when scoring functions aren't given one. Meant to be
+ *  called before analysis starts, not while other threads are scoring text.
+ *  @param model Model to use, NULL to restore the built-in one
+ */
+void EnglishSetModel(EnglishModel const *model)
+{
+    activeModel.store(model);
+}
+
+/**
+ *  Build model from a sample of English text
+ *  @param corpus Sample text, the longer the better (at least tens of kB)
+ *  @param len Length of sample text
+ *  @param model [out] Built model
+ */
+void EnglishBuildModel(char const *corpus, size_t len, EnglishModel *model)
+{
+    uint8_t const *c = (const uint8_t*)corpus;
+    double freq[256] = { 0 };
+    vector<double> tri(ENG_SYMBOLS * ENG_SYMBOLS * ENG_SYMBOLS, 0);
+    uint32_t ctx = 0;
+
+    for (size_t i = 0; i < len; i++)
+    {
+        freq[c[i]] += 100000.0 / len;
+        ctx = ((ctx << 5) | engSymbol[c[i]]) & 0x7FFF;
+        if (i >= 2)
+            tri[ctx]++;
+    }
+
+    ModelFromCounts(freq, tri.data(), model);
+}
+
+/**
+ *  Save model into a binary model file
+ *  @param path Path to the file
+ *  @param model Model to save
+ *  @return True if the file was written, false otherwise
+ */
+bool EnglishSaveModel(string const &path, EnglishModel const &model)
+{
+    ofstream file(path, ios::binary | ios::trunc);
+
+    file.write((char const*)&model, sizeof(model));
+
+    return file.good();
+}
+
+/**
+ *  Map binary model file to memory, tables are read from the file directly
+ *  @param path Path to the file
+ *  @return Mapped model; NULL if file can't be opened or isn't a model file
+ */
+EnglishModel const *EnglishLoadModel(string const &path)
+{
+    struct stat st;
+    int fd = open(path.c_str(), O_RDONLY);
+
+    if (fd < 0)
+        return NULL;
+    if ((fstat(fd, &st) < 0) || ((size_t)st.st_size != sizeof(EnglishModel)))
+    {
+        close(fd);
+        return NULL;
+    }
+
+    void *map = mmap(NULL, sizeof(EnglishModel), PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+        return NULL;
+    if (memcmp(map, ENG_MAGIC, sizeof(((EnglishModel*)0)->magic)) != 0)
+    {
+        munmap(map, sizeof(EnglishModel));
+        return NULL;
+    }
+
+    return (EnglishModel const*)map;
+}
+
+/**
+ *  Unmap model returned by EnglishLoadModel, mustn't be active at the time
+ *  @param model Mapped model
+ */
+void EnglishUnloadModel(EnglishModel const *model)
+{
+    if (model)
+        munmap((void*)model, sizeof(EnglishModel));
+}
+
+//------------------------------------------------------------------------------
+//      Scoring                                                         [PUBLIC]
+//------------------------------------------------------------------------------
+/**
+ *  Score text by how likely it is to be English
+ *  @param text Text to score
+ *  @param len Length of text
+ *  @param model Model to score with, NULL for the active one
+ *  @return Average log-likelihood of a byte (in nats, higher is better); 0 for
+ *  empty text
+ */
+double EnglishScore(char const *text, size_t len, EnglishModel const *model)
+{
+    return EnglishScoreXOR(text, len, "", 1, model);
+}
+
+/**
+ *  Score text by how likely it is to be English
+ *  @param text Text to score
+ *  @param model Model to score with, NULL for the active one
+ *  @return Average log-likelihood of a byte (in nats, higher is better)
+ */
+double EnglishScore(string const &text, EnglishModel const *model)
+{
+    return EnglishScoreXOR(text.data(), text.length(), "", 1, model);
+}
+
+/**
+ *  Score plaintext obtained by XORing ciphertext with a repeating key, without
+ *  decrypting it into a buffer first. With key as long as the ciphertext the
+ *  same scores keystream guesses (e.g. fixed-nonce CTR).
+ *  @param text Ciphertext
+ *  @param len Length of ciphertext
+ *  @param key Key bytes
+ *  @param keyLen Length of key, non-zero
+ *  @param model Model to score with, NULL for the active one
+ *  @return Average log-likelihood of a plaintext byte (in nats, higher is
+ *  better); 0 for empty text or key
+ */
+double EnglishScoreXOR(char const *text, size_t len, char const *key,
+                       size_t keyLen, EnglishModel const *model)
+{
+    if ((len == 0) || (keyLen == 0))
+        return 0;
+
+    EnglishModel const &m = model ? *model : EnglishActiveModel();
+    uint8_t const *t = (const uint8_t*)text, *k = (const uint8_t*)key;
+    int64_t sum = 0;
+    uint32_t ctx = 0;
+    size_t j = 0;
+
+    //  First two bytes don't have a full context
+    for (size_t i = 0; (i < 2) && (i < len); i++)
+    {
+        uint8_t c = t[i] ^ k[j];
+        if (++j == keyLen)
+            j = 0;
+        sum += m.unigram[c] + ((i > 0) ? m.bigram[(ctx << 5) | engSymbol[c]] : 0);
+        ctx = (ctx << 5) | engSymbol[c];
+    }
+
+    //  Index of the trigram table is a sliding window of three symbols
+    for (size_t i = 2; i < len; i++)
+    {
+        uint8_t c = t[i] ^ k[j];
+        if (++j == keyLen)
+            j = 0;
+        ctx = ((ctx << 5) | engSymbol[c]) & 0x7FFF;
+        sum += m.unigram[c] + m.trigram[ctx];
+    }
+
+    return (double)sum / ENG_SCALE / len;
+}
+
+/**
+ *  Score many windows of ciphertext under the same key at once, e.g. all
+ *  offsets where a crib might fit. Window at offset o is x[o, o + keyLen)
+ *  XORed with key.
+ *  @param score [out] Average log-likelihood of every window (see EnglishScore)
+ *  @param x Ciphertext
+ *  @param offsets Offsets of windows in ciphertext
+ *  @param count Number of windows
+ *  @param key Key bytes, also length of every window
+ *  @param keyLen Length of key, non-zero
+ *  @param model Model to score with, NULL for the active one
+ */
+void EnglishScoreWindows(double *score, char const *x, size_t const *offsets,
+                         size_t count, char const *key, size_t keyLen,
+                         EnglishModel const *model)
+{
+    if (keyLen == 0)
+        return;
+
+    EnglishModel const &m = model ? *model : EnglishActiveModel();
+    uint8_t const *k = (const uint8_t*)key;
+    double norm = 1.0 / ENG_SCALE / keyLen;
+
+    for (size_t w = 0; w < count; w++)
+    {
+        uint8_t const *t = (const uint8_t*)x + offsets[w];
+        uint8_t c = t[0] ^ k[0];
+        uint32_t ctx = engSymbol[c];
+        int64_t sum = m.unigram[c];
+
+        if (keyLen > 1)
+        {
+            c = t[1] ^ k[1];
+            ctx = (ctx << 5) | engSymbol[c];
+            sum += m.unigram[c] + m.bigram[ctx];
+        }
+        for (size_t i = 2; i < keyLen; i++)
+        {
+            c = t[i] ^ k[i];
+            ctx = ((ctx << 5) | engSymbol[c]) & 0x7FFF;
+            sum += m.unigram[c] + m.trigram[ctx];
+        }
+
+        score[w] = sum * norm;
+    }
+}
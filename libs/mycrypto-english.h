@@ -0,0 +1,141 @@
+/**
+ *    English language model, used to tell plaintext from garbage
+ *    Bytes are scored by their frequency in English text, corrected by
+ *    bigram and trigram statistics over a reduced alphabet of 32 symbols
+ *    (letters regardless of case, space, white space, digits, punctuation...)
+ *
+ *    Created: 17. Oct 2026.
+ *    Author: Vedran Mikov
+ */
+#ifndef MYCRYPTO_ENGLISH_H_
+#define MYCRYPTO_ENGLISH_H_
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+//  Log-probabilities in model tables are fixed point, in 1/ENG_SCALE nats
+#define ENG_SCALE      1024
+//  Size of the alphabet n-grams are counted over (see EnglishSymbol)
+#define ENG_SYMBOLS    32
+//  First bytes of a binary model file
+#define ENG_MAGIC      "MCENGv1\n"
+
+using namespace std;
+
+/**
+ *  Tables of English language model, laid out the same as in a binary model
+ *  file so that the file can be mapped to memory and used as is
+ */
+struct EnglishModel
+{
+    char    magic[8];
+    //  log P(byte)
+    int16_t unigram[256];
+    //  log P(s2|s1) - log P(s2), for symbols s1 s2 at index s1*32 + s2
+    int16_t bigram[ENG_SYMBOLS * ENG_SYMBOLS];
+    //  log P(s3|s1 s2) - log P(s3), at index s1*1024 + s2*32 + s3
+    int16_t trigram[ENG_SYMBOLS * ENG_SYMBOLS * ENG_SYMBOLS];
+};
+
+/**
+ *  Symbol of a byte in the n-gram alphabet: 0-25 for letters (of any case),
+ *  26 for space, 27 for other white space, 28 for digits, 29 for punctuation
+ *  ending a sentence or a clause, 30 for other printable characters and 31 for
+ *  control characters and bytes from 0x80 up
+ *  @param c Byte
+ *  @return Symbol of the byte, in range [0, 31]
+ */
+uint8_t EnglishSymbol(uint8_t c);
+
+/**
+ *  Built-in model, derived from character frequencies and trigram counts of
+ *  about half a megabyte of English prose
+ *  @return Built-in model
+ */
+EnglishModel const &EnglishDefaultModel();
+/**
+ *  Model used when scoring functions aren't given one, built-in by default
+ *  @return Active model
+ */
+EnglishModel const &EnglishActiveModel();
+/**
+ *  Replace the model used when scoring functions aren't given one. Meant to be
+ *  called before analysis starts, not while other threads are scoring text.
+ *  @param model Model to use, NULL to restore the built-in one
+ */
+void EnglishSetModel(EnglishModel const *model);
+
+/**
+ *  Build model from a sample of English text
+ *  @param corpus Sample text, the longer the better (at least tens of kB)
+ *  @param len Length of sample text
+ *  @param model [out] Built model
+ */
+void EnglishBuildModel(char const *corpus, size_t len, EnglishModel *model);
+/**
+ *  Save model into a binary model file
+ *  @param path Path to the file
+ *  @param model Model to save
+ *  @return True if the file was written, false otherwise
+ */
+bool EnglishSaveModel(string const &path, EnglishModel const &model);
+/**
+ *  Map binary model file to memory, tables are read from the file directly
+ *  @param path Path to the file
+ *  @return Mapped model; NULL if file can't be opened or isn't a model file
+ */
+EnglishModel const *EnglishLoadModel(string const &path);
+/**
+ *  Unmap model returned by EnglishLoadModel, mustn't be active at the time
+ *  @param model Mapped model
+ */
+void EnglishUnloadModel(EnglishModel const *model);
+
+/**
+ *  Score text by how likely it is to be English
+ *  @param text Text to score
+ *  @param len Length of text
+ *  @param model Model to score with, NULL for the active one
+ *  @return Average log-likelihood of a byte (in nats, higher is better); 0 for
+ *  empty text
+ */
+double EnglishScore(char const *text, size_t len, EnglishModel const *model = NULL);
+/**
+ *  Score text by how likely it is to be English
+ *  @param text Text to score
+ *  @param model Model to score with, NULL for the active one
+ *  @return Average log-likelihood of a byte (in nats, higher is better)
+ */
+double EnglishScore(string const &text, EnglishModel const *model = NULL);
+/**
+ *  Score plaintext obtained by XORing ciphertext with a repeating key, without
+ *  decrypting it into a buffer first. With key as long as the ciphertext the
+ *  same scores keystream guesses (e.g. fixed-nonce CTR).
+ *  @param text Ciphertext
+ *  @param len Length of ciphertext
+ *  @param key Key bytes
+ *  @param keyLen Length of key, non-zero
+ *  @param model Model to score with, NULL for the active one
+ *  @return Average log-likelihood of a plaintext byte (in nats, higher is
+ *  better); 0 for empty text or key
+ */
+double EnglishScoreXOR(char const *text, size_t len, char const *key,
+                       size_t keyLen, EnglishModel const *model = NULL);
+/**
+ *  Score many windows of ciphertext under the same key at once, e.g. all
+ *  offsets where a crib might fit. Window at offset o is x[o, o + keyLen)
+ *  XORed with key.
+ *  @param score [out] Average log-likelihood of every window (see EnglishScore)
+ *  @param x Ciphertext
+ *  @param offsets Offsets of windows in ciphertext
+ *  @param count Number of windows
+ *  @param key Key bytes, also length of every window
+ *  @param keyLen Length of key, non-zero
+ *  @param model Model to score with, NULL for the active one
+ */
+void EnglishScoreWindows(double *score, char const *x, size_t const *offsets,
+                         size_t count, char const *key, size_t keyLen,
+                         EnglishModel const *model = NULL);
+
+#endif  /* MYCRYPTO_ENGLISH_H_ */
@@ -0,0 +1,2267 @@
+/**
+ *    Implementation of vectorized kernels from mycrypto-simd header
+ *    Description
+ *      Every kernel comes in a scalar (reference) version and SSSE3, AVX2 and
+ *      AVX-512 versions compiled through target attributes, so the library
+ *      itself can be built without any -m flags. Kernels for the level
+ *      reported by CPUID are picked on the first call. Vector kernels only
+ *      process the bulk of the input and leave the tail to scalar version.
+ *      Invalid input characters are detected in-register and accumulated over
+ *      the whole loop, so there is no branch per block.
+ *
+ *    Created: 17. Oct 2026.
+ *    Author: Vedran Mikov
+ */
+#include <cstdlib>
+#include <cstring>
+#include <atomic>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SIMD_X86
+//  GCC intrinsic headers initialize unused AVX-512 operands with themselves,
+//  which triggers false warnings once they get inlined in the kernels
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#endif
+
+#include "mycrypto-simd.h"
+
+//  Longest key (in bytes) repeated into a pattern buffer by repeating-key XOR
+//  kernels, longer keys are used directly
+#define XOR_PATTERN_MAX 256
+
+//  Base64 character set, padded to 64 bytes so it can be loaded in a register
+const char b64EncTable[65] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+//  HEX digits, in order of their value
+const char hexEncTable[17] = "0123456789abcdef";
+
+//  Reverse of the Base64 character set, maps every possible input byte to its
+//  6-bit value. Padding character '=' maps to 0xFE, any other invalid
+//  character to 0xFF, so upper bits of the decoded value flag invalid input
+const uint8_t b64DecTable[256] =
+{
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x3E, 0xFF, 0xFF, 0xFF, 0x3F,
+    0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3A, 0x3B, 0x3C, 0x3D, 0xFF, 0xFF, 0xFF, 0xFE, 0xFF, 0xFF,
+    0xFF, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E,
+    0x0F, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0x1A, 0x1B, 0x1C, 0x1D, 0x1E, 0x1F, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28,
+    0x29, 0x2A, 0x2B, 0x2C, 0x2D, 0x2E, 0x2F, 0x30, 0x31, 0x32, 0x33, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+};
+
+//  Maps HEX digits (upper and lower case) to their value, invalid characters
+//  map to 0xFF
+const uint8_t hexDecTable[256] =
+{
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+};
+
+//------------------------------------------------------------------------------
+//      Scalar reference kernels                                       [PRIVATE]
+//------------------------------------------------------------------------------
+/**
+ *  Decode even-length HEX string, one pair of digits at the time
+ */
+static size_t HexDecodeScalar(uint8_t *out, char const *in, size_t inLen)
+{
+    const uint8_t *src = (const uint8_t*)in;
+    uint8_t invalid = 0;
+
+    for (size_t i = 0; i < inLen; i += 2)
+    {
+        uint8_t hi = hexDecTable[src[i]], lo = hexDecTable[src[i+1]];
+        invalid |= hi | lo;
+        out[i/2] = (hi << 4) | (lo & 0x0F);
+    }
+
+    return (invalid & 0xF0) ? BUF_ERROR : inLen/2;
+}
+
+/**
+ *  Encode bytes as HEX, one byte at the time
+ */
+static size_t HexEncodeScalar(char *out, uint8_t const *in, size_t inLen)
+{
+    for (size_t i = 0; i < inLen; i++)
+    {
+        out[2*i]   = hexEncTable[in[i] >> 4];
+        out[2*i+1] = hexEncTable[in[i] & 0x0F];
+    }
+
+    return 2*inLen;
+}
+
+/**
+ *  Decode Base64 data (padding already stripped), 4 digits at the time. Last
+ *  chunk can be 2 or 3 digits long.
+ */
+static size_t Base64DecodeScalar(uint8_t *out, char const *in, size_t dataLen)
+{
+    const uint8_t *src = (const uint8_t*)in;
+    size_t i = 0, o = 0;
+    uint8_t invalid = 0;
+
+    //  Single Base64 digit holds only 6 bits, not enough to produce a byte
+    if ((dataLen % 4) == 1)
+        return BUF_ERROR;
+
+    for (; (i + 4) <= dataLen; i += 4, o += 3)
+    {
+        uint8_t d0 = b64DecTable[src[i]],   d1 = b64DecTable[src[i+1]],
+                d2 = b64DecTable[src[i+2]], d3 = b64DecTable[src[i+3]];
+        uint32_t chunk24bit = ((uint32_t)d0 << 18) | ((uint32_t)d1 << 12) |
+                              ((uint32_t)d2 << 6) | (uint32_t)d3;
+
+        invalid |= d0 | d1 | d2 | d3;
+        out[o]   = (chunk24bit >> 16) & 0xFF;
+        out[o+1] = (chunk24bit >> 8) & 0xFF;
+        out[o+2] = chunk24bit & 0xFF;
+    }
+
+    if (i < dataLen)
+    {
+        uint32_t chunk24bit = 0;
+        for (uint8_t j = 0; (i + j) < dataLen; j++)
+        {
+            uint8_t d = b64DecTable[src[i+j]];
+            invalid |= d;
+            chunk24bit |= (uint32_t)d << ((3-j)*6);
+        }
+
+        out[o++] = (chunk24bit >> 16) & 0xFF;
+        if ((dataLen - i) == 3)
+            out[o++] = (chunk24bit >> 8) & 0xFF;
+    }
+
+    return (invalid & 0xC0) ? BUF_ERROR : o;
+}
+
+/**
+ *  Encode bytes as Base64, 3 bytes at the time, and pad the last chunk
+ */
+static size_t Base64EncodeScalar(char *out, uint8_t const *in, size_t inLen)
+{
+    size_t i = 0, o = 0;
+
+    for (; (i + 3) <= inLen; i += 3, o += 4)
+    {
+        uint32_t chunk24bit = ((uint32_t)in[i] << 16) |
+                              ((uint32_t)in[i+1] << 8) | (uint32_t)in[i+2];
+
+        out[o]   = b64EncTable[(chunk24bit >> 18) & 0x3F];
+        out[o+1] = b64EncTable[(chunk24bit >> 12) & 0x3F];
+        out[o+2] = b64EncTable[(chunk24bit >> 6) & 0x3F];
+        out[o+3] = b64EncTable[chunk24bit & 0x3F];
+    }
+
+    if (i < inLen)
+    {
+        uint32_t chunk24bit = (uint32_t)in[i] << 16;
+        if ((i + 1) < inLen)
+            chunk24bit |= (uint32_t)in[i+1] << 8;
+
+        out[o]   = b64EncTable[(chunk24bit >> 18) & 0x3F];
+        out[o+1] = b64EncTable[(chunk24bit >> 12) & 0x3F];
+        out[o+2] = ((i + 1) < inLen) ? b64EncTable[(chunk24bit >> 6) & 0x3F] : '=';
+        out[o+3] = '=';
+        o += 4;
+    }
+
+    return o;
+}
+
+/**
+ *  Repeating-key XOR, one byte at the time
+ *  @return Key position following the last processed byte
+ */
+static size_t RepeatXORScalar(uint8_t *out, uint8_t const *in, size_t inLen,
+                              uint8_t const *key, size_t keyLen, size_t keyPos)
+{
+    for (size_t i = 0; i < inLen; i++)
+    {
+        out[i] = in[i] ^ key[keyPos];
+        if (++keyPos == keyLen)
+            keyPos = 0;
+    }
+
+    return keyPos;
+}
+
+/**
+ *  Repeat key to fill keyLen + width bytes, so that a vector of given width
+ *  loaded at any key position holds the key in order of use
+ */
+static inline void RepeatXORPattern(uint8_t *pattern, uint8_t const *key,
+                                    size_t keyLen, size_t width)
+{
+    size_t total = keyLen + width;
+
+    for (size_t j = 0; j < total; j += keyLen)
+        memcpy(pattern + j, key, ((total - j) < keyLen) ? (total - j) : keyLen);
+}
+
+/**
+ *  XOR HEX digits with repeating key digits, digit by digit
+ *  @return Key position following the last processed digit; BUF_ERROR on
+ *  invalid digit in input or key
+ */
+static size_t HexRepeatXORScalar(char *out, char const *in, size_t inLen,
+                                 char const *key, size_t keyLen, size_t keyPos)
+{
+    const uint8_t *src = (const uint8_t*)in, *k = (const uint8_t*)key;
+    uint8_t invalid = 0;
+
+    for (size_t i = 0; i < inLen; i++)
+    {
+        uint8_t a = hexDecTable[src[i]], b = hexDecTable[k[keyPos]];
+        invalid |= a | b;
+        out[i] = hexEncTable[(a ^ b) & 0x0F];
+        if (++keyPos == keyLen)
+            keyPos = 0;
+    }
+
+    return (invalid & 0xF0) ? BUF_ERROR : keyPos;
+}
+
+/**
+ *  Number of differing bits between two buffers, 8 bytes at the time
+ */
+static size_t HammingScalar(uint8_t const *a, uint8_t const *b, size_t len)
+{
+    size_t i = 0, dist = 0;
+
+    for (; (i + 8) <= len; i += 8)
+    {
+        uint64_t x, y;
+        memcpy(&x, a + i, 8);
+        memcpy(&y, b + i, 8);
+        dist += __builtin_popcountll(x ^ y);
+    }
+    for (; i < len; i++)
+        dist += __builtin_popcount(a[i] ^ b[i]);
+
+    return dist;
+}
+
+/**
+ *  Number of bytes in a set given by nibble rows, see SIMDCountByteSet
+ */
+static size_t ByteSetCountScalar(uint8_t const *in, size_t len, uint8_t const *rows,
+                                 bool high)
+{
+    size_t count = 0;
+
+    for (size_t i = 0; i < len; i++)
+        count += (in[i] & 0x80) ? high : ((rows[in[i] & 0x0F] >> (in[i] >> 4)) & 1);
+
+    return count;
+}
+
+/**
+ *  Scores of all single-byte XOR keys, see SIMDXORKeyScores
+ */
+static void XORKeyScoresScalar(double *score, uint64_t const *hist, double const *rows)
+{
+    for (size_t c = 0; c < 256; c++)
+    {
+        if (hist[c] == 0)
+            continue;
+
+        double const *row = rows + 256*(c & 0x0F);
+        double weight = hist[c];
+        for (size_t kh = 0; kh < 16; kh++)
+            for (size_t kl = 0; kl < 16; kl++)
+                score[16*kh + kl] += weight * row[16*((c >> 4) ^ kh) + kl];
+    }
+}
+
+/**
+ *  Transpose rows [first, rows) of row-major k-byte rows into columns of
+ *  stride bytes, cells past the end of input are set to 0
+ */
+static void TransposeRowsScalar(uint8_t *out, uint8_t const *in, size_t len,
+                                size_t k, size_t first)
+{
+    size_t stride = (len + k - 1) / k;
+
+    //  Blocks of rows, so that every column gets a whole cache line at the time
+    for (size_t r0 = first; r0 < stride; r0 += 64)
+    {
+        size_t rEnd = (r0 + 64 < stride) ? (r0 + 64) : stride;
+        for (size_t j = 0; j < k; j++)
+            for (size_t r = r0; r < rEnd; r++)
+                out[j*stride + r] = ((r*k + j) < len) ? in[r*k + j] : 0;
+    }
+}
+
+/**
+ *  Inverse of TransposeRowsScalar, for rows [first, rows)
+ */
+static void UntransposeRowsScalar(uint8_t *out, uint8_t const *in, size_t len,
+                                  size_t k, size_t first)
+{
+    size_t stride = (len + k - 1) / k;
+
+    for (size_t r0 = first; r0 < stride; r0 += 64)
+    {
+        size_t rEnd = (r0 + 64 < stride) ? (r0 + 64) : stride;
+        for (size_t j = 0; j < k; j++)
+            for (size_t r = r0; r < rEnd; r++)
+                if ((r*k + j) < len)
+                    out[r*k + j] = in[j*stride + r];
+    }
+}
+
+static void TransposeScalar(uint8_t *out, uint8_t const *in, size_t len, size_t k)
+{
+    TransposeRowsScalar(out, in, len, k, 0);
+}
+
+static void UntransposeScalar(uint8_t *out, uint8_t const *in, size_t len, size_t k)
+{
+    UntransposeRowsScalar(out, in, len, k, 0);
+}
+
+/**
+ *  Number of leading rows vector transpose kernels can process in blocks of
+ *  R rows: loads and stores of 16 bytes at the start of the last column block
+ *  of a row have to stay within len
+ */
+static inline size_t TransposeVectorRows(size_t len, size_t k, size_t R)
+{
+    size_t stride = (len + k - 1) / k, lastBlock = ((k - 1) / 16) * 16;
+    size_t rows = 0;
+
+    while (((rows + R) <= stride) && (((rows + R - 1)*k + lastBlock + 16) <= len))
+        rows += R;
+
+    return rows;
+}
+
+/**
+ *  Windows of crib matching the set, for offsets [first, n), see SIMDCribMatch
+ */
+static void CribMatchRangeScalar(uint64_t *match, uint8_t const *x, size_t n,
+                                 uint8_t const *crib, size_t cribLen,
+                                 uint8_t const *rows, bool high, uint8_t maxMiss,
+                                 size_t first)
+{
+    for (size_t o = first; o < n; o++)
+    {
+        size_t miss = 0;
+
+        for (size_t i = 0; (i < cribLen) && (miss <= maxMiss); i++)
+        {
+            uint8_t b = x[o + i] ^ crib[i];
+            miss += !((b & 0x80) ? high : ((rows[b & 0x0F] >> (b >> 4)) & 1));
+        }
+        if (miss <= maxMiss)
+            match[o >> 6] |= 1ULL << (o & 63);
+    }
+}
+
+static void CribMatchScalar(uint64_t *match, uint8_t const *x, size_t n,
+                            uint8_t const *crib, size_t cribLen,
+                            uint8_t const *rows, bool high, uint8_t maxMiss)
+{
+    CribMatchRangeScalar(match, x, n, crib, cribLen, rows, high, maxMiss, 0);
+}
+
+#ifdef SIMD_X86
+//------------------------------------------------------------------------------
+//      SSSE3 kernels                                                  [PRIVATE]
+//------------------------------------------------------------------------------
+/**
+ *  Map 16 HEX digits to their 4-bit values. Lanes holding anything else than
+ *  a HEX digit are flagged in err
+ */
+__attribute__((target("ssse3")))
+static inline __m128i HexNibblesSSSE3(__m128i c, __m128i &err)
+{
+    //  Digits are in range [0,9] after subtracting '0', letters (converted to
+    //  lower case) in range [0,5] after subtracting 'a'. Unsigned comparison
+    //  is done through min(x, limit) == x
+    __m128i dig = _mm_sub_epi8(c, _mm_set1_epi8('0'));
+    __m128i alp = _mm_sub_epi8(_mm_or_si128(c, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+    __m128i isDig = _mm_cmpeq_epi8(_mm_min_epu8(dig, _mm_set1_epi8(9)), dig);
+    __m128i isAlp = _mm_cmpeq_epi8(_mm_min_epu8(alp, _mm_set1_epi8(5)), alp);
+
+    err = _mm_or_si128(err, _mm_andnot_si128(_mm_or_si128(isDig, isAlp), _mm_set1_epi8(-1)));
+
+    return _mm_or_si128(_mm_and_si128(isDig, dig),
+                        _mm_andnot_si128(isDig, _mm_add_epi8(alp, _mm_set1_epi8(10))));
+}
+
+__attribute__((target("ssse3")))
+static size_t HexDecodeSSSE3(uint8_t *out, char const *in, size_t inLen)
+{
+    //  Multiplier combining two adjacent nibbles into hi*16 + lo
+    const __m128i pairMul = _mm_set1_epi16(0x0110);
+    __m128i err = _mm_setzero_si128();
+    size_t i = 0;
+
+    for (; (i + 32) <= inLen; i += 32)
+    {
+        __m128i n0 = HexNibblesSSSE3(_mm_loadu_si128((const __m128i*)(in + i)), err);
+        __m128i n1 = HexNibblesSSSE3(_mm_loadu_si128((const __m128i*)(in + i + 16)), err);
+
+        n0 = _mm_maddubs_epi16(n0, pairMul);
+        n1 = _mm_maddubs_epi16(n1, pairMul);
+        _mm_storeu_si128((__m128i*)(out + i/2), _mm_packus_epi16(n0, n1));
+    }
+
+    if (_mm_movemask_epi8(err) != 0)
+        return BUF_ERROR;
+    if (HexDecodeScalar(out + i/2, in + i, inLen - i) == BUF_ERROR)
+        return BUF_ERROR;
+
+    return inLen/2;
+}
+
+__attribute__((target("ssse3")))
+static size_t HexEncodeSSSE3(char *out, uint8_t const *in, size_t inLen)
+{
+    const __m128i lut = _mm_loadu_si128((const __m128i*)hexEncTable);
+    const __m128i mask = _mm_set1_epi8(0x0F);
+    size_t i = 0;
+
+    for (; (i + 16) <= inLen; i += 16)
+    {
+        __m128i x = _mm_loadu_si128((const __m128i*)(in + i));
+        __m128i hi = _mm_shuffle_epi8(lut, _mm_and_si128(_mm_srli_epi16(x, 4), mask));
+        __m128i lo = _mm_shuffle_epi8(lut, _mm_and_si128(x, mask));
+
+        _mm_storeu_si128((__m128i*)(out + 2*i), _mm_unpacklo_epi8(hi, lo));
+        _mm_storeu_si128((__m128i*)(out + 2*i + 16), _mm_unpackhi_epi8(hi, lo));
+    }
+
+    HexEncodeScalar(out + 2*i, in + i, inLen - i);
+    return 2*inLen;
+}
+
+/**
+ *  Translate 16 Base64 digits into their 6-bit values, invalid digits are
+ *  flagged in err. Nibble-lookup validation by W. Mula and D. Lemire
+ */
+__attribute__((target("ssse3")))
+static inline __m128i Base64ValuesSSSE3(__m128i str, __m128i &err)
+{
+    const __m128i lutLo = _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                                        0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+    const __m128i lutHi = _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+                                        0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+    const __m128i lutRoll = _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71,
+                                          0, 0, 0, 0, 0, 0, 0, 0);
+    const __m128i mask2F = _mm_set1_epi8(0x2F);
+
+    __m128i hiNibbles = _mm_and_si128(_mm_srli_epi32(str, 4), mask2F);
+    __m128i loNibbles = _mm_and_si128(str, mask2F);
+    __m128i lo = _mm_shuffle_epi8(lutLo, loNibbles);
+    __m128i hi = _mm_shuffle_epi8(lutHi, hiNibbles);
+    __m128i roll = _mm_shuffle_epi8(lutRoll,
+                        _mm_add_epi8(_mm_cmpeq_epi8(str, mask2F), hiNibbles));
+
+    err = _mm_or_si128(err, _mm_and_si128(lo, hi));
+    return _mm_add_epi8(str, roll);
+}
+
+/**
+ *  Pack sixteen 6-bit values into 12 bytes, placed in low part of the register
+ */
+__attribute__((target("ssse3")))
+static inline __m128i Base64PackSSSE3(__m128i values)
+{
+    __m128i merged = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+    merged = _mm_madd_epi16(merged, _mm_set1_epi32(0x00011000));
+    return _mm_shuffle_epi8(merged, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8,
+                                                  14, 13, 12, -1, -1, -1, -1));
+}
+
+__attribute__((target("ssse3")))
+static size_t Base64DecodeSSSE3(uint8_t *out, char const *in, size_t dataLen)
+{
+    __m128i err = _mm_setzero_si128();
+    size_t i = 0, o = 0, tail;
+
+    //  Each store writes 4 bytes past the decoded 12, keep enough input left
+    //  for those to be overwritten later
+    for (; (i + 32) <= dataLen; i += 16, o += 12)
+    {
+        __m128i v = Base64ValuesSSSE3(_mm_loadu_si128((const __m128i*)(in + i)), err);
+        _mm_storeu_si128((__m128i*)(out + o), Base64PackSSSE3(v));
+    }
+
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(err, _mm_setzero_si128())) != 0xFFFF)
+        return BUF_ERROR;
+    if ((tail = Base64DecodeScalar(out + o, in + i, dataLen - i)) == BUF_ERROR)
+        return BUF_ERROR;
+
+    return o + tail;
+}
+
+/**
+ *  Split 12 bytes (in a shuffled register) into 16 Base64 digits
+ */
+__attribute__((target("ssse3")))
+static inline __m128i Base64CharsSSSE3(__m128i in)
+{
+    //  Gather bytes so that every 32-bit lane holds bytes (1, 0, 2, 1) of one
+    //  3-byte chunk, then extract four 6-bit indices from each lane
+    in = _mm_shuffle_epi8(in, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7,
+                                           4, 5, 3, 4, 1, 2, 0, 1));
+    __m128i t0 = _mm_mulhi_epu16(_mm_and_si128(in, _mm_set1_epi32(0x0FC0FC00)),
+                                 _mm_set1_epi32(0x04000040));
+    __m128i t1 = _mm_mullo_epi16(_mm_and_si128(in, _mm_set1_epi32(0x003F03F0)),
+                                 _mm_set1_epi32(0x01000010));
+    __m128i idx = _mm_or_si128(t0, t1);
+
+    //  Translate indices into characters by adding an offset that depends on
+    //  the range index falls into
+    const __m128i shiftLUT = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52,
+                                           '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                           '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+                                           '/' - 63, 'A', 0, 0);
+    __m128i range = _mm_subs_epu8(idx, _mm_set1_epi8(51));
+    __m128i less = _mm_cmpgt_epi8(_mm_set1_epi8(26), idx);
+    range = _mm_or_si128(range, _mm_and_si128(less, _mm_set1_epi8(13)));
+
+    return _mm_add_epi8(idx, _mm_shuffle_epi8(shiftLUT, range));
+}
+
+__attribute__((target("ssse3")))
+static size_t Base64EncodeSSSE3(char *out, uint8_t const *in, size_t inLen)
+{
+    size_t i = 0, o = 0;
+
+    //  Loads read 4 bytes past the encoded 12
+    for (; (i + 16) <= inLen; i += 12, o += 16)
+    {
+        __m128i x = _mm_loadu_si128((const __m128i*)(in + i));
+        _mm_storeu_si128((__m128i*)(out + o), Base64CharsSSSE3(x));
+    }
+
+    return o + Base64EncodeScalar(out + o, in + i, inLen - i);
+}
+
+/**
+ *  Repeating-key XOR for keys longer than XOR_PATTERN_MAX, text is XORed
+ *  against contiguous runs of the key itself
+ */
+__attribute__((target("ssse3")))
+static size_t RepeatXORLongKeySSSE3(uint8_t *out, uint8_t const *in, size_t inLen,
+                                    uint8_t const *key, size_t keyLen, size_t keyPos)
+{
+    for (size_t i = 0; i < inLen; )
+    {
+        size_t run = ((inLen - i) < (keyLen - keyPos)) ? (inLen - i) : (keyLen - keyPos);
+        size_t j = 0;
+
+        for (; (j + 16) <= run; j += 16)
+        {
+            __m128i t = _mm_loadu_si128((const __m128i*)(in + i + j));
+            __m128i k = _mm_loadu_si128((const __m128i*)(key + keyPos + j));
+            _mm_storeu_si128((__m128i*)(out + i + j), _mm_xor_si128(t, k));
+        }
+        RepeatXORScalar(out + i + j, in + i + j, run - j, key + keyPos + j, run - j, 0);
+
+        i += run;
+        keyPos += run;
+        if (keyPos == keyLen)
+            keyPos = 0;
+    }
+
+    return keyPos;
+}
+
+/**
+ *  Repeating-key XOR, 16 bytes at the time. Short keys are repeated into a
+ *  pattern from which a whole register of key bytes is loaded at any phase.
+ */
+__attribute__((target("ssse3")))
+static size_t RepeatXORSSSE3(uint8_t *out, uint8_t const *in, size_t inLen,
+                             uint8_t const *key, size_t keyLen, size_t keyPos)
+{
+    uint8_t pattern[XOR_PATTERN_MAX + 16];
+    size_t i = 0, step = 16 % keyLen;
+
+    //  Not worth building the pattern for less than a register of text
+    if (inLen < 16)
+        return RepeatXORScalar(out, in, inLen, key, keyLen, keyPos);
+    if (keyLen > XOR_PATTERN_MAX)
+        return RepeatXORLongKeySSSE3(out, in, inLen, key, keyLen, keyPos);
+
+    RepeatXORPattern(pattern, key, keyLen, 16);
+
+    if (step == 0)
+    {
+        //  Key divides the register, the same key bytes apply to every block
+        const __m128i k = _mm_loadu_si128((const __m128i*)(pattern + keyPos));
+        for (; (i + 64) <= inLen; i += 64)
+        {
+            __m128i a = _mm_loadu_si128((const __m128i*)(in + i));
+            __m128i b = _mm_loadu_si128((const __m128i*)(in + i + 16));
+            __m128i c = _mm_loadu_si128((const __m128i*)(in + i + 32));
+            __m128i d = _mm_loadu_si128((const __m128i*)(in + i + 48));
+            _mm_storeu_si128((__m128i*)(out + i), _mm_xor_si128(a, k));
+            _mm_storeu_si128((__m128i*)(out + i + 16), _mm_xor_si128(b, k));
+            _mm_storeu_si128((__m128i*)(out + i + 32), _mm_xor_si128(c, k));
+            _mm_storeu_si128((__m128i*)(out + i + 48), _mm_xor_si128(d, k));
+        }
+    }
+
+    //  Otherwise key phase moves by the same step for every block
+    for (; (i + 16) <= inLen; i += 16)
+    {
+        __m128i t = _mm_loadu_si128((const __m128i*)(in + i));
+        __m128i k = _mm_loadu_si128((const __m128i*)(pattern + keyPos));
+        _mm_storeu_si128((__m128i*)(out + i), _mm_xor_si128(t, k));
+        keyPos += step;
+        if (keyPos >= keyLen)
+            keyPos -= keyLen;
+    }
+
+    return RepeatXORScalar(out + i, in + i, inLen - i, key, keyLen, keyPos);
+}
+
+/**
+ *  XOR 16 HEX digits with 16 key digits, digit by digit
+ */
+__attribute__((target("ssse3")))
+static inline void HexXORBlockSSSE3(char *out, char const *in, char const *key,
+                                    __m128i const &lut, __m128i &err)
+{
+    __m128i t = HexNibblesSSSE3(_mm_loadu_si128((const __m128i*)in), err);
+    __m128i k = HexNibblesSSSE3(_mm_loadu_si128((const __m128i*)key), err);
+    _mm_storeu_si128((__m128i*)out, _mm_shuffle_epi8(lut, _mm_xor_si128(t, k)));
+}
+
+/**
+ *  XOR HEX digits with repeating key digits, 16 at the time. Short keys are
+ *  repeated into a pattern as for byte XOR, long ones are used directly.
+ */
+__attribute__((target("ssse3")))
+static size_t HexRepeatXORSSSE3(char *out, char const *in, size_t inLen,
+                                char const *key, size_t keyLen, size_t keyPos)
+{
+    const __m128i lut = _mm_loadu_si128((const __m128i*)hexEncTable);
+    char pattern[XOR_PATTERN_MAX + 16];
+    __m128i err = _mm_setzero_si128();
+    size_t i = 0, step = 16 % keyLen;
+
+    if (inLen < 16)
+        return HexRepeatXORScalar(out, in, inLen, key, keyLen, keyPos);
+
+    if (keyLen > XOR_PATTERN_MAX)
+    {
+        //  Key digits are read in place, except where they wrap around
+        while ((i + 16) <= inLen)
+        {
+            if ((keyLen - keyPos) >= 16)
+            {
+                HexXORBlockSSSE3(out + i, in + i, key + keyPos, lut, err);
+                i += 16;
+                keyPos += 16;
+            }
+            else
+            {
+                size_t run = keyLen - keyPos;
+                if (HexRepeatXORScalar(out + i, in + i, run, key + keyPos, run, 0) == BUF_ERROR)
+                    return BUF_ERROR;
+                i += run;
+                keyPos += run;
+            }
+            if (keyPos == keyLen)
+                keyPos = 0;
+        }
+    }
+    else
+    {
+        RepeatXORPattern((uint8_t*)pattern, (const uint8_t*)key, keyLen, 16);
+        for (; (i + 16) <= inLen; i += 16)
+        {
+            HexXORBlockSSSE3(out + i, in + i, pattern + keyPos, lut, err);
+            keyPos += step;
+            if (keyPos >= keyLen)
+                keyPos -= keyLen;
+        }
+    }
+
+    if (_mm_movemask_epi8(err) != 0)
+        return BUF_ERROR;
+
+    return HexRepeatXORScalar(out + i, in + i, inLen - i, key, keyLen, keyPos);
+}
+
+/**
+ *  Number of differing bits between two buffers, 16 bytes at the time. Bits
+ *  are counted per nibble through a shuffle table and summed per 64-bit lane.
+ */
+__attribute__((target("ssse3")))
+static size_t HammingSSSE3(uint8_t const *a, uint8_t const *b, size_t len)
+{
+    const __m128i lut = _mm_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m128i low = _mm_set1_epi8(0x0F);
+    __m128i acc = _mm_setzero_si128();
+    size_t i = 0;
+
+    for (; (i + 16) <= len; i += 16)
+    {
+        __m128i x = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(a + i)),
+                                  _mm_loadu_si128((const __m128i*)(b + i)));
+        __m128i cnt = _mm_add_epi8(_mm_shuffle_epi8(lut, _mm_and_si128(x, low)),
+                                   _mm_shuffle_epi8(lut, _mm_and_si128(_mm_srli_epi16(x, 4), low)));
+        acc = _mm_add_epi64(acc, _mm_sad_epu8(cnt, _mm_setzero_si128()));
+    }
+
+    return _mm_cvtsi128_si64(acc) + _mm_cvtsi128_si64(_mm_unpackhi_epi64(acc, acc)) +
+           HammingScalar(a + i, b + i, len - i);
+}
+
+/**
+ *  Number of bytes in a set given by nibble rows, 16 bytes at the time. Row of
+ *  every byte is looked up by its low nibble and tested against the bit picked
+ *  by its high nibble, shuffles return 0 for bytes from 0x80 up. Hits are
+ *  summed per byte and flushed to 64-bit lanes before they could overflow.
+ */
+__attribute__((target("ssse3")))
+static size_t ByteSetCountSSSE3(uint8_t const *in, size_t len, uint8_t const *rows,
+                                bool high)
+{
+    const __m128i rowLUT = _mm_loadu_si128((const __m128i*)rows);
+    const __m128i bitLUT = _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128,
+                                         0, 0, 0, 0, 0, 0, 0, 0);
+    const __m128i low = _mm_set1_epi8(0x0F), one = _mm_set1_epi8(1);
+    const __m128i highHit = high ? one : _mm_setzero_si128();
+    __m128i acc = _mm_setzero_si128(), acc8 = _mm_setzero_si128();
+    size_t i = 0, n = 0;
+
+    for (; (i + 16) <= len; i += 16)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i*)(in + i));
+        __m128i bit = _mm_shuffle_epi8(bitLUT, _mm_and_si128(_mm_srli_epi16(v, 4), low));
+        __m128i hit = _mm_min_epu8(_mm_and_si128(_mm_shuffle_epi8(rowLUT, v), bit), one);
+        hit = _mm_or_si128(hit, _mm_and_si128(_mm_cmplt_epi8(v, _mm_setzero_si128()), highHit));
+        acc8 = _mm_add_epi8(acc8, hit);
+        if (++n == 255)
+        {
+            acc = _mm_add_epi64(acc, _mm_sad_epu8(acc8, _mm_setzero_si128()));
+            acc8 = _mm_setzero_si128();
+            n = 0;
+        }
+    }
+    acc = _mm_add_epi64(acc, _mm_sad_epu8(acc8, _mm_setzero_si128()));
+
+    return _mm_cvtsi128_si64(acc) + _mm_cvtsi128_si64(_mm_unpackhi_epi64(acc, acc)) +
+           ByteSetCountScalar(in + i, len - i, rows, high);
+}
+
+/**
+ *  Scores of all single-byte XOR keys, 2 keys at the time
+ */
+__attribute__((target("ssse3")))
+static void XORKeyScoresSSSE3(double *score, uint64_t const *hist, double const *rows)
+{
+    for (size_t c = 0; c < 256; c++)
+    {
+        if (hist[c] == 0)
+            continue;
+
+        double const *row = rows + 256*(c & 0x0F);
+        __m128d weight = _mm_set1_pd((double)hist[c]);
+        for (size_t kh = 0; kh < 16; kh++)
+        {
+            double const *src = row + 16*((c >> 4) ^ kh);
+            for (size_t kl = 0; kl < 16; kl += 2)
+                _mm_storeu_pd(score + 16*kh + kl,
+                              _mm_add_pd(_mm_loadu_pd(score + 16*kh + kl),
+                                         _mm_mul_pd(weight, _mm_loadu_pd(src + kl))));
+        }
+    }
+}
+
+/**
+ *  Transpose 16x16 bytes in registers. Interleaving rows i and i+8 four times
+ *  moves every byte to its transposed position.
+ */
+__attribute__((target("ssse3")))
+static inline void Transpose16SSSE3(__m128i *r)
+{
+    __m128i t[16];
+
+    for (size_t round = 0; round < 4; round++)
+    {
+        for (size_t i = 0; i < 8; i++)
+        {
+            t[2*i] = _mm_unpacklo_epi8(r[i], r[i+8]);
+            t[2*i+1] = _mm_unpackhi_epi8(r[i], r[i+8]);
+        }
+        for (size_t i = 0; i < 16; i++)
+            r[i] = t[i];
+    }
+}
+
+/**
+ *  Split k-byte rows into columns, in tiles of 16 rows by 16 columns
+ */
+__attribute__((target("ssse3")))
+static void TransposeSSSE3(uint8_t *out, uint8_t const *in, size_t len, size_t k)
+{
+    size_t stride = (len + k - 1) / k, rows = TransposeVectorRows(len, k, 16);
+    __m128i r[16];
+
+    for (size_t r0 = 0; r0 < rows; r0 += 16)
+        for (size_t j0 = 0; j0 < k; j0 += 16)
+        {
+            for (size_t i = 0; i < 16; i++)
+                r[i] = _mm_loadu_si128((const __m128i*)(in + (r0 + i)*k + j0));
+            Transpose16SSSE3(r);
+            for (size_t c = 0; (c < 16) && ((j0 + c) < k); c++)
+                _mm_storeu_si128((__m128i*)(out + (j0 + c)*stride + r0), r[c]);
+        }
+
+    TransposeRowsScalar(out, in, len, k, rows);
+}
+
+/**
+ *  Reassemble k-byte rows from columns, in tiles of 16 rows by 16 columns.
+ *  Rows of the last, narrower column block are stored whole, spilling into
+ *  the following row, so that block goes first and the rest overwrite it.
+ */
+__attribute__((target("ssse3")))
+static void UntransposeSSSE3(uint8_t *out, uint8_t const *in, size_t len, size_t k)
+{
+    size_t stride = (len + k - 1) / k, rows = TransposeVectorRows(len, k, 16);
+    size_t lastBlock = ((k - 1) / 16) * 16;
+    __m128i r[16];
+
+    for (size_t r0 = 0; r0 < rows; r0 += 16)
+        for (size_t b = 0; b <= lastBlock; b += 16)
+        {
+            size_t j0 = (b == 0) ? lastBlock : (b - 16);
+            for (size_t c = 0; c < 16; c++)
+                r[c] = ((j0 + c) < k) ? _mm_loadu_si128((const __m128i*)(in + (j0 + c)*stride + r0))
+                                      : _mm_setzero_si128();
+            Transpose16SSSE3(r);
+            for (size_t i = 0; i < 16; i++)
+                _mm_storeu_si128((__m128i*)(out + (r0 + i)*k + j0), r[i]);
+        }
+
+    UntransposeRowsScalar(out, in, len, k, rows);
+}
+
+/**
+ *  Windows of crib matching the set, 16 offsets at the time. Every lane
+ *  counts misses of its window (saturating), and the block is left as soon as
+ *  all of them have too many.
+ */
+__attribute__((target("ssse3")))
+static void CribMatchSSSE3(uint64_t *match, uint8_t const *x, size_t n,
+                           uint8_t const *crib, size_t cribLen,
+                           uint8_t const *rows, bool high, uint8_t maxMiss)
+{
+    const __m128i rowLUT = _mm_loadu_si128((const __m128i*)rows);
+    const __m128i bitLUT = _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128,
+                                         0, 0, 0, 0, 0, 0, 0, 0);
+    const __m128i low = _mm_set1_epi8(0x0F), one = _mm_set1_epi8(1);
+    const __m128i highHit = high ? one : _mm_setzero_si128();
+    const __m128i dead = _mm_set1_epi8(maxMiss + 1);
+    size_t o = 0;
+
+    for (; (o + 16) <= n; o += 16)
+    {
+        __m128i miss = _mm_setzero_si128();
+
+        for (size_t i = 0; i < cribLen; i++)
+        {
+            __m128i v = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(x + o + i)),
+                                      _mm_set1_epi8(crib[i]));
+            __m128i bit = _mm_shuffle_epi8(bitLUT, _mm_and_si128(_mm_srli_epi16(v, 4), low));
+            __m128i hit = _mm_min_epu8(_mm_and_si128(_mm_shuffle_epi8(rowLUT, v), bit), one);
+            hit = _mm_or_si128(hit, _mm_and_si128(_mm_cmplt_epi8(v, _mm_setzero_si128()), highHit));
+            miss = _mm_adds_epu8(miss, _mm_xor_si128(hit, one));
+            if (((i & 3) == 3) &&
+                (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_min_epu8(miss, dead), dead)) == 0xFFFF))
+                break;
+        }
+
+        uint64_t ok = ~_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_min_epu8(miss, dead), dead)) & 0xFFFF;
+        match[o >> 6] |= ok << (o & 63);
+    }
+
+    CribMatchRangeScalar(match, x, n, crib, cribLen, rows, high, maxMiss, o);
+}
+
+//------------------------------------------------------------------------------
+//      AVX2 kernels                                                   [PRIVATE]
+//------------------------------------------------------------------------------
+__attribute__((target("avx2")))
+static inline __m256i HexNibblesAVX2(__m256i c, __m256i &err)
+{
+    __m256i dig = _mm256_sub_epi8(c, _mm256_set1_epi8('0'));
+    __m256i alp = _mm256_sub_epi8(_mm256_or_si256(c, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('a'));
+    __m256i isDig = _mm256_cmpeq_epi8(_mm256_min_epu8(dig, _mm256_set1_epi8(9)), dig);
+    __m256i isAlp = _mm256_cmpeq_epi8(_mm256_min_epu8(alp, _mm256_set1_epi8(5)), alp);
+
+    err = _mm256_or_si256(err, _mm256_andnot_si256(_mm256_or_si256(isDig, isAlp),
+                                                   _mm256_set1_epi8(-1)));
+
+    return _mm256_blendv_epi8(_mm256_add_epi8(alp, _mm256_set1_epi8(10)), dig, isDig);
+}
+
+__attribute__((target("avx2")))
+static size_t HexDecodeAVX2(uint8_t *out, char const *in, size_t inLen)
+{
+    const __m256i pairMul = _mm256_set1_epi16(0x0110);
+    __m256i err = _mm256_setzero_si256();
+    size_t i = 0;
+
+    for (; (i + 64) <= inLen; i += 64)
+    {
+        __m256i n0 = HexNibblesAVX2(_mm256_loadu_si256((const __m256i*)(in + i)), err);
+        __m256i n1 = HexNibblesAVX2(_mm256_loadu_si256((const __m256i*)(in + i + 32)), err);
+
+        //  Pack works within 128-bit lanes, restore order of 64-bit quarters
+        __m256i packed = _mm256_packus_epi16(_mm256_maddubs_epi16(n0, pairMul),
+                                             _mm256_maddubs_epi16(n1, pairMul));
+        packed = _mm256_permute4x64_epi64(packed, _MM_SHUFFLE(3, 1, 2, 0));
+        _mm256_storeu_si256((__m256i*)(out + i/2), packed);
+    }
+
+    if (!_mm256_testz_si256(err, err))
+        return BUF_ERROR;
+    if (HexDecodeScalar(out + i/2, in + i, inLen - i) == BUF_ERROR)
+        return BUF_ERROR;
+
+    return inLen/2;
+}
+
+__attribute__((target("avx2")))
+static size_t HexEncodeAVX2(char *out, uint8_t const *in, size_t inLen)
+{
+    const __m256i lut = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)hexEncTable));
+    const __m256i mask = _mm256_set1_epi16(0x0F);
+    size_t i = 0;
+
+    //  Widen every byte to 16 bits and place its high nibble in the low byte
+    //  and low nibble in the high byte, which is the order of HEX digits
+    for (; (i + 16) <= inLen; i += 16)
+    {
+        __m256i w = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)(in + i)));
+        w = _mm256_or_si256(_mm256_srli_epi16(w, 4),
+                            _mm256_slli_epi16(_mm256_and_si256(w, mask), 8));
+        _mm256_storeu_si256((__m256i*)(out + 2*i), _mm256_shuffle_epi8(lut, w));
+    }
+
+    HexEncodeScalar(out + 2*i, in + i, inLen - i);
+    return 2*inLen;
+}
+
+__attribute__((target("avx2")))
+static size_t Base64DecodeAVX2(uint8_t *out, char const *in, size_t dataLen)
+{
+    const __m256i lutLo = _mm256_setr_epi8(
+            0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A,
+            0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+    const __m256i lutHi = _mm256_setr_epi8(
+            0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+            0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+    const __m256i lutRoll = _mm256_setr_epi8(
+            0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0,
+            0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m256i packShuf = _mm256_setr_epi8(
+            2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+            2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+    const __m256i mask2F = _mm256_set1_epi8(0x2F);
+    __m256i err = _mm256_setzero_si256();
+    size_t i = 0, o = 0, tail;
+
+    //  Each store writes 8 bytes past the decoded 24
+    for (; (i + 64) <= dataLen; i += 32, o += 24)
+    {
+        __m256i str = _mm256_loadu_si256((const __m256i*)(in + i));
+        __m256i hiNibbles = _mm256_and_si256(_mm256_srli_epi32(str, 4), mask2F);
+        __m256i lo = _mm256_shuffle_epi8(lutLo, _mm256_and_si256(str, mask2F));
+        __m256i hi = _mm256_shuffle_epi8(lutHi, hiNibbles);
+        __m256i roll = _mm256_shuffle_epi8(lutRoll,
+                            _mm256_add_epi8(_mm256_cmpeq_epi8(str, mask2F), hiNibbles));
+
+        err = _mm256_or_si256(err, _mm256_and_si256(lo, hi));
+        str = _mm256_add_epi8(str, roll);
+
+        //  Pack 6-bit values to 12 bytes per lane, then join the two lanes
+        str = _mm256_maddubs_epi16(str, _mm256_set1_epi32(0x01400140));
+        str = _mm256_madd_epi16(str, _mm256_set1_epi32(0x00011000));
+        str = _mm256_shuffle_epi8(str, packShuf);
+        str = _mm256_permutevar8x32_epi32(str, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 7, 7));
+        _mm256_storeu_si256((__m256i*)(out + o), str);
+    }
+
+    if (!_mm256_testz_si256(err, err))
+        return BUF_ERROR;
+    if ((tail = Base64DecodeScalar(out + o, in + i, dataLen - i)) == BUF_ERROR)
+        return BUF_ERROR;
+
+    return o + tail;
+}
+
+__attribute__((target("avx2")))
+static size_t Base64EncodeAVX2(char *out, uint8_t const *in, size_t inLen)
+{
+    const __m256i gather = _mm256_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1,
+                                           10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1);
+    const __m256i shiftLUT = _mm256_setr_epi8(
+            'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+            '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0,
+            'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+            '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+    size_t i = 0, o = 0;
+
+    //  Two 12-byte chunks go in separate 128-bit lanes, second load reads 4
+    //  bytes past the encoded 24
+    for (; (i + 28) <= inLen; i += 24, o += 32)
+    {
+        __m256i x = _mm256_inserti128_si256(
+                        _mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)(in + i))),
+                        _mm_loadu_si128((const __m128i*)(in + i + 12)), 1);
+        x = _mm256_shuffle_epi8(x, gather);
+
+        __m256i t0 = _mm256_mulhi_epu16(_mm256_and_si256(x, _mm256_set1_epi32(0x0FC0FC00)),
+                                        _mm256_set1_epi32(0x04000040));
+        __m256i t1 = _mm256_mullo_epi16(_mm256_and_si256(x, _mm256_set1_epi32(0x003F03F0)),
+                                        _mm256_set1_epi32(0x01000010));
+        __m256i idx = _mm256_or_si256(t0, t1);
+        __m256i range = _mm256_subs_epu8(idx, _mm256_set1_epi8(51));
+        __m256i less = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), idx);
+        range = _mm256_or_si256(range, _mm256_and_si256(less, _mm256_set1_epi8(13)));
+
+        _mm256_storeu_si256((__m256i*)(out + o),
+                            _mm256_add_epi8(idx, _mm256_shuffle_epi8(shiftLUT, range)));
+    }
+
+    return o + Base64EncodeScalar(out + o, in + i, inLen - i);
+}
+
+/**
+ *  Repeating-key XOR for keys longer than XOR_PATTERN_MAX, text is XORed
+ *  against contiguous runs of the key itself
+ */
+__attribute__((target("avx2")))
+static size_t RepeatXORLongKeyAVX2(uint8_t *out, uint8_t const *in, size_t inLen,
+                                   uint8_t const *key, size_t keyLen, size_t keyPos)
+{
+    for (size_t i = 0; i < inLen; )
+    {
+        size_t run = ((inLen - i) < (keyLen - keyPos)) ? (inLen - i) : (keyLen - keyPos);
+        size_t j = 0;
+
+        for (; (j + 32) <= run; j += 32)
+        {
+            __m256i t = _mm256_loadu_si256((const __m256i*)(in + i + j));
+            __m256i k = _mm256_loadu_si256((const __m256i*)(key + keyPos + j));
+            _mm256_storeu_si256((__m256i*)(out + i + j), _mm256_xor_si256(t, k));
+        }
+        RepeatXORScalar(out + i + j, in + i + j, run - j, key + keyPos + j, run - j, 0);
+
+        i += run;
+        keyPos += run;
+        if (keyPos == keyLen)
+            keyPos = 0;
+    }
+
+    return keyPos;
+}
+
+/**
+ *  Repeating-key XOR, 32 bytes at the time. Short keys are repeated into a
+ *  pattern from which a whole register of key bytes is loaded at any phase.
+ */
+__attribute__((target("avx2")))
+static size_t RepeatXORAVX2(uint8_t *out, uint8_t const *in, size_t inLen,
+                            uint8_t const *key, size_t keyLen, size_t keyPos)
+{
+    uint8_t pattern[XOR_PATTERN_MAX + 32];
+    size_t i = 0, step = 32 % keyLen;
+
+    //  Not worth building the pattern for less than a register of text
+    if (inLen < 32)
+        return RepeatXORScalar(out, in, inLen, key, keyLen, keyPos);
+    if (keyLen > XOR_PATTERN_MAX)
+        return RepeatXORLongKeyAVX2(out, in, inLen, key, keyLen, keyPos);
+
+    RepeatXORPattern(pattern, key, keyLen, 32);
+
+    if (step == 0)
+    {
+        //  Key divides the register, the same key bytes apply to every block
+        const __m256i k = _mm256_loadu_si256((const __m256i*)(pattern + keyPos));
+        for (; (i + 128) <= inLen; i += 128)
+        {
+            __m256i a = _mm256_loadu_si256((const __m256i*)(in + i));
+            __m256i b = _mm256_loadu_si256((const __m256i*)(in + i + 32));
+            __m256i c = _mm256_loadu_si256((const __m256i*)(in + i + 64));
+            __m256i d = _mm256_loadu_si256((const __m256i*)(in + i + 96));
+            _mm256_storeu_si256((__m256i*)(out + i), _mm256_xor_si256(a, k));
+            _mm256_storeu_si256((__m256i*)(out + i + 32), _mm256_xor_si256(b, k));
+            _mm256_storeu_si256((__m256i*)(out + i + 64), _mm256_xor_si256(c, k));
+            _mm256_storeu_si256((__m256i*)(out + i + 96), _mm256_xor_si256(d, k));
+        }
+    }
+
+    //  Otherwise key phase moves by the same step for every block
+    for (; (i + 32) <= inLen; i += 32)
+    {
+        __m256i t = _mm256_loadu_si256((const __m256i*)(in + i));
+        __m256i k = _mm256_loadu_si256((const __m256i*)(pattern + keyPos));
+        _mm256_storeu_si256((__m256i*)(out + i), _mm256_xor_si256(t, k));
+        keyPos += step;
+        if (keyPos >= keyLen)
+            keyPos -= keyLen;
+    }
+
+    return RepeatXORScalar(out + i, in + i, inLen - i, key, keyLen, keyPos);
+}
+
+/**
+ *  XOR 32 HEX digits with 32 key digits, digit by digit
+ */
+__attribute__((target("avx2")))
+static inline void HexXORBlockAVX2(char *out, char const *in, char const *key,
+                                   __m256i const &lut, __m256i &err)
+{
+    __m256i t = HexNibblesAVX2(_mm256_loadu_si256((const __m256i*)in), err);
+    __m256i k = HexNibblesAVX2(_mm256_loadu_si256((const __m256i*)key), err);
+    _mm256_storeu_si256((__m256i*)out, _mm256_shuffle_epi8(lut, _mm256_xor_si256(t, k)));
+}
+
+/**
+ *  XOR HEX digits with repeating key digits, 32 at the time. Short keys are
+ *  repeated into a pattern as for byte XOR, long ones are used directly.
+ */
+__attribute__((target("avx2")))
+static size_t HexRepeatXORAVX2(char *out, char const *in, size_t inLen,
+                               char const *key, size_t keyLen, size_t keyPos)
+{
+    const __m256i lut = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)hexEncTable));
+    char pattern[XOR_PATTERN_MAX + 32];
+    __m256i err = _mm256_setzero_si256();
+    size_t i = 0, step = 32 % keyLen;
+
+    if (inLen < 32)
+        return HexRepeatXORScalar(out, in, inLen, key, keyLen, keyPos);
+
+    if (keyLen > XOR_PATTERN_MAX)
+    {
+        //  Key digits are read in place, except where they wrap around
+        while ((i + 32) <= inLen)
+        {
+            if ((keyLen - keyPos) >= 32)
+            {
+                HexXORBlockAVX2(out + i, in + i, key + keyPos, lut, err);
+                i += 32;
+                keyPos += 32;
+            }
+            else
+            {
+                size_t run = keyLen - keyPos;
+                if (HexRepeatXORScalar(out + i, in + i, run, key + keyPos, run, 0) == BUF_ERROR)
+                    return BUF_ERROR;
+                i += run;
+                keyPos += run;
+            }
+            if (keyPos == keyLen)
+                keyPos = 0;
+        }
+    }
+    else
+    {
+        RepeatXORPattern((uint8_t*)pattern, (const uint8_t*)key, keyLen, 32);
+        for (; (i + 32) <= inLen; i += 32)
+        {
+            HexXORBlockAVX2(out + i, in + i, pattern + keyPos, lut, err);
+            keyPos += step;
+            if (keyPos >= keyLen)
+                keyPos -= keyLen;
+        }
+    }
+
+    if (_mm256_movemask_epi8(err) != 0)
+        return BUF_ERROR;
+
+    return HexRepeatXORScalar(out + i, in + i, inLen - i, key, keyLen, keyPos);
+}
+
+/**
+ *  Number of differing bits between two buffers, 32 bytes at the time
+ */
+__attribute__((target("avx2,popcnt")))
+static size_t HammingAVX2(uint8_t const *a, uint8_t const *b, size_t len)
+{
+    const __m256i lut = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                         0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low = _mm256_set1_epi8(0x0F);
+    __m256i acc = _mm256_setzero_si256();
+    uint64_t lanes[4];
+    size_t i = 0, dist = 0;
+
+    for (; (i + 32) <= len; i += 32)
+    {
+        __m256i x = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(a + i)),
+                                     _mm256_loadu_si256((const __m256i*)(b + i)));
+        __m256i cnt = _mm256_add_epi8(_mm256_shuffle_epi8(lut, _mm256_and_si256(x, low)),
+                                      _mm256_shuffle_epi8(lut, _mm256_and_si256(_mm256_srli_epi16(x, 4), low)));
+        acc = _mm256_add_epi64(acc, _mm256_sad_epu8(cnt, _mm256_setzero_si256()));
+    }
+    _mm256_storeu_si256((__m256i*)lanes, acc);
+
+    //  Tail with popcnt instruction, every AVX2 CPU has it
+    for (; (i + 8) <= len; i += 8)
+    {
+        uint64_t x, y;
+        memcpy(&x, a + i, 8);
+        memcpy(&y, b + i, 8);
+        dist += _mm_popcnt_u64(x ^ y);
+    }
+    for (; i < len; i++)
+        dist += _mm_popcnt_u32(a[i] ^ b[i]);
+
+    return dist + lanes[0] + lanes[1] + lanes[2] + lanes[3];
+}
+
+/**
+ *  Number of bytes in a set given by nibble rows, 32 bytes at the time
+ */
+__attribute__((target("avx2,popcnt")))
+static size_t ByteSetCountAVX2(uint8_t const *in, size_t len, uint8_t const *rows,
+                               bool high)
+{
+    const __m256i rowLUT = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)rows));
+    const __m256i bitLUT = _mm256_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 0, 0, 0, 0, 0, 0, 0, 0,
+                                            1, 2, 4, 8, 16, 32, 64, -128, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m256i low = _mm256_set1_epi8(0x0F);
+    size_t i = 0, count = 0;
+
+    for (; (i + 32) <= len; i += 32)
+    {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(in + i));
+        __m256i bit = _mm256_shuffle_epi8(bitLUT, _mm256_and_si256(_mm256_srli_epi16(v, 4), low));
+        __m256i miss = _mm256_cmpeq_epi8(_mm256_and_si256(_mm256_shuffle_epi8(rowLUT, v), bit),
+                                         _mm256_setzero_si256());
+        uint32_t hits = ~(uint32_t)_mm256_movemask_epi8(miss);
+        //  Bytes from 0x80 up always miss in the table, their sign bits select them
+        if (high)
+            hits |= (uint32_t)_mm256_movemask_epi8(v);
+        count += _mm_popcnt_u32(hits);
+    }
+
+    return count + ByteSetCountScalar(in + i, len - i, rows, high);
+}
+
+/**
+ *  Scores of all single-byte XOR keys, 4 keys at the time
+ */
+__attribute__((target("avx2")))
+static void XORKeyScoresAVX2(double *score, uint64_t const *hist, double const *rows)
+{
+    for (size_t c = 0; c < 256; c++)
+    {
+        if (hist[c] == 0)
+            continue;
+
+        double const *row = rows + 256*(c & 0x0F);
+        __m256d weight = _mm256_set1_pd((double)hist[c]);
+        for (size_t kh = 0; kh < 16; kh++)
+        {
+            double const *src = row + 16*((c >> 4) ^ kh);
+            for (size_t kl = 0; kl < 16; kl += 4)
+                _mm256_storeu_pd(score + 16*kh + kl,
+                                 _mm256_add_pd(_mm256_loadu_pd(score + 16*kh + kl),
+                                               _mm256_mul_pd(weight, _mm256_loadu_pd(src + kl))));
+        }
+    }
+}
+
+/**
+ *  Transpose two 16x16 tiles of bytes, one in every 128-bit lane
+ */
+__attribute__((target("avx2")))
+static inline void Transpose16AVX2(__m256i *r)
+{
+    __m256i t[16];
+
+    for (size_t round = 0; round < 4; round++)
+    {
+        for (size_t i = 0; i < 8; i++)
+        {
+            t[2*i] = _mm256_unpacklo_epi8(r[i], r[i+8]);
+            t[2*i+1] = _mm256_unpackhi_epi8(r[i], r[i+8]);
+        }
+        for (size_t i = 0; i < 16; i++)
+            r[i] = t[i];
+    }
+}
+
+/**
+ *  Split k-byte rows into columns, in tiles of 32 rows by 16 columns, rows
+ *  16-31 of the tile go to the upper lane
+ */
+__attribute__((target("avx2")))
+static void TransposeAVX2(uint8_t *out, uint8_t const *in, size_t len, size_t k)
+{
+    size_t stride = (len + k - 1) / k, rows = TransposeVectorRows(len, k, 32);
+    __m256i r[16];
+
+    for (size_t r0 = 0; r0 < rows; r0 += 32)
+        for (size_t j0 = 0; j0 < k; j0 += 16)
+        {
+            for (size_t i = 0; i < 16; i++)
+                r[i] = _mm256_inserti128_si256(
+                    _mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)(in + (r0 + i)*k + j0))),
+                    _mm_loadu_si128((const __m128i*)(in + (r0 + 16 + i)*k + j0)), 1);
+            Transpose16AVX2(r);
+            for (size_t c = 0; (c < 16) && ((j0 + c) < k); c++)
+                _mm256_storeu_si256((__m256i*)(out + (j0 + c)*stride + r0), r[c]);
+        }
+
+    TransposeRowsScalar(out, in, len, k, rows);
+}
+
+/**
+ *  Reassemble k-byte rows from columns, in tiles of 32 rows by 16 columns
+ *  (see UntransposeSSSE3 for order of column blocks)
+ */
+__attribute__((target("avx2")))
+static void UntransposeAVX2(uint8_t *out, uint8_t const *in, size_t len, size_t k)
+{
+    size_t stride = (len + k - 1) / k, rows = TransposeVectorRows(len, k, 32);
+    size_t lastBlock = ((k - 1) / 16) * 16;
+    __m256i r[16];
+
+    for (size_t r0 = 0; r0 < rows; r0 += 32)
+        for (size_t b = 0; b <= lastBlock; b += 16)
+        {
+            size_t j0 = (b == 0) ? lastBlock : (b - 16);
+            for (size_t c = 0; c < 16; c++)
+                r[c] = ((j0 + c) < k) ? _mm256_loadu_si256((const __m256i*)(in + (j0 + c)*stride + r0))
+                                      : _mm256_setzero_si256();
+            Transpose16AVX2(r);
+            for (size_t i = 0; i < 16; i++)
+                _mm_storeu_si128((__m128i*)(out + (r0 + i)*k + j0), _mm256_castsi256_si128(r[i]));
+            for (size_t i = 0; i < 16; i++)
+                _mm_storeu_si128((__m128i*)(out + (r0 + 16 + i)*k + j0), _mm256_extracti128_si256(r[i], 1));
+        }
+
+    UntransposeRowsScalar(out, in, len, k, rows);
+}
+
+/**
+ *  Windows of crib matching the set, 32 offsets at the time
+ */
+__attribute__((target("avx2")))
+static void CribMatchAVX2(uint64_t *match, uint8_t const *x, size_t n,
+                          uint8_t const *crib, size_t cribLen,
+                          uint8_t const *rows, bool high, uint8_t maxMiss)
+{
+    const __m256i rowLUT = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)rows));
+    const __m256i bitLUT = _mm256_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 0, 0, 0, 0, 0, 0, 0, 0,
+                                            1, 2, 4, 8, 16, 32, 64, -128, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m256i low = _mm256_set1_epi8(0x0F), one = _mm256_set1_epi8(1);
+    const __m256i zero = _mm256_setzero_si256(), dead = _mm256_set1_epi8(maxMiss + 1);
+    size_t o = 0;
+
+    for (; (o + 32) <= n; o += 32)
+    {
+        __m256i miss = zero;
+
+        for (size_t i = 0; i < cribLen; i++)
+        {
+            __m256i v = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(x + o + i)),
+                                         _mm256_set1_epi8(crib[i]));
+            __m256i bit = _mm256_shuffle_epi8(bitLUT, _mm256_and_si256(_mm256_srli_epi16(v, 4), low));
+            __m256i out = _mm256_cmpeq_epi8(_mm256_and_si256(_mm256_shuffle_epi8(rowLUT, v), bit), zero);
+            //  Bytes from 0x80 up always miss in the table, their sign bits select them
+            if (high)
+                out = _mm256_andnot_si256(_mm256_cmpgt_epi8(zero, v), out);
+            miss = _mm256_adds_epu8(miss, _mm256_and_si256(out, one));
+            if (((i & 3) == 3) &&
+                ((uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_min_epu8(miss, dead), dead)) == 0xFFFFFFFF))
+                break;
+        }
+
+        uint64_t ok = ~(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_min_epu8(miss, dead), dead));
+        match[o >> 6] |= (ok & 0xFFFFFFFF) << (o & 63);
+    }
+
+    CribMatchRangeScalar(match, x, n, crib, cribLen, rows, high, maxMiss, o);
+}
+
+//------------------------------------------------------------------------------
+//      AVX-512 kernels                                                [PRIVATE]
+//------------------------------------------------------------------------------
+__attribute__((target("avx512f,avx512bw")))
+static inline __m512i HexNibblesAVX512(__m512i c, __mmask64 &err)
+{
+    __m512i dig = _mm512_sub_epi8(c, _mm512_set1_epi8('0'));
+    __m512i alp = _mm512_sub_epi8(_mm512_or_si512(c, _mm512_set1_epi8(0x20)), _mm512_set1_epi8('a'));
+    __mmask64 isDig = _mm512_cmple_epu8_mask(dig, _mm512_set1_epi8(9));
+    __mmask64 isAlp = _mm512_cmple_epu8_mask(alp, _mm512_set1_epi8(5));
+
+    err |= ~(isDig | isAlp);
+
+    return _mm512_mask_blend_epi8(isDig, _mm512_add_epi8(alp, _mm512_set1_epi8(10)), dig);
+}
+
+__attribute__((target("avx512f,avx512bw")))
+static size_t HexDecodeAVX512(uint8_t *out, char const *in, size_t inLen)
+{
+    const __m512i pairMul = _mm512_set1_epi16(0x0110);
+    __mmask64 err = 0;
+    size_t i = 0;
+
+    for (; (i + 64) <= inLen; i += 64)
+    {
+        __m512i n = HexNibblesAVX512(_mm512_loadu_si512((const void*)(in + i)), err);
+        _mm256_storeu_si256((__m256i*)(out + i/2),
+                            _mm512_cvtepi16_epi8(_mm512_maddubs_epi16(n, pairMul)));
+    }
+
+    if (err != 0)
+        return BUF_ERROR;
+    if (HexDecodeScalar(out + i/2, in + i, inLen - i) == BUF_ERROR)
+        return BUF_ERROR;
+
+    return inLen/2;
+}
+
+__attribute__((target("avx512f,avx512bw")))
+static size_t HexEncodeAVX512(char *out, uint8_t const *in, size_t inLen)
+{
+    const __m512i lut = _mm512_broadcast_i32x4(_mm_loadu_si128((const __m128i*)hexEncTable));
+    const __m512i mask = _mm512_set1_epi16(0x0F);
+    size_t i = 0;
+
+    for (; (i + 32) <= inLen; i += 32)
+    {
+        __m512i w = _mm512_cvtepu8_epi16(_mm256_loadu_si256((const __m256i*)(in + i)));
+        w = _mm512_or_si512(_mm512_srli_epi16(w, 4),
+                            _mm512_slli_epi16(_mm512_and_si512(w, mask), 8));
+        _mm512_storeu_si512((void*)(out + 2*i), _mm512_shuffle_epi8(lut, w));
+    }
+
+    HexEncodeScalar(out + 2*i, in + i, inLen - i);
+    return 2*inLen;
+}
+
+/**
+ *  Byte positions gathering 48 decoded bytes from 16 32-bit lanes holding
+ *  24 bits each (in big-endian order)
+ */
+static const uint8_t b64PackIdx[64] =
+{
+     2,  1,  0,  6,  5,  4, 10,  9,  8, 14, 13, 12, 18, 17, 16, 22,
+    21, 20, 26, 25, 24, 30, 29, 28, 34, 33, 32, 38, 37, 36, 42, 41,
+    40, 46, 45, 44, 50, 49, 48, 54, 53, 52, 58, 57, 56, 62, 61, 60,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0
+};
+
+/**
+ *  Byte positions spreading 48 input bytes into 16 32-bit lanes, each holding
+ *  bytes (1, 0, 2, 1) of one 3-byte chunk
+ */
+static const uint8_t b64GatherIdx[64] =
+{
+     1,  0,  2,  1,  4,  3,  5,  4,  7,  6,  8,  7, 10,  9, 11, 10,
+    13, 12, 14, 13, 16, 15, 17, 16, 19, 18, 20, 19, 22, 21, 23, 22,
+    25, 24, 26, 25, 28, 27, 29, 28, 31, 30, 32, 31, 34, 33, 35, 34,
+    37, 36, 38, 37, 40, 39, 41, 40, 43, 42, 44, 43, 46, 45, 47, 46
+};
+
+__attribute__((target("avx512f,avx512bw,avx512vbmi")))
+static size_t Base64DecodeAVX512(uint8_t *out, char const *in, size_t dataLen)
+{
+    //  First 128 entries of decoding table, invalid characters have bit 7 set
+    const __m512i lut0 = _mm512_loadu_si512((const void*)b64DecTable);
+    const __m512i lut1 = _mm512_loadu_si512((const void*)(b64DecTable + 64));
+    const __m512i pack = _mm512_loadu_si512((const void*)b64PackIdx);
+    __mmask64 err = 0;
+    size_t i = 0, o = 0, tail;
+
+    for (; (i + 64) <= dataLen; i += 64, o += 48)
+    {
+        __m512i str = _mm512_loadu_si512((const void*)(in + i));
+        //  Look up low 7 bits, input bytes above 127 are caught by the OR
+        __m512i val = _mm512_permutex2var_epi8(lut0, str, lut1);
+        err |= _mm512_movepi8_mask(_mm512_or_si512(val, str));
+
+        val = _mm512_maddubs_epi16(val, _mm512_set1_epi32(0x01400140));
+        val = _mm512_madd_epi16(val, _mm512_set1_epi32(0x00011000));
+        val = _mm512_permutexvar_epi8(pack, val);
+        _mm512_mask_storeu_epi8((void*)(out + o), 0x0000FFFFFFFFFFFFULL, val);
+    }
+
+    if (err != 0)
+        return BUF_ERROR;
+    if ((tail = Base64DecodeScalar(out + o, in + i, dataLen - i)) == BUF_ERROR)
+        return BUF_ERROR;
+
+    return o + tail;
+}
+
+__attribute__((target("avx512f,avx512bw,avx512vbmi")))
+static size_t Base64EncodeAVX512(char *out, uint8_t const *in, size_t inLen)
+{
+    const __m512i lut = _mm512_loadu_si512((const void*)b64EncTable);
+    const __m512i gather = _mm512_loadu_si512((const void*)b64GatherIdx);
+    //  Bit offsets of 4 digits within each 32-bit lane (two lanes per qword)
+    const __m512i shifts = _mm512_set1_epi64(0x3036242A1016040AULL);
+    size_t i = 0, o = 0;
+
+    //  Masked load reads only the 48 bytes that get encoded
+    for (; (i + 48) <= inLen; i += 48, o += 64)
+    {
+        __m512i x = _mm512_maskz_loadu_epi8(0x0000FFFFFFFFFFFFULL, (const void*)(in + i));
+        x = _mm512_permutexvar_epi8(gather, x);
+        x = _mm512_multishift_epi64_epi8(shifts, x);
+        _mm512_storeu_si512((void*)(out + o), _mm512_permutexvar_epi8(x, lut));
+    }
+
+    return o + Base64EncodeScalar(out + o, in + i, inLen - i);
+}
+/**
+ *  Repeating-key XOR for keys longer than XOR_PATTERN_MAX, text is XORed
+ *  against contiguous runs of the key itself
+ */
+__attribute__((target("avx512f")))
+static size_t RepeatXORLongKeyAVX512(uint8_t *out, uint8_t const *in, size_t inLen,
+                                     uint8_t const *key, size_t keyLen, size_t keyPos)
+{
+    for (size_t i = 0; i < inLen; )
+    {
+        size_t run = ((inLen - i) < (keyLen - keyPos)) ? (inLen - i) : (keyLen - keyPos);
+        size_t j = 0;
+
+        for (; (j + 64) <= run; j += 64)
+        {
+            __m512i t = _mm512_loadu_si512((const void*)(in + i + j));
+            __m512i k = _mm512_loadu_si512((const void*)(key + keyPos + j));
+            _mm512_storeu_si512((void*)(out + i + j), _mm512_xor_si512(t, k));
+        }
+        RepeatXORScalar(out + i + j, in + i + j, run - j, key + keyPos + j, run - j, 0);
+
+        i += run;
+        keyPos += run;
+        if (keyPos == keyLen)
+            keyPos = 0;
+    }
+
+    return keyPos;
+}
+
+/**
+ *  Repeating-key XOR, 64 bytes at the time. Short keys are repeated into a
+ *  pattern from which a whole register of key bytes is loaded at any phase.
+ */
+__attribute__((target("avx512f")))
+static size_t RepeatXORAVX512(uint8_t *out, uint8_t const *in, size_t inLen,
+                              uint8_t const *key, size_t keyLen, size_t keyPos)
+{
+    uint8_t pattern[XOR_PATTERN_MAX + 64];
+    size_t i = 0, step = 64 % keyLen;
+
+    //  Not worth building the pattern for less than a register of text
+    if (inLen < 64)
+        return RepeatXORScalar(out, in, inLen, key, keyLen, keyPos);
+    if (keyLen > XOR_PATTERN_MAX)
+        return RepeatXORLongKeyAVX512(out, in, inLen, key, keyLen, keyPos);
+
+    RepeatXORPattern(pattern, key, keyLen, 64);
+
+    if (step == 0)
+    {
+        //  Key divides the register, the same key bytes apply to every block
+        const __m512i k = _mm512_loadu_si512((const void*)(pattern + keyPos));
+        for (; (i + 256) <= inLen; i += 256)
+        {
+            __m512i a = _mm512_loadu_si512((const void*)(in + i));
+            __m512i b = _mm512_loadu_si512((const void*)(in + i + 64));
+            __m512i c = _mm512_loadu_si512((const void*)(in + i + 128));
+            __m512i d = _mm512_loadu_si512((const void*)(in + i + 192));
+            _mm512_storeu_si512((void*)(out + i), _mm512_xor_si512(a, k));
+            _mm512_storeu_si512((void*)(out + i + 64), _mm512_xor_si512(b, k));
+            _mm512_storeu_si512((void*)(out + i + 128), _mm512_xor_si512(c, k));
+            _mm512_storeu_si512((void*)(out + i + 192), _mm512_xor_si512(d, k));
+        }
+    }
+
+    //  Otherwise key phase moves by the same step for every block
+    for (; (i + 64) <= inLen; i += 64)
+    {
+        __m512i t = _mm512_loadu_si512((const void*)(in + i));
+        __m512i k = _mm512_loadu_si512((const void*)(pattern + keyPos));
+        _mm512_storeu_si512((void*)(out + i), _mm512_xor_si512(t, k));
+        keyPos += step;
+        if (keyPos >= keyLen)
+            keyPos -= keyLen;
+    }
+
+    return RepeatXORScalar(out + i, in + i, inLen - i, key, keyLen, keyPos);
+}
+/**
+ *  XOR 64 HEX digits with 64 key digits, digit by digit
+ */
+__attribute__((target("avx512f,avx512bw")))
+static inline void HexXORBlockAVX512(char *out, char const *in, char const *key,
+                                     __m512i const &lut, __mmask64 &err)
+{
+    __m512i t = HexNibblesAVX512(_mm512_loadu_si512((const void*)in), err);
+    __m512i k = HexNibblesAVX512(_mm512_loadu_si512((const void*)key), err);
+    _mm512_storeu_si512((void*)out, _mm512_shuffle_epi8(lut, _mm512_xor_si512(t, k)));
+}
+
+/**
+ *  XOR HEX digits with repeating key digits, 64 at the time. Short keys are
+ *  repeated into a pattern as for byte XOR, long ones are used directly.
+ */
+__attribute__((target("avx512f,avx512bw")))
+static size_t HexRepeatXORAVX512(char *out, char const *in, size_t inLen,
+                                 char const *key, size_t keyLen, size_t keyPos)
+{
+    const __m512i lut = _mm512_broadcast_i32x4(_mm_loadu_si128((const __m128i*)hexEncTable));
+    char pattern[XOR_PATTERN_MAX + 64];
+    __mmask64 err = 0;
+    size_t i = 0, step = 64 % keyLen;
+
+    if (inLen < 64)
+        return HexRepeatXORScalar(out, in, inLen, key, keyLen, keyPos);
+
+    if (keyLen > XOR_PATTERN_MAX)
+    {
+        //  Key digits are read in place, except where they wrap around
+        while ((i + 64) <= inLen)
+        {
+            if ((keyLen - keyPos) >= 64)
+            {
+                HexXORBlockAVX512(out + i, in + i, key + keyPos, lut, err);
+                i += 64;
+                keyPos += 64;
+            }
+            else
+            {
+                size_t run = keyLen - keyPos;
+                if (HexRepeatXORScalar(out + i, in + i, run, key + keyPos, run, 0) == BUF_ERROR)
+                    return BUF_ERROR;
+                i += run;
+                keyPos += run;
+            }
+            if (keyPos == keyLen)
+                keyPos = 0;
+        }
+    }
+    else
+    {
+        RepeatXORPattern((uint8_t*)pattern, (const uint8_t*)key, keyLen, 64);
+        for (; (i + 64) <= inLen; i += 64)
+        {
+            HexXORBlockAVX512(out + i, in + i, pattern + keyPos, lut, err);
+            keyPos += step;
+            if (keyPos >= keyLen)
+                keyPos -= keyLen;
+        }
+    }
+
+    if (err != 0)
+        return BUF_ERROR;
+
+    return HexRepeatXORScalar(out + i, in + i, inLen - i, key, keyLen, keyPos);
+}
+/**
+ *  Number of differing bits between two buffers, 64 bytes at the time. Tail
+ *  is loaded through a mask, so short blocks take a single iteration.
+ */
+__attribute__((target("avx512f,avx512bw")))
+static size_t HammingAVX512(uint8_t const *a, uint8_t const *b, size_t len)
+{
+    const __m512i lut = _mm512_broadcast_i32x4(_mm_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3,
+                                                             1, 2, 2, 3, 2, 3, 3, 4));
+    const __m512i low = _mm512_set1_epi8(0x0F);
+    __m512i acc = _mm512_setzero_si512();
+
+    for (size_t i = 0; i < len; i += 64)
+    {
+        __mmask64 m = ((len - i) >= 64) ? ~0ULL : ((1ULL << (len - i)) - 1);
+        __m512i x = _mm512_xor_si512(_mm512_maskz_loadu_epi8(m, a + i),
+                                     _mm512_maskz_loadu_epi8(m, b + i));
+        __m512i cnt = _mm512_add_epi8(_mm512_shuffle_epi8(lut, _mm512_and_si512(x, low)),
+                                      _mm512_shuffle_epi8(lut, _mm512_and_si512(_mm512_srli_epi16(x, 4), low)));
+        acc = _mm512_add_epi64(acc, _mm512_sad_epu8(cnt, _mm512_setzero_si512()));
+    }
+
+    return _mm512_reduce_add_epi64(acc);
+}
+
+/**
+ *  Same as HammingAVX512, for CPUs with AVX-512 VPOPCNTDQ extension
+ */
+__attribute__((target("avx512f,avx512bw,avx512vpopcntdq")))
+static size_t HammingVPOPCNT(uint8_t const *a, uint8_t const *b, size_t len)
+{
+    __m512i acc = _mm512_setzero_si512();
+
+    for (size_t i = 0; i < len; i += 64)
+    {
+        __mmask64 m = ((len - i) >= 64) ? ~0ULL : ((1ULL << (len - i)) - 1);
+        __m512i x = _mm512_xor_si512(_mm512_maskz_loadu_epi8(m, a + i),
+                                     _mm512_maskz_loadu_epi8(m, b + i));
+        acc = _mm512_add_epi64(acc, _mm512_popcnt_epi64(x));
+    }
+
+    return _mm512_reduce_add_epi64(acc);
+}
+
+/**
+ *  Number of bytes in a set given by nibble rows, 64 bytes at the time. Tail
+ *  is loaded through a mask, so short strings take a single iteration.
+ */
+__attribute__((target("avx512f,avx512bw,popcnt")))
+static size_t ByteSetCountAVX512(uint8_t const *in, size_t len, uint8_t const *rows,
+                                 bool high)
+{
+    const __m512i rowLUT = _mm512_broadcast_i32x4(_mm_loadu_si128((const __m128i*)rows));
+    const __m512i bitLUT = _mm512_broadcast_i32x4(_mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128,
+                                                                0, 0, 0, 0, 0, 0, 0, 0));
+    const __m512i low = _mm512_set1_epi8(0x0F);
+    size_t count = 0;
+
+    for (size_t i = 0; i < len; i += 64)
+    {
+        __mmask64 m = ((len - i) >= 64) ? ~0ULL : ((1ULL << (len - i)) - 1);
+        __m512i v = _mm512_maskz_loadu_epi8(m, in + i);
+        __m512i bit = _mm512_shuffle_epi8(bitLUT, _mm512_and_si512(_mm512_srli_epi16(v, 4), low));
+        __mmask64 hits = _mm512_test_epi8_mask(_mm512_shuffle_epi8(rowLUT, v), bit);
+        if (high)
+            hits |= _mm512_movepi8_mask(v);
+        count += _mm_popcnt_u64(hits & m);
+    }
+
+    return count;
+}
+
+/**
+ *  Scores of all single-byte XOR keys, 8 keys at the time. All 256 scores are
+ *  kept in registers while rows of all ciphertext bytes are added to them.
+ */
+__attribute__((target("avx512f")))
+static void XORKeyScoresAVX512(double *score, uint64_t const *hist, double const *rows)
+{
+    __m512d acc[32];
+
+    for (size_t i = 0; i < 32; i++)
+        acc[i] = _mm512_loadu_pd(score + 8*i);
+
+    for (size_t c = 0; c < 256; c++)
+    {
+        if (hist[c] == 0)
+            continue;
+
+        double const *row = rows + 256*(c & 0x0F);
+        __m512d weight = _mm512_set1_pd((double)hist[c]);
+        for (size_t kh = 0; kh < 16; kh++)
+        {
+            double const *src = row + 16*((c >> 4) ^ kh);
+            acc[2*kh] = _mm512_fmadd_pd(weight, _mm512_loadu_pd(src), acc[2*kh]);
+            acc[2*kh+1] = _mm512_fmadd_pd(weight, _mm512_loadu_pd(src + 8), acc[2*kh+1]);
+        }
+    }
+
+    for (size_t i = 0; i < 32; i++)
+        _mm512_storeu_pd(score + 8*i, acc[i]);
+}
+
+/**
+ *  Transpose four 16x16 tiles of bytes, one in every 128-bit lane
+ */
+__attribute__((target("avx512f,avx512bw")))
+static inline void Transpose16AVX512(__m512i *r)
+{
+    __m512i t[16];
+
+    for (size_t round = 0; round < 4; round++)
+    {
+        for (size_t i = 0; i < 8; i++)
+        {
+            t[2*i] = _mm512_unpacklo_epi8(r[i], r[i+8]);
+            t[2*i+1] = _mm512_unpackhi_epi8(r[i], r[i+8]);
+        }
+        for (size_t i = 0; i < 16; i++)
+            r[i] = t[i];
+    }
+}
+
+/**
+ *  Split k-byte rows into columns, in tiles of 64 rows by 16 columns, so that
+ *  every column gets a whole cache line
+ */
+__attribute__((target("avx512f,avx512bw")))
+static void TransposeAVX512(uint8_t *out, uint8_t const *in, size_t len, size_t k)
+{
+    size_t stride = (len + k - 1) / k, rows = TransposeVectorRows(len, k, 64);
+    __m512i r[16];
+
+    for (size_t r0 = 0; r0 < rows; r0 += 64)
+        for (size_t j0 = 0; j0 < k; j0 += 16)
+        {
+            for (size_t i = 0; i < 16; i++)
+            {
+                uint8_t const *row = in + (r0 + i)*k + j0;
+                r[i] = _mm512_castsi128_si512(_mm_loadu_si128((const __m128i*)row));
+                r[i] = _mm512_inserti32x4(r[i], _mm_loadu_si128((const __m128i*)(row + 16*k)), 1);
+                r[i] = _mm512_inserti32x4(r[i], _mm_loadu_si128((const __m128i*)(row + 32*k)), 2);
+                r[i] = _mm512_inserti32x4(r[i], _mm_loadu_si128((const __m128i*)(row + 48*k)), 3);
+            }
+            Transpose16AVX512(r);
+            for (size_t c = 0; (c < 16) && ((j0 + c) < k); c++)
+                _mm512_storeu_si512(out + (j0 + c)*stride + r0, r[c]);
+        }
+
+    TransposeRowsScalar(out, in, len, k, rows);
+}
+
+/**
+ *  Reassemble k-byte rows from columns, in tiles of 64 rows by 16 columns
+ *  (see UntransposeSSSE3 for order of column blocks)
+ */
+__attribute__((target("avx512f,avx512bw")))
+static void UntransposeAVX512(uint8_t *out, uint8_t const *in, size_t len, size_t k)
+{
+    size_t stride = (len + k - 1) / k, rows = TransposeVectorRows(len, k, 64);
+    size_t lastBlock = ((k - 1) / 16) * 16;
+    __m512i r[16];
+
+    for (size_t r0 = 0; r0 < rows; r0 += 64)
+        for (size_t b = 0; b <= lastBlock; b += 16)
+        {
+            size_t j0 = (b == 0) ? lastBlock : (b - 16);
+            for (size_t c = 0; c < 16; c++)
+                r[c] = ((j0 + c) < k) ? _mm512_loadu_si512(in + (j0 + c)*stride + r0)
+                                      : _mm512_setzero_si512();
+            Transpose16AVX512(r);
+            for (size_t i = 0; i < 16; i++)
+                _mm_storeu_si128((__m128i*)(out + (r0 + i)*k + j0), _mm512_castsi512_si128(r[i]));
+            for (size_t i = 0; i < 16; i++)
+                _mm_storeu_si128((__m128i*)(out + (r0 + 16 + i)*k + j0), _mm512_extracti32x4_epi32(r[i], 1));
+            for (size_t i = 0; i < 16; i++)
+                _mm_storeu_si128((__m128i*)(out + (r0 + 32 + i)*k + j0), _mm512_extracti32x4_epi32(r[i], 2));
+            for (size_t i = 0; i < 16; i++)
+                _mm_storeu_si128((__m128i*)(out + (r0 + 48 + i)*k + j0), _mm512_extracti32x4_epi32(r[i], 3));
+        }
+
+    UntransposeRowsScalar(out, in, len, k, rows);
+}
+
+/**
+ *  Windows of crib matching the set, 64 offsets at the time, which is also
+ *  one whole word of the output
+ */
+__attribute__((target("avx512f,avx512bw")))
+static void CribMatchAVX512(uint64_t *match, uint8_t const *x, size_t n,
+                            uint8_t const *crib, size_t cribLen,
+                            uint8_t const *rows, bool high, uint8_t maxMiss)
+{
+    const __m512i rowLUT = _mm512_broadcast_i32x4(_mm_loadu_si128((const __m128i*)rows));
+    const __m512i bitLUT = _mm512_broadcast_i32x4(_mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128,
+                                                                0, 0, 0, 0, 0, 0, 0, 0));
+    const __m512i low = _mm512_set1_epi8(0x0F), one = _mm512_set1_epi8(1);
+    const __m512i limit = _mm512_set1_epi8(maxMiss);
+    size_t o = 0;
+
+    for (; (o + 64) <= n; o += 64)
+    {
+        __m512i miss = _mm512_setzero_si512();
+        __mmask64 alive = ~0ULL;
+
+        for (size_t i = 0; (i < cribLen) && alive; i++)
+        {
+            __m512i v = _mm512_xor_si512(_mm512_loadu_si512(x + o + i),
+                                         _mm512_set1_epi8(crib[i]));
+            __m512i bit = _mm512_shuffle_epi8(bitLUT, _mm512_and_si512(_mm512_srli_epi16(v, 4), low));
+            __mmask64 hit = _mm512_test_epi8_mask(_mm512_shuffle_epi8(rowLUT, v), bit);
+            if (high)
+                hit |= _mm512_movepi8_mask(v);
+            miss = _mm512_mask_adds_epu8(miss, ~hit, miss, one);
+            alive = _mm512_cmple_epu8_mask(miss, limit);
+        }
+
+        match[o >> 6] = alive;
+    }
+
+    CribMatchRangeScalar(match, x, n, crib, cribLen, rows, high, maxMiss, o);
+}
+#endif  /* SIMD_X86 */
+
+//------------------------------------------------------------------------------
+//      Runtime dispatch                                               [PRIVATE]
+//------------------------------------------------------------------------------
+struct Kernels
+{
+    size_t (*hexDecode)(uint8_t*, char const*, size_t);
+    size_t (*hexEncode)(char*, uint8_t const*, size_t);
+    size_t (*b64Decode)(uint8_t*, char const*, size_t);
+    size_t (*b64Encode)(char*, uint8_t const*, size_t);
+    size_t (*repeatXOR)(uint8_t*, uint8_t const*, size_t, uint8_t const*, size_t, size_t);
+    size_t (*hexRepeatXOR)(char*, char const*, size_t, char const*, size_t, size_t);
+    size_t (*hamming)(uint8_t const*, uint8_t const*, size_t);
+    size_t (*byteSetCount)(uint8_t const*, size_t, uint8_t const*, bool);
+    void   (*xorKeyScores)(double*, uint64_t const*, double const*);
+    void   (*transpose)(uint8_t*, uint8_t const*, size_t, size_t);
+    void   (*untranspose)(uint8_t*, uint8_t const*, size_t, size_t);
+    void   (*cribMatch)(uint64_t*, uint8_t const*, size_t, uint8_t const*, size_t,
+                        uint8_t const*, bool, uint8_t);
+};
+
+//  Kernels indexed by SIMD_* level
+static const Kernels kernelTable[] =
+{
+    { HexDecodeScalar, HexEncodeScalar, Base64DecodeScalar, Base64EncodeScalar,
+      RepeatXORScalar, HexRepeatXORScalar, HammingScalar, ByteSetCountScalar,
+      XORKeyScoresScalar,
+      TransposeScalar, UntransposeScalar,
+      CribMatchScalar },
+#ifdef SIMD_X86
+    { HexDecodeSSSE3,  HexEncodeSSSE3,  Base64DecodeSSSE3,  Base64EncodeSSSE3,
+      RepeatXORSSSE3, HexRepeatXORSSSE3, HammingSSSE3, ByteSetCountSSSE3,
+      XORKeyScoresSSSE3,
+      TransposeSSSE3, UntransposeSSSE3,
+      CribMatchSSSE3 },
+    { HexDecodeAVX2,   HexEncodeAVX2,   Base64DecodeAVX2,   Base64EncodeAVX2,
+      RepeatXORAVX2, HexRepeatXORAVX2, HammingAVX2, ByteSetCountAVX2,
+      XORKeyScoresAVX2,
+      TransposeAVX2, UntransposeAVX2,
+      CribMatchAVX2 },
+    { HexDecodeAVX512, HexEncodeAVX512, Base64DecodeAVX512, Base64EncodeAVX512,
+      RepeatXORAVX512, HexRepeatXORAVX512, HammingAVX512, ByteSetCountAVX512,
+      XORKeyScoresAVX512,
+      TransposeAVX512, UntransposeAVX512,
+      CribMatchAVX512 },
+#endif
+};
+
+/**
+ *  Query CPUID for the highest level all kernels can run on
+ */
+static uint8_t DetectLevel()
+{
+#ifdef SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") &&
+        __builtin_cpu_supports("avx512vbmi"))
+        return SIMD_AVX512;
+    if (__builtin_cpu_supports("avx2"))
+        return SIMD_AVX2;
+    if (__builtin_cpu_supports("ssse3"))
+        return SIMD_SSSE3;
+#endif
+    return SIMD_SCALAR;
+}
+
+/**
+ *  Level of kernels in use, initialized on first use to the supported one
+ */
+static std::atomic<uint8_t> &ActiveLevel()
+{
+    static std::atomic<uint8_t> level(SIMDSupportedLevel());
+    return level;
+}
+
+static inline const Kernels &Active()
+{
+    return kernelTable[ActiveLevel().load(std::memory_order_relaxed)];
+}
+
+/**
+ *  AVX-512 VPOPCNTDQ is not required by SIMD_AVX512 level, kernels using it
+ *  are picked on top of that level when CPU has it
+ */
+static bool HasVPOPCNT()
+{
+#ifdef SIMD_X86
+    static const bool has = __builtin_cpu_supports("avx512vpopcntdq");
+    return has;
+#else
+    return false;
+#endif
+}
+
+//------------------------------------------------------------------------------
+//      Kernel level selection                                          [PUBLIC]
+//------------------------------------------------------------------------------
+/**
+ *  Highest instruction set level supported by this CPU (from CPUID)
+ *  @return One of SIMD_* macros
+ */
+uint8_t SIMDSupportedLevel()
+{
+    static const uint8_t level = DetectLevel();
+    return level;
+}
+
+/**
+ *  Instruction set level of kernels currently in use
+ *  @return One of SIMD_* macros
+ */
+uint8_t SIMDLevel()
+{
+    return ActiveLevel().load();
+}
+
+/**
+ *  Force kernels of a given level to be used, level is capped to the one
+ *  supported by the CPU
+ *  @param level One of SIMD_* macros
+ *  @return Level that has actually been selected
+ */
+uint8_t SIMDSetLevel(uint8_t level)
+{
+    if (level > SIMDSupportedLevel())
+        level = SIMDSupportedLevel();
+
+    ActiveLevel().store(level);
+    return level;
+}
+
+//------------------------------------------------------------------------------
+//      HEX and Base64 codecs                                           [PUBLIC]
+//------------------------------------------------------------------------------
+/**
+ *  Decode HEX string into bytes (both upper and lower case digits accepted)
+ *  @param out Output buffer, has to hold at least inLen/2 bytes
+ *  @param in Input HEX string
+ *  @param inLen Length of input, has to be even
+ *  @return Number of bytes written; BUF_ERROR on odd length or invalid digit
+ */
+size_t SIMDHexDecode(uint8_t *out, char const *in, size_t inLen)
+{
+    if ((inLen % 2) != 0)
+        return BUF_ERROR;
+
+    return Active().hexDecode(out, in, inLen);
+}
+
+/**
+ *  Encode bytes as lower case HEX string
+ *  @param out Output buffer, has to hold at least 2*inLen chars
+ *  @param in Input bytes
+ *  @param inLen Number of input bytes
+ *  @return Number of chars written
+ */
+size_t SIMDHexEncode(char *out, uint8_t const *in, size_t inLen)
+{
+    return Active().hexEncode(out, in, inLen);
+}
+
+/**
+ *  Decode Base64 string into bytes. Up to two '=' padding chars at the end of
+ *  input are accepted but not required.
+ *  @param out Output buffer, has to hold at least ((inLen+3)/4)*3 bytes
+ *  @param in Input Base64 string
+ *  @param inLen Length of input
+ *  @return Number of bytes written; BUF_ERROR on invalid length or digit
+ */
+size_t SIMDBase64Decode(uint8_t *out, char const *in, size_t inLen)
+{
+    //  Strip padding, kernels only see the data part
+    for (uint8_t b64Pad = 0; (b64Pad < 2) && (inLen > 0) && (in[inLen-1] == '='); b64Pad++)
+        inLen--;
+
+    return Active().b64Decode(out, in, inLen);
+}
+
+/**
+ *  Encode bytes as padded Base64 string
+ *  @param out Output buffer, has to hold at least ((inLen+2)/3)*4 chars
+ *  @param in Input bytes
+ *  @param inLen Number of input bytes
+ *  @return Number of chars written
+ */
+size_t SIMDBase64Encode(char *out, uint8_t const *in, size_t inLen)
+{
+    return Active().b64Encode(out, in, inLen);
+}
+
+//------------------------------------------------------------------------------
+//      XOR                                                             [PUBLIC]
+//------------------------------------------------------------------------------
+/**
+ *  XOR input with a repeating key, without expanding the key to the length of
+ *  input. Can be called on consecutive chunks of input by passing returned key
+ *  position to the next call.
+ *  @param out Output buffer, has to hold at least inLen bytes, may be in
+ *  @param in Input bytes
+ *  @param inLen Number of input bytes
+ *  @param key Key bytes
+ *  @param keyLen Length of key, non-zero
+ *  @param keyPos Position in key to apply to the first input byte
+ *  @return Key position following the last input byte; BUF_ERROR on empty key
+ */
+size_t SIMDRepeatXOR(uint8_t *out, uint8_t const *in, size_t inLen,
+                     uint8_t const *key, size_t keyLen, size_t keyPos)
+{
+    if (keyLen == 0)
+        return BUF_ERROR;
+
+    return Active().repeatXOR(out, in, inLen, key, keyLen, keyPos % keyLen);
+}
+
+/**
+ *  XOR HEX digits with repeating HEX key digits, digit by digit, without
+ *  decoding them into bytes first. Output digits are lower case.
+ *  @param out Output buffer, has to hold at least inLen chars, may be in
+ *  @param in Input HEX digits
+ *  @param inLen Number of input digits
+ *  @param key Key HEX digits
+ *  @param keyLen Number of key digits, non-zero
+ *  @param keyPos Position in key to apply to the first input digit
+ *  @return Key position following the last input digit; BUF_ERROR on empty
+ *  key or invalid digit
+ */
+size_t SIMDHexRepeatXOR(char *out, char const *in, size_t inLen,
+                        char const *key, size_t keyLen, size_t keyPos)
+{
+    if (keyLen == 0)
+        return BUF_ERROR;
+
+    return Active().hexRepeatXOR(out, in, inLen, key, keyLen, keyPos % keyLen);
+}
+
+//------------------------------------------------------------------------------
+//      Bit counting                                                    [PUBLIC]
+//------------------------------------------------------------------------------
+/**
+ *  Hamming distance (number of differing bits) between two buffers
+ *  @param a First buffer
+ *  @param b Second buffer
+ *  @param len Length of both buffers
+ *  @return Number of bits that differ
+ */
+size_t SIMDHamming(uint8_t const *a, uint8_t const *b, size_t len)
+{
+#ifdef SIMD_X86
+    if ((ActiveLevel().load(std::memory_order_relaxed) == SIMD_AVX512) && HasVPOPCNT())
+        return HammingVPOPCNT(a, b, len);
+#endif
+    return Active().hamming(a, b, len);
+}
+
+/**
+ *  Count bytes belonging to a set. Byte b below 0x80 is in the set if bit
+ *  (b >> 4) of rows[b & 0x0F] is set, bytes from 0x80 up if high is true, so
+ *  any set of bytes can be described and tested with two shuffles per vector.
+ *  @param in Input bytes
+ *  @param len Number of input bytes
+ *  @param rows 16 rows of the set, indexed by low nibble of a byte
+ *  @param high Whether bytes from 0x80 up are in the set
+ *  @return Number of input bytes in the set
+ */
+size_t SIMDCountByteSet(uint8_t const *in, size_t len, uint8_t const *rows, bool high)
+{
+    return Active().byteSetCount(in, len, rows, high);
+}
+
+/**
+ *  Add scores of all 256 keys of single-byte XOR, given a table of scores of
+ *  plaintext bytes: score[k] += sum over c of hist[c] * table[c ^ k]
+ *  @param score Scores of keys, 256 elements
+ *  @param hist Histogram of ciphertext bytes, 256 elements
+ *  @param rows 16 copies of the 256-element table, copy l with index XORed by
+ *  l (rows[256*l + i] = table[i ^ l]), so that 16 keys read a contiguous row
+ */
+void SIMDXORKeyScores(double *score, uint64_t const *hist, double const *rows)
+{
+    Active().xorKeyScores(score, hist, rows);
+}
+
+//------------------------------------------------------------------------------
+//      Data layout                                                     [PUBLIC]
+//------------------------------------------------------------------------------
+/**
+ *  Split buffer of k-byte rows into k columns, column j holding bytes j, j+k,
+ *  j+2k... of input, at out + j*stride where stride = ceil(len/k). Cells past
+ *  the end of input (end of shorter columns) are set to 0.
+ *  @param out Output buffer, has to hold at least k*stride bytes
+ *  @param in Input bytes
+ *  @param len Number of input bytes
+ *  @param k Number of columns, non-zero
+ */
+void SIMDTranspose(uint8_t *out, uint8_t const *in, size_t len, size_t k)
+{
+    if ((len > 0) && (k > 0))
+        Active().transpose(out, in, len, k);
+}
+
+/**
+ *  Inverse of SIMDTranspose, reassemble len bytes of k-byte rows from columns
+ *  @param out Output buffer, has to hold at least len bytes
+ *  @param in Columns, k*stride bytes where stride = ceil(len/k)
+ *  @param len Number of bytes to reassemble
+ *  @param k Number of columns, non-zero
+ */
+void SIMDUntranspose(uint8_t *out, uint8_t const *in, size_t len, size_t k)
+{
+    if ((len > 0) && (k > 0))
+        Active().untranspose(out, in, len, k);
+}
+
+//------------------------------------------------------------------------------
+//      Crib dragging                                                   [PUBLIC]
+//------------------------------------------------------------------------------
+/**
+ *  Slide a crib over a buffer and find windows where crib XORed into the
+ *  buffer yields bytes of a set (see SIMDCountByteSet for rows and high),
+ *  allowing up to maxMiss bytes outside of it. Window at offset o covers
+ *  x[o, o + cribLen).
+ *  @param match Output bitmap, bit o (bit o%64 of word o/64) set if window at
+ *  offset o matches, all ceil(n/64) words are written
+ *  @param x Buffer, n + cribLen - 1 bytes
+ *  @param n Number of offsets
+ *  @param crib Crib bytes
+ *  @param cribLen Length of crib, non-zero
+ *  @param rows 16 rows of the set, indexed by low nibble of a byte
+ *  @param high Whether bytes from 0x80 up are in the set
+ *  @param maxMiss Number of bytes allowed outside of the set, up to 254
+ */
+void SIMDCribMatch(uint64_t *match, uint8_t const *x, size_t n, uint8_t const *crib,
+                   size_t cribLen, uint8_t const *rows, bool high, uint8_t maxMiss)
+{
+    memset(match, 0, ((n + 63) / 64) * sizeof(uint64_t));
+    if ((n == 0) || (cribLen == 0))
+        return;
+    if (maxMiss > 254)
+        maxMiss = 254;
+
+    Active().cribMatch(match, x, n, crib, cribLen, rows, high, maxMiss);
+}
@@ -0,0 +1,176 @@
+/**
+ *    Vectorized kernels used by the rest of mycrypto library
+ *    All kernels work on raw buffers. Each of them has a scalar reference
+ *    implementation and SSSE3/AVX2/AVX-512 variants, one of which is selected
+ *    at runtime based on features reported by CPUID.
+ *
+ *    Created: 17. Oct 2026.
+ *    Author: Vedran Mikov
+ */
+#ifndef MYCRYPTO_SIMD_H_
+#define MYCRYPTO_SIMD_H_
+
+#include <cstdint>
+#include <cstddef>
+
+#include "mycrypto-basic.h"
+
+//  Instruction set levels kernels are available in, higher level includes all
+//  lower ones
+#define SIMD_SCALAR     0
+#define SIMD_SSSE3      1
+#define SIMD_AVX2       2
+#define SIMD_AVX512     3   //  AVX-512 F, BW and VBMI
+
+
+/**
+ *  Highest instruction set level supported by this CPU (from CPUID)
+ *  @return One of SIMD_* macros
+ */
+uint8_t SIMDSupportedLevel();
+/**
+ *  Instruction set level of kernels currently in use
+ *  @return One of SIMD_* macros
+ */
+uint8_t SIMDLevel();
+/**
+ *  Force kernels of a given level to be used, mostly for testing and
+ *  benchmarking against the scalar reference. Level is capped to the one
+ *  supported by the CPU.
+ *  @param level One of SIMD_* macros
+ *  @return Level that has actually been selected
+ */
+uint8_t SIMDSetLevel(uint8_t level);
+
+
+/**
+ *  Decode HEX string into bytes (both upper and lower case digits accepted)
+ *  @param out Output buffer, has to hold at least inLen/2 bytes
+ *  @param in Input HEX string
+ *  @param inLen Length of input, has to be even
+ *  @return Number of bytes written; BUF_ERROR on odd length or invalid digit
+ */
+size_t SIMDHexDecode(uint8_t *out, char const *in, size_t inLen);
+/**
+ *  Encode bytes as lower case HEX string
+ *  @param out Output buffer, has to hold at least 2*inLen chars
+ *  @param in Input bytes
+ *  @param inLen Number of input bytes
+ *  @return Number of chars written
+ */
+size_t SIMDHexEncode(char *out, uint8_t const *in, size_t inLen);
+/**
+ *  Decode Base64 string into bytes. Up to two '=' padding chars at the end of
+ *  input are accepted but not required.
+ *  @param out Output buffer, has to hold at least ((inLen+3)/4)*3 bytes
+ *  @param in Input Base64 string
+ *  @param inLen Length of input
+ *  @return Number of bytes written; BUF_ERROR on invalid length or digit
+ */
+size_t SIMDBase64Decode(uint8_t *out, char const *in, size_t inLen);
+/**
+ *  Encode bytes as padded Base64 string
+ *  @param out Output buffer, has to hold at least ((inLen+2)/3)*4 chars
+ *  @param in Input bytes
+ *  @param inLen Number of input bytes
+ *  @return Number of chars written
+ */
+size_t SIMDBase64Encode(char *out, uint8_t const *in, size_t inLen);
+
+
+/**
+ *  XOR input with a repeating key, without expanding the key to the length of
+ *  input. Can be called on consecutive chunks of input by passing returned key
+ *  position to the next call.
+ *  @param out Output buffer, has to hold at least inLen bytes, may be in
+ *  @param in Input bytes
+ *  @param inLen Number of input bytes
+ *  @param key Key bytes
+ *  @param keyLen Length of key, non-zero
+ *  @param keyPos Position in key to apply to the first input byte
+ *  @return Key position following the last input byte; BUF_ERROR on empty key
+ */
+size_t SIMDRepeatXOR(uint8_t *out, uint8_t const *in, size_t inLen,
+                     uint8_t const *key, size_t keyLen, size_t keyPos = 0);
+/**
+ *  XOR HEX digits with repeating HEX key digits, digit by digit, without
+ *  decoding them into bytes first. Output digits are lower case.
+ *  @param out Output buffer, has to hold at least inLen chars, may be in
+ *  @param in Input HEX digits
+ *  @param inLen Number of input digits
+ *  @param key Key HEX digits
+ *  @param keyLen Number of key digits, non-zero
+ *  @param keyPos Position in key to apply to the first input digit
+ *  @return Key position following the last input digit; BUF_ERROR on empty
+ *  key or invalid digit
+ */
+size_t SIMDHexRepeatXOR(char *out, char const *in, size_t inLen,
+                        char const *key, size_t keyLen, size_t keyPos = 0);
+
+/**
+ *  Hamming distance (number of differing bits) between two buffers
+ *  @param a First buffer
+ *  @param b Second buffer
+ *  @param len Length of both buffers
+ *  @return Number of bits that differ
+ */
+size_t SIMDHamming(uint8_t const *a, uint8_t const *b, size_t len);
+/**
+ *  Count bytes belonging to a set. Byte b below 0x80 is in the set if bit
+ *  (b >> 4) of rows[b & 0x0F] is set, bytes from 0x80 up if high is true, so
+ *  any set of bytes can be described and tested with two shuffles per vector.
+ *  @param in Input bytes
+ *  @param len Number of input bytes
+ *  @param rows 16 rows of the set, indexed by low nibble of a byte
+ *  @param high Whether bytes from 0x80 up are in the set
+ *  @return Number of input bytes in the set
+ */
+size_t SIMDCountByteSet(uint8_t const *in, size_t len, uint8_t const *rows, bool high);
+/**
+ *  Add scores of all 256 keys of single-byte XOR, given a table of scores of
+ *  plaintext bytes: score[k] += sum over c of hist[c] * table[c ^ k]
+ *  @param score Scores of keys, 256 elements
+ *  @param hist Histogram of ciphertext bytes, 256 elements
+ *  @param rows 16 copies of the 256-element table, copy l with index XORed by
+ *  l (rows[256*l + i] = table[i ^ l]), so that 16 keys read a contiguous row
+ */
+void SIMDXORKeyScores(double *score, uint64_t const *hist, double const *rows);
+
+/**
+ *  Split buffer of k-byte rows into k columns, column j holding bytes j, j+k,
+ *  j+2k... of input, at out + j*stride where stride = ceil(len/k). Cells past
+ *  the end of input (end of shorter columns) are set to 0.
+ *  @param out Output buffer, has to hold at least k*stride bytes
+ *  @param in Input bytes
+ *  @param len Number of input bytes
+ *  @param k Number of columns, non-zero
+ */
+void SIMDTranspose(uint8_t *out, uint8_t const *in, size_t len, size_t k);
+/**
+ *  Inverse of SIMDTranspose, reassemble len bytes of k-byte rows from columns
+ *  @param out Output buffer, has to hold at least len bytes
+ *  @param in Columns, k*stride bytes where stride = ceil(len/k)
+ *  @param len Number of bytes to reassemble
+ *  @param k Number of columns, non-zero
+ */
+void SIMDUntranspose(uint8_t *out, uint8_t const *in, size_t len, size_t k);
+
+/**
+ *  Slide a crib over a buffer and find windows where crib XORed into the
+ *  buffer yields bytes of a set (see SIMDCountByteSet for rows and high),
+ *  allowing up to maxMiss bytes outside of it. Window at offset o covers
+ *  x[o, o + cribLen).
+ *  @param match Output bitmap, bit o (bit o%64 of word o/64) set if window at
+ *  offset o matches, all ceil(n/64) words are written
+ *  @param x Buffer, n + cribLen - 1 bytes
+ *  @param n Number of offsets
+ *  @param crib Crib bytes
+ *  @param cribLen Length of crib, non-zero
+ *  @param rows 16 rows of the set, indexed by low nibble of a byte
+ *  @param high Whether bytes from 0x80 up are in the set
+ *  @param maxMiss Number of bytes allowed outside of the set, up to 254
+ */
+void SIMDCribMatch(uint64_t *match, uint8_t const *x, size_t n, uint8_t const *crib,
+                   size_t cribLen, uint8_t const *rows, bool high, uint8_t maxMiss);
+
+#endif  /* MYCRYPTO_SIMD_H_ */
@@ -1,6 +1,7 @@
 #define CATCH_CONFIG_MAIN
 
 #include <string>
+#include <cstring>
 
 #include "catch.hpp"
 
@@ -24,3 +25,441 @@ TEST_CASE( "AES CDC encryption/decryption on ASCII, 128b block", "[asciiStr]" )
 }
 
 
+TEST_CASE( "AES-128 context against FIPS-197 example", "[context]" ) {
+    string  key = HexToASCII("000102030405060708090a0b0c0d0e0f"),
+            plain = HexToASCII("00112233445566778899aabbccddeeff"),
+            cipher = HexToASCII("69c4e0d86a7b0430d8cdb78070b4c55a");
+    uint8_t out[AES_ECB_BLOCK_SIZE];
+
+    AES128Context ctx(key);
+    ctx.encryptBlock((const uint8_t*)plain.data(), out);
+    REQUIRE( string((const char*)out, AES_ECB_BLOCK_SIZE) == cipher );
+    ctx.decryptBlock(out, out);
+    REQUIRE( string((const char*)out, AES_ECB_BLOCK_SIZE) == plain );
+
+    //  Bulk calls give the same blocks as single ones, also in place
+    string text;
+    for (uint8_t i = 0; i < 10; i++)
+        text += testCases[i][TC_ASCII];
+    text.resize(text.length() / AES_ECB_BLOCK_SIZE * AES_ECB_BLOCK_SIZE);
+    size_t blocks = text.length() / AES_ECB_BLOCK_SIZE;
+
+    string bulk(text.length(), 0), single(text.length(), 0);
+    ctx.setKey("WogThi85$#22ehwb");
+    ctx.encryptBlocks((const uint8_t*)text.data(), (uint8_t*)&bulk[0], blocks);
+    for (size_t b = 0; b < blocks; b++)
+        ctx.encryptBlock((const uint8_t*)text.data() + b*AES_ECB_BLOCK_SIZE,
+                         (uint8_t*)&single[b*AES_ECB_BLOCK_SIZE]);
+    REQUIRE( bulk == single );
+    REQUIRE( bulk == AESEBCEncryptText("WogThi85$#22ehwb", zeroVect, text).substr(0, text.length()) );
+    ctx.decryptBlocks((const uint8_t*)bulk.data(), (uint8_t*)&bulk[0], blocks);
+    REQUIRE( bulk == text );
+
+    REQUIRE_THROWS( AES128Context("short key") );
+}
+
+TEST_CASE( "AES ECB encryption/decryption with padding", "[asciiStr]" ) {
+    string key("WogThi85$#22ehwb");
+
+    for (uint8_t i = 0; i < 10; i++)
+    {
+        string cipher = AESEBCEncryptText(key, zeroVect, testCases[i][TC_ASCII]);
+        REQUIRE( cipher.length() % AES_ECB_BLOCK_SIZE == 0 );
+        REQUIRE( cipher.length() > testCases[i][TC_ASCII].length() );
+        REQUIRE( AESEBCDecryptText(key, zeroVect, cipher) == testCases[i][TC_ASCII] );
+    }
+
+    //  Whole block of padding after aligned text
+    string aligned(32, 'a');
+    REQUIRE( AESEBCEncryptText(key, zeroVect, aligned).length() == 48 );
+    REQUIRE( AESEBCDecryptText(key, zeroVect, AESEBCEncryptText(key, zeroVect, aligned)) == aligned );
+    REQUIRE_THROWS( AESEBCDecryptText(key, zeroVect, string(20, 'a')) );
+}
+
+TEST_CASE( "AES CBC buffer encryption/decryption", "[buffer]" ) {
+    //  NIST SP 800-38A, F.2.1
+    string  key = HexToASCII("2b7e151628aed2a6abf7158809cf4f3c"),
+            iv = HexToASCII("000102030405060708090a0b0c0d0e0f"),
+            plain = HexToASCII("6bc1bee22e409f96e93d7e117393172aae2d8a571e03ac9c9eb76fac45af8e51"),
+            cipher = HexToASCII("7649abac8119b246cee98e9b12e9197d5086cb9b507219ee95db113a917678b2");
+    AES128Context ctx(key);
+    string out(48, 0);
+
+    //  Aligned text gets a whole block of padding
+    REQUIRE( AESCBCEncryptText(ctx, (const uint8_t*)iv.data(), plain.data(), 32, &out[0], 47) == BUF_ERROR );
+    REQUIRE( AESCBCEncryptText(ctx, (const uint8_t*)iv.data(), plain.data(), 32, &out[0], 48) == 48 );
+    REQUIRE( out.substr(0, 32) == cipher );
+    REQUIRE( AESCBCEncryptText(key, iv, plain) == out );
+    REQUIRE( AESCBCDecryptText(ctx, (const uint8_t*)iv.data(), out.data(), 48, &out[0], 48) == 32 );
+    REQUIRE( out.substr(0, 32) == plain );
+
+    //  Long text crosses decryption chunks, in place and into other buffer
+    string text;
+    for (uint32_t r = 0; r < 100; r++)
+        text += testCases[r % 10][TC_ASCII];
+    string enc = AESCBCEncryptText(key, iv, text), dec(enc.length(), 0);
+    REQUIRE( AESCBCDecryptText(ctx, (const uint8_t*)iv.data(), enc.data(), enc.length(), &dec[0], dec.length()) == text.length() );
+    REQUIRE( dec.substr(0, text.length()) == text );
+    string inPlace = text + string(AES_ECB_BLOCK_SIZE, 0);
+    size_t n = AESCBCEncryptText(ctx, (const uint8_t*)iv.data(), inPlace.data(), text.length(), &inPlace[0], inPlace.length());
+    REQUIRE( inPlace.substr(0, n) == enc );
+    REQUIRE( AESCBCDecryptText(ctx, (const uint8_t*)iv.data(), inPlace.data(), n, &inPlace[0], n) == text.length() );
+    REQUIRE( inPlace.substr(0, text.length()) == text );
+
+    //  Bad length, bad padding
+    REQUIRE( AESCBCDecryptText(ctx, (const uint8_t*)iv.data(), enc.data(), 40, &dec[0], dec.length()) == BUF_ERROR );
+    enc[enc.length() - 20] ^= 0x01;
+    REQUIRE( AESCBCDecryptText(ctx, (const uint8_t*)iv.data(), enc.data(), enc.length(), &dec[0], dec.length()) == BUF_ERROR );
+    REQUIRE( AESCBCDecryptText(key, iv, enc).length() == enc.length() );
+    REQUIRE_THROWS( AESCBCDecryptText(key, iv, enc.substr(1)) );
+}
+
+TEST_CASE( "Native AES engines against OpenSSL", "[engine]" ) {
+    uint8_t engines[] = { AES_ENGINE_AESNI, AES_ENGINE_TTABLE, AES_ENGINE_BITSLICE,
+                          AES_ENGINE_HYBRID };
+    string text;
+    for (uint32_t r = 0; r < 20; r++)
+        text += testCases[r % 10][TC_ASCII];
+
+    REQUIRE( AESEngineSupported(AES_ENGINE_OPENSSL) );
+    REQUIRE( AESEngine() != AES_ENGINE_AUTO );
+
+    for (uint8_t e : engines)
+    {
+        if (!AESEngineSupported(e))
+        {
+            REQUIRE_THROWS( AES128Context(e) );
+            continue;
+        }
+
+        for (uint8_t k = 0; k < 4; k++)
+        {
+            string key = text.substr(k * 37, AES_ECB_BLOCK_SIZE);
+            AES128Context native(key, e), reference(key, AES_ENGINE_OPENSSL);
+            REQUIRE( native.engine() == e );
+
+            //  Every block count up to a few full batches, to cover leftovers
+            for (size_t blocks = 1; blocks <= 27; blocks++)
+            {
+                size_t len = blocks * AES_ECB_BLOCK_SIZE;
+                string a(len, 0), b(len, 0);
+
+                native.encryptBlocks((const uint8_t*)text.data() + k, (uint8_t*)&a[0], blocks);
+                reference.encryptBlocks((const uint8_t*)text.data() + k, (uint8_t*)&b[0], blocks);
+                REQUIRE( a == b );
+
+                native.decryptBlocks((const uint8_t*)text.data() + k, (uint8_t*)&a[0], blocks);
+                reference.decryptBlocks((const uint8_t*)text.data() + k, (uint8_t*)&b[0], blocks);
+                REQUIRE( a == b );
+            }
+
+            //  Single blocks, as used by CBC encryption and CTR tails
+            for (size_t i = 0; i < 5; i++)
+            {
+                uint8_t const *in = (const uint8_t*)text.data() + 16 * i + k;
+                uint8_t a[AES_ECB_BLOCK_SIZE], b[AES_ECB_BLOCK_SIZE];
+
+                native.encryptBlock(in, a);
+                reference.encryptBlock(in, b);
+                REQUIRE( memcmp(a, b, AES_ECB_BLOCK_SIZE) == 0 );
+
+                native.decryptBlock(in, a);
+                reference.decryptBlock(in, b);
+                REQUIRE( memcmp(a, b, AES_ECB_BLOCK_SIZE) == 0 );
+            }
+
+            //  CBC encryption chains single blocks
+            string a((text.length() / 16 + 1) * 16, 0), b(a.length(), 0);
+            size_t aLen = AESCBCEncryptText(native, (const uint8_t*)key.data(), text.data(),
+                                            text.length(), &a[0], a.length());
+            size_t bLen = AESCBCEncryptText(reference, (const uint8_t*)key.data(), text.data(),
+                                            text.length(), &b[0], b.length());
+            REQUIRE( aLen == bLen );
+            REQUIRE( a == b );
+
+            //  Text functions select engine
+            string cipher = AESEBCEncryptText(key, zeroVect, text, e);
+            REQUIRE( cipher == AESEBCEncryptText(key, zeroVect, text, AES_ENGINE_OPENSSL) );
+            REQUIRE( AESEBCDecryptText(key, zeroVect, cipher, e) == text );
+        }
+    }
+
+    //  Default engine can be changed and restored. Without AES-NI it is the
+    //  hybrid one, so that short calls don't pay for a full bitsliced group.
+    uint8_t def = AESEngine();
+    REQUIRE( def == (AESEngineSupported(AES_ENGINE_AESNI) ? AES_ENGINE_AESNI
+                                                          : AES_ENGINE_HYBRID) );
+    REQUIRE( AESSetEngine(AES_ENGINE_OPENSSL) == AES_ENGINE_OPENSSL );
+    REQUIRE( AES128Context().engine() == AES_ENGINE_OPENSSL );
+    REQUIRE( AESSetEngine(AES_ENGINE_AUTO) == def );
+    REQUIRE( AESSetEngine(200) == def );
+}
+
+TEST_CASE( "Parallel AES CBC decryption", "[buffer]" ) {
+    //  A few chunks of a megabyte and a partial one, split between threads
+    string text(3 * 1048576 + 1000, 0), iv = "YELLOW SUBMARINE";
+    for (size_t i = 0; i < text.length(); i++)
+        text[i] = (char)(i * 131 + (i >> 12));
+    uint8_t engines[] = { AES_ENGINE_OPENSSL, AES_ENGINE_AESNI, AES_ENGINE_BITSLICE,
+                          AES_ENGINE_HYBRID };
+
+    for (uint8_t e : engines)
+    {
+        if (!AESEngineSupported(e))
+            continue;
+
+        AES128Context ctx("Key of 16 bytes!", e), copy(ctx), empty(e);
+        string cipher(text.length() + AES_ECB_BLOCK_SIZE, 0), plain(cipher);
+        size_t n = AESCBCEncryptText(ctx, (uint8_t const*)iv.data(), text.data(),
+                                     text.length(), &cipher[0], cipher.length());
+
+        //  Copy of a context has the same key, copy of one without key can
+        //  still be keyed
+        AES128Context emptyCopy(empty);
+        emptyCopy.setKey("Key of 16 bytes!");
+        uint8_t a[AES_ECB_BLOCK_SIZE], b[AES_ECB_BLOCK_SIZE], c[AES_ECB_BLOCK_SIZE];
+        ctx.encryptBlock((uint8_t const*)iv.data(), a);
+        copy.encryptBlock((uint8_t const*)iv.data(), b);
+        emptyCopy.encryptBlock((uint8_t const*)iv.data(), c);
+        REQUIRE( memcmp(a, b, AES_ECB_BLOCK_SIZE) == 0 );
+        REQUIRE( memcmp(a, c, AES_ECB_BLOCK_SIZE) == 0 );
+
+        for (uint32_t threads = 0; threads <= 5; threads += 2)
+        {
+            REQUIRE( AESCBCDecryptText(ctx, (uint8_t const*)iv.data(), cipher.data(), n,
+                                       &plain[0], plain.length(), threads) == text.length() );
+            REQUIRE( plain.compare(0, text.length(), text) == 0 );
+
+            //  In place, chaining blocks are saved before chunks are overwritten
+            plain = cipher;
+            REQUIRE( AESCBCDecryptText(ctx, (uint8_t const*)iv.data(), plain.data(), n,
+                                       &plain[0], plain.length(), threads) == text.length() );
+            REQUIRE( plain.compare(0, text.length(), text) == 0 );
+        }
+
+        REQUIRE( AESCBCDecryptText("Key of 16 bytes!", iv, cipher.substr(0, n), 4) == text );
+    }
+}
+
+TEST_CASE( "Batch AES CBC encryption", "[buffer]" ) {
+    string text(4000, 0);
+    for (size_t i = 0; i < text.length(); i++)
+        text[i] = (char)(i * 97 + (i >> 5));
+    uint8_t engines[] = { AES_ENGINE_AESNI, AES_ENGINE_TTABLE, AES_ENGINE_OPENSSL };
+    AES128Context *ctx[6];
+    for (uint8_t c = 0; c < 6; c++)
+    {
+        uint8_t e = engines[c % 3];
+        ctx[c] = new AES128Context(text.substr(c * 16, 16), AESEngineSupported(e) ? e : AES_ENGINE_AUTO);
+    }
+
+    //  More jobs than lanes, of very different lengths, so that lanes finish
+    //  at different steps and get refilled
+    const size_t count = 100;
+    vector<AESCBCJob> jobs(count);
+    vector<string> out(count), expected(count);
+    for (size_t j = 0; j < count; j++)
+    {
+        size_t len = (j * j * 7) % 700, off = j * 31;
+        AESCBCJob &job = jobs[j];
+
+        out[j].assign((len / AES_ECB_BLOCK_SIZE + 1) * AES_ECB_BLOCK_SIZE, 0);
+        expected[j] = out[j];
+        job.ctx = ctx[(j % 5 == 0) ? (j % 6) : (2 * (j % 3))];
+        job.iv = (uint8_t const*)text.data() + j;
+        job.text = text.data() + off;
+        job.len = len;
+        job.out = &out[j][0];
+        job.outSize = out[j].length();
+        //  Some jobs in place, and one with an output buffer too small
+        if (j % 7 == 3)
+        {
+            out[j].replace(0, len, text, off, len);
+            job.text = out[j].data();
+        }
+        if (j == 42)
+            job.outSize = len;
+
+        AESCBCEncryptText(*job.ctx, job.iv, text.data() + off, len,
+                          &expected[j][0], expected[j].length());
+    }
+
+    AESCBCEncryptBatch(jobs.data(), count);
+    for (size_t j = 0; j < count; j++)
+    {
+        if (j == 42)
+        {
+            REQUIRE( jobs[j].outLen == BUF_ERROR );
+            continue;
+        }
+        REQUIRE( jobs[j].outLen == out[j].length() );
+        REQUIRE( out[j] == expected[j] );
+    }
+
+    AESCBCEncryptBatch(NULL, 0);
+    for (uint8_t c = 0; c < 6; c++)
+        delete ctx[c];
+}
+
+TEST_CASE( "AES CTR encryption/decryption", "[ctr]" ) {
+    //  Cryptopals set 3 challenge 18
+    string cipher = Base64ToASCII("L77na/nrFsKvynd6HzOoG7GHTLXsTVu9qvY/2syLXzhPweyyMTJULu/6/kXX0KSvoOLSFQ==");
+    string plain = "Yo, VIP Let's kick it Ice, Ice, baby Ice, Ice, baby ";
+    REQUIRE( AESCTRCryptText("YELLOW SUBMARINE", 0, cipher) == plain );
+    REQUIRE( AESCTRCryptText("YELLOW SUBMARINE", 0, plain) == cipher );
+    REQUIRE( AESCTRCryptText("YELLOW SUBMARINE", 1, plain) != cipher );
+    REQUIRE( AESCTRCryptText("YELLOW SUBMARINE", 0, "") == "" );
+
+    //  Long enough for several threads, and for counters past 2^8 and 2^16
+    string text(2 * 1048576 + 333, 0);
+    for (size_t i = 0; i < text.length(); i++)
+        text[i] = (char)(i * 131 + (i >> 9));
+    uint8_t engines[] = { AES_ENGINE_OPENSSL, AES_ENGINE_AESNI, AES_ENGINE_BITSLICE,
+                          AES_ENGINE_HYBRID };
+
+    for (uint8_t e : engines)
+    {
+        if (!AESEngineSupported(e))
+            continue;
+
+        AES128Context ctx("Key of 16 bytes!", e);
+        AES128CTR whole(ctx, 0x0123456789ABCDEFULL, 1);
+        string expected(text.length(), 0);
+        whole.crypt(text.data(), text.length(), &expected[0]);
+        REQUIRE( whole.tell() == text.length() );
+
+        for (uint32_t threads = 0; threads <= 4; threads += 2)
+        {
+            AES128CTR ctr(ctx, 0x0123456789ABCDEFULL, threads);
+            string out(text);
+
+            //  In pieces of odd lengths, in place
+            for (size_t pos = 0, n = 1; pos < out.length(); pos += n, n = n * 7 + 3)
+            {
+                n = min(n, out.length() - pos);
+                ctr.crypt(out.data() + pos, n, &out[pos]);
+            }
+            REQUIRE( out == expected );
+
+            //  Random access, without going through earlier bytes
+            size_t offsets[] = { 1048575, 17, 1500000, 0, text.length() - 5 };
+            for (size_t o : offsets)
+            {
+                string part(5, 0);
+                ctr.seek(o);
+                ctr.crypt(expected.data() + o, 5, &part[0]);
+                REQUIRE( ctr.tell() == o + 5 );
+                REQUIRE( part == text.substr(o, 5) );
+            }
+
+            //  Edit leaves the rest of ciphertext and the offset as they are
+            string edited(expected);
+            REQUIRE( ctr.edit(&edited[0], edited.length(), 1048570, "new text", 8) == 8 );
+            REQUIRE( ctr.tell() == text.length() );
+            ctr.seek(0);
+            ctr.crypt(edited.data(), edited.length(), &edited[0]);
+            REQUIRE( edited.substr(1048570, 8) == "new text" );
+            REQUIRE( edited.compare(0, 1048570, text, 0, 1048570) == 0 );
+            REQUIRE( edited.compare(1048578, string::npos, text, 1048578, string::npos) == 0 );
+            REQUIRE( ctr.edit(&edited[0], 10, 5, "new text", 8) == BUF_ERROR );
+            REQUIRE( ctr.edit(&edited[0], 10, 11, "", 0) == BUF_ERROR );
+        }
+    }
+
+    //  Editing text functions, new text may go past the end
+    REQUIRE( AESCTRCryptText("YELLOW SUBMARINE", 0,
+                             AESCTREditText("YELLOW SUBMARINE", 0, cipher, 4, "DJ")) ==
+             "Yo, DJP Let's kick it Ice, Ice, baby Ice, Ice, baby " );
+    REQUIRE( AESCTRCryptText("YELLOW SUBMARINE", 0,
+                             AESCTREditText("YELLOW SUBMARINE", 0, cipher, plain.length(), "!!")) ==
+             plain + "!!" );
+    REQUIRE_THROWS( AESCTREditText("YELLOW SUBMARINE", 0, cipher, plain.length() + 1, "!") );
+}
+
+/**
+ *  Pass message through a stream in pieces of given lengths (cycled)
+ *  @return Whole output; "ERROR" if update or final failed
+ */
+static string StreamPieces(AES128Stream &stream, string const &in,
+                           size_t const *pieces, size_t count)
+{
+    string retVal;
+    char out[300 + AES_ECB_BLOCK_SIZE];
+
+    for (size_t pos = 0, p = 0; pos < in.length(); p++)
+    {
+        size_t n = min(pieces[p % count], in.length() - pos);
+        size_t written = stream.update(in.data() + pos, n, out, sizeof(out));
+        if (written == BUF_ERROR)
+            return "ERROR";
+        retVal.append(out, written);
+        pos += n;
+    }
+
+    size_t written = stream.final(out, AES_ECB_BLOCK_SIZE);
+    if (written == BUF_ERROR)
+        return "ERROR";
+    return retVal.append(out, written);
+}
+
+TEST_CASE( "Streaming AES encryption/decryption", "[stream]" ) {
+    string key = "YELLOW SUBMARINE", iv = "0123456789abcdef";
+    AES128Context ctx(key);
+    size_t pieces[][4] = { { 1, 1, 1, 1 }, { 15, 17, 16, 3 }, { 300, 1, 32, 64 },
+                           { 16, 16, 16, 16 } };
+
+    for (size_t len = 0; len < 100; len += 7)
+    {
+        string text = testCases[len % 10][TC_ASCII].substr(0, len);
+        string ecb = AESEBCEncryptText(key, zeroVect, text);
+        string cbc = AESCBCEncryptText(key, iv, text);
+        string ctr = AESCTRCryptText(key, 5, text);
+
+        for (size_t p = 0; p < 4; p++)
+        {
+            AES128ECBStream ecbEnc(ctx, true), ecbDec(ctx, false);
+            AES128CBCStream cbcEnc(ctx, (uint8_t const*)iv.data(), true),
+                            cbcDec(ctx, (uint8_t const*)iv.data(), false);
+            AES128CTRStream ctrStream(ctx, 5);
+
+            REQUIRE( StreamPieces(ecbEnc, text, pieces[p], 4) == ecb );
+            REQUIRE( StreamPieces(ecbDec, ecb, pieces[p], 4) == text );
+            REQUIRE( StreamPieces(cbcEnc, text, pieces[p], 4) == cbc );
+            REQUIRE( StreamPieces(cbcDec, cbc, pieces[p], 4) == text );
+            REQUIRE( StreamPieces(ctrStream, text, pieces[p], 4) == ctr );
+            REQUIRE( StreamPieces(ctrStream, ctr, pieces[p], 4) == text );
+
+            //  Streams start over after final
+            REQUIRE( StreamPieces(cbcEnc, text, pieces[p], 4) == cbc );
+            REQUIRE( StreamPieces(ecbDec, ecb, pieces[p], 4) == text );
+        }
+    }
+
+    //  Without padding, messages have to be whole blocks
+    string blocks = testCases[3][TC_ASCII].substr(0, 64);
+    AES128CBCStream raw(ctx, (uint8_t const*)iv.data(), true, false);
+    REQUIRE( StreamPieces(raw, blocks, pieces[1], 4) == AESCBCEncryptText(key, iv, blocks).substr(0, 64) );
+    REQUIRE( StreamPieces(raw, blocks.substr(0, 63), pieces[1], 4) == "ERROR" );
+    REQUIRE( StreamPieces(raw, blocks, pieces[1], 4).length() == 64 );
+
+    //  New initialization vector for the next message
+    raw.init((uint8_t const*)zeroVect.data());
+    REQUIRE( StreamPieces(raw, blocks, pieces[0], 4) ==
+             AESCBCEncryptText(key, zeroVect, blocks).substr(0, 64) );
+
+    //  Invalid padding or truncated ciphertext
+    AES128CBCStream dec(ctx, (uint8_t const*)iv.data(), false);
+    string cbc = AESCBCEncryptText(key, iv, blocks);
+    REQUIRE( StreamPieces(dec, cbc.substr(0, 64), pieces[2], 4) == "ERROR" );
+    REQUIRE( StreamPieces(dec, cbc.substr(0, 70), pieces[2], 4) == "ERROR" );
+    REQUIRE( StreamPieces(dec, cbc, pieces[2], 4) == blocks );
+
+    //  Output buffers too small, nothing is consumed
+    char out[64];
+    AES128ECBStream enc(ctx, true);
+    REQUIRE( enc.update(blocks.data(), 40, out, 31) == BUF_ERROR );
+    REQUIRE( enc.update(blocks.data(), 40, out, 32) == 32 );
+    REQUIRE( enc.final(out, 15) == BUF_ERROR );
+    REQUIRE( enc.final(out, 16) == 16 );
+    REQUIRE( memcmp(out, AESEBCEncryptText(key, zeroVect, blocks.substr(0, 40)).data() + 32, 16) == 0 );
+}
@@ -2,6 +2,12 @@
 
 #include "catch.hpp"
 #include <string>
+#include <cstdlib>
+#include <cstdio>
+#include <new>
+#include <vector>
+#include <algorithm>
+#include <atomic>
 #include "testCases.h"
 
 #include "../mycrypto-basic.h"
@@ -12,6 +18,81 @@
  *  Unit tests for conversion functions in basicFunctions.h file
  */
 
+//  Number of heap allocations made so far, used to check that buffer-oriented
+//  functions never allocate. The whole family of global allocation functions
+//  is replaced, so that every allocation is freed by a matching function.
+//  Worker threads of other tests allocate too, hence the atomic counter.
+static atomic<size_t> allocCount(0);
+
+static void* CountedAlloc(size_t size)
+{
+    allocCount++;
+    return malloc(size ? size : 1);
+}
+
+//  Kept out of line so the compiler never pairs an inlined free() with a
+//  pointer it only knows as coming from operator new
+__attribute__((noinline)) static void ReleaseAlloc(void *p)
+{
+    free(p);
+}
+
+void* operator new(size_t size)
+{
+    void *p = CountedAlloc(size);
+    if (p == NULL)
+        throw bad_alloc();
+    return p;
+}
+
+void* operator new[](size_t size)
+{
+    void *p = CountedAlloc(size);
+    if (p == NULL)
+        throw bad_alloc();
+    return p;
+}
+
+void* operator new(size_t size, nothrow_t const &) noexcept
+{
+    return CountedAlloc(size);
+}
+
+void* operator new[](size_t size, nothrow_t const &) noexcept
+{
+    return CountedAlloc(size);
+}
+
+void operator delete(void *p) noexcept
+{
+    ReleaseAlloc(p);
+}
+
+void operator delete[](void *p) noexcept
+{
+    ReleaseAlloc(p);
+}
+
+void operator delete(void *p, nothrow_t const &) noexcept
+{
+    ReleaseAlloc(p);
+}
+
+void operator delete[](void *p, nothrow_t const &) noexcept
+{
+    ReleaseAlloc(p);
+}
+
+void operator delete(void *p, size_t) noexcept
+{
+    ReleaseAlloc(p);
+}
+
+void operator delete[](void *p, size_t) noexcept
+{
+    ReleaseAlloc(p);
+}
+
 TEST_CASE( "Test HEX to Base64", "[base64Str]" ) {
     for (uint8_t i = 0; i < 10; i++)
         REQUIRE( HexToBase64(testCases[i][TC_HEX]) == testCases[i][TC_BASE64] );
@@ -37,6 +118,23 @@ TEST_CASE( "Test ASCII to Base64", "[base64Str]" ) {
         REQUIRE( ASCIIToBase64(testCases[i][TC_ASCII]) == testCases[i][TC_BASE64] );
 }
 
+TEST_CASE( "Test Base64 to ASCII", "[ASCIIstr]" ) {
+    for (uint8_t i = 0; i < 10; i++)
+        REQUIRE( Base64ToASCII(testCases[i][TC_BASE64]) == testCases[i][TC_ASCII] );
+
+    //  Round trip over all byte values, including those above 127
+    string allBytes;
+    for (uint16_t i = 0; i < 256; i++)
+        allBytes += (char)i;
+    for (uint8_t i = 0; i < 3; i++)
+        REQUIRE( Base64ToASCII(ASCIIToBase64(allBytes.substr(i))) == allBytes.substr(i) );
+
+    //  Malformed inputs
+    REQUIRE( Base64ToASCII("SGVsbG8*") == "ERROR" );
+    REQUIRE( Base64ToASCII("SG=sbG8h") == "ERROR" );
+    REQUIRE( Base64ToASCII("SGVsb") == "ERROR" );
+}
+
 /**
  *  Test Repeating-key XOR in various encodings (this also test Fixed-key XOR
  *  since repeating-key XOR only expands the key and calls fixed-key XOR)
@@ -63,3 +161,705 @@ TEST_CASE( "Test ASCII to Base64", "[base64Str]" ) {
              HexToASCII(HexRepeatKeyXOR(Base64ToHex(testCases[3][TC_BASE64]),
                                         Base64ToHex(testCases[1][TC_BASE64]))) );
 }
+
+/**
+ *  Test streaming encoders/decoders by feeding them the dataset in chunks of
+ *  every possible size, with line breaks inserted into the input
+ */
+
+TEST_CASE( "Test streaming Base64 decoder", "[stream]" ) {
+    Base64Decoder dec;
+
+    for (uint8_t i = 0; i < 10; i++)
+    {
+        //  Wrap input at 7 chars, with mixed LF and CRLF line endings
+        string wrapped;
+        for (uint32_t j = 0; j < testCases[i][TC_BASE64].length(); j += 7)
+            wrapped += testCases[i][TC_BASE64].substr(j, 7) + ((j % 2) ? "\n" : "\r\n");
+
+        for (uint32_t chunk = 1; chunk <= wrapped.length(); chunk++)
+        {
+            string out;
+            for (uint32_t j = 0; j < wrapped.length(); j += chunk)
+                out += dec.update(wrapped.substr(j, chunk));
+            out += dec.finish();
+            REQUIRE( out == testCases[i][TC_ASCII] );
+        }
+    }
+
+    //  Data after padding, invalid character, single leftover digit
+    REQUIRE( dec.update("QQ==\nQUJD") == "ERROR" );
+    dec.reset();
+    REQUIRE( dec.update("QU*D") == "ERROR" );
+    REQUIRE( dec.finish() == "ERROR" );
+    REQUIRE( dec.update("QUJDR") == "ABC" );
+    REQUIRE( dec.finish() == "ERROR" );
+}
+
+TEST_CASE( "Test streaming HEX decoder", "[stream]" ) {
+    HexDecoder dec;
+
+    for (uint8_t i = 0; i < 10; i++)
+    {
+        string wrapped;
+        for (uint32_t j = 0; j < testCases[i][TC_HEX].length(); j += 9)
+            wrapped += testCases[i][TC_HEX].substr(j, 9) + "\n";
+
+        for (uint32_t chunk = 1; chunk <= wrapped.length(); chunk++)
+        {
+            string out;
+            for (uint32_t j = 0; j < wrapped.length(); j += chunk)
+                out += dec.update(wrapped.substr(j, chunk));
+            REQUIRE( dec.finish() == 0 );
+            REQUIRE( out == testCases[i][TC_ASCII] );
+        }
+    }
+
+    REQUIRE( dec.update("4g") == "ERROR" );
+    REQUIRE( dec.finish() == BUF_ERROR );
+    REQUIRE( dec.update("414") == "A" );
+    REQUIRE( dec.finish() == BUF_ERROR );
+}
+
+TEST_CASE( "Test streaming Base64 encoder", "[stream]" ) {
+    Base64Encoder enc;
+
+    for (uint8_t i = 0; i < 10; i++)
+        for (uint32_t chunk = 1; chunk <= testCases[i][TC_ASCII].length(); chunk++)
+        {
+            string out;
+            for (uint32_t j = 0; j < testCases[i][TC_ASCII].length(); j += chunk)
+                out += enc.update(testCases[i][TC_ASCII].substr(j, chunk));
+            out += enc.finish();
+            REQUIRE( out == testCases[i][TC_BASE64] );
+        }
+}
+
+TEST_CASE( "Test memory-mapped files", "[stream]" ) {
+    //  All samples wrapped at 11 chars, mixed LF and CRLF, no final line break
+    string wrapped, joined;
+    for (uint8_t i = 0; i < 10; i++)
+        joined += testCases[i][TC_ASCII];
+    string b64 = ASCIIToBase64(joined);
+    for (uint32_t j = 0; j < b64.length(); j += 11)
+        wrapped += ((j > 0) ? ((j % 2) ? "\n" : "\r\n") : "") + b64.substr(j, 11);
+
+    FILE *f = fopen("mappedTest.tmp", "wb");
+    REQUIRE( f != NULL );
+    fwrite(wrapped.data(), 1, wrapped.length(), f);
+    fclose(f);
+
+    MappedFile file("mappedTest.tmp");
+    REQUIRE( file.isOpen() );
+    REQUIRE( file.size() == wrapped.length() );
+    REQUIRE( string(file.data(), file.size()) == wrapped );
+
+    //  Lines are views into the file, without line breaks
+    char const *line;
+    size_t len, lines = 0;
+    for (uint8_t pass = 0; pass < 2; pass++)
+    {
+        lines = 0;
+        while (file.nextLine(line, len))
+        {
+            REQUIRE( line >= file.data() );
+            REQUIRE( line + len <= file.data() + file.size() );
+            REQUIRE( string(line, len) == b64.substr(lines * 11, 11) );
+            lines++;
+        }
+        REQUIRE( lines == (b64.length() + 10) / 11 );
+        file.rewind();
+    }
+    file.close();
+    REQUIRE( !file.isOpen() );
+    REQUIRE( !file.nextLine(line, len) );
+
+    //  Whole file decoded at once
+    REQUIRE( Base64FileToASCII("mappedTest.tmp") == joined );
+    vector<char> buf((wrapped.length()/4 + 1)*3);
+    REQUIRE( Base64FileToASCII("mappedTest.tmp", buf.data(), buf.size()) == joined.length() );
+    REQUIRE( string(buf.data(), joined.length()) == joined );
+    REQUIRE( Base64FileToASCII("mappedTest.tmp", buf.data(), buf.size() - 1) == BUF_ERROR );
+
+    //  Invalid Base64, empty file, missing file
+    f = fopen("mappedTest.tmp", "wb");
+    fputs("QUJD\nQU*D\n", f);
+    fclose(f);
+    REQUIRE( Base64FileToASCII("mappedTest.tmp") == "ERROR" );
+    f = fopen("mappedTest.tmp", "wb");
+    fclose(f);
+    REQUIRE( file.open("mappedTest.tmp") );
+    REQUIRE( file.size() == 0 );
+    REQUIRE( !file.nextLine(line, len) );
+    REQUIRE( Base64FileToASCII("mappedTest.tmp") == "" );
+    remove("mappedTest.tmp");
+    REQUIRE( !file.open("mappedTest.tmp") );
+    REQUIRE( Base64FileToASCII("mappedTest.tmp") == "ERROR" );
+}
+
+/**
+ *  Test buffer-oriented overloads against their string counterparts, and check
+ *  that they reject output buffers that are too small
+ */
+
+TEST_CASE( "Test buffer conversions", "[buffer]" ) {
+    char out[512];
+
+    for (uint8_t i = 0; i < 10; i++)
+    {
+        string const &ascii = testCases[i][TC_ASCII];
+        string const &b64 = testCases[i][TC_BASE64];
+        string const &hex = testCases[i][TC_HEX];
+        size_t n;
+
+        n = ASCIIToBase64(ascii.data(), ascii.length(), out, sizeof(out));
+        REQUIRE( string(out, n) == b64 );
+        n = ASCIIToHex(ascii.data(), ascii.length(), out, sizeof(out));
+        REQUIRE( string(out, n) == hex );
+        n = Base64ToASCII(b64.data(), b64.length(), out, sizeof(out));
+        REQUIRE( string(out, n) == ascii );
+        n = Base64ToHex(b64.data(), b64.length(), out, sizeof(out));
+        REQUIRE( string(out, n) == hex );
+        n = HexToASCII(hex.data(), hex.length(), out, sizeof(out));
+        REQUIRE( string(out, n) == ascii );
+        n = HexToBase64(hex.data(), hex.length(), out, sizeof(out));
+        REQUIRE( string(out, n) == b64 );
+
+        //  One byte short of required output
+        REQUIRE( ASCIIToBase64(ascii.data(), ascii.length(), out, b64.length()-1) == BUF_ERROR );
+        REQUIRE( ASCIIToHex(ascii.data(), ascii.length(), out, hex.length()-1) == BUF_ERROR );
+        REQUIRE( Base64ToASCII(b64.data(), b64.length(), out, ascii.length()-1) == BUF_ERROR );
+        REQUIRE( Base64ToHex(b64.data(), b64.length(), out, hex.length()-1) == BUF_ERROR );
+        REQUIRE( HexToASCII(hex.data(), hex.length(), out, ascii.length()-1) == BUF_ERROR );
+        REQUIRE( HexToBase64(hex.data(), hex.length(), out, b64.length()-1) == BUF_ERROR );
+    }
+
+    REQUIRE( HexToASCII("4g", 2, out, sizeof(out)) == BUF_ERROR );
+    REQUIRE( Base64ToASCII("SGVsb", 5, out, sizeof(out)) == BUF_ERROR );
+}
+
+TEST_CASE( "Test buffer XOR and padding", "[buffer]" ) {
+    string const &text = testCases[3][TC_ASCII], &key = testCases[4][TC_ASCII];
+    string out(2*text.length(), 0);
+    size_t n;
+
+    n = ASCIIRepeatKeyXOR(text.data(), text.length(), key.data(), key.length(),
+                          &out[0], out.length());
+    REQUIRE( out.substr(0, n) == ASCIIRepeatKeyXOR(text, key) );
+    n = ASCIIFixedXOR(text.data(), text.length(), text.data(), text.length(),
+                      &out[0], out.length());
+    REQUIRE( out.substr(0, n) == string(text.length(), 0) );
+    REQUIRE( ASCIIFixedXOR(text.data(), text.length(), key.data(), key.length(),
+                           &out[0], out.length()) == BUF_ERROR );
+    REQUIRE( ASCIIRepeatKeyXOR(text.data(), text.length(), key.data(), 0,
+                               &out[0], out.length()) == BUF_ERROR );
+
+    //  In-place encryption and decryption
+    string inplace(text);
+    RepeatKeyXOR(inplace.data(), inplace.length(), key.data(), key.length(),
+                 ENC_ASCII, &inplace[0], inplace.length());
+    REQUIRE( inplace == ASCIIRepeatKeyXOR(text, key) );
+    RepeatKeyXOR(inplace.data(), inplace.length(), key.data(), key.length(),
+                 ENC_ASCII, &inplace[0], inplace.length());
+    REQUIRE( inplace == text );
+
+    REQUIRE( PadString("YELLOW SUBMARINE", 20, ENC_ASCII) == "YELLOW SUBMARINE\x04\x04\x04\x04" );
+    REQUIRE( PadString("abcd", 8, ENC_HEX) == "abcd0404" );
+    REQUIRE( PadString("abcd", 8, ENC_BASE64) == "ERROR" );
+    REQUIRE( PadString("abcd", 2, ENC_ASCII) == "ERROR" );
+}
+
+TEST_CASE( "Test Base64 and HEX XOR against ASCII", "[buffer]" ) {
+    //  Long enough for several internal chunks, with a key that doesn't divide
+    //  their size
+    string text, key = "Ice, ice baby!";
+    for (uint32_t i = 0; i < 10000; i++)
+        text += (char)(i * 7 + (i >> 5));
+
+    string b64Text = ASCIIToBase64(text);
+    string expected = ASCIIToBase64(ASCIIRepeatKeyXOR(text, key));
+
+    REQUIRE( RepeatKeyXOR(b64Text, ASCIIToBase64(key), ENC_BASE64) == expected );
+    REQUIRE( FixedKeyXOR(b64Text, ASCIIToBase64(ASCIIRepeatKeyXOR(string(text.length(), 0), key)),
+                         ENC_BASE64) == expected );
+    REQUIRE( FixedKeyXOR(b64Text, ASCIIToBase64(key), ENC_BASE64) == "ERROR" );
+
+    //  Key longer than internal chunks is decoded in pieces
+    string longKey = text.substr(1234, 5000);
+    REQUIRE( RepeatKeyXOR(b64Text, ASCIIToBase64(longKey), ENC_BASE64) ==
+             ASCIIToBase64(ASCIIRepeatKeyXOR(text, longKey)) );
+
+    REQUIRE( HexRepeatKeyXOR(ASCIIToHex(text), ASCIIToHex(key)) ==
+             ASCIIToHex(ASCIIRepeatKeyXOR(text, key)) );
+    REQUIRE( HexFixedXOR("0f1e", "zz00") == "ERROR" );
+
+    for (uint32_t keyLen = 1; keyLen < 8; keyLen++)
+    {
+        string k = key.substr(0, keyLen);
+        REQUIRE( RepeatKeyXOR(testCases[3][TC_BASE64], ASCIIToBase64(k), ENC_BASE64) ==
+                 ASCIIToBase64(ASCIIRepeatKeyXOR(testCases[3][TC_ASCII], k)) );
+    }
+}
+
+TEST_CASE( "Test crack loop does not allocate", "[buffer]" ) {
+    string const &hex = testCases[3][TC_HEX];
+    string cipher(hex.length()/2, 0), plain(hex.length()/2, 0);
+    size_t len, valid = 0, before;
+    uint32_t dist = 0;
+
+    //  Single-byte XOR brute force, the same as done in set 1
+    before = allocCount.load();
+    len = HexToASCII(hex.data(), hex.length(), &cipher[0], cipher.length());
+    for (uint32_t k = 0; k < 256; k++)
+    {
+        char key = k;
+        ASCIIRepeatKeyXOR(cipher.data(), len, &key, 1, &plain[0], plain.length());
+        valid += validASCIIString(plain.data(), len);
+        dist += ASCIIDistHamming(plain.data(), len, cipher.data(), len);
+    }
+    REQUIRE( allocCount.load() == before );
+
+    REQUIRE( len == testCases[3][TC_ASCII].length() );
+    REQUIRE( valid > 0 );
+    REQUIRE( dist > 0 );
+}
+
+TEST_CASE( "Test transposing into key columns", "[buffer]" ) {
+    string const &text = testCases[5][TC_ASCII];
+    string key = "Terminator X";
+    string cipher = ASCIIRepeatKeyXOR(text, key);
+    size_t k = key.length(), stride = (text.length() + k - 1) / k;
+
+    REQUIRE( ASCIITranspose("abcdefg", 3) == string("adgbe\0cf\0", 9) );
+    REQUIRE( ASCIIUntranspose(string("adgbe\0cf\0", 9), 7, 3) == "abcdefg" );
+
+    //  Every column is encrypted with one key byte, decrypting them one by one
+    //  and reassembling gives plaintext back
+    string cols(k*stride, 0), out(text.length(), 0);
+    REQUIRE( ASCIITranspose(cipher.data(), cipher.length(), k, &cols[0], cols.length()) == k*stride );
+    for (size_t j = 0; j < k; j++)
+        ASCIIRepeatKeyXOR(&cols[j*stride], stride, &key[j], 1, &cols[j*stride], stride);
+    REQUIRE( ASCIIUntranspose(cols.data(), cols.length(), text.length(), k, &out[0], out.length()) == text.length() );
+    REQUIRE( out == text );
+
+    REQUIRE( ASCIITranspose(cipher.data(), cipher.length(), k, &cols[0], cols.length() - 1) == BUF_ERROR );
+    REQUIRE( ASCIITranspose(cipher.data(), cipher.length(), 0, &cols[0], cols.length()) == BUF_ERROR );
+    REQUIRE( ASCIIUntranspose(cols.data(), cols.length() - 1, text.length(), k, &out[0], out.length()) == BUF_ERROR );
+    REQUIRE( ASCIIUntranspose(cols.data(), cols.length(), text.length(), k, &out[0], out.length() - 1) == BUF_ERROR );
+    REQUIRE( ASCIITranspose(text, 0) == "ERROR" );
+    REQUIRE( ASCIITranspose("", 4) == "" );
+}
+
+TEST_CASE( "Test Hamming distance", "[hamming]" ) {
+    string a = "this is a test", b = "wokka wokka!!!";
+
+    REQUIRE( ASCIIDistHamming(a, b) == 37 );
+    REQUIRE( HexDistHamming(ASCIIToHex(a), ASCIIToHex(b)) == 37 );
+    REQUIRE( Base64DistHamming(ASCIIToBase64(a), ASCIIToBase64(b)) == 37 );
+    //  Odd number of HEX digits
+    REQUIRE( HexDistHamming(ASCIIToHex(a) + "f", ASCIIToHex(b) + "0") == 41 );
+
+    REQUIRE( ASCIIDistHamming(a, b + "!") == BUF_ERROR );
+    REQUIRE( HexDistHamming("0g", "00") == BUF_ERROR );
+    REQUIRE( Base64DistHamming("QQ==", "QUI=") == BUF_ERROR );
+
+    //  Batch versions match one by one comparison
+    string text = testCases[5][TC_ASCII];
+    size_t blockLen = 7, count = text.length() / blockLen;
+    vector<size_t> batch(count), matrix(count*count);
+
+    REQUIRE( ASCIIDistHammingBatch(a.data(), text.data(), blockLen, blockLen, count, &batch[0]) == count );
+    REQUIRE( ASCIIDistHammingMatrix(text.data(), blockLen, blockLen, count, &matrix[0]) == count*count );
+    for (size_t i = 0; i < count; i++)
+    {
+        REQUIRE( batch[i] == ASCIIDistHamming(a.substr(0, blockLen), text.substr(i*blockLen, blockLen)) );
+        for (size_t j = 0; j < count; j++)
+            REQUIRE( matrix[i*count + j] == ASCIIDistHamming(text.substr(i*blockLen, blockLen),
+                                                             text.substr(j*blockLen, blockLen)) );
+    }
+}
+
+TEST_CASE( "Test repeating-key size estimation", "[hamming]" ) {
+    string text, key = "Terminator X";
+    for (uint8_t i = 0; i < 10; i++)
+        text += testCases[i][TC_ASCII] + " ";
+    string cipher = ASCIIRepeatKeyXOR(text, key);
+
+    vector<KeySizeScore> ranking = EstimateRepeatingKeySize(cipher, 2, 40, 1);
+    REQUIRE( ranking.size() == 39 );
+    REQUIRE( (ranking[0].keySize % key.length()) == 0 );
+    for (size_t i = 0; i < ranking.size(); i++)
+    {
+        REQUIRE( ranking[i].keySize >= 2 );
+        REQUIRE( ranking[i].keySize <= 40 );
+        if (i > 0)
+            REQUIRE( ranking[i-1].score <= ranking[i].score );
+    }
+
+    //  Same result regardless of number of threads
+    vector<KeySizeScore> ranking4 = EstimateRepeatingKeySize(cipher, 2, 40, 4);
+    REQUIRE( ranking4.size() == ranking.size() );
+    for (size_t i = 0; i < ranking.size(); i++)
+    {
+        REQUIRE( ranking4[i].keySize == ranking[i].keySize );
+        REQUIRE( ranking4[i].score == ranking[i].score );
+    }
+
+    //  Key sizes leaving less than two blocks are skipped
+    REQUIRE( EstimateRepeatingKeySize(string("abcdef"), 2, 40).size() == 2 );
+    REQUIRE( EstimateRepeatingKeySize(string("abc"), 2, 40).empty() );
+}
+
+TEST_CASE( "Test repeating-key size estimation from autocorrelation", "[hamming]" ) {
+    string text, key = "Terminator X";
+    for (uint8_t i = 0; i < 10; i++)
+        text += testCases[i][TC_ASCII] + " ";
+    string cipher = ASCIIRepeatKeyXOR(text, key);
+
+    vector<KeySizeScore> ranking = EstimateRepeatingKeySizeIoC(cipher, 2, 40, 1);
+    REQUIRE( ranking.size() == 39 );
+    REQUIRE( ranking[0].keySize == key.length() );
+
+    //  Text made of random words, encrypted with a short and a long key
+    const char *words[] = { "the", "of", "and", "a", "to", "in", "is", "you",
+                            "that", "it", "he", "was", "for", "on", "are",
+                            "as", "with", "his", "they", "I", "at", "be",
+                            "this", "have", "from", "or", "one", "had", "by",
+                            "word", "but", "not", "what", "all", "were" };
+    uint32_t state = 12345;
+    string longText, shortKey, longKey;
+    while (longText.length() < 200000)
+    {
+        state = state * 1103515245 + 12345;
+        longText += string(words[(state >> 16) % 35]) + " ";
+    }
+    for (size_t i = 0; i < 7; i++)
+        shortKey += (char)(i * 131 + 7);
+    for (size_t i = 0; i < 1237; i++)
+        longKey += (char)(i * 131 + 7);
+
+    //  Short key in short text, multiples of it rank right behind it
+    string shortCipher = ASCIIRepeatKeyXOR(longText.substr(0, 3000), shortKey);
+    ranking = EstimateRepeatingKeySizeIoC(shortCipher, 2, 40, 1);
+    REQUIRE( ranking[0].keySize == 7 );
+    for (size_t i = 1; i < 5; i++)
+        REQUIRE( ranking[i].keySize == 7 * (i + 1) );
+
+    //  Key longer than the default range, in long text
+    shortKey.resize(37, 'x');
+    shortCipher = ASCIIRepeatKeyXOR(longText, shortKey);
+    ranking = EstimateRepeatingKeySizeIoC(shortCipher, 2, 40, 2);
+    REQUIRE( ranking[0].keySize == 37 );
+
+    //  Long key over a wide range of key sizes, several threads, score is the
+    //  exact share of equal bytes at every key size
+    string longCipher = ASCIIRepeatKeyXOR(longText, longKey);
+    ranking = EstimateRepeatingKeySizeIoC(longCipher, 2, 3000, 3);
+    REQUIRE( ranking.size() == 2999 );
+    REQUIRE( ranking[0].keySize == longKey.length() );
+    for (size_t i = 0; i < ranking.size(); i += 97)
+    {
+        size_t k = ranking[i].keySize, equal = 0;
+        for (size_t j = 0; (j + k) < longCipher.length(); j++)
+            equal += (longCipher[j] == longCipher[j + k]);
+        REQUIRE( ranking[i].score == (double)equal / (longCipher.length() - k) );
+    }
+
+    //  Few distinct bytes over a wide range of key sizes, counted with FFT
+    string coins, coinKey = string("\x01\x00\x00\x01\x01\x00\x01\x00\x00", 9);
+    for (size_t i = 0; i < 20000; i++)
+    {
+        state = state * 1103515245 + 12345;
+        coins += ((state >> 16) % 5) ? 'a' : 'b';
+    }
+    string coinCipher = ASCIIRepeatKeyXOR(coins, coinKey);
+    ranking = EstimateRepeatingKeySizeIoC(coinCipher, 2, 4000, 2);
+    REQUIRE( ranking.size() == 3999 );
+    REQUIRE( ranking[0].keySize == coinKey.length() );
+    for (size_t i = 0; i < ranking.size(); i += 97)
+    {
+        size_t k = ranking[i].keySize, equal = 0;
+        for (size_t j = 0; (j + k) < coinCipher.length(); j++)
+            equal += (coinCipher[j] == coinCipher[j + k]);
+        REQUIRE( ranking[i].score == (double)equal / (coinCipher.length() - k) );
+    }
+
+    REQUIRE( EstimateRepeatingKeySizeIoC(string("abc"), 2, 40).empty() );
+}
+
+/**
+ *  Character validation as done before class tables, for reference
+ */
+static bool ValidCharReference(char c, bool lc, bool uc, bool num, bool sent,
+                               bool comm, bool spec, bool cont)
+{
+    if ((c > 64) && (c < 91))
+        return uc;
+    else if ((c > 96) && (c < 123))
+        return lc;
+    else if ((c > 47) && (c < 58))
+        return num;
+    else if ((c == 32) || (c == 33) || (c == 34) || (c == 39) || (c == 44) ||
+             (c == 46) || (c == 58) || (c == 59) || (c == 63))
+        return sent;
+    else if (((c > 34) && (c < 44)) || (c == 45) || (c == 47) || (c == 10) || (c == 13))
+        return comm;
+    else if ((c < 32) || (c == 127))
+        return cont;
+    return spec;
+}
+
+TEST_CASE( "Test character classes", "[classes]" ) {
+    string all(256, 0), text;
+    for (size_t i = 0; i < 256; i++)
+        all[i] = (char)i;
+    for (uint8_t i = 0; i < 10; i++)
+        text += testCases[i][TC_ASCII];
+
+    for (uint8_t mask = 0; mask < 128; mask++)
+    {
+        bool f[7];
+        size_t count = 0, textCount = 0;
+        for (uint8_t b = 0; b < 7; b++)
+            f[b] = (mask >> b) & 1;
+
+        for (size_t i = 0; i < 256; i++)
+        {
+            bool valid = ValidCharReference(all[i], f[0], f[1], f[2], f[3], f[4], f[5], f[6]);
+            REQUIRE( validASCIIString(&all[i], 1, f[0], f[1], f[2], f[3], f[4], f[5], f[6]) == valid );
+            REQUIRE( ((ASCIICharClass(all[i]) & mask) != 0) == valid );
+            count += valid;
+        }
+        for (size_t i = 0; i < text.length(); i++)
+            textCount += ValidCharReference(text[i], f[0], f[1], f[2], f[3], f[4], f[5], f[6]);
+
+        REQUIRE( ASCIIClassCount(all, mask) == count );
+        REQUIRE( ASCIIClassCount(text, mask) == textCount );
+        REQUIRE( ASCIIClassRatio(text, mask) == Approx((double)textCount / text.length()) );
+    }
+
+    REQUIRE( ASCIIClassRatio("", 0) == 1.0 );
+    REQUIRE( ASCIIClassRatio(string("abc\x01"), CHAR_TEXT) == 0.75 );
+    REQUIRE( validASCIIString(testCases[3][TC_ASCII]) );
+    REQUIRE( validASCIIString(testCases[3][TC_ASCII] + "\x80") == false );
+}
+
+TEST_CASE( "Test single-byte XOR cracking", "[singleXOR]" ) {
+    //  Histogram matches byte by byte count
+    string text = testCases[5][TC_ASCII];
+    uint64_t hist[256] = { 0 };
+    ByteHistogram(text.data(), text.length(), hist);
+    ByteHistogram(text.data(), 3, hist);
+    for (size_t b = 0; b < 256; b++)
+        REQUIRE( hist[b] == (size_t)(count(text.begin(), text.end(), (char)b) +
+                                     count(text.begin(), text.begin() + 3, (char)b)) );
+
+    for (uint8_t i = 0; i < 10; i++)
+    {
+        if (testCases[i][TC_ASCII].length() < 20)
+            continue;
+        for (size_t k = 0; k < 256; k += 37)
+        {
+            string cipher = ASCIIRepeatKeyXOR(testCases[i][TC_ASCII], string(1, (char)k));
+            vector<SingleByteKey> best = CrackSingleByteXOR(cipher, 5);
+
+            REQUIRE( best.size() == 5 );
+            REQUIRE( best[0].key == k );
+            for (size_t j = 1; j < best.size(); j++)
+                REQUIRE( best[j-1].score >= best[j].score );
+        }
+    }
+
+    //  All keys, distinct
+    vector<SingleByteKey> all = CrackSingleByteXOR(testCases[5][TC_ASCII], 1000);
+    REQUIRE( all.size() == 256 );
+    uint64_t seen[4] = { 0 };
+    for (size_t j = 0; j < all.size(); j++)
+        seen[all[j].key / 64] |= 1ULL << (all[j].key % 64);
+    REQUIRE( (seen[0] & seen[1] & seen[2] & seen[3]) == ~0ULL );
+}
+
+TEST_CASE( "Test bulk single-byte XOR detection", "[singleXOR]" ) {
+    //  Random lines with a few encrypted English ones among them
+    string hexLines, b64Lines;
+    string secret[3] = { testCases[3][TC_ASCII], testCases[5][TC_ASCII],
+                         "Now that the party is jumping" };
+    size_t secretLine[3] = { 17, 1234, 4999 }, s = 0;
+    srand(1357);
+    for (size_t l = 0; l < 5000; l++)
+    {
+        string line(30, 0);
+        if ((s < 3) && (l == secretLine[s]))
+            line = ASCIIRepeatKeyXOR(secret[s], string(1, (char)(s*50 + 1))), s++;
+        else
+            for (size_t i = 0; i < line.length(); i++)
+                line[i] = (char)(rand() & 0xFF);
+        hexLines += ASCIIToHex(line) + ((l % 2) ? "\r\n" : "\n");
+        b64Lines += ASCIIToBase64(line) + "\n";
+    }
+
+    size_t lines = 0;
+    vector<LineKeyScore> best = DetectSingleByteXOR(hexLines.data(), hexLines.length(),
+                                                    ENC_HEX, 3, 1, &lines);
+    REQUIRE( lines == 5000 );
+    REQUIRE( best.size() == 3 );
+    for (size_t i = 0; i < 3; i++)
+    {
+        size_t j = find(secretLine, secretLine + 3, best[i].line) - secretLine;
+        REQUIRE( j < 3 );
+        REQUIRE( best[i].key == j*50 + 1 );
+        REQUIRE( best[i].plain == secret[j] );
+        if (i > 0)
+            REQUIRE( best[i-1].score >= best[i].score );
+    }
+
+    //  Same result for any number of threads and any encoding
+    for (uint32_t threads = 2; threads <= 8; threads *= 2)
+    {
+        vector<LineKeyScore> other = DetectSingleByteXOR(b64Lines.data(), b64Lines.length(),
+                                                         ENC_BASE64, 3, threads, &lines);
+        REQUIRE( lines == 5000 );
+        REQUIRE( other.size() == 3 );
+        for (size_t i = 0; i < 3; i++)
+        {
+            REQUIRE( other[i].line == best[i].line );
+            REQUIRE( other[i].key == best[i].key );
+            REQUIRE( other[i].score == Approx(best[i].score) );
+        }
+    }
+
+    //  From file, last line without new line
+    FILE *f = fopen("detectTest.tmp", "wb");
+    REQUIRE( f != NULL );
+    fwrite(hexLines.data(), 1, hexLines.length() - 1, f);
+    fclose(f);
+    best = DetectSingleByteXOR(string("detectTest.tmp"), ENC_HEX, 1, 3, &lines);
+    remove("detectTest.tmp");
+    REQUIRE( lines == 5000 );
+    REQUIRE( best.size() == 1 );
+
+    DetectSingleByteXOR(string("noSuchFile.tmp"), ENC_HEX, 1, 1, &lines);
+    REQUIRE( lines == BUF_ERROR );
+    REQUIRE( DetectSingleByteXOR("", 0, ENC_HEX, 1, 2, &lines).empty() );
+    REQUIRE( lines == 0 );
+    lines = 1;
+    REQUIRE( DetectSingleByteXOR(hexLines.data(), hexLines.length(), ENC_HEX, 0, 2,
+                                 &lines).empty() );
+    REQUIRE( lines == 0 );
+}
+
+TEST_CASE( "Test breaking repeating-key XOR", "[repkeyXOR]" ) {
+    string text;
+    for (uint8_t i = 0; i < 10; i++)
+        text += testCases[i][TC_ASCII] + " ";
+
+    string keys[] = { "ICE", "Terminator X", "Vanilla" };
+    for (size_t i = 0; i < 3; i++)
+    {
+        string cipher = ASCIIRepeatKeyXOR(text, keys[i]);
+        vector<RepeatingKey> best = BreakRepeatingKeyXOR(cipher, 3, 2, 40, 3, 16, 1);
+
+        REQUIRE( best.size() == 3 );
+        REQUIRE( best[0].key == keys[i] );
+        REQUIRE( best[0].plain == text );
+        for (size_t j = 1; j < best.size(); j++)
+        {
+            REQUIRE( best[j-1].score >= best[j].score );
+            REQUIRE( best[j].key != best[0].key );
+        }
+
+        //  Same result with more threads
+        vector<RepeatingKey> other = BreakRepeatingKeyXOR(cipher, 3, 2, 40, 3, 16, 4);
+        REQUIRE( other.size() == best.size() );
+        for (size_t j = 0; j < best.size(); j++)
+            REQUIRE( other[j].key == best[j].key );
+    }
+
+    //  Long key over a long text, far beyond what enumeration of all
+    //  combinations could handle
+    string longText, longKey = "Play that funky music white boy";
+    for (size_t r = 0; r < 20; r++)
+        longText += text;
+    vector<RepeatingKey> best = BreakRepeatingKeyXOR(ASCIIRepeatKeyXOR(longText, longKey), 1, 2, 40);
+    REQUIRE( best.size() == 1 );
+    REQUIRE( best[0].key == longKey );
+}
+
+/**
+ *  Ordering of crib dragging results, as documented
+ */
+static bool BetterMatchReference(CribMatch const &m1, CribMatch const &m2)
+{
+    return (m1.ratio > m2.ratio) || ((m1.ratio == m2.ratio) && (m1.score > m2.score));
+}
+
+TEST_CASE( "Test crib dragging", "[crib]" ) {
+    const char *words[] = { "the", "of", "and", "a", "to", "in", "is", "you",
+                            "that", "it", "he", "was", "for", "on", "are",
+                            "as", "with", "his", "they", "I", "at", "be",
+                            "this", "have", "from", "or", "one", "had", "by",
+                            "word", "but", "not", "what", "all", "were" };
+    string plain[2], phrase = " two time pads leak ";
+    uint32_t state = 777;
+    for (size_t p = 0; p < 2; p++)
+        while (plain[p].length() < 200000)
+        {
+            state = state * 1103515245 + 12345;
+            plain[p] += string(words[(state >> 16) % 35]) + " ";
+        }
+    //  Across the boundary of first chunk of offsets
+    size_t at = 65530;
+    plain[0].replace(at, phrase.length(), phrase);
+
+    //  XOR of ciphertexts under the same keystream is XOR of plaintexts
+    string stream(plain[0].length(), 0);
+    for (size_t i = 0; i < stream.length(); i++)
+        stream[i] = (char)(i * 2654435761U >> 13);
+    string x = ASCIIFixedXOR(ASCIIFixedXOR(plain[0], stream),
+                             ASCIIFixedXOR(plain[1].substr(0, plain[0].length()), stream));
+
+    vector<string> cribs;
+    for (size_t i = 0; i < 100; i++)
+        cribs.push_back(string(words[i % 35]) + " " + words[(i * 7) % 35] + "\x01zq");
+    cribs.push_back(phrase);
+    cribs.push_back("");
+
+    vector<CribMatch> best = CribDrag(x, cribs, 5, 1.0, CHAR_TEXT, 1);
+    REQUIRE( best.size() == 5 );
+    REQUIRE( best[0].crib == 100 );
+    REQUIRE( best[0].offset == at );
+    REQUIRE( best[0].ratio == 1.0 );
+    REQUIRE( best[0].text == plain[1].substr(at, phrase.length()) );
+    for (size_t i = 1; i < best.size(); i++)
+        REQUIRE( !BetterMatchReference(best[i], best[i-1]) );
+
+    //  Same result with more threads
+    vector<CribMatch> other = CribDrag(x, cribs, 5, 1.0, CHAR_TEXT, 4);
+    REQUIRE( other.size() == best.size() );
+    for (size_t i = 0; i < best.size(); i++)
+    {
+        REQUIRE( other[i].crib == best[i].crib );
+        REQUIRE( other[i].offset == best[i].offset );
+    }
+
+    //  Lower ratio lets through windows with some non-text chars
+    //  (in a class rare enough to get all windows that pass)
+    vector<CribMatch> strict = CribDrag(x, cribs, 100000, 1.0, CHAR_UPPER, 2);
+    vector<CribMatch> loose = CribDrag(x, cribs, 100000, 0.5, CHAR_UPPER, 2);
+    REQUIRE( loose.size() < 100000 );
+    REQUIRE( loose.size() > strict.size() );
+    REQUIRE( loose.back().ratio < 1.0 );
+    for (size_t i = 0; i < loose.size(); i++)
+    {
+        string const &crib = cribs[loose[i].crib];
+        string text = ASCIIFixedXOR(x.substr(loose[i].offset, crib.length()), crib);
+        REQUIRE( loose[i].text == text );
+        REQUIRE( loose[i].ratio == Approx(ASCIIClassRatio(text, CHAR_UPPER)) );
+        REQUIRE( loose[i].ratio >= 0.5 );
+    }
+
+    REQUIRE( CribDrag("", cribs).empty() );
+    REQUIRE( CribDrag(x, vector<string>()).empty() );
+    REQUIRE( CribDrag("abc", vector<string>(1, "abcd")).empty() );
+}
+
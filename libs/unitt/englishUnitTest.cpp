@@ -0,0 +1,141 @@
+#define CATCH_CONFIG_MAIN
+
+#include "catch.hpp"
+#include <string>
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+#include "testCases.h"
+
+#include "../mycrypto-basic.h"
+#include "../mycrypto-english.h"
+
+
+/**
+ *  Unit tests for English language model in mycrypto-english.h file
+ */
+
+TEST_CASE( "Test symbols of n-gram alphabet", "[english]" ) {
+    REQUIRE( EnglishSymbol('a') == 0 );
+    REQUIRE( EnglishSymbol('Z') == 25 );
+    REQUIRE( EnglishSymbol(' ') == 26 );
+    REQUIRE( EnglishSymbol('\t') == 27 );
+    REQUIRE( EnglishSymbol('\n') == 27 );
+    REQUIRE( EnglishSymbol('7') == 28 );
+    REQUIRE( EnglishSymbol('?') == 29 );
+    REQUIRE( EnglishSymbol('#') == 30 );
+    REQUIRE( EnglishSymbol(0x00) == 31 );
+    REQUIRE( EnglishSymbol(0x7F) == 31 );
+    REQUIRE( EnglishSymbol(0xC3) == 31 );
+
+    for (uint32_t c = 0; c < 256; c++)
+        REQUIRE( EnglishSymbol(c) < ENG_SYMBOLS );
+}
+
+TEST_CASE( "Test scoring English text", "[english]" ) {
+    string english = "The quick brown fox jumps over the lazy dog, and then "
+                     "it runs back into the forest where nobody can see it.";
+
+    //  Same characters in reverse order only differ in n-grams
+    string reversed(english.rbegin(), english.rend());
+    REQUIRE( EnglishScore(english) > EnglishScore(reversed) + 0.5 );
+
+    //  Text is far better than noise, or text XORed with a wrong key
+    string noise(english.length(), 0);
+    for (size_t i = 0; i < noise.length(); i++)
+        noise[i] = (char)(i * 131 + 17);
+    REQUIRE( EnglishScore(english) > EnglishScore(noise) + 3.0 );
+    REQUIRE( EnglishScore(english) > EnglishScore(ASCIIRepeatKeyXOR(english, "\x01")) + 1.0 );
+
+    //  Tabs and UTF-8 lower the score of real text, but don't rule it out
+    string tabs = english, utf8 = english;
+    replace(tabs.begin(), tabs.end(), ' ', '\t');
+    utf8.replace(4, 5, "qu\xC3\xA9" "ck");
+    REQUIRE( EnglishScore(tabs) > EnglishScore(noise) + 1.0 );
+    REQUIRE( EnglishScore(utf8) > EnglishScore(english) - 0.5 );
+
+    REQUIRE( EnglishScore("") == 0 );
+    REQUIRE( EnglishScore("a", 1) < 0 );
+    REQUIRE( EnglishScore("an", 2) < 0 );
+}
+
+TEST_CASE( "Test scoring plaintext under XOR key", "[english]" ) {
+    for (uint8_t i = 0; i < 10; i++)
+    {
+        string const &plain = testCases[i][TC_ASCII];
+        string key = "Ice, ice baby";
+        string cipher = ASCIIRepeatKeyXOR(plain, key);
+
+        REQUIRE( EnglishScoreXOR(cipher.data(), cipher.length(), key.data(), key.length()) ==
+                 Approx(EnglishScore(plain)) );
+
+        //  Keystream as long as the text
+        string stream(plain.length(), 0);
+        for (size_t j = 0; j < stream.length(); j++)
+            stream[j] = (char)(j * 37 + i);
+        cipher = ASCIIFixedXOR(plain, stream);
+        REQUIRE( EnglishScoreXOR(cipher.data(), cipher.length(), stream.data(), stream.length()) ==
+                 Approx(EnglishScore(plain)) );
+    }
+
+    REQUIRE( EnglishScoreXOR("abc", 3, "k", 0) == 0 );
+
+    //  Batch of windows under the same key
+    string const &text = testCases[3][TC_ASCII];
+    for (size_t keyLen = 1; keyLen < 12; keyLen += 5)
+    {
+        string key = text.substr(7, keyLen);
+        size_t offsets[] = { 0, 1, 17, 40, text.length() - keyLen };
+        double score[5];
+
+        EnglishScoreWindows(score, text.data(), offsets, 5, key.data(), keyLen);
+        for (size_t w = 0; w < 5; w++)
+            REQUIRE( score[w] == Approx(EnglishScoreXOR(text.data() + offsets[w], keyLen,
+                                                        key.data(), keyLen)) );
+    }
+}
+
+TEST_CASE( "Test building, saving and loading models", "[english]" ) {
+    string corpus;
+    for (uint32_t r = 0; r < 50; r++)
+        for (uint8_t i = 0; i < 10; i++)
+            corpus += testCases[i][TC_ASCII] + "\n";
+
+    EnglishModel *built = new EnglishModel;
+    EnglishBuildModel(corpus.data(), corpus.length(), built);
+    REQUIRE( memcmp(built->magic, ENG_MAGIC, sizeof(built->magic)) == 0 );
+
+    //  Model fits text it was built from better than the built-in one
+    string const &sample = testCases[3][TC_ASCII];
+    REQUIRE( EnglishScore(sample, built) > EnglishScore(sample) );
+
+    REQUIRE( EnglishSaveModel("englishTest.tmp", *built) );
+    EnglishModel const *mapped = EnglishLoadModel("englishTest.tmp");
+    REQUIRE( mapped != NULL );
+    REQUIRE( memcmp(mapped, built, sizeof(EnglishModel)) == 0 );
+
+    //  Active model is used when none is given
+    double builtIn = EnglishScore(sample);
+    REQUIRE( &EnglishActiveModel() == &EnglishDefaultModel() );
+    EnglishSetModel(mapped);
+    REQUIRE( EnglishScore(sample) == EnglishScore(sample, built) );
+    REQUIRE( CrackSingleByteXOR(ASCIIRepeatKeyXOR(sample, "\x5A"))[0].key == 0x5A );
+    EnglishSetModel(NULL);
+    REQUIRE( EnglishScore(sample) == builtIn );
+    EnglishUnloadModel(mapped);
+
+    //  Files of wrong size or type aren't mapped
+    string junk(sizeof(EnglishModel), 'x');
+    FILE *f = fopen("englishTest.tmp", "wb");
+    fwrite(junk.data(), 1, junk.length(), f);
+    fclose(f);
+    REQUIRE( EnglishLoadModel("englishTest.tmp") == NULL );
+    f = fopen("englishTest.tmp", "wb");
+    fwrite(built, 1, 100, f);
+    fclose(f);
+    REQUIRE( EnglishLoadModel("englishTest.tmp") == NULL );
+    remove("englishTest.tmp");
+    REQUIRE( EnglishLoadModel("englishTest.tmp") == NULL );
+
+    delete built;
+}
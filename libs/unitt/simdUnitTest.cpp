@@ -0,0 +1,371 @@
+#define CATCH_CONFIG_MAIN
+
+#include "catch.hpp"
+#include <string>
+#include <cstdlib>
+#include <vector>
+#include "testCases.h"
+
+#include "../mycrypto-basic.h"
+#include "../mycrypto-simd.h"
+
+
+/**
+ *  Unit tests for vectorized kernels in mycrypto-simd.h file. Every level
+ *  supported by the CPU is checked against the scalar reference.
+ */
+
+/**
+ *  Generate random string of given length, with bytes in range [0,255]
+ */
+static string RandomBytes(size_t length)
+{
+    string retVal(length, 0);
+    for (size_t i = 0; i < length; i++)
+        retVal[i] = (char)(rand() & 0xFF);
+    return retVal;
+}
+
+TEST_CASE( "Test SIMD kernels on dataset", "[simd]" ) {
+    for (uint8_t lvl = SIMD_SCALAR; lvl <= SIMDSupportedLevel(); lvl++)
+    {
+        REQUIRE( SIMDSetLevel(lvl) == lvl );
+        for (uint8_t i = 0; i < 10; i++)
+        {
+            REQUIRE( HexToBase64(testCases[i][TC_HEX]) == testCases[i][TC_BASE64] );
+            REQUIRE( Base64ToHex(testCases[i][TC_BASE64]) == testCases[i][TC_HEX] );
+            REQUIRE( ASCIIToHex(testCases[i][TC_ASCII]) == testCases[i][TC_HEX] );
+            REQUIRE( HexToASCII(testCases[i][TC_HEX]) == testCases[i][TC_ASCII] );
+            REQUIRE( ASCIIToBase64(testCases[i][TC_ASCII]) == testCases[i][TC_BASE64] );
+            REQUIRE( Base64ToASCII(testCases[i][TC_BASE64]) == testCases[i][TC_ASCII] );
+        }
+    }
+    SIMDSetLevel(SIMDSupportedLevel());
+}
+
+TEST_CASE( "Test SIMD kernels against scalar reference", "[simd]" ) {
+    srand(1234);
+
+    //  Lengths around all vector widths and chunk boundaries
+    for (size_t len = 0; len < 400; len += ((len < 200) ? 1 : 37))
+    {
+        string ascii = RandomBytes(len);
+
+        SIMDSetLevel(SIMD_SCALAR);
+        string hex = ASCIIToHex(ascii), b64 = ASCIIToBase64(ascii);
+        string upperHex(hex);
+        for (size_t i = 0; i < upperHex.length(); i++)
+            upperHex[i] = toupper(upperHex[i]);
+
+        for (uint8_t lvl = SIMD_SSSE3; lvl <= SIMDSupportedLevel(); lvl++)
+        {
+            SIMDSetLevel(lvl);
+            REQUIRE( ASCIIToHex(ascii) == hex );
+            REQUIRE( ASCIIToBase64(ascii) == b64 );
+            REQUIRE( HexToASCII(hex) == ascii );
+            REQUIRE( HexToASCII(upperHex) == ascii );
+            REQUIRE( Base64ToASCII(b64) == ascii );
+            REQUIRE( Base64ToHex(b64) == hex );
+            REQUIRE( HexToBase64(hex) == b64 );
+        }
+    }
+    SIMDSetLevel(SIMDSupportedLevel());
+}
+
+TEST_CASE( "Test SIMD kernels reject invalid characters", "[simd]" ) {
+    string ascii = RandomBytes(300);
+
+    SIMDSetLevel(SIMD_SCALAR);
+    string hex = ASCIIToHex(ascii), b64 = ASCIIToBase64(ascii);
+
+    for (uint8_t lvl = SIMD_SCALAR; lvl <= SIMDSupportedLevel(); lvl++)
+    {
+        SIMDSetLevel(lvl);
+        //  Place an invalid character at every position in turn
+        for (size_t pos = 0; pos < hex.length(); pos += 7)
+        {
+            string bad(hex);
+            bad[pos] = "g/ \n\x80\xFF"[pos % 6];
+            REQUIRE( HexToASCII(bad) == "ERROR" );
+        }
+        for (size_t pos = 0; pos < b64.length() - 2; pos += 5)
+        {
+            string bad(b64);
+            bad[pos] = "=-. \n\x80\xFF"[pos % 7];
+            REQUIRE( Base64ToASCII(bad) == "ERROR" );
+        }
+    }
+    SIMDSetLevel(SIMDSupportedLevel());
+}
+
+TEST_CASE( "Test repeating-key XOR kernels against scalar reference", "[simd]" ) {
+    srand(4321);
+    string text = RandomBytes(3000), key = RandomBytes(700);
+
+    //  Key lengths dividing, not dividing and exceeding the vector width and
+    //  the internal pattern buffer, at different starting key positions
+    for (size_t keyLen = 1; keyLen <= key.length(); keyLen += ((keyLen < 70) ? 1 : 63))
+        for (size_t len = 0; len < text.length(); len += ((len < 300) ? 7 : 541))
+        {
+            size_t keyPos = (len * 13) % keyLen;
+            string ref(len, 0);
+
+            SIMDSetLevel(SIMD_SCALAR);
+            size_t refPos = SIMDRepeatXOR((uint8_t*)&ref[0], (const uint8_t*)text.data(),
+                                          len, (const uint8_t*)key.data(), keyLen, keyPos);
+
+            for (uint8_t lvl = SIMD_SSSE3; lvl <= SIMDSupportedLevel(); lvl++)
+            {
+                string out(text.substr(0, len));
+                SIMDSetLevel(lvl);
+                //  In place
+                REQUIRE( SIMDRepeatXOR((uint8_t*)&out[0], (const uint8_t*)out.data(), len,
+                                       (const uint8_t*)key.data(), keyLen, keyPos) == refPos );
+                REQUIRE( out == ref );
+            }
+        }
+    SIMDSetLevel(SIMDSupportedLevel());
+
+    //  Chunked calls continue where the last one stopped
+    string whole(1000, 0), chunked(1000, 0);
+    size_t pos = 0;
+    SIMDRepeatXOR((uint8_t*)&whole[0], (const uint8_t*)text.data(), 1000,
+                  (const uint8_t*)key.data(), 37);
+    for (size_t i = 0; i < 1000; i += 99)
+        pos = SIMDRepeatXOR((uint8_t*)&chunked[i], (const uint8_t*)text.data() + i,
+                            (i + 99 < 1000) ? 99 : (1000 - i),
+                            (const uint8_t*)key.data(), 37, pos);
+    REQUIRE( chunked == whole );
+    REQUIRE( SIMDRepeatXOR((uint8_t*)&chunked[0], (const uint8_t*)text.data(), 10,
+                           (const uint8_t*)key.data(), 0) == BUF_ERROR );
+}
+
+TEST_CASE( "Test HEX-domain XOR kernels against scalar reference", "[simd]" ) {
+    srand(5678);
+    SIMDSetLevel(SIMD_SCALAR);
+    string text = ASCIIToHex(RandomBytes(1500)), key = ASCIIToHex(RandomBytes(350));
+    string upperText(text);
+    for (size_t i = 0; i < upperText.length(); i++)
+        upperText[i] = toupper(upperText[i]);
+
+    for (size_t keyLen = 1; keyLen <= key.length(); keyLen += ((keyLen < 70) ? 1 : 63))
+        for (size_t len = 0; len < text.length(); len += ((len < 300) ? 7 : 541))
+        {
+            size_t keyPos = (len * 13) % keyLen;
+            string ref(len, 0);
+
+            SIMDSetLevel(SIMD_SCALAR);
+            size_t refPos = SIMDHexRepeatXOR(&ref[0], text.data(), len, key.data(),
+                                             keyLen, keyPos);
+            //  Same as XOR of decoded bytes, for whole bytes of key
+            if (((keyLen % 2) == 0) && ((keyPos % 2) == 0) && ((len % 2) == 0))
+            {
+                string k = HexToASCII(key.substr(0, keyLen));
+                string bytes = HexToASCII(text.substr(0, len));
+                SIMDRepeatXOR((uint8_t*)&bytes[0], (const uint8_t*)bytes.data(),
+                              bytes.length(), (const uint8_t*)k.data(), k.length(), keyPos/2);
+                REQUIRE( ASCIIToHex(bytes) == ref );
+            }
+
+            for (uint8_t lvl = SIMD_SSSE3; lvl <= SIMDSupportedLevel(); lvl++)
+            {
+                string out(upperText.substr(0, len));
+                SIMDSetLevel(lvl);
+                REQUIRE( SIMDHexRepeatXOR(&out[0], out.data(), len, key.data(),
+                                          keyLen, keyPos) == refPos );
+                REQUIRE( out == ref );
+            }
+        }
+
+    //  Invalid digit anywhere in text or key
+    for (uint8_t lvl = SIMD_SCALAR; lvl <= SIMDSupportedLevel(); lvl++)
+    {
+        string out(text.length(), 0);
+        SIMDSetLevel(lvl);
+        for (size_t pos = 0; pos < text.length(); pos += 37)
+        {
+            string bad(text);
+            bad[pos] = "g \n\x80"[pos % 4];
+            REQUIRE( SIMDHexRepeatXOR(&out[0], bad.data(), bad.length(), key.data(), 5) == BUF_ERROR );
+            //  Long key, only its first 320 digits are used
+            REQUIRE( SIMDHexRepeatXOR(&out[0], text.data(), text.length(), bad.data(),
+                                      320) == ((pos < 320) ? BUF_ERROR : (text.length() % 320)) );
+        }
+    }
+    SIMDSetLevel(SIMDSupportedLevel());
+}
+
+TEST_CASE( "Test Hamming distance kernels against scalar reference", "[simd]" ) {
+    srand(8765);
+    string a = RandomBytes(2000), b = RandomBytes(2000);
+
+    for (size_t len = 0; len < a.length(); len += ((len < 300) ? 1 : 97))
+    {
+        SIMDSetLevel(SIMD_SCALAR);
+        size_t ref = SIMDHamming((const uint8_t*)a.data(), (const uint8_t*)b.data(), len);
+        REQUIRE( SIMDHamming((const uint8_t*)a.data(), (const uint8_t*)a.data(), len) == 0 );
+
+        for (uint8_t lvl = SIMD_SSSE3; lvl <= SIMDSupportedLevel(); lvl++)
+        {
+            SIMDSetLevel(lvl);
+            //  Unaligned start as well
+            REQUIRE( SIMDHamming((const uint8_t*)a.data(), (const uint8_t*)b.data(), len) == ref );
+            SIMDSetLevel(SIMD_SCALAR);
+            size_t ref1 = SIMDHamming((const uint8_t*)a.data() + 1, (const uint8_t*)b.data() + 3, len/2);
+            SIMDSetLevel(lvl);
+            REQUIRE( SIMDHamming((const uint8_t*)a.data() + 1, (const uint8_t*)b.data() + 3, len/2) == ref1 );
+        }
+    }
+    SIMDSetLevel(SIMDSupportedLevel());
+}
+
+TEST_CASE( "Test byte set counting kernels against scalar reference", "[simd]" ) {
+    srand(2468);
+    string in = RandomBytes(1000);
+
+    for (uint8_t set = 0; set < 40; set++)
+    {
+        string rows = RandomBytes(16);
+        bool high = set & 1;
+
+        for (size_t len = 0; len < in.length(); len += ((len < 200) ? 1 : 73))
+        {
+            size_t ref = 0;
+            for (size_t i = 0; i < len; i++)
+            {
+                uint8_t b = in[i];
+                ref += (b < 0x80) ? ((rows[b & 0x0F] >> (b >> 4)) & 1) : high;
+            }
+
+            for (uint8_t lvl = SIMD_SCALAR; lvl <= SIMDSupportedLevel(); lvl++)
+            {
+                SIMDSetLevel(lvl);
+                REQUIRE( SIMDCountByteSet((const uint8_t*)in.data(), len,
+                                          (const uint8_t*)rows.data(), high) == ref );
+            }
+        }
+    }
+
+    //  Long input, past the point where per-byte counters are flushed
+    string rows(16, (char)0xFF), big = RandomBytes(10000);
+    for (uint8_t lvl = SIMD_SCALAR; lvl <= SIMDSupportedLevel(); lvl++)
+    {
+        SIMDSetLevel(lvl);
+        REQUIRE( SIMDCountByteSet((const uint8_t*)big.data(), big.length(),
+                                  (const uint8_t*)rows.data(), true) == big.length() );
+    }
+    SIMDSetLevel(SIMDSupportedLevel());
+}
+
+TEST_CASE( "Test XOR key scoring kernels against direct sum", "[simd]" ) {
+    srand(3579);
+    vector<double> table(256), rows(16*256);
+    for (size_t i = 0; i < 256; i++)
+        table[i] = (double)(rand() % 1000) / 7;
+    for (size_t l = 0; l < 16; l++)
+        for (size_t i = 0; i < 256; i++)
+            rows[256*l + i] = table[i ^ l];
+
+    for (size_t used = 1; used <= 256; used *= 2)
+    {
+        uint64_t hist[256] = { 0 };
+        for (size_t i = 0; i < used; i++)
+            hist[rand() & 0xFF] += rand() % 100;
+
+        vector<double> ref(256, 1.0);
+        for (size_t k = 0; k < 256; k++)
+            for (size_t c = 0; c < 256; c++)
+                ref[k] += hist[c] * table[c ^ k];
+
+        for (uint8_t lvl = SIMD_SCALAR; lvl <= SIMDSupportedLevel(); lvl++)
+        {
+            vector<double> score(256, 1.0);
+            SIMDSetLevel(lvl);
+            SIMDXORKeyScores(score.data(), hist, rows.data());
+            for (size_t k = 0; k < 256; k++)
+                REQUIRE( score[k] == Approx(ref[k]) );
+        }
+    }
+    SIMDSetLevel(SIMDSupportedLevel());
+}
+
+TEST_CASE( "Test transpose kernels against direct reference", "[simd]" ) {
+    srand(1357);
+    string in = RandomBytes(3000);
+    const size_t guard = 64;
+
+    for (size_t k = 1; k <= 70; k += ((k < 40) ? 1 : 7))
+        for (size_t len = 0; len < in.length(); len += ((len < 300) ? 13 : 541))
+        {
+            size_t stride = (len + k - 1) / k;
+            string ref(k*stride, 0);
+            for (size_t i = 0; i < len; i++)
+                ref[(i % k)*stride + i / k] = in[i];
+
+            for (uint8_t lvl = SIMD_SCALAR; lvl <= SIMDSupportedLevel(); lvl++)
+            {
+                SIMDSetLevel(lvl);
+                //  Guard bytes past the end of output must stay untouched
+                string cols(k*stride + guard, (char)0xA5);
+                SIMDTranspose((uint8_t*)&cols[0], (const uint8_t*)in.data(), len, k);
+                REQUIRE( cols.substr(0, k*stride) == ref );
+                REQUIRE( cols.substr(k*stride) == string(guard, (char)0xA5) );
+
+                string rows(len + guard, (char)0xA5);
+                SIMDUntranspose((uint8_t*)&rows[0], (const uint8_t*)ref.data(), len, k);
+                REQUIRE( rows.substr(0, len) == in.substr(0, len) );
+                REQUIRE( rows.substr(len) == string(guard, (char)0xA5) );
+            }
+        }
+    SIMDSetLevel(SIMDSupportedLevel());
+}
+
+TEST_CASE( "Test crib matching kernels against direct reference", "[simd]" ) {
+    srand(97531);
+    string x = RandomBytes(700);
+    vector<uint64_t> match((x.length() + 63) / 64);
+
+    for (size_t set = 0; set < 12; set++)
+    {
+        //  Dense sets, so that some windows survive
+        string rows = RandomBytes(16);
+        for (size_t l = 0; l < 16; l++)
+            rows[l] |= RandomBytes(1)[0];
+        bool high = set & 1;
+
+        for (size_t cribLen = 1; cribLen <= 20; cribLen += 3)
+        {
+            string crib = RandomBytes(cribLen);
+            for (size_t maxMiss = 0; maxMiss <= cribLen; maxMiss += 2)
+                for (size_t n = 0; (n + cribLen - 1) <= x.length(); n += ((n < 140) ? 1 : 97))
+                {
+                    for (uint8_t lvl = SIMD_SCALAR; lvl <= SIMDSupportedLevel(); lvl++)
+                    {
+                        SIMDSetLevel(lvl);
+                        match.assign(match.size(), ~0ULL);
+                        SIMDCribMatch(match.data(), (const uint8_t*)x.data(), n,
+                                      (const uint8_t*)crib.data(), cribLen,
+                                      (const uint8_t*)rows.data(), high, maxMiss);
+
+                        size_t wrong = 0;
+                        for (size_t o = 0; o < ((n + 63) / 64) * 64; o++)
+                        {
+                            size_t miss = cribLen + 1;
+                            if (o < n)
+                            {
+                                miss = 0;
+                                for (size_t i = 0; i < cribLen; i++)
+                                {
+                                    uint8_t b = x[o + i] ^ crib[i];
+                                    miss += !((b < 0x80) ? ((rows[b & 0x0F] >> (b >> 4)) & 1) : high);
+                                }
+                            }
+                            wrong += ((match[o / 64] >> (o % 64)) & 1) != (miss <= maxMiss);
+                        }
+                        REQUIRE( wrong == 0 );
+                    }
+                }
+        }
+    }
+    SIMDSetLevel(SIMDSupportedLevel());
+}
@@ -21,24 +21,17 @@ int main()
     //  Convert HEX string to ASCII string
     string b1ASCII = HexToASCII(b1);
 
-    //  Loop through all 128 possible hex characters in an attempt to brute-force
-    //  decription with all possible single-char keys
-    for (int i = 0; i < 127; i++)
-    {
-        //  Generate string key used for decryption through XORing
-        string key(b1ASCII);
-        for (int j = 0; j < key.length(); j++)
-            key[j] = i;
+    //  Score all 256 single-char keys from the histogram of the cipher and
+    //  decrypt the cipher with the three most likely ones
+    vector<SingleByteKey> best = CrackSingleByteXOR(b1ASCII, 3);
 
-        //  Perform Fixed XOR operation on ASCII strings
-        string ret = ASCIIFixedXOR(b1ASCII, key);
+    for (size_t i = 0; i < best.size(); i++)
+    {
+        char key = best[i].key;
 
-        //  Evaluate returned string
-        //  Discard all strings which contain special & control characters
-        if (validASCIIString(ret))
-            cout <<"Key: "<< key<<", \tResult: " << ret << endl;
+        cout <<"Key: "<< key<<", \tScore: "<<best[i].score<<", \tResult: "
+             << ASCIIRepeatKeyXOR(b1ASCII, string(1, key)) << endl;
     }
 
-
     return 0;
 }
@@ -9,39 +9,33 @@
 #include <cstdlib>
 #include <cstdio>
 #include <iostream>
-#include <fstream>
+#include <chrono>
 #include "../libs/mycrypto-basic.h"
 
 using namespace std;
 
 int main()
 {
-    //  Open external resource file
-    fstream file, file1;
-    file.open("ch4_res1.txt");
-    //  Holds extracted line from file
-    string b1;
+    size_t lines;
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
 
-    while (getline(file, b1))
-    {
-            //  Convert HEX string to ASCII string
-            string b1ASCII = HexToASCII(b1);
-            //  Generate string key used for decryption through XORing
-            string key(b1ASCII);
+    //  File is memory-mapped and its lines split between threads, each line is
+    //  decoded and scored for all single-char keys from its histogram. Score
+    //  is average per char, so it can be compared between lines
+    vector<LineKeyScore> best = DetectSingleByteXOR("ch4_res1.txt", ENC_HEX, 1,
+                                                    0, &lines);
+    double sec = chrono::duration<double>(chrono::steady_clock::now() - start).count();
 
-        for (int i = 0; i < 127; i++)
-        {
-            for (int j = 0; j < key.length(); j++)
-                key[j] = i;
+    if (best.empty())
+    {
+        cout << "Failed to read ch4_res1.txt" << endl;
+        return 1;
+    }
 
-            string ret = ASCIIFixedXOR(b1ASCII, key);
+    char key = best[0].key;
+    cout <<"Line: "<<best[0].line<<", \tKey: "<< key<<", \tScore: "<<best[0].score
+         <<", \tResult: "<<best[0].plain;
+    cout <<lines<<" lines in "<<sec<<" s ("<<(lines / sec)<<" lines/s)"<<endl;
 
-            //  Evaluate returned string
-            //  Discard all strings which contain special characters
-            if (validASCIIString(ret,true,true,true,true,true,false,false))
-                cout <<"Key: "<< key<<", \tResult: " << ret;
-        }
-    }
-    file.close();
     return 0;
 }
@@ -17,22 +17,12 @@ using namespace std;
 
 int main()
 {
-    //  Open external resource file
-    fstream file;
-    file.open("ch7_res1.txt");
-    //  Holds extracted line from file
-    string b1, txtStr;
-
-    //  Load file into a single string
-    while (getline(file, b1))
-        txtStr += b1;
-
-    //  Close file, we're done
-    file.close();
+    //  External resource file is base64-encoded, map it and decode it at once
+    string ciphertext = Base64FileToASCII("ch7_res1.txt");
 
     InitAES128EBC();
 
-    string  ciphertext = HexToASCII(Base64ToHex(txtStr)).c_str(), rtext;
+    string  rtext;
     string  key = "YELLOW SUBMARINE",
             iv(17,0x48);
 
@@ -42,6 +32,7 @@ int main()
     cout<<"Decrypting, check output file decrypted.out";
 
     //  Open external resource file
+    fstream file;
     file.open("ch7_decrypted.out", ios::out);
     file << rtext;
     file.close();
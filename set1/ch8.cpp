@@ -12,7 +12,6 @@
 #include <cstdlib>
 #include <string>
 #include <iostream>
-#include <fstream>
 #include <cstdint>
 #include "../libs/mycrypto-basic.h"
 
@@ -28,16 +27,17 @@ typedef tuple<string, uint32_t> entry;
 
 int main()
 {
-    //  Open external resource file
-    fstream file;
-    file.open("ch8_res1.txt");
+    //  Map external resource file
+    MappedFile file("ch8_res1.txt");
 
-    string b1;  //  Holds extracted line from file
-    //  Open file, load one line of HEX data, split it in blocks and compare all
-    //  blocks for matches
+    char const *line;   //  Holds extracted line from file
+    size_t len;
+    //  Go through file, take one line of HEX data, split it in blocks and
+    //  compare all blocks for matches
     vector< entry >ranking;
-    while (getline(file, b1))
+    while (file.nextLine(line, len))
     {
+        string b1(line, len);
         //  Store blocks of data for matching
         vector<string>block;
         //  Holds temporary block of data extracted from ciphertext
@@ -65,7 +65,7 @@ int main()
         ranking.push_back(make_tuple(b1, match));
     }
 
-    //  Close file, we're done
+    //  Unmap file, we're done
     file.close();
 
     //  Sort vector in descending order based on number of matches
@@ -29,22 +29,8 @@ int main()
     //  Split input plaintext into blocks
     string text = "This is my plaintext to encrypt with AES and then try to decrypt it back unchanged.";
 
-    //  Open external resource file
-    fstream file;
-    file.open("ch10_res1.txt");
-    //  Holds extracted line from file
-    string b1, txtStr;
-
-    //  Load file into a single string
-    while (getline(file, b1))
-        txtStr += b1;
-
-    //  Close file, we're done
-    file.close();
-
-    //  String from file is base64-encoded, decode it to ASCII (no direct
-    //  conversion available at the moment :( )
-    txtStr = HexToASCII(Base64ToHex(txtStr));
+    //  External resource file is base64-encoded, map it and decode it at once
+    string txtStr = Base64FileToASCII("ch10_res1.txt");
 
     //  Initialize openSSL
     InitAES128EBC();
@@ -53,6 +39,7 @@ int main()
     string plainText = AESCBCDecryptText(key, iv, txtStr);
 
     //  Write result to file
+    fstream file;
     file.open("ch10_decrypted.out", ios::out);
     file<<"Got the following plaintext: \n\t"<<plainText<<endl;
     file.close();
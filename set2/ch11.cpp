@@ -117,9 +117,8 @@ int main()
     //  Close file, we're done
     file.close();
 
-    //  String from file is base64-encoded, decode it to ASCII (no direct
-    //  conversion available at the moment :( )
-    txtStr = HexToASCII(Base64ToHex(txtStr));
+    //  String from file is base64-encoded, decode it to ASCII
+    txtStr = Base64ToASCII(txtStr);
 
     //  Initialize openSSL
     InitAES128EBC();